@@ -0,0 +1,108 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ENTITYTYPEIDARRAY_H_
+#define KATANA_LIBGALOIS_KATANA_ENTITYTYPEIDARRAY_H_
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#include "katana/EntityTypeManager.h"
+#include "katana/NUMAArray.h"
+#include "katana/config.h"
+
+namespace katana {
+
+class KATANA_EXPORT DynamicBitset;
+
+/// The EntityTypeID of each node or edge of a graph.
+///
+/// EntityTypeIDs are 16 bits, but most graphs use only a few of them, so an
+/// array that holds at most kMaxNarrowTypes distinct EntityTypeIDs stores one
+/// byte per entity: an index into a dictionary of the EntityTypeIDs it holds.
+/// When those EntityTypeIDs are all small, the dictionary is the identity and
+/// each byte is the EntityTypeID itself. Only arrays with more distinct
+/// EntityTypeIDs store two bytes per entity.
+///
+/// The dictionary has an entry for every byte value, so reading an
+/// EntityTypeID is one load from the array and, for narrow arrays, one load
+/// from a table that fits in a few cache lines.
+class KATANA_EXPORT EntityTypeIDArray {
+public:
+  /// The largest number of distinct EntityTypeIDs stored in one byte each
+  static constexpr size_t kMaxNarrowTypes =
+      size_t{std::numeric_limits<uint8_t>::max()} + 1;
+  using Dictionary = std::array<EntityTypeID, kMaxNarrowTypes>;
+
+  EntityTypeIDArray() { dictionary_.fill(kInvalidEntityType); }
+  EntityTypeIDArray(EntityTypeIDArray&&) = default;
+  EntityTypeIDArray& operator=(EntityTypeIDArray&&) = default;
+
+  EntityTypeIDArray(const EntityTypeIDArray&) = delete;
+  EntityTypeIDArray& operator=(const EntityTypeIDArray&) = delete;
+
+  /// Encode \p ids with the narrowest encoding that holds them.
+  static EntityTypeIDArray Make(NUMAArray<EntityTypeID>&& ids);
+
+  /// \returns an array of \p size entities that all have type \p id
+  static EntityTypeIDArray MakeFilled(size_t size, EntityTypeID id);
+
+  /// \returns a narrow array where each byte of \p ids is an EntityTypeID
+  static EntityTypeIDArray MakeIdentity(NUMAArray<uint8_t>&& ids);
+
+  /// \returns a narrow array where each byte of \p codes is an index into the
+  /// first \p dictionary_size entries of \p dictionary
+  static EntityTypeIDArray MakeNarrow(
+      const Dictionary& dictionary, size_t dictionary_size,
+      NUMAArray<uint8_t>&& codes);
+
+  /// \returns an array with two bytes per entity
+  static EntityTypeIDArray MakeWide(NUMAArray<EntityTypeID>&& ids);
+
+  EntityTypeID operator[](size_t index) const noexcept {
+    return is_narrow_ ? dictionary_[codes_[index]] : ids_[index];
+  }
+
+  size_t size() const noexcept {
+    return is_narrow_ ? codes_.size() : ids_.size();
+  }
+
+  /// \returns true iff the array stores one byte per entity
+  bool is_narrow() const noexcept { return is_narrow_; }
+
+  /// \returns true iff the array stores one byte per entity and each byte is
+  /// the EntityTypeID itself
+  bool is_identity() const noexcept { return is_identity_; }
+
+  /// The dictionary of a narrow array. Its first dictionary_size() entries
+  /// are the EntityTypeIDs that codes() index, the rest are
+  /// kInvalidEntityType unless the dictionary is the identity.
+  const Dictionary& dictionary() const noexcept { return dictionary_; }
+
+  size_t dictionary_size() const noexcept { return dictionary_size_; }
+
+  /// The bytes of a narrow array
+  const NUMAArray<uint8_t>& codes() const noexcept { return codes_; }
+
+  /// The EntityTypeIDs of an array that is not narrow
+  const NUMAArray<EntityTypeID>& ids() const noexcept { return ids_; }
+
+  /// Resize \p bitset to size() and set the bit of each entity whose
+  /// EntityTypeID is in \p types, and only those, in one parallel pass.
+  ///
+  /// Each 64 entities are tested into one word of \p bitset; for narrow
+  /// arrays each test is a lookup of the entity's byte in a table computed
+  /// once from \p types.
+  void FindEntitiesOfTypes(
+      const SetOfEntityTypeIDs& types, DynamicBitset* bitset) const;
+
+private:
+  bool is_narrow_{true};
+  bool is_identity_{false};
+  Dictionary dictionary_;
+  size_t dictionary_size_{0};
+  NUMAArray<uint8_t> codes_;
+  NUMAArray<EntityTypeID> ids_;
+};
+
+}  // namespace katana
+
+#endif
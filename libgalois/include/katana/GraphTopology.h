@@ -1,6 +1,7 @@
 #ifndef KATANA_LIBGALOIS_KATANA_GRAPHTOPOLOGY_H_
 #define KATANA_LIBGALOIS_KATANA_GRAPHTOPOLOGY_H_
 
+#include <limits>
 #include <utility>
 #include <vector>
 
@@ -25,7 +26,7 @@ struct KATANA_EXPORT GraphTopologyTypes {
   using Node = uint32_t;
   using Edge = uint64_t;
   using PropertyIndex = uint64_t;
-  using EntityType = uint8_t;
+  using EntityType = uint16_t;
   using node_iterator = boost::counting_iterator<Node>;
   using edge_iterator = boost::counting_iterator<Edge>;
   using nodes_range = StandardRange<node_iterator>;
@@ -327,6 +328,10 @@ public:
     kAny = 0,
     kSortedByDegree,
     kSortedByNodeType,
+    kReverseCuthillMcKee,
+    kGorder,
+    kDegreeBucketed,
+    kBreadthFirst,
   };
 
   PropertyIndex node_property_index(const Node& nid) const noexcept {
@@ -350,6 +355,50 @@ public:
   static std::unique_ptr<ShuffleTopology> MakeSortedByNodeType(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
 
+  /// Group the nodes by partition, keeping their order within a partition,
+  /// so that the nodes of a partition and most of their edges are contiguous.
+  /// partition_ids[n] is the partition of node n of seed_topo. The order
+  /// depends on data outside the graph, so it has no NodeSortKind and the
+  /// result reports kAny.
+  static std::unique_ptr<ShuffleTopology> MakeSortedByPartition(
+      const EdgeShuffleTopology& seed_topo,
+      const uint32_t* partition_ids) noexcept;
+
+  // The orders below improve the locality of graph traversals. They only
+  // follow the edges of seed_topo, so they work best on symmetric graphs.
+
+  /// Reverse Cuthill-McKee: breadth first search from a pseudo-peripheral
+  /// node of each component, visiting neighbors by increasing degree, and
+  /// then reversed. Keeps the labels of neighbors close, i.e., minimizes
+  /// bandwidth. Serial.
+  static std::unique_ptr<ShuffleTopology> MakeReverseCuthillMcKee(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
+  /// An approximation of Gorder that runs in parallel: the breadth first
+  /// order is cut into chunks and each chunk is reordered greedily so that
+  /// each node shares the most neighbors with the few nodes placed just
+  /// before it.
+  ///
+  ///   Hao Wei, Jeffrey Xu Yu, Can Lu and Xuemin Lin. Speedup Graph
+  ///   Processing by Graph Ordering. SIGMOD 2016.
+  static std::unique_ptr<ShuffleTopology> MakeGorder(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
+  /// Degree based grouping: nodes are bucketed by the logarithm of their
+  /// degree, buckets of higher degree first, keeping the original order
+  /// within a bucket. Clusters the hubs together at little cost while
+  /// preserving most of the existing locality.
+  ///
+  ///   Priyank Faldu, Jeff Diamond and Boris Grot. A Closer Look at
+  ///   Lightweight Graph Reordering. IISWC 2019.
+  static std::unique_ptr<ShuffleTopology> MakeDegreeBucketed(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
+  /// Breadth first order, starting each component from its node of highest
+  /// degree. Serial.
+  static std::unique_ptr<ShuffleTopology> MakeBreadthFirst(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
   static std::unique_ptr<ShuffleTopology> MakeFromTopo(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo,
       const NodeSortKind& node_sort_todo,
@@ -366,6 +415,18 @@ public:
     case NodeSortKind::kSortedByNodeType:
       ret = MakeSortedByNodeType(pg, seed_topo);
       break;
+    case NodeSortKind::kReverseCuthillMcKee:
+      ret = MakeReverseCuthillMcKee(pg, seed_topo);
+      break;
+    case NodeSortKind::kGorder:
+      ret = MakeGorder(pg, seed_topo);
+      break;
+    case NodeSortKind::kDegreeBucketed:
+      ret = MakeDegreeBucketed(pg, seed_topo);
+      break;
+    case NodeSortKind::kBreadthFirst:
+      ret = MakeBreadthFirst(pg, seed_topo);
+      break;
     default:
       KATANA_LOG_FATAL("switch case fell through");
     }
@@ -391,61 +452,16 @@ private:
         node_prop_indices.begin(), node_prop_indices.end(),
         [&](const auto& i1, const auto& i2) { return cmp(i1, i2); });
 
-    GraphTopology::AdjIndexVec degrees;
-    degrees.allocateInterleaved(seed_topo.num_nodes());
-
-    katana::NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
-    old_to_new_map.allocateInterleaved(seed_topo.num_nodes());
-    // TODO(amber): given 32-bit node ids, put a check here that
-    // node_prop_indices.size() < 2^32
-    katana::do_all(
-        katana::iterate(size_t{0}, node_prop_indices.size()),
-        [&](auto i) {
-          // node_prop_indices[i] gives old node id
-          old_to_new_map[node_prop_indices[i]] = i;
-          degrees[i] = seed_topo.degree(node_prop_indices[i]);
-        },
-        katana::no_stats());
-
-    KATANA_LOG_DEBUG_ASSERT(std::is_sorted(degrees.begin(), degrees.end()));
-
-    katana::ParallelSTL::partial_sum(
-        degrees.begin(), degrees.end(), degrees.begin());
-
-    GraphTopologyTypes::EdgeDestVec new_dest_vec;
-    new_dest_vec.allocateInterleaved(seed_topo.num_edges());
-
-    GraphTopologyTypes::PropIndexVec edge_prop_indices;
-    edge_prop_indices.allocateInterleaved(seed_topo.num_edges());
-
-    katana::do_all(
-        katana::iterate(seed_topo.all_nodes()),
-        [&](auto old_srd_id) {
-          auto new_srd_id = old_to_new_map[old_srd_id];
-          auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
-
-          for (auto e : seed_topo.edges(old_srd_id)) {
-            auto new_edge_dest = old_to_new_map[seed_topo.edge_dest(e)];
-
-            auto new_edge_id = new_out_index;
-            ++new_out_index;
-            KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
-
-            new_dest_vec[new_edge_id] = new_edge_dest;
-
-            // copy over edge_property_index mapping from old edge to new edge
-            edge_prop_indices[new_edge_id] = seed_topo.edge_property_index(e);
-          }
-        },
-        katana::steal(), katana::no_stats());
-
-    return std::make_unique<ShuffleTopology>(ShuffleTopology{
-        seed_topo.transpose_state(), node_sort_todo,
-        seed_topo.edge_sort_state(), std::move(degrees),
-        std::move(node_prop_indices), std::move(new_dest_vec),
-        std::move(edge_prop_indices)});
+    return MakeNodePermutedTopo(
+        seed_topo, std::move(node_prop_indices), node_sort_todo);
   }
 
+  /// Relabel the nodes of seed_topo so that node i is node
+  /// node_prop_indices[i] of seed_topo
+  static std::unique_ptr<ShuffleTopology> MakeNodePermutedTopo(
+      const EdgeShuffleTopology& seed_topo, PropIndexVec&& node_prop_indices,
+      const NodeSortKind& node_sort_todo) noexcept;
+
   ShuffleTopology(
       const TransposeKind& tpose_todo, const NodeSortKind& node_sort_todo,
       const EdgeSortKind& edge_sort_todo, AdjIndexVec&& adj_indices,
@@ -472,12 +488,17 @@ private:
 
 class KATANA_EXPORT CondensedTypeIDMap : public GraphTopologyTypes {
   /// map an integer id to each unique edge edge_type in the graph, such that, the
-  /// integer ids assigned are contiguous, i.e., 0 .. num_unique_types-1
-  using TypeIDToIndexMap = std::unordered_map<EntityType, uint32_t>;
+  /// integer ids assigned are contiguous, i.e., 0 .. num_unique_types-1.
+  /// Indexed by edge_type up to the largest edge_type in the graph, so that
+  /// looking up an index is a single load; absent types map to kInvalidIndex
+  using TypeIDToIndexMap = std::vector<uint32_t>;
   /// reverse map that allows looking up edge_type using its integer index
   using IndexToTypeIDMap = std::vector<EntityType>;
 
 public:
+  static constexpr uint32_t kInvalidIndex =
+      std::numeric_limits<uint32_t>::max();
+
   using EdgeTypeIDRange =
       katana::StandardRange<IndexToTypeIDMap::const_iterator>;
 
@@ -498,8 +519,8 @@ public:
   }
 
   uint32_t GetIndex(const EntityType& edge_type) const noexcept {
-    KATANA_LOG_DEBUG_ASSERT(type_to_index_map_.count(edge_type) > 0);
-    return type_to_index_map_.at(edge_type);
+    KATANA_LOG_DEBUG_ASSERT(has_edge_type_id(edge_type));
+    return type_to_index_map_[edge_type];
   }
 
   size_t num_unique_types() const noexcept { return index_to_type_map_.size(); }
@@ -507,7 +528,8 @@ public:
   /// @param edge_type: edge_type to check
   /// @returns true iff there exists some edge in the graph with that edge_type
   bool has_edge_type_id(const EntityType& edge_type) const noexcept {
-    return (type_to_index_map_.find(edge_type) != type_to_index_map_.cend());
+    return size_t(edge_type) < type_to_index_map_.size() &&
+           type_to_index_map_[edge_type] != kInvalidIndex;
   }
 
   /// Wrapper to get the distinct edge types in the graph.
@@ -528,7 +550,9 @@ private:
       : type_to_index_map_(std::move(type_to_index)),
         index_to_type_map_(std::move(index_to_type)),
         is_valid_(true) {
-    KATANA_LOG_ASSERT(index_to_type_map_.size() == type_to_index_map_.size());
+    KATANA_LOG_ASSERT(
+        index_to_type_map_.empty() ||
+        size_t(index_to_type_map_.back()) + 1 == type_to_index_map_.size());
   }
 
   TypeIDToIndexMap type_to_index_map_;
@@ -561,6 +585,10 @@ public:
     return topo().edge_source(eid);
   }
 
+  /// Raw destination array; the destinations of node N are
+  /// dest_data()[*edges(N).begin() .. *edges(N).end()).
+  auto dest_data() const noexcept { return topo().dest_data(); }
+
   /// @param node node to get degree for
   /// @returns Degree of node N
   auto degree(const Node& node) const noexcept { return topo().degree(node); }
@@ -897,6 +925,15 @@ using EdgesSortedByDestTopology = SortedTopologyWrapper<EdgeShuffleTopology>;
 using NodesSortedByDegreeEdgesSortedByDestIDTopology =
     SortedTopologyWrapper<ShuffleTopology>;
 
+/// Nodes relabeled in the order given by kNodeSort and edges sorted by
+/// destination. Each order is a distinct type so that it is a distinct view.
+template <ShuffleTopology::NodeSortKind kNodeSort>
+class ReorderedEdgesSortedByDestIDTopology
+    : public SortedTopologyWrapper<ShuffleTopology> {
+public:
+  using SortedTopologyWrapper<ShuffleTopology>::SortedTopologyWrapper;
+};
+
 class KATANA_EXPORT EdgeTypeAwareBiDirTopology
     : public BasicBiDirTopoWrapper<
           EdgeTypeAwareTopology, EdgeTypeAwareTopology> {
@@ -1032,6 +1069,9 @@ using PGViewNodesSortedByDegreeEdgesSortedByDestID =
 using PGViewBiDirectional = BasicPropGraphViewWrapper<SimpleBiDirTopology>;
 using PGViewEdgeTypeAwareBiDir =
     BasicPropGraphViewWrapper<EdgeTypeAwareBiDirTopology>;
+template <ShuffleTopology::NodeSortKind kNodeSort>
+using PGViewReorderedEdgesSortedByDestID =
+    BasicPropGraphViewWrapper<ReorderedEdgesSortedByDestIDTopology<kNodeSort>>;
 
 template <typename PGView>
 struct PGViewBuilder {};
@@ -1049,6 +1089,14 @@ struct PGViewBuilder<PGViewBiDirectional> {
 
     return PGViewBiDirectional{pg, bidir_topo};
   }
+
+  template <typename ViewCache>
+  static bool IsCached(
+      const PropertyGraph* pg, const ViewCache& viewCache) noexcept {
+    return viewCache.FindEdgeShuffTopo(
+               pg, EdgeShuffleTopology::TransposeKind::kYes,
+               EdgeShuffleTopology::EdgeSortKind::kAny) != nullptr;
+  }
 };
 
 template <>
@@ -1063,6 +1111,14 @@ struct PGViewBuilder<PGViewEdgesSortedByDestID> {
     return PGViewEdgesSortedByDestID{
         pg, EdgesSortedByDestTopology{sorted_topo}};
   }
+
+  template <typename ViewCache>
+  static bool IsCached(
+      const PropertyGraph* pg, const ViewCache& viewCache) noexcept {
+    return viewCache.FindEdgeShuffTopo(
+               pg, EdgeShuffleTopology::TransposeKind::kNo,
+               EdgeShuffleTopology::EdgeSortKind::kSortedByDestID) != nullptr;
+  }
 };
 
 template <>
@@ -1071,13 +1127,44 @@ struct PGViewBuilder<PGViewNodesSortedByDegreeEdgesSortedByDestID> {
   static PGViewNodesSortedByDegreeEdgesSortedByDestID BuildView(
       const PropertyGraph* pg, ViewCache& viewCache) noexcept {
     auto sorted_topo = viewCache.BuildOrGetShuffTopo(
-        pg, EdgeShuffleTopology::TransposeKind::kYes,
+        pg, EdgeShuffleTopology::TransposeKind::kNo,
         ShuffleTopology::NodeSortKind::kSortedByDegree,
         EdgeShuffleTopology::EdgeSortKind::kSortedByDestID);
 
     return PGViewNodesSortedByDegreeEdgesSortedByDestID{
         pg, NodesSortedByDegreeEdgesSortedByDestIDTopology{sorted_topo}};
   }
+
+  template <typename ViewCache>
+  static bool IsCached(
+      const PropertyGraph* pg, const ViewCache& viewCache) noexcept {
+    return viewCache.FindShuffTopo(
+               pg, EdgeShuffleTopology::TransposeKind::kNo,
+               ShuffleTopology::NodeSortKind::kSortedByDegree,
+               EdgeShuffleTopology::EdgeSortKind::kSortedByDestID) != nullptr;
+  }
+};
+
+template <ShuffleTopology::NodeSortKind kNodeSort>
+struct PGViewBuilder<PGViewReorderedEdgesSortedByDestID<kNodeSort>> {
+  template <typename ViewCache>
+  static PGViewReorderedEdgesSortedByDestID<kNodeSort> BuildView(
+      const PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto sorted_topo = viewCache.BuildOrGetShuffTopo(
+        pg, EdgeShuffleTopology::TransposeKind::kNo, kNodeSort,
+        EdgeShuffleTopology::EdgeSortKind::kSortedByDestID);
+
+    return PGViewReorderedEdgesSortedByDestID<kNodeSort>{
+        pg, ReorderedEdgesSortedByDestIDTopology<kNodeSort>{sorted_topo}};
+  }
+
+  template <typename ViewCache>
+  static bool IsCached(
+      const PropertyGraph* pg, const ViewCache& viewCache) noexcept {
+    return viewCache.FindShuffTopo(
+               pg, EdgeShuffleTopology::TransposeKind::kNo, kNodeSort,
+               EdgeShuffleTopology::EdgeSortKind::kSortedByDestID) != nullptr;
+  }
 };
 
 template <>
@@ -1093,6 +1180,15 @@ struct PGViewBuilder<PGViewEdgeTypeAwareBiDir> {
     return PGViewEdgeTypeAwareBiDir{
         pg, EdgeTypeAwareBiDirTopology{out_topo, in_topo}};
   }
+
+  template <typename ViewCache>
+  static bool IsCached(
+      const PropertyGraph* pg, const ViewCache& viewCache) noexcept {
+    return viewCache.FindEdgeTypeAwareTopo(
+               pg, EdgeShuffleTopology::TransposeKind::kNo) != nullptr &&
+           viewCache.FindEdgeTypeAwareTopo(
+               pg, EdgeShuffleTopology::TransposeKind::kYes) != nullptr;
+  }
 };
 
 }  // end namespace internal
@@ -1103,6 +1199,20 @@ struct PropertyGraphViews {
   using EdgeTypeAwareBiDir = internal::PGViewEdgeTypeAwareBiDir;
   using NodesSortedByDegreeEdgesSortedByDestID =
       internal::PGViewNodesSortedByDegreeEdgesSortedByDestID;
+
+  // Locality improving node orders; see the ShuffleTopology factories
+  using NodesReverseCuthillMcKeeEdgesSortedByDestID =
+      internal::PGViewReorderedEdgesSortedByDestID<
+          ShuffleTopology::NodeSortKind::kReverseCuthillMcKee>;
+  using NodesGorderEdgesSortedByDestID =
+      internal::PGViewReorderedEdgesSortedByDestID<
+          ShuffleTopology::NodeSortKind::kGorder>;
+  using NodesDegreeBucketedEdgesSortedByDestID =
+      internal::PGViewReorderedEdgesSortedByDestID<
+          ShuffleTopology::NodeSortKind::kDegreeBucketed>;
+  using NodesBreadthFirstEdgesSortedByDestID =
+      internal::PGViewReorderedEdgesSortedByDestID<
+          ShuffleTopology::NodeSortKind::kBreadthFirst>;
 };
 
 class KATANA_EXPORT PGViewCache {
@@ -1128,12 +1238,34 @@ public:
     return internal::PGViewBuilder<PGView>::BuildView(pg, *this);
   }
 
+  /// \returns true if BuildView<PGView> would reuse cached topologies instead
+  /// of copying and sorting the topology of \p pg
+  template <typename PGView>
+  bool IsViewCached(const PropertyGraph* pg) const noexcept {
+    return internal::PGViewBuilder<PGView>::IsCached(pg, *this);
+  }
+
 private:
   const GraphTopology* GetOriginalTopology(
       const PropertyGraph* pg) const noexcept;
 
   CondensedTypeIDMap* BuildOrGetEdgeTypeIndex(const PropertyGraph* pg) noexcept;
 
+  EdgeShuffleTopology* FindEdgeShuffTopo(
+      const PropertyGraph* pg,
+      const EdgeShuffleTopology::TransposeKind& tpose_kind,
+      const EdgeShuffleTopology::EdgeSortKind& sort_kind) const noexcept;
+
+  ShuffleTopology* FindShuffTopo(
+      const PropertyGraph* pg,
+      const EdgeShuffleTopology::TransposeKind& tpose_kind,
+      const ShuffleTopology::NodeSortKind& node_sort_todo,
+      const EdgeShuffleTopology::EdgeSortKind& edge_sort_todo) const noexcept;
+
+  EdgeTypeAwareTopology* FindEdgeTypeAwareTopo(
+      const PropertyGraph* pg,
+      const EdgeShuffleTopology::TransposeKind& tpose_kind) const noexcept;
+
   EdgeShuffleTopology* BuildOrGetEdgeShuffTopo(
       const PropertyGraph* pg,
       const EdgeShuffleTopology::TransposeKind& tpose_kind,
@@ -0,0 +1,153 @@
+#ifndef KATANA_LIBGALOIS_KATANA_LAZYGRAPHTOPOLOGY_H_
+#define KATANA_LIBGALOIS_KATANA_LAZYGRAPHTOPOLOGY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/RDGPrefix.h"
+
+namespace katana {
+
+/// A LazyGraphTopology is a read-only view of the topology of an RDG that,
+/// unlike GraphTopology, does not load the edge destinations up front. Make
+/// only loads the CSR header and out indexes through tsuba::RDGPrefix, so the
+/// time to the first query does not depend on the number of edges, and
+/// edge_dest() faults in the page of a destination the first time it is read.
+///
+/// Faulting in one page at a time is slow, so traversals should pass the nodes
+/// of their next frontier to Prefetch, which fetches all of their neighbor
+/// lists with a few large asynchronous reads. Prefetch and Trim also release
+/// the least recently used pages (by the clock algorithm) to keep the number
+/// of resident pages under a budget. edge_dest may be called in parallel, but
+/// not concurrently with Prefetch or Trim.
+///
+/// Algorithms that scan the whole graph should load a GraphTopology instead.
+class KATANA_EXPORT LazyGraphTopology : public GraphTopologyTypes {
+public:
+  static constexpr uint64_t kDefaultMaxResidentBytes = UINT64_C(1) << 30;
+
+  LazyGraphTopology(const LazyGraphTopology& no_copy) = delete;
+  LazyGraphTopology& operator=(const LazyGraphTopology& no_copy) = delete;
+
+  /// Open the topology of a single partition RDG. Up to max_resident_bytes of
+  /// edge destinations, rounded up to whole pages, stay in memory between
+  /// calls to Prefetch or Trim.
+  static Result<std::unique_ptr<LazyGraphTopology>> Make(
+      const std::string& rdg_name,
+      uint64_t max_resident_bytes = kDefaultMaxResidentBytes);
+
+  uint64_t num_nodes() const noexcept { return prefix_.num_nodes(); }
+
+  uint64_t num_edges() const noexcept { return prefix_.num_edges(); }
+
+  /// Gets the edge range of some node.
+  ///
+  /// \param node node to get the edge range of
+  /// \returns iterable edge range for node.
+  edges_range edges(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < num_nodes());
+    edge_iterator e_beg{node > 0 ? prefix_[node - 1] : 0};
+    edge_iterator e_end{prefix_[node]};
+
+    return MakeStandardRange(e_beg, e_end);
+  }
+
+  /// The destination of an edge, fetching its page from storage if needed.
+  /// Failing to fetch is fatal, like failing to read mapped memory.
+  Node edge_dest(Edge edge_id) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(edge_id < num_edges());
+    std::atomic<uint8_t>& state = pages_[page_index(edge_id)];
+    uint8_t current = state.load(std::memory_order_acquire);
+    if (current == kReady) {
+      state.store(kReferenced, std::memory_order_relaxed);
+    } else if (current != kReferenced) {
+      Fault(page_index(edge_id));
+    }
+    return dests_[edge_id];
+  }
+
+  nodes_range all_nodes() const noexcept {
+    return MakeStandardRange<node_iterator>(
+        Node{0}, static_cast<Node>(num_nodes()));
+  }
+
+  size_t degree(Node node) const noexcept { return edges(node).size(); }
+
+  /// Start fetching the neighbor lists of nodes, first releasing pages that
+  /// they do not need if the budget would be exceeded. Pages needed by nodes
+  /// are fetched even if they do not fit in the budget.
+  Result<void> Prefetch(const std::vector<Node>& nodes);
+
+  /// Release pages until no more than max_resident_pages() remain.
+  Result<void> Trim();
+
+  uint64_t max_resident_pages() const { return max_resident_pages_; }
+
+  /// Pages of edge destinations that are in memory or being fetched
+  uint64_t resident_pages() const { return resident_pages_; }
+
+  /// Number of times edge_dest had to wait for storage
+  uint64_t num_faults() const { return num_faults_; }
+
+  /// Number of pages released to stay under the budget
+  uint64_t num_released_pages() const { return num_released_pages_; }
+
+private:
+  enum PageState : uint8_t {
+    kAbsent = 0,
+    // fetched by Prefetch, but maybe not ready to read
+    kFetching,
+    kReady,
+    // ready and read since the clock hand last passed
+    kReferenced,
+  };
+
+  // Inclusive ranges of page indexes
+  using PageRanges = std::vector<std::pair<uint64_t, uint64_t>>;
+
+  LazyGraphTopology(tsuba::RDGPrefix&& prefix, uint64_t max_resident_pages);
+
+  uint64_t page_index(Edge edge_id) const noexcept {
+    return ((prefix_.view_offset() + edge_id * sizeof(Node)) >> page_shift_) -
+           first_page_;
+  }
+
+  /// The byte range in the topology file of a page
+  std::pair<uint64_t, uint64_t> PageBytes(uint64_t index) const;
+
+  void Fault(uint64_t index) const;
+
+  /// Release pages that are not in keep until at most target remain
+  Result<void> Evict(uint64_t target, const PageRanges& keep);
+
+  mutable tsuba::RDGPrefix prefix_;
+  const Node* dests_{nullptr};
+  uint8_t page_shift_{0};
+  // the page of the first destination
+  uint64_t first_page_{0};
+  uint64_t num_pages_{0};
+  // the first page, when the out indexes share it, is never released
+  bool first_page_shared_{false};
+  uint64_t max_resident_pages_{0};
+  std::unique_ptr<std::atomic<uint8_t>[]> pages_;
+  uint64_t clock_hand_{0};
+
+  // serializes faults, so that a page is only fetched once
+  mutable std::mutex fault_mutex_;
+  mutable std::atomic<uint64_t> resident_pages_{0};
+  mutable std::atomic<uint64_t> num_faults_{0};
+  uint64_t num_released_pages_{0};
+};
+
+}  // namespace katana
+
+#endif
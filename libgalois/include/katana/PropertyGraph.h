@@ -1,6 +1,7 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PROPERTYGRAPH_H_
 #define KATANA_LIBGALOIS_KATANA_PROPERTYGRAPH_H_
 
+#include <type_traits>
 #include <utility>
 
 #include <arrow/api.h>
@@ -9,6 +10,7 @@
 
 #include "katana/ArrowInterchange.h"
 #include "katana/Details.h"
+#include "katana/EntityTypeIDArray.h"
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
 #include "katana/GraphTopology.h"
@@ -54,7 +56,8 @@ public:
   using Node = GraphTopology::Node;
   using Edge = GraphTopology::Edge;
 
-  using EntityTypeIDArray = katana::NUMAArray<EntityTypeID>;
+  using EntityTypeIDArray = katana::EntityTypeIDArray;
+  static_assert(std::is_same_v<GraphTopology::EntityType, EntityTypeID>);
 
 private:
   /// Validate performs a sanity check on the the graph after loading
@@ -74,6 +77,20 @@ private:
   Result<void> WriteView(
       const std::string& uri, const std::string& command_line);
 
+  /// Report the loaded properties to the PropertyMemoryManager. This never
+  /// evicts properties.
+  void SyncNodeProperties();
+  void SyncEdgeProperties();
+
+  /// Unload a property on behalf of the PropertyMemoryManager
+  Result<void> EvictProperty(
+      tsuba::NodeEdge node_edge, const std::string& prop_name);
+
+  /// Bring the loaded properties under the budget of the
+  /// PropertyMemoryManager after prop_name was loaded, without evicting it
+  Result<void> TrimAfterLoad(
+      tsuba::NodeEdge node_edge, const std::string& prop_name);
+
   tsuba::RDG rdg_;
   std::unique_ptr<tsuba::RDGFile> file_;
   GraphTopology topology_;
@@ -93,10 +110,15 @@ private:
       node_indexes_;
   std::vector<std::unique_ptr<PropertyIndex<GraphTopology::Edge>>>
       edge_indexes_;
+  // Properties whose indexes were dropped when they were unloaded; the
+  // indexes are rebuilt when they are loaded again
+  std::vector<std::string> unloaded_node_indexes_;
+  std::vector<std::string> unloaded_edge_indexes_;
 
   PGViewCache pg_view_cache_;
 
   friend class PropertyGraphRetractor;
+  friend class PropertyMemoryManager;
 
 public:
   /// PropertyView provides a uniform interface when you don't need to
@@ -210,12 +232,28 @@ public:
         edge_entity_type_ids_(std::move(edge_entity_type_ids)) {
     KATANA_LOG_DEBUG_ASSERT(node_entity_type_ids_.size() == num_nodes());
     KATANA_LOG_DEBUG_ASSERT(edge_entity_type_ids_.size() == num_edges());
+    SyncNodeProperties();
+    SyncEdgeProperties();
   }
 
+  /// The PropertyMemoryManager keeps track of graphs by address, so moving
+  /// or destroying a graph updates it.
+  PropertyGraph(PropertyGraph&& other) noexcept;
+  PropertyGraph& operator=(PropertyGraph&& other) noexcept;
+  ~PropertyGraph();
+
   template <typename PGView>
   PGView BuildView() noexcept {
     return pg_view_cache_.BuildView<PGView>(this);
   }
+
+  /// \returns true if BuildView<PGView>() would be served from the view cache
+  /// without copying or sorting the topology
+  template <typename PGView>
+  bool IsViewCached() const noexcept {
+    return pg_view_cache_.IsViewCached<PGView>(this);
+  }
+
   /// Make a property graph from a constructed RDG. Take ownership of the RDG
   /// and its underlying resources.
   static Result<std::unique_ptr<PropertyGraph>> Make(
@@ -232,8 +270,9 @@ public:
 
   /// Make a property graph from topology and type arrays
   static Result<std::unique_ptr<PropertyGraph>> Make(
-      GraphTopology&& topo_to_assign, EntityTypeIDArray&& node_entity_type_ids,
-      EntityTypeIDArray&& edge_entity_type_ids,
+      GraphTopology&& topo_to_assign,
+      NUMAArray<EntityTypeID>&& node_entity_type_ids,
+      NUMAArray<EntityTypeID>&& edge_entity_type_ids,
       EntityTypeManager&& node_type_manager,
       EntityTypeManager&& edge_type_manager);
 
@@ -252,6 +291,8 @@ public:
   /// Construct node & edge EntityTypeIDs from node & edge properties
   /// Also constructs metadata to convert between atomic types and EntityTypeIDs
   /// Assumes all boolean or uint8 properties are atomic types
+  /// The constructed EntityTypeIDs are stored by the next Commit or Write, so
+  /// that Make loads them instead of constructing them again
   /// TODO(roshan) move this to be a part of Make()
   Result<void> ConstructEntityTypeIDs();
 
@@ -263,19 +304,14 @@ public:
     return edge_entity_type_ids_.size();
   }
 
-  /// This is an unfortunate hack. Due to some technical debt, we need a way to
-  /// modify these arrays in place from outside this class. This style mirrors a
-  /// similar hack in GraphTopology and hopefully makes it clear that these
-  /// functions should not be used lightly.
-  const EntityTypeID* node_type_data() const noexcept {
-    return node_entity_type_ids_.data();
+  /// The EntityTypeID of each node, which may be stored with one byte per node
+  const EntityTypeIDArray& node_entity_type_ids() const noexcept {
+    return node_entity_type_ids_;
   }
-  /// This is an unfortunate hack. Due to some technical debt, we need a way to
-  /// modify these arrays in place from outside this class. This style mirrors a
-  /// similar hack in GraphTopology and hopefully makes it clear that these
-  /// functions should not be used lightly.
-  const EntityTypeID* edge_type_data() const noexcept {
-    return edge_entity_type_ids_.data();
+
+  /// The EntityTypeID of each edge, which may be stored with one byte per edge
+  const EntityTypeIDArray& edge_entity_type_ids() const noexcept {
+    return edge_entity_type_ids_;
   }
 
   const EntityTypeManager& GetNodeTypeManager() const {
@@ -303,6 +339,16 @@ public:
   Result<void> Commit(const std::string& command_line);
   Result<void> WriteView(const std::string& command_line);
 
+  /// Options, like compression and encodings, for the files that Write,
+  /// Commit and unloading a property store properties in. Settings for a
+  /// single property are kept apart for node and edge properties.
+  const tsuba::RDGWriteOptions& property_write_opts() const {
+    return rdg_.write_opts();
+  }
+  void set_property_write_opts(tsuba::RDGWriteOptions opts) {
+    rdg_.set_write_opts(std::move(opts));
+  }
+
   /// Determine if two PropertyGraphs are Equal
   /// THIS IS A TESTING ONLY FUNCTION, DO NOT EXPOSE THIS TO THE USER
   /// when comparing PG in Equals we directly compare all tables in properties
@@ -632,19 +678,25 @@ public:
   Result<void> RemoveEdgeProperty(const std::string& prop_name);
 
   /// Write a node property column out to storage and de-allocate the memory
-  /// it was using
+  /// it was using. An index over the property is dropped with it and
+  /// rebuilt when the property is loaded again.
   Result<void> UnloadNodeProperty(const std::string& prop_name);
 
   /// Write an edge property column out to storage and de-allocate the
-  /// memory it was using
+  /// memory it was using. An index over the property is dropped with it and
+  /// rebuilt when the property is loaded again.
   Result<void> UnloadEdgeProperty(const std::string& prop_name);
 
   /// Load a node property by name put it in the table at index i
-  /// if i is not a valid index, append the column to the end of the table
+  /// if i is not a valid index, append the column to the end of the table.
+  /// Loading may evict other unpinned properties to stay under the budget
+  /// of the PropertyMemoryManager.
   Result<void> LoadNodeProperty(const std::string& name, int i = -1);
 
   /// Load an edge property by name put it in the table at index i
-  /// if i is not a valid index, append the column to the end of the table
+  /// if i is not a valid index, append the column to the end of the table.
+  /// Loading may evict other unpinned properties to stay under the budget
+  /// of the PropertyMemoryManager.
   Result<void> LoadEdgeProperty(const std::string& name, int i = -1);
 
   /// Load a node property by name if it is absent and append its column to
@@ -655,13 +707,23 @@ public:
   /// the table do nothing otherwise
   Result<void> EnsureEdgePropertyLoaded(const std::string& name);
 
+  /// Load a node property if it is absent and keep the PropertyMemoryManager
+  /// from evicting it until a matching UnpinNodeProperty. Pins nest.
+  Result<void> PinNodeProperty(const std::string& name);
+  Result<void> UnpinNodeProperty(const std::string& name);
+
+  /// Load an edge property if it is absent and keep the PropertyMemoryManager
+  /// from evicting it until a matching UnpinEdgeProperty. Pins nest.
+  Result<void> PinEdgeProperty(const std::string& name);
+  Result<void> UnpinEdgeProperty(const std::string& name);
+
   std::vector<std::string> ListNodeProperties() const;
   std::vector<std::string> ListEdgeProperties() const;
 
   /// Remove all node properties
-  void DropNodeProperties() { rdg_.DropNodeProperties(); }
+  void DropNodeProperties();
   /// Remove all edge properties
-  void DropEdgeProperties() { rdg_.DropEdgeProperties(); }
+  void DropEdgeProperties();
 
   MutablePropertyView NodeMutablePropertyView() {
     return MutablePropertyView{
@@ -840,6 +902,23 @@ CreateSymmetricGraph(PropertyGraph* pg);
 KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>>
 CreateTransposeGraphTopology(const GraphTopology& topology);
 
+/// Find the nodes that have any of the entity types \p node_entity_type_ids,
+/// i.e., the nodes for which DoesNodeHaveType holds for one of them.
+///
+/// \p nodes is resized to the number of nodes and the bit of each node found
+/// is set, in one parallel pass over the nodes. A selection vector of the
+/// nodes found is nodes->GetOffsets<GraphTopology::Node>().
+KATANA_EXPORT Result<void> FindNodesWithEntityTypes(
+    const PropertyGraph* pg, const SetOfEntityTypeIDs& node_entity_type_ids,
+    DynamicBitset* nodes);
+
+/// Find the edges that have any of the entity types \p edge_entity_type_ids.
+///
+/// \see FindNodesWithEntityTypes
+KATANA_EXPORT Result<void> FindEdgesWithEntityTypes(
+    const PropertyGraph* pg, const SetOfEntityTypeIDs& edge_entity_type_ids,
+    DynamicBitset* edges);
+
 }  // namespace katana
 
 #endif
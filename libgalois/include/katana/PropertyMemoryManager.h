@@ -0,0 +1,143 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PROPERTYMEMORYMANAGER_H_
+#define KATANA_LIBGALOIS_KATANA_PROPERTYMEMORYMANAGER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <arrow/api.h>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/PropertyCache.h"
+
+namespace katana {
+
+class PropertyGraph;
+
+/// PropertyMemoryManager tracks the memory used by the loaded properties of
+/// every PropertyGraph in the process and, when a budget is set, Trim brings
+/// it under the budget by unloading the least recently used properties back
+/// to their RDGs with PropertyGraph::UnloadNodeProperty and
+/// UnloadEdgeProperty, which also drop the indexes over them.
+/// PropertyGraph::EnsureNodePropertyLoaded and EnsureEdgePropertyLoaded load
+/// evicted properties again and rebuild their indexes.
+///
+/// Property views and TypedPropertyGraph point into the columns of loaded
+/// properties, so properties are only evicted at safe points: by
+/// PropertyGraph::LoadNodeProperty and LoadEdgeProperty, and the Ensure and
+/// Pin calls that load through them, which trim after loading and never
+/// evict the property just loaded, and by explicit calls to Trim. Adding
+/// properties or unpinning them never evicts. Analytics do not load
+/// properties, so they are not interrupted by eviction unless another
+/// thread loads properties meanwhile; callers that keep a view across a
+/// load should pin its properties first. Pinned properties, with
+/// PropertyGraph::PinNodeProperty or PinEdgeProperty, are never evicted.
+/// Properties of graphs without an RDG directory cannot be written out and
+/// are never evicted either.
+///
+/// The budget comes from the environment variable
+/// KATANA_PROPERTY_MEMORY_BUDGET_MB; without it, memory is tracked but never
+/// reclaimed. Like PropertyGraph itself, paging is not thread safe.
+class KATANA_EXPORT PropertyMemoryManager {
+public:
+  PropertyMemoryManager(const PropertyMemoryManager& no_copy) = delete;
+  PropertyMemoryManager& operator=(const PropertyMemoryManager& no_copy) =
+      delete;
+
+  /// The manager shared by every PropertyGraph in the process.
+  static PropertyMemoryManager& Get();
+
+  /// The budget in bytes, or 0 if there is none.
+  uint64_t budget() const { return budget_; }
+
+  /// Set the budget in bytes that Trim keeps to. A budget of 0 disables
+  /// eviction.
+  void set_budget(uint64_t budget) { budget_ = budget; }
+
+  /// Unload least recently used properties of all graphs until the loaded
+  /// properties fit the budget. This is a safe point: the caller must make
+  /// sure that no property view or TypedPropertyGraph into an unpinned
+  /// property of any graph is live, e.g., by calling it between analytics.
+  /// Loading a property calls it.
+  void Trim();
+
+  /// Approximate bytes used by the loaded properties of all graphs.
+  uint64_t used() const;
+
+  /// Approximate bytes used by the pinned properties of all graphs.
+  uint64_t pinned() const;
+
+  /// Number of properties unloaded to stay under the budget.
+  uint64_t num_evictions() const;
+
+private:
+  friend class PropertyGraph;
+
+  struct Key {
+    PropertyGraph* graph;
+    tsuba::NodeEdge node_edge;
+    std::string name;
+
+    bool operator==(const Key& o) const {
+      return graph == o.graph && node_edge == o.node_edge && name == o.name;
+    }
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key& k) const;
+  };
+
+  struct Entry {
+    // identifies the column, so that replacing it is noticed
+    std::weak_ptr<arrow::ChunkedArray> column;
+    uint64_t bytes{0};
+    uint32_t pins{0};
+    // false after unloading failed
+    bool evictable{true};
+    // position in lru_, the most recently used at the front
+    std::list<Key>::iterator lru_pos;
+  };
+
+  PropertyMemoryManager();
+
+  /// Bring the entries of graph for node_edge up to date with the columns of
+  /// table.
+  void Sync(
+      PropertyGraph* graph, tsuba::NodeEdge node_edge,
+      const std::shared_ptr<arrow::Table>& table);
+
+  /// Record a use of a property.
+  void Touch(
+      const PropertyGraph* graph, tsuba::NodeEdge node_edge,
+      const std::string& name);
+
+  Result<void> Pin(
+      PropertyGraph* graph, tsuba::NodeEdge node_edge, const std::string& name);
+  Result<void> Unpin(
+      PropertyGraph* graph, tsuba::NodeEdge node_edge, const std::string& name);
+
+  /// Drop the entries of a graph being destroyed.
+  void Forget(PropertyGraph* graph);
+
+  /// Move the entries of a graph to its new address.
+  void Move(PropertyGraph* from, PropertyGraph* to);
+
+  void Remove(std::unordered_map<Key, Entry, KeyHash>::iterator it);
+
+  mutable std::mutex mutex_;
+  std::atomic<uint64_t> budget_{0};
+  uint64_t used_{0};
+  uint64_t pinned_{0};
+  uint64_t num_evictions_{0};
+  std::unordered_map<Key, Entry, KeyHash> entries_;
+  std::list<Key> lru_;
+};
+
+}  // namespace katana
+
+#endif
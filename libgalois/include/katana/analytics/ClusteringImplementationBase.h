@@ -20,13 +20,16 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <random>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/Galois.h"
 #include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -60,6 +63,12 @@ struct ClusteringImplementationBase {
 
   using CommunityArray = katana::NUMAArray<CommunityType>;
 
+  /// An edge to a (sub)community with its weight.
+  struct WeightedNeighbor {
+    uint64_t id;
+    EdgeTy weight;
+  };
+
   /**
    * Algorithm to find the best cluster for the node
    * to move to among its neighbors in the graph and moves.
@@ -399,27 +408,249 @@ struct ClusteringImplementationBase {
   /**
  * Renumbers the cluster to contiguous cluster ids
  * to fill the holes in the cluster id assignments.
+ * Cluster ids keep their relative order.
  */
+  template <typename CommunityIDProperty = CurrentCommunityID>
   uint64_t RenumberClustersContiguously(Graph* graph) {
-    std::map<uint64_t, uint64_t> cluster_local_map;
-    uint64_t num_unique_clusters = 0;
-
-    for (GNode n = 0; n < graph->num_nodes(); ++n) {
-      auto& n_data_curr_comm_id =
-          graph->template GetData<CurrentCommunityID>(n);
-      if (n_data_curr_comm_id != UNASSIGNED) {
-        KATANA_LOG_DEBUG_ASSERT(n_data_curr_comm_id < graph->num_nodes());
-        auto stored_already = cluster_local_map.find(n_data_curr_comm_id);
-        if (stored_already != cluster_local_map.end()) {
-          n_data_curr_comm_id = stored_already->second;
-        } else {
-          cluster_local_map[n_data_curr_comm_id] = num_unique_clusters;
-          n_data_curr_comm_id = num_unique_clusters;
-          num_unique_clusters++;
-        }
-      }
+    const uint64_t num_nodes = graph->num_nodes();
+    if (num_nodes == 0) {
+      return 0;
     }
-    return num_unique_clusters;
+
+    katana::NUMAArray<uint64_t> new_ids;
+    new_ids.allocateInterleaved(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t c) { new_ids[c] = 0; }, katana::no_stats());
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](GNode n) {
+          auto n_data_comm_id = graph->template GetData<CommunityIDProperty>(n);
+          if (n_data_comm_id != UNASSIGNED) {
+            KATANA_LOG_DEBUG_ASSERT(n_data_comm_id < num_nodes);
+            new_ids[n_data_comm_id] = 1;
+          }
+        },
+        katana::no_stats());
+
+    katana::ParallelSTL::partial_sum(
+        new_ids.begin(), new_ids.end(), new_ids.begin());
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](GNode n) {
+          auto& n_data_comm_id =
+              graph->template GetData<CommunityIDProperty>(n);
+          if (n_data_comm_id != UNASSIGNED) {
+            n_data_comm_id = new_ids[n_data_comm_id] - 1;
+          }
+        },
+        katana::loopname("RenumberClusters"), katana::no_stats());
+
+    return new_ids[num_nodes - 1];
+  }
+
+  /**
+ * Counting sort of the nodes by community: the members of community c are
+ * members[offsets[c]] to members[offsets[c + 1] - 1]. Nodes without a
+ * community are left out.
+ */
+  template <typename CommunityIDProperty>
+  static void GroupNodesByCommunity(
+      const Graph& graph, katana::NUMAArray<uint64_t>* offsets,
+      katana::NUMAArray<GNode>* members) {
+    const uint64_t num_nodes = graph.num_nodes();
+
+    katana::NUMAArray<std::atomic<uint64_t>> cursor;
+    cursor.allocateInterleaved(num_nodes);
+    offsets->allocateInterleaved(num_nodes + 1);
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t c) { cursor[c].store(0, std::memory_order_relaxed); },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto c = graph.template GetData<CommunityIDProperty>(n);
+          if (c != UNASSIGNED) {
+            cursor[c].fetch_add(1, std::memory_order_relaxed);
+          }
+        },
+        katana::no_stats());
+
+    (*offsets)[0] = 0;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t c) { (*offsets)[c + 1] = cursor[c].load(); },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        offsets->begin(), offsets->end(), offsets->begin());
+
+    members->allocateInterleaved((*offsets)[num_nodes]);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t c) { cursor[c].store((*offsets)[c]); },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto c = graph.template GetData<CommunityIDProperty>(n);
+          if (c != UNASSIGNED) {
+            (*members)[cursor[c].fetch_add(1, std::memory_order_relaxed)] = n;
+          }
+        },
+        katana::no_stats());
+  }
+
+  /**
+ * Whether a (sub)community with the given degree weight has at least as
+ * much edge weight to the rest of its community as expected in a random
+ * graph with the same degrees.
+ */
+  static bool IsWellConnected(
+      double external_wt, double degree_wt, double community_degree_wt,
+      double constant_for_second_term) {
+    return external_wt >=
+           degree_wt * (community_degree_wt - degree_wt) *
+               constant_for_second_term;
+  }
+
+  /**
+ * Refinement phase of the Leiden algorithm:
+ *
+ *   V. A. Traag, L. Waltman and N. J. van Eck. From Louvain to Leiden:
+ *   guaranteeing well-connected communities. Scientific Reports 9, 2019.
+ *
+ * Splits every community (CurrentCommunityID) into subcommunities, whose
+ * ids are written to RefinedCommunityID. Each node starts in its own
+ * subcommunity. Visiting the nodes of a community in order, a node that is
+ * still alone and well connected to its community joins the neighboring
+ * subcommunity with the largest modularity gain, if that one is well
+ * connected too. A node only joins a subcommunity it has an edge to and a
+ * subcommunity that has been joined never moves, so every subcommunity is
+ * connected. Communities are refined in parallel.
+ */
+  template <typename EdgeWeightType, typename RefinedCommunityID>
+  void RefineCommunities(Graph* graph, double constant_for_second_term) {
+    const uint64_t num_nodes = graph->num_nodes();
+
+    katana::NUMAArray<uint64_t> offsets;
+    katana::NUMAArray<GNode> members;
+    GroupNodesByCommunity<CurrentCommunityID>(*graph, &offsets, &members);
+
+    // Indexed by subcommunity id, which is the id of its first node
+    katana::NUMAArray<EdgeTy> sub_degree_wt;
+    katana::NUMAArray<EdgeTy> sub_external_wt;
+    katana::NUMAArray<uint64_t> sub_size;
+    sub_degree_wt.allocateInterleaved(num_nodes);
+    sub_external_wt.allocateInterleaved(num_nodes);
+    sub_size.allocateInterleaved(num_nodes);
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t c) {
+          auto begin = members.begin() + offsets[c];
+          auto end = members.begin() + offsets[c + 1];
+          if (begin == end) {
+            return;
+          }
+          // Visit nodes in id order so that the result does not depend on
+          // the schedule
+          std::sort(begin, end);
+
+          auto same_community = [&](GNode u) {
+            return graph->template GetData<CurrentCommunityID>(u) == c;
+          };
+
+          EdgeTy community_degree_wt = 0;
+          for (auto it = begin; it != end; ++it) {
+            GNode v = *it;
+            EdgeTy external_wt = 0;
+            for (auto ii = graph->edge_begin(v); ii != graph->edge_end(v);
+                 ++ii) {
+              auto u = *graph->GetEdgeDest(ii);
+              if (u != v && same_community(u)) {
+                external_wt +=
+                    graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(
+                        ii);
+              }
+            }
+            graph->template GetData<RefinedCommunityID>(v) = v;
+            sub_degree_wt[v] =
+                graph->template GetData<DegreeWeight<EdgeWeightType>>(v);
+            sub_external_wt[v] = external_wt;
+            sub_size[v] = 1;
+            community_degree_wt += sub_degree_wt[v];
+          }
+
+          std::vector<WeightedNeighbor>& neighbors =
+              *neighbor_scratch_.getLocal();
+          for (auto it = begin; it != end; ++it) {
+            GNode v = *it;
+            auto& v_sub = graph->template GetData<RefinedCommunityID>(v);
+            if (sub_size[v_sub] != 1 ||
+                !IsWellConnected(
+                    sub_external_wt[v_sub], sub_degree_wt[v_sub],
+                    community_degree_wt, constant_for_second_term)) {
+              continue;
+            }
+
+            neighbors.clear();
+            for (auto ii = graph->edge_begin(v); ii != graph->edge_end(v);
+                 ++ii) {
+              auto u = *graph->GetEdgeDest(ii);
+              if (u != v && same_community(u)) {
+                neighbors.push_back(WeightedNeighbor{
+                    graph->template GetData<RefinedCommunityID>(u),
+                    graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(
+                        ii)});
+              }
+            }
+            std::sort(
+                neighbors.begin(), neighbors.end(),
+                [](const WeightedNeighbor& a, const WeightedNeighbor& b) {
+                  return a.id < b.id;
+                });
+
+            // Modularity gain of joining a subcommunity, up to a positive
+            // factor; ties go to the smallest subcommunity id.
+            uint64_t best = v_sub;
+            double best_gain = 0;
+            EdgeTy best_wt = 0;
+            for (size_t i = 0; i < neighbors.size();) {
+              uint64_t sub = neighbors[i].id;
+              EdgeTy wt = 0;
+              for (; i < neighbors.size() && neighbors[i].id == sub; ++i) {
+                wt += neighbors[i].weight;
+              }
+              if (!IsWellConnected(
+                      sub_external_wt[sub], sub_degree_wt[sub],
+                      community_degree_wt, constant_for_second_term)) {
+                continue;
+              }
+              double gain = wt - (double)sub_degree_wt[v_sub] *
+                                     (double)sub_degree_wt[sub] *
+                                     constant_for_second_term;
+              if (gain > best_gain) {
+                best_gain = gain;
+                best = sub;
+                best_wt = wt;
+              }
+            }
+
+            if (best != v_sub) {
+              sub_size[best] += 1;
+              sub_degree_wt[best] += sub_degree_wt[v_sub];
+              sub_external_wt[best] =
+                  sub_external_wt[best] + sub_external_wt[v_sub] - 2 * best_wt;
+              sub_size[v_sub] = 0;
+              v_sub = best;
+            }
+          }
+        },
+        katana::steal(), katana::loopname("Leiden: Refinement"));
   }
 
   template <typename EdgeWeightType>
@@ -493,13 +724,21 @@ struct ClusteringImplementationBase {
   /**
  * Creates a coarsened hierarchical graph for the next phase
  * of the clustering algorithm. It merges all the nodes within a
- * same cluster to form a super node for the coursened graphs.
+ * same cluster (given by CommunityIDProperty) to form a super node for the
+ * coursened graphs.
  * The total number of nodes in the coarsened graph are equal to
  * the number of unique clusters in the previous level of the graph.
  * All the edges inside a cluster are merged (edge weights are summed
  * up) to form the edges within super nodes.
+ *
+ * The edges of each node are scattered to a range of its cluster, bounded
+ * by prefix sums of the degrees over clusters, then sorted and merged in
+ * place and compacted into the CSR of the coarsened graph. The scratch
+ * space is kept across levels.
  */
-  template <typename NodeData, typename EdgeData, typename EdgeWeightType>
+  template <
+      typename NodeData, typename EdgeData, typename EdgeWeightType,
+      typename CommunityIDProperty = CurrentCommunityID>
   katana::Result<std::unique_ptr<katana::PropertyGraph>> GraphCoarsening(
       const Graph& graph, katana::PropertyGraph* pfg_mutable,
       uint64_t num_unique_clusters,
@@ -512,73 +751,111 @@ struct ClusteringImplementationBase {
 
     const uint64_t num_nodes_next = num_unique_clusters;
 
-    std::vector<std::vector<GNode>> cluster_bags(num_unique_clusters);
-    // TODO(amber): This loop can be parallelized when using a concurrent container
-    // for cluster_bags, but something like katana::InsertBag exhausts the
-    // per-thread-storage memory
-    for (GNode n = 0; n < graph.num_nodes(); ++n) {
-      auto n_data_curr_comm_id = graph.template GetData<CurrentCommunityID>(n);
-      if (n_data_curr_comm_id != UNASSIGNED) {
-        cluster_bags[n_data_curr_comm_id].push_back(n);
-      }
-    }
+    /* Bound the number of edges of each cluster by the degrees of its nodes */
+    katana::NUMAArray<std::atomic<uint64_t>> cluster_cursor;
+    cluster_cursor.allocateInterleaved(num_nodes_next);
+    katana::NUMAArray<uint64_t> cluster_bound;
+    cluster_bound.allocateInterleaved(num_nodes_next);
 
-    std::vector<katana::gstl::Vector<uint32_t>> edges_id(num_unique_clusters);
-    std::vector<katana::gstl::Vector<EdgeTy>> edges_data(num_unique_clusters);
-
-    /* First pass to find the number of edges */
     katana::do_all(
-        katana::iterate(uint64_t{0}, num_unique_clusters),
+        katana::iterate(uint64_t{0}, num_nodes_next),
         [&](uint64_t c) {
-          katana::gstl::Map<uint64_t, uint64_t> cluster_local_map;
-          uint64_t num_unique_clusters = 0;
-          for (auto node : cluster_bags[c]) {
-            KATANA_LOG_DEBUG_ASSERT(
-                graph.template GetData<CurrentCommunityID>(node) ==
-                c);  // All nodes in this bag must have same cluster id
-
-            for (auto ii = graph.edge_begin(node); ii != graph.edge_end(node);
-                 ++ii) {
-              auto dst = graph.GetEdgeDest(ii);
-              auto dst_data_curr_comm_id =
-                  graph.template GetData<CurrentCommunityID>(dst);
-              KATANA_LOG_DEBUG_ASSERT(dst_data_curr_comm_id != UNASSIGNED);
-              auto stored_already = cluster_local_map.find(
-                  dst_data_curr_comm_id);  // Check if it already exists
-              if (stored_already != cluster_local_map.end()) {
-                edges_data[c][stored_already->second] +=
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
-              } else {
-                cluster_local_map[dst_data_curr_comm_id] = num_unique_clusters;
-                edges_id[c].push_back(dst_data_curr_comm_id);
-                edges_data[c].push_back(
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii));
-                num_unique_clusters++;
-              }
-            }  // End edge loop
+          cluster_cursor[c].store(0, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto n_data_comm_id = graph.template GetData<CommunityIDProperty>(n);
+          if (n_data_comm_id != UNASSIGNED) {
+            cluster_cursor[n_data_comm_id].fetch_add(
+                std::distance(graph.edge_begin(n), graph.edge_end(n)),
+                std::memory_order_relaxed);
           }
         },
-        katana::steal(), katana::loopname("BuildGraph: Find edges"));
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_next),
+        [&](uint64_t c) { cluster_bound[c] = cluster_cursor[c].load(); },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        cluster_bound.begin(), cluster_bound.end(), cluster_bound.begin());
 
-    /* Serial loop to reduce all the edge counts */
-    katana::NUMAArray<uint64_t> prefix_edges_count;
-    prefix_edges_count.allocateInterleaved(num_unique_clusters);
+    auto cluster_begin = [&](uint64_t c) -> uint64_t {
+      return (c == 0) ? 0 : cluster_bound[c - 1];
+    };
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_next),
+        [&](uint64_t c) { cluster_cursor[c].store(cluster_begin(c)); },
+        katana::no_stats());
 
-    katana::GAccumulator<uint64_t> num_edges_acc;
+    const uint64_t num_scattered =
+        (num_nodes_next == 0) ? 0 : cluster_bound[num_nodes_next - 1];
+    if (coarsening_scratch_.size() < num_scattered) {
+      coarsening_scratch_.deallocate();
+      coarsening_scratch_.allocateInterleaved(num_scattered);
+    }
+
+    /* Scatter the edges of each node to its cluster */
     katana::do_all(
-        katana::iterate(uint64_t{0}, num_nodes_next), [&](uint64_t c) {
-          prefix_edges_count[c] = edges_id[c].size();
-          num_edges_acc += prefix_edges_count[c];
-        });
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto n_data_comm_id = graph.template GetData<CommunityIDProperty>(n);
+          if (n_data_comm_id == UNASSIGNED) {
+            return;
+          }
+          uint64_t pos = cluster_cursor[n_data_comm_id].fetch_add(
+              std::distance(graph.edge_begin(n), graph.edge_end(n)),
+              std::memory_order_relaxed);
+          for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
+            auto dst_data_comm_id = graph.template GetData<CommunityIDProperty>(
+                graph.GetEdgeDest(ii));
+            KATANA_LOG_DEBUG_ASSERT(dst_data_comm_id != UNASSIGNED);
+            coarsening_scratch_[pos++] = WeightedNeighbor{
+                dst_data_comm_id,
+                graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii)};
+          }
+        },
+        katana::steal(), katana::loopname("BuildGraph: Scatter edges"));
 
-    const uint64_t num_edges_next = num_edges_acc.reduce();
+    /* Merge the edges of each cluster to the same destination cluster */
+    katana::NUMAArray<uint64_t> prefix_edges_count;
+    prefix_edges_count.allocateInterleaved(num_nodes_next);
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_next),
+        [&](uint64_t c) {
+          auto begin = coarsening_scratch_.begin() + cluster_begin(c);
+          auto end = coarsening_scratch_.begin() + cluster_bound[c];
+          std::sort(
+              begin, end,
+              [](const WeightedNeighbor& a, const WeightedNeighbor& b) {
+                return a.id < b.id;
+              });
+
+          if (begin == end) {
+            prefix_edges_count[c] = 0;
+            return;
+          }
+          auto last = begin;
+          for (auto it = begin + 1; it != end; ++it) {
+            if (it->id == last->id) {
+              last->weight += it->weight;
+            } else {
+              *++last = *it;
+            }
+          }
+          prefix_edges_count[c] = last - begin + 1;
+        },
+        katana::steal(), katana::loopname("BuildGraph: Merge edges"));
 
     katana::ParallelSTL::partial_sum(
         prefix_edges_count.begin(), prefix_edges_count.end(),
         prefix_edges_count.begin());
 
-    KATANA_LOG_DEBUG_ASSERT(
-        prefix_edges_count[num_unique_clusters - 1] == num_edges_next);
+    const uint64_t num_edges_next =
+        (num_nodes_next == 0) ? 0 : prefix_edges_count[num_nodes_next - 1];
+
     katana::StatTimer TimerConstructFrom("Timer_Construct_From");
     TimerConstructFrom.start();
 
@@ -614,23 +891,15 @@ struct ClusteringImplementationBase {
                        : (prefix_edges_count[n] - prefix_edges_count[n - 1]);
           uint64_t start_index = (n == 0) ? 0 : prefix_edges_count[n - 1];
           for (uint64_t k = 0; k < number_of_edges; ++k) {
-            out_dests_next[start_index + k] = edges_id[n][k];
-            edge_data_next[start_index + k] = edges_data[n][k];
+            const WeightedNeighbor& edge =
+                coarsening_scratch_[cluster_begin(n) + k];
+            out_dests_next[start_index + k] = edge.id;
+            edge_data_next[start_index + k] = edge.weight;
           }
         });
 
     TimerConstructFrom.stop();
 
-    // TODO(amber): This is a lame attempt at freeing the memory back to each
-    // thread's pool of free pages and blocks. Due to stealing, the execution of
-    // do_all above that populates these containers may be different from the
-    // do_all below that frees them.
-    katana::do_all(
-        katana::iterate(uint64_t{0}, num_unique_clusters), [&](uint64_t c) {
-          edges_id[c] = gstl::Vector<uint32_t>();
-          edges_data[c] = gstl::Vector<EdgeTy>();
-        });
-
     GraphTopology topo_next{
         std::move(prefix_edges_count), std::move(out_dests_next)};
     auto pfg_next_res = katana::PropertyGraph::Make(std::move(topo_next));
@@ -670,6 +939,12 @@ struct ClusteringImplementationBase {
     TimerGraphBuild.stop();
     return std::unique_ptr<katana::PropertyGraph>(std::move(pfg_next));
   }
+
+private:
+  // Scratch space of GraphCoarsening and RefineCommunities, reused across
+  // levels
+  katana::NUMAArray<WeightedNeighbor> coarsening_scratch_;
+  katana::PerThreadStorage<std::vector<WeightedNeighbor>> neighbor_scratch_;
 };
 }  // namespace katana::analytics
 #endif  // CLUSTERING_H
@@ -0,0 +1,407 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_INTERSECTION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_INTERSECTION_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+/// \file Intersection.h
+///
+/// Kernels for intersecting sorted adjacency lists. These are shared by the
+/// triangle based analytics (triangle count, local clustering coefficient,
+/// k-truss).
+///
+/// All kernels assume their inputs are sorted in ascending order and contain
+/// no duplicates, which is the case for the adjacency lists of a cleaned graph
+/// with edges sorted by destination.
+
+namespace katana::analytics {
+
+/// If one list is more than this many times longer than the other, switch
+/// from a merge to galloping (exponential) search of the longer list.
+constexpr static const size_t kGallopingRatio = 32;
+
+/// Lists shorter than this do not benefit from the vectorized merge.
+constexpr static const size_t kSimdMinLength = 16;
+
+/// A contiguous run of sorted neighbor ids.
+template <typename T>
+struct SortedSpan {
+  const T* data{nullptr};
+  size_t size{0};
+
+  const T* begin() const { return data; }
+  const T* end() const { return data + size; }
+  bool empty() const { return size == 0; }
+  const T& operator[](size_t i) const { return data[i]; }
+
+  /// \returns the prefix of this span containing elements < bound
+  SortedSpan LessThan(T bound) const {
+    const T* last = std::lower_bound(begin(), end(), bound);
+    return {data, static_cast<size_t>(last - data)};
+  }
+
+  /// \returns the prefix of this span containing elements <= bound
+  SortedSpan LessThanOrEqual(T bound) const {
+    const T* last = std::upper_bound(begin(), end(), bound);
+    return {data, static_cast<size_t>(last - data)};
+  }
+
+  /// \returns the suffix of this span containing elements > bound
+  SortedSpan GreaterThan(T bound) const {
+    const T* first = std::upper_bound(begin(), end(), bound);
+    return {first, static_cast<size_t>(end() - first)};
+  }
+};
+
+/// \returns the destinations of node n in a topology (or view) whose edges
+/// are sorted by destination id.
+template <typename Graph>
+SortedSpan<typename Graph::Node>
+SortedNeighbors(const Graph& g, typename Graph::Node n) {
+  auto edges = g.edges(n);
+  auto first = *edges.begin();
+  auto last = *edges.end();
+  return {g.dest_data() + first, static_cast<size_t>(last - first)};
+}
+
+/// Scalar merge based intersection count.
+template <typename T>
+size_t
+IntersectCountMerge(const T* a, size_t a_len, const T* b, size_t b_len) {
+  size_t count = 0;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a_len && j < b_len) {
+    T x = a[i];
+    T y = b[j];
+    // Branch-free advance: both move forward on a match.
+    i += (x <= y);
+    j += (y <= x);
+    count += (x == y);
+  }
+  return count;
+}
+
+/// Index of the first element in [first, len) of list that is >= key, found
+/// by doubling the step size and then binary searching the last step.
+template <typename T>
+size_t
+GallopLowerBound(const T* list, size_t first, size_t len, T key) {
+  if (first >= len || list[first] >= key) {
+    return first;
+  }
+  size_t step = 1;
+  size_t lo = first;
+  size_t hi = first + step;
+  while (hi < len && list[hi] < key) {
+    lo = hi;
+    step <<= 1;
+    hi = first + step;
+  }
+  hi = std::min(hi, len);
+  return std::lower_bound(list + lo + 1, list + hi, key) - list;
+}
+
+/// Intersection count for lists with very different lengths. Cost is
+/// O(|small| log(|large| / |small|)).
+template <typename T>
+size_t
+IntersectCountGalloping(
+    const T* small, size_t small_len, const T* large, size_t large_len) {
+  size_t count = 0;
+  size_t j = 0;
+  for (size_t i = 0; i < small_len && j < large_len; ++i) {
+    j = GallopLowerBound(large, j, large_len, small[i]);
+    if (j < large_len && large[j] == small[i]) {
+      ++count;
+      ++j;
+    }
+  }
+  return count;
+}
+
+namespace internal {
+
+#if defined(__AVX512F__)
+/// Vectorized merge of 16 element blocks: each block of a is compared against
+/// all 16 rotations of the current block of b.
+inline size_t
+IntersectCountAvx512(
+    const uint32_t* a, size_t a_len, const uint32_t* b, size_t b_len,
+    size_t* i_out, size_t* j_out) {
+  constexpr size_t kWidth = 16;
+  const __m512i kOne = _mm512_set1_epi32(1);
+  const __m512i kMask = _mm512_set1_epi32(kWidth - 1);
+  const __m512i kIdentity = _mm512_setr_epi32(
+      0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+  size_t count = 0;
+  size_t i = 0;
+  size_t j = 0;
+  while (i + kWidth <= a_len && j + kWidth <= b_len) {
+    __m512i va = _mm512_loadu_si512(reinterpret_cast<const void*>(a + i));
+    __m512i vb = _mm512_loadu_si512(reinterpret_cast<const void*>(b + j));
+
+    __mmask16 matches = _mm512_cmpeq_epi32_mask(va, vb);
+    __m512i rot = kIdentity;
+    for (size_t r = 1; r < kWidth; ++r) {
+      rot = _mm512_and_si512(_mm512_add_epi32(rot, kOne), kMask);
+      matches |= _mm512_cmpeq_epi32_mask(
+          va, _mm512_maskz_permutexvar_epi32(0xFFFF, rot, vb));
+    }
+    count += __builtin_popcount(static_cast<uint32_t>(matches));
+
+    uint32_t a_max = a[i + kWidth - 1];
+    uint32_t b_max = b[j + kWidth - 1];
+    i += (a_max <= b_max) * kWidth;
+    j += (b_max <= a_max) * kWidth;
+  }
+  *i_out = i;
+  *j_out = j;
+  return count;
+}
+#endif
+
+#if defined(__AVX2__)
+/// Vectorized merge of 8 element blocks: each block of a is compared against
+/// all 8 rotations of the current block of b.
+inline size_t
+IntersectCountAvx2(
+    const uint32_t* a, size_t a_len, const uint32_t* b, size_t b_len,
+    size_t* i_out, size_t* j_out) {
+  constexpr size_t kWidth = 8;
+  const __m256i kOne = _mm256_set1_epi32(1);
+  const __m256i kMask = _mm256_set1_epi32(kWidth - 1);
+  const __m256i kIdentity = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+  size_t count = 0;
+  size_t i = 0;
+  size_t j = 0;
+  while (i + kWidth <= a_len && j + kWidth <= b_len) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+
+    __m256i matches = _mm256_cmpeq_epi32(va, vb);
+    __m256i rot = kIdentity;
+    for (size_t r = 1; r < kWidth; ++r) {
+      rot = _mm256_and_si256(_mm256_add_epi32(rot, kOne), kMask);
+      matches = _mm256_or_si256(
+          matches,
+          _mm256_cmpeq_epi32(va, _mm256_permutevar8x32_epi32(vb, rot)));
+    }
+    count += __builtin_popcount(static_cast<uint32_t>(
+        _mm256_movemask_ps(_mm256_castsi256_ps(matches))));
+
+    uint32_t a_max = a[i + kWidth - 1];
+    uint32_t b_max = b[j + kWidth - 1];
+    i += (a_max <= b_max) * kWidth;
+    j += (b_max <= a_max) * kWidth;
+  }
+  *i_out = i;
+  *j_out = j;
+  return count;
+}
+#endif
+
+}  // namespace internal
+
+/// Block merge intersection count. Uses AVX-512 or AVX2 when the library is
+/// built for a target that supports them and falls back to the scalar merge
+/// otherwise.
+inline size_t
+IntersectCountSimd(
+    const uint32_t* a, size_t a_len, const uint32_t* b, size_t b_len) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t count = 0;
+#if defined(__AVX512F__)
+  count += internal::IntersectCountAvx512(a, a_len, b, b_len, &i, &j);
+#endif
+#if defined(__AVX2__)
+  {
+    size_t ii = 0;
+    size_t jj = 0;
+    count += internal::IntersectCountAvx2(
+        a + i, a_len - i, b + j, b_len - j, &ii, &jj);
+    i += ii;
+    j += jj;
+  }
+#endif
+  return count + IntersectCountMerge(a + i, a_len - i, b + j, b_len - j);
+}
+
+/// \returns |a ∩ b|, picking galloping, vectorized or scalar merging based on
+/// the list lengths.
+template <typename T>
+size_t
+IntersectCount(const T* a, size_t a_len, const T* b, size_t b_len) {
+  if (a_len == 0 || b_len == 0) {
+    return 0;
+  }
+  if (a_len > b_len) {
+    std::swap(a, b);
+    std::swap(a_len, b_len);
+  }
+  // Disjoint ranges are common once lists are trimmed by id.
+  if (a[a_len - 1] < b[0] || b[b_len - 1] < a[0]) {
+    return 0;
+  }
+  if (b_len / a_len >= kGallopingRatio) {
+    return IntersectCountGalloping(a, a_len, b, b_len);
+  }
+  if constexpr (std::is_same_v<T, uint32_t>) {
+    if (a_len >= kSimdMinLength) {
+      return IntersectCountSimd(a, a_len, b, b_len);
+    }
+  }
+  return IntersectCountMerge(a, a_len, b, b_len);
+}
+
+template <typename T>
+size_t
+IntersectCount(const SortedSpan<T>& a, const SortedSpan<T>& b) {
+  return IntersectCount(a.data, a.size, b.data, b.size);
+}
+
+/// Calls fn(i, j) for every pair of positions with a[i] == b[j].
+///
+/// If fn returns bool, returning false stops the intersection early. Like
+/// IntersectCount, this gallops over the longer list when the lengths are
+/// skewed.
+template <typename T, typename Fn>
+void
+IntersectForEach(
+    const T* a, size_t a_len, const T* b, size_t b_len, const Fn& fn) {
+  constexpr bool kCanStop =
+      std::is_same_v<std::invoke_result_t<Fn, size_t, size_t>, bool>;
+
+  auto visit = [&](size_t i, size_t j) {
+    if constexpr (kCanStop) {
+      return fn(i, j);
+    } else {
+      fn(i, j);
+      return true;
+    }
+  };
+
+  if (a_len == 0 || b_len == 0) {
+    return;
+  }
+
+  if (b_len / a_len >= kGallopingRatio) {
+    size_t j = 0;
+    for (size_t i = 0; i < a_len && j < b_len; ++i) {
+      j = GallopLowerBound(b, j, b_len, a[i]);
+      if (j < b_len && b[j] == a[i]) {
+        if (!visit(i, j)) {
+          return;
+        }
+        ++j;
+      }
+    }
+    return;
+  }
+
+  if (a_len / b_len >= kGallopingRatio) {
+    size_t i = 0;
+    for (size_t j = 0; j < b_len && i < a_len; ++j) {
+      i = GallopLowerBound(a, i, a_len, b[j]);
+      if (i < a_len && a[i] == b[j]) {
+        if (!visit(i, j)) {
+          return;
+        }
+        ++i;
+      }
+    }
+    return;
+  }
+
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a_len && j < b_len) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      if (!visit(i, j)) {
+        return;
+      }
+      ++i;
+      ++j;
+    }
+  }
+}
+
+template <typename T, typename Fn>
+void
+IntersectForEach(
+    const SortedSpan<T>& a, const SortedSpan<T>& b, const Fn& fn) {
+  IntersectForEach(a.data, a.size, b.data, b.size, fn);
+}
+
+/// Dense membership bitmap for intersecting many lists against the
+/// neighborhood of a single high degree (hub) node. Marking the hub's list
+/// once makes each subsequent intersection O(|other list|) regardless of the
+/// hub's degree.
+///
+/// Clearing only touches the words that were set, so one bitmap can be reused
+/// across hubs (e.g., one per thread).
+class IntersectionBitmap {
+  std::vector<uint64_t> words_;
+
+public:
+  /// Lists at least this long are worth marking in a bitmap.
+  constexpr static const size_t kHubDegree = 4096;
+
+  IntersectionBitmap() = default;
+
+  explicit IntersectionBitmap(size_t universe_size) { Resize(universe_size); }
+
+  void Resize(size_t universe_size) {
+    words_.assign((universe_size + 63) / 64, uint64_t{0});
+  }
+
+  size_t universe_size() const { return words_.size() * 64; }
+
+  template <typename T>
+  void Mark(const SortedSpan<T>& list) {
+    for (T v : list) {
+      words_[v >> 6] |= uint64_t{1} << (v & 63);
+    }
+  }
+
+  template <typename T>
+  void Unmark(const SortedSpan<T>& list) {
+    for (T v : list) {
+      words_[v >> 6] = 0;
+    }
+  }
+
+  template <typename T>
+  bool Test(T v) const {
+    return (words_[v >> 6] >> (v & 63)) & 1;
+  }
+
+  /// \returns the number of elements of list that are marked
+  template <typename T>
+  size_t Count(const SortedSpan<T>& list) const {
+    size_t count = 0;
+    for (T v : list) {
+      count += Test(v);
+    }
+    return count;
+  }
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_PEELINGBUCKETS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_PEELINGBUCKETS_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Loops.h"
+#include "katana/Reduction.h"
+
+namespace katana::analytics {
+
+/// Buckets of items keyed by an integer priority that only decreases, drained
+/// in increasing order of priority. This is the bucket structure of peeling
+/// algorithms such as k-core and truss decomposition:
+///
+///   Laxman Dhulipala, Guy Blelloch and Julian Shun. Julienne: A Framework
+///   for Parallel Graph Algorithms using Work-efficient Bucketing. SPAA 2017.
+///
+/// Only the buckets [base, base + num_open_buckets) exist. Items of higher
+/// priority wait in an overflow bag until the window moves past the buckets
+/// below them. When the priority of an item drops, the caller pushes it again
+/// and the old entry goes stale; callers must skip stale entries, typically
+/// with a flag marking the items already drained.
+template <typename T>
+class PeelingBuckets {
+public:
+  using Bag = katana::InsertBag<T>;
+
+  explicit PeelingBuckets(uint32_t num_open_buckets)
+      : buckets_(std::max(num_open_buckets, uint32_t{1})),
+        overflow_(std::make_unique<Bag>()) {}
+
+  /// The smallest priority in the window.
+  uint32_t base() const { return base_; }
+
+  bool InWindow(uint32_t priority) const {
+    return priority - base_ < buckets_.size();
+  }
+
+  /// Push an item. The priority must not be below base(). Thread safe.
+  void Push(const T& item, uint32_t priority) {
+    if (InWindow(priority)) {
+      buckets_[priority - base_].push(item);
+    } else {
+      overflow_->push(item);
+    }
+  }
+
+  /// Push an item whose priority dropped. Items still beyond the window are
+  /// in overflow already and are not pushed again. Thread safe.
+  void PushMoved(const T& item, uint32_t priority) {
+    if (InWindow(priority)) {
+      buckets_[priority - base_].push(item);
+    }
+  }
+
+  /// The bucket of a priority in the window.
+  Bag& Bucket(uint32_t priority) { return buckets_[priority - base_]; }
+
+  /// Restart the window at the smallest priority in overflow and move the
+  /// overflow items into it. Must be called only once every bucket in the
+  /// window is drained.
+  ///
+  /// @param priority returns the current priority of an item
+  /// @param is_live returns false for stale entries
+  /// @return the new base
+  template <typename PriorityFn, typename IsLiveFn>
+  uint32_t Advance(const PriorityFn& priority, const IsLiveFn& is_live) {
+    katana::GReduceMin<uint32_t> min_priority;
+    katana::do_all(
+        katana::iterate(*overflow_),
+        [&](const T& item) {
+          if (is_live(item)) {
+            min_priority.update(priority(item));
+          }
+        },
+        katana::no_stats());
+
+    auto pending = std::move(overflow_);
+    overflow_ = std::make_unique<Bag>();
+    base_ = min_priority.reduce();
+
+    katana::do_all(
+        katana::iterate(*pending),
+        [&](const T& item) {
+          if (is_live(item)) {
+            Push(item, priority(item));
+          }
+        },
+        katana::loopname("PeelingBuckets Advance"), katana::no_stats());
+    return base_;
+  }
+
+private:
+  std::vector<Bag> buckets_;
+  std::unique_ptr<Bag> overflow_;
+  uint32_t base_{0};
+};
+
+}  // namespace katana::analytics
+
+#endif
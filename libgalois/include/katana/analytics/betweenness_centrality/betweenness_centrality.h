@@ -18,19 +18,27 @@ public:
   enum Algorithm {
     kLevel,
     kOuter,
-    // TODO(gill): Reinstate async and auto once we have bidirectional graphs.
-    // kAsynchronous,
+    kAsynchronous,
+    kBatched,
+    // TODO(gill): Reinstate auto.
     // kAutomatic,
   };
 
+  static constexpr uint32_t kDefaultBatchSize = 64;
+  /// Sources of a batch are tracked as the bits of one 64-bit word per node.
+  static constexpr uint32_t kMaxBatchSize = 64;
+
 private:
   Algorithm algorithm_;
+  uint32_t batch_size_;
 
-  BetweennessCentralityPlan(Architecture architecture, Algorithm algorithm)
-      : Plan(architecture), algorithm_(algorithm) {}
+  BetweennessCentralityPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t batch_size)
+      : Plan(architecture), algorithm_(algorithm), batch_size_(batch_size) {}
 
 public:
-  BetweennessCentralityPlan() : BetweennessCentralityPlan{kCPU, kLevel} {}
+  BetweennessCentralityPlan()
+      : BetweennessCentralityPlan{kCPU, kLevel, kDefaultBatchSize} {}
 
   BetweennessCentralityPlan(const katana::PropertyGraph* pg [[maybe_unused]])
       : BetweennessCentralityPlan() {
@@ -51,12 +59,51 @@ public:
 
   Algorithm algorithm() const { return algorithm_; }
 
-  static BetweennessCentralityPlan Level() { return {kCPU, kLevel}; }
+  /// The number of sources traversed together by kBatched.
+  uint32_t batch_size() const { return batch_size_; }
+
+  /// Process the levels of the BFS from each source in parallel, one source
+  /// at a time.
+  static BetweennessCentralityPlan Level() {
+    return {kCPU, kLevel, kDefaultBatchSize};
+  }
+
+  /// Process sources in parallel, each one sequentially by a single thread.
+  static BetweennessCentralityPlan Outer() {
+    return {kCPU, kOuter, kDefaultBatchSize};
+  }
+
+  /// Process one source at a time without level barriers. Shortest path
+  /// counts and dependencies flow through the shortest path DAG as soon as
+  /// all the predecessors (resp. successors) of a node are done, which
+  /// suits high-diameter graphs such as road networks. Predecessors are read
+  /// from the incoming edges of the graph instead of being recorded:
+  ///
+  ///   Dimitrios Prountzos and Keshav Pingali. Betweenness Centrality:
+  ///   Algorithms and Implementations. PPoPP 2013.
+  static BetweennessCentralityPlan Asynchronous() {
+    return {kCPU, kAsynchronous, kDefaultBatchSize};
+  }
 
-  static BetweennessCentralityPlan Outer() { return {kCPU, kOuter}; }
+  /// Traverse from batch_size sources at once, level by level, with the
+  /// frontier of each node held as a bitmask of sources:
+  ///
+  ///   Manuel Then, Moritz Kaufmann, Fernando Chirigati, et al. The More the
+  ///   Merrier: Efficient Multi-Source Graph Traversal. VLDB 2014.
+  ///
+  /// This shares each edge visit among the sources that reach it at the same
+  /// depth, which suits approximate centrality over many sampled sources.
+  /// Needs 12 * batch_size bytes of path counts and dependencies per node.
+  ///
+  /// @param batch_size number of sources per traversal, at most
+  ///     kMaxBatchSize
+  static BetweennessCentralityPlan Batched(
+      uint32_t batch_size = kDefaultBatchSize) {
+    return {kCPU, kBatched, batch_size};
+  }
 
   static BetweennessCentralityPlan FromAlgorithm(Algorithm algo) {
-    return BetweennessCentralityPlan(kCPU, algo);
+    return BetweennessCentralityPlan(kCPU, algo, kDefaultBatchSize);
   }
 };
 
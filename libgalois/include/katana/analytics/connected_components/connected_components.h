@@ -2,6 +2,8 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_CONNECTEDCOMPONENTS_CONNECTEDCOMPONENTS_H_
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
@@ -161,6 +163,26 @@ KATANA_EXPORT Result<void> ConnectedComponents(
     PropertyGraph* pg, const std::string& output_property_name,
     ConnectedComponentsPlan plan = ConnectedComponentsPlan());
 
+/// Update the components in property_name, computed by ConnectedComponents,
+/// to account for new undirected edges between existing nodes of pg. Only
+/// the labels of components joined by new edges are looked at: they are
+/// merged with a concurrent union-find, each merged set keeps its smallest
+/// label, and the nodes with the other labels are relabeled by a parallel
+/// scan of the labels. The time of an update is thus proportional to the
+/// size of the batch plus a scan of the nodes, with no traversal of edges.
+///
+/// The new edges need not be in the topology of pg yet, and neither need
+/// the edges of earlier updates: a component may span several parts of the
+/// topology, which is why it is relabeled by a scan of the labels rather
+/// than a traversal.
+///
+/// @param pg The graph whose components are in property_name.
+/// @param property_name The existing component property to update in place.
+/// @param new_edges Pairs of source and destination nodes.
+KATANA_EXPORT Result<void> ConnectedComponentsIncremental(
+    PropertyGraph* pg, const std::string& property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& new_edges);
+
 KATANA_EXPORT Result<void> ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
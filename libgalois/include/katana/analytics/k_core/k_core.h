@@ -67,5 +67,75 @@ struct KATANA_EXPORT KCoreStatistics {
       const std::string& property_name);
 };
 
+/// A computational plan for k-core decomposition, which computes the core
+/// number of every node at once.
+class KCoreDecompositionPlan : public Plan {
+public:
+  /// Algorithm selectors for KCoreDecomposition
+  enum Algorithm { kBucketPeeling };
+
+  static const uint32_t kDefaultNumOpenBuckets = 128;
+
+private:
+  Algorithm algorithm_;
+  uint32_t num_open_buckets_;
+
+  KCoreDecompositionPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t num_open_buckets)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        num_open_buckets_(num_open_buckets) {}
+
+public:
+  KCoreDecompositionPlan()
+      : KCoreDecompositionPlan{kCPU, kBucketPeeling, kDefaultNumOpenBuckets} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The number of degree buckets materialized at a time.
+  uint32_t num_open_buckets() const { return num_open_buckets_; }
+
+  /// Peel all nodes of minimum degree in level synchronous rounds, keeping
+  /// the remaining nodes in buckets by degree (Julienne). Only
+  /// num_open_buckets buckets are kept at a time; nodes of higher degree wait
+  /// in an overflow bucket until the window reaches them.
+  ///
+  ///   Laxman Dhulipala, Guy Blelloch and Julian Shun. Julienne: A Framework
+  ///   for Parallel Graph Algorithms using Work-efficient Bucketing. SPAA 2017.
+  static KCoreDecompositionPlan BucketPeeling(
+      uint32_t num_open_buckets = kDefaultNumOpenBuckets) {
+    return {kCPU, kBucketPeeling, num_open_buckets};
+  }
+};
+
+/// Compute the core number of every node in pg, i.e., the largest k such that
+/// the node belongs to the k-core. The pg must be symmetric.
+/// The uint32 property named output_property_name is created by this function
+/// and may not exist before the call.
+KATANA_EXPORT Result<void> KCoreDecomposition(
+    PropertyGraph* pg, const std::string& output_property_name,
+    KCoreDecompositionPlan plan = KCoreDecompositionPlan());
+
+/// Check that every node's core number is the h-index of its neighbors' core
+/// numbers, which holds for the core decomposition.
+KATANA_EXPORT Result<void> KCoreDecompositionAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT KCoreDecompositionStatistics {
+  /// The largest core number, i.e., the degeneracy of the graph.
+  uint32_t max_core_number;
+  /// Number of nodes in the max_core_number-core.
+  uint64_t number_of_nodes_in_max_core;
+  /// Average core number over all nodes.
+  double average_core_number;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<KCoreDecompositionStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
 }  // namespace katana::analytics
 #endif
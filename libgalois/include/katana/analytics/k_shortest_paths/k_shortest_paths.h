@@ -0,0 +1,128 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_KSHORTESTPATHS_KSHORTESTPATHS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_KSHORTESTPATHS_KSHORTESTPATHS_H_
+
+#include <iostream>
+#include <vector>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan to for k shortest paths, specifying how the work of
+/// a batch of queries is spread over the threads. The plan does not change
+/// the paths that are found.
+class KShortestPathsPlan : public Plan {
+public:
+  /// Algorithm selectors for KShortestPaths and KShortestSimplePaths
+  enum Algorithm { kAutomatic, kParallelQueries, kParallelSpurPaths };
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+
+  KShortestPathsPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  KShortestPathsPlan() : KShortestPathsPlan{kCPU, kAutomatic} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Choose ParallelQueries for batches with at least one query per thread
+  /// and ParallelSpurPaths otherwise.
+  static KShortestPathsPlan Automatic() { return {kCPU, kAutomatic}; }
+
+  /// Answer the queries of a batch in parallel, each on a single thread.
+  static KShortestPathsPlan ParallelQueries() {
+    return {kCPU, kParallelQueries};
+  }
+
+  /// Answer the queries of a batch one after another. For simple paths, the
+  /// spur paths that deviate from the last path found are computed in
+  /// parallel, one spur node per task.
+  static KShortestPathsPlan ParallelSpurPaths() {
+    return {kCPU, kParallelSpurPaths};
+  }
+};
+
+/// A path query: find paths from source to target.
+struct KShortestPathsQuery {
+  uint32_t source;
+  uint32_t target;
+};
+
+/// A path found by KShortestPaths or KShortestSimplePaths.
+struct KATANA_EXPORT KShortestPath {
+  /// The nodes of the path, from the source to the target of the query.
+  std::vector<uint32_t> nodes;
+  /// The edges of the path; edges[i] goes from nodes[i] to nodes[i + 1].
+  std::vector<uint64_t> edges;
+  /// The sum of the weights of the edges.
+  double weight;
+
+  /// Print the path in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+/// Find the k shortest paths from source to target in pg. A path may visit
+/// a node more than once. The edge weights are taken from the property named
+/// edge_weight_property_name (which may be a 32- or 64-bit sign or unsigned
+/// int, or a float or double) and must be nonnegative. The paths are
+/// returned by nondecreasing weight. Each query is answered by a
+/// deterministic search, so the result is the same for all plans and thread
+/// counts. Fewer than k paths are returned if fewer exist.
+///
+/// The distances to the target, found by Dijkstra's algorithm on the
+/// incoming edges, guide a best first search over paths from the source that
+/// settles each node at most k times, like K* (Aljazzar and Leue, AI 2011)
+/// but without Eppstein's path graph.
+KATANA_EXPORT Result<std::vector<KShortestPath>> KShortestPaths(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    uint32_t source, uint32_t target, uint32_t k,
+    KShortestPathsPlan plan = KShortestPathsPlan());
+
+/// Answer a batch of KShortestPaths queries on the same graph; the i-th
+/// result holds the paths for queries[i]. All queries share one
+/// bidirectional view of pg, which is kept in the view cache of pg for later
+/// calls, and each thread reuses its scratch buffers, about 40 bytes per
+/// node, from query to query.
+KATANA_EXPORT Result<std::vector<std::vector<KShortestPath>>> KShortestPaths(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::vector<KShortestPathsQuery>& queries, uint32_t k,
+    KShortestPathsPlan plan = KShortestPathsPlan());
+
+/// Like KShortestPaths, but only return paths that visit every node at most
+/// once, found with Yen's algorithm (Management Science 1971) and Lawler's
+/// rule to only deviate from a path after the node where it deviated from
+/// its parent. The spur paths are found by A* search, with the distances to
+/// the target as the heuristic.
+KATANA_EXPORT Result<std::vector<KShortestPath>> KShortestSimplePaths(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    uint32_t source, uint32_t target, uint32_t k,
+    KShortestPathsPlan plan = KShortestPathsPlan());
+
+/// Answer a batch of KShortestSimplePaths queries on the same graph; see the
+/// batch version of KShortestPaths.
+KATANA_EXPORT Result<std::vector<std::vector<KShortestPath>>>
+KShortestSimplePaths(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::vector<KShortestPathsQuery>& queries, uint32_t k,
+    KShortestPathsPlan plan = KShortestPathsPlan());
+
+/// Check that every path goes from the source to the target of query along
+/// edges of pg, that its weight is the sum of its edge weights, that the
+/// paths are distinct and sorted by weight, and, if simple is true, that no
+/// path visits a node twice. This does not check that the paths are the
+/// shortest ones.
+KATANA_EXPORT Result<void> KShortestPathsAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const KShortestPathsQuery& query, const std::vector<KShortestPath>& paths,
+    bool simple);
+
+}  // namespace katana::analytics
+
+#endif
@@ -48,7 +48,8 @@ public:
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
 ///
-/// @warning This algorithm will reorder nodes and edges in the graph.
+/// The algorithm runs on a sorted view of the graph; the topology of pg is not
+/// modified.
 KATANA_EXPORT Result<void> KTruss(
     PropertyGraph* pg, uint32_t k_truss_number,
     const std::string& output_property_name, KTrussPlan plan = KTrussPlan());
@@ -69,5 +70,77 @@ struct KATANA_EXPORT KTrussStatistics {
       const std::string& property_name);
 };
 
+/// A computational plan for truss decomposition, which computes the trussness
+/// of every edge at once.
+class KTrussDecompositionPlan : public Plan {
+public:
+  /// Algorithm selectors for KTrussDecomposition
+  enum Algorithm { kBucketPeeling };
+
+  static const uint32_t kDefaultNumOpenBuckets = 128;
+
+private:
+  Algorithm algorithm_;
+  uint32_t num_open_buckets_;
+
+  KTrussDecompositionPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t num_open_buckets)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        num_open_buckets_(num_open_buckets) {}
+
+public:
+  KTrussDecompositionPlan()
+      : KTrussDecompositionPlan{
+            kCPU, kBucketPeeling, kDefaultNumOpenBuckets} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The number of support buckets materialized at a time.
+  uint32_t num_open_buckets() const { return num_open_buckets_; }
+
+  /// Count the support (number of triangles) of every edge once, then peel
+  /// edges in increasing order of support in level synchronous rounds,
+  /// keeping the remaining edges in buckets by support.
+  ///
+  ///   Humayun Kabir and Kamesh Madduri. Shared-memory Graph Truss
+  ///   Decomposition. HiPC 2017.
+  static KTrussDecompositionPlan BucketPeeling(
+      uint32_t num_open_buckets = kDefaultNumOpenBuckets) {
+    return {kCPU, kBucketPeeling, num_open_buckets};
+  }
+};
+
+/// Compute the trussness of every edge of pg, i.e., the largest k such that
+/// the edge belongs to the k-truss. Edges in no triangle have trussness 2 and
+/// self loops have trussness 0. The pg must be symmetric and have no parallel
+/// edges; both directions of an edge get the same trussness.
+/// The uint32 edge property named output_property_name is created by this
+/// function and may not exist before the call. The topology of pg is not
+/// modified.
+KATANA_EXPORT Result<void> KTrussDecomposition(
+    PropertyGraph* pg, const std::string& output_property_name,
+    KTrussDecompositionPlan plan = KTrussDecompositionPlan());
+
+/// Check that every edge with trussness k is in at least k - 2 triangles whose
+/// other edges have trussness at least k, and that both directions of an edge
+/// agree.
+KATANA_EXPORT Result<void> KTrussDecompositionAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT KTrussDecompositionStatistics {
+  /// The largest trussness of any edge.
+  uint32_t max_trussness;
+  /// Number of undirected edges in the max_trussness-truss.
+  uint64_t number_of_edges_in_max_truss;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<KTrussDecompositionStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
 }  // namespace katana::analytics
 #endif
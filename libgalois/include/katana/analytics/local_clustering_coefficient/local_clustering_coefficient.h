@@ -79,7 +79,8 @@ public:
  * @param output_property_name name of the output property
  * @param plan
  *
- * @warning This algorithm will reorder nodes and edges in the graph.
+ * The algorithm runs on a sorted (and possibly degree relabeled) view of the
+ * graph. The view is cached in pg and shared with other analytics.
  */
 KATANA_EXPORT Result<void> LocalClusteringCoefficient(
     PropertyGraph* pg, const std::string& output_property_name,
@@ -16,6 +16,7 @@ public:
   enum Algorithm {
     kDoAll,
     kDeterministic,
+    kLeiden,
   };
 
   static const bool kDefaultEnableVF = false;
@@ -110,6 +111,34 @@ public:
         max_iterations,
         min_graph_size};
   }
+
+  /// Leiden algorithm: the nondeterministic local moving of DoAll, followed
+  /// by a refinement phase that splits each community into well connected
+  /// subcommunities before coarsening. The communities of the last level
+  /// come from local moving and are only guaranteed to be connected once
+  /// the levels converge, which the thresholds and max_iterations can cut
+  /// short, so in the end every community is split into the connected
+  /// components it induces. Unlike Louvain, the communities found are thus
+  /// never disconnected.
+  ///
+  ///   V. A. Traag, L. Waltman and N. J. van Eck. From Louvain to Leiden:
+  ///   guaranteeing well-connected communities. Scientific Reports 9, 2019.
+  static LouvainClusteringPlan Leiden(
+      bool enable_vf = kDefaultEnableVF,
+      double modularity_threshold_per_round =
+          kDefaultModularityThresholdPerRound,
+      double modularity_threshold_total = kDefaultModularityThresholdTotal,
+      uint32_t max_iterations = kDefaultMaxIterations,
+      uint32_t min_graph_size = kDefaultMinGraphSize) {
+    return {
+        kCPU,
+        kLeiden,
+        enable_vf,
+        modularity_threshold_per_round,
+        modularity_threshold_total,
+        max_iterations,
+        min_graph_size};
+  }
 };
 
 /// Compute the Louvain Clustering for pg.
@@ -119,6 +148,10 @@ public:
 /// output_property_name (as uint32_t).
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
+///
+/// The size of each level, its modularity and the time spent in local moving,
+/// refinement and coarsening are reported as statistics of the
+/// LouvainClustering region.
 KATANA_EXPORT Result<void> LouvainClustering(
     PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name, LouvainClusteringPlan plan = {});
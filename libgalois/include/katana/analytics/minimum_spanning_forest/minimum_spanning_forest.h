@@ -0,0 +1,112 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+
+#include <iostream>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan to for minimum spanning forest, specifying the
+/// algorithm and any parameters associated with it.
+class MinimumSpanningForestPlan : public Plan {
+public:
+  /// Algorithm selectors for MinimumSpanningForest
+  enum Algorithm { kBoruvka, kFilterKruskal };
+
+  static const uint32_t kDefaultBaseCaseSize = 1 << 14;
+  /// Graphs with at least this many edges per node are dense enough for
+  /// filter-Kruskal to discard most edges without sorting them.
+  static const uint32_t kDenseAverageDegree = 32;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  uint32_t base_case_size_;
+
+  MinimumSpanningForestPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t base_case_size)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        base_case_size_(base_case_size) {}
+
+public:
+  MinimumSpanningForestPlan() : MinimumSpanningForestPlan{kCPU, kBoruvka, 0} {}
+
+  /// Choose filter-Kruskal for dense graphs and Boruvka otherwise.
+  MinimumSpanningForestPlan(const katana::PropertyGraph* pg)
+      : MinimumSpanningForestPlan{} {
+    if (pg->num_edges() >= uint64_t{kDenseAverageDegree} * pg->num_nodes()) {
+      *this = FilterKruskal();
+    }
+  }
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The number of edges below which filter-Kruskal sorts edges instead of
+  /// partitioning them.
+  uint32_t base_case_size() const { return base_case_size_; }
+
+  /// Parallel Boruvka. In each round, every component picks its lightest
+  /// edge to another component and the picked edges are merged into the
+  /// forest. Edges inside a component are filtered out of the edge list
+  /// as they are found, so later rounds only scan edges between components.
+  static MinimumSpanningForestPlan Boruvka() { return {kCPU, kBoruvka, 0}; }
+
+  /// Kruskal's algorithm, quicksort style: partition the edges around a
+  /// pivot weight, recurse on the light edges and then drop the heavy edges
+  /// whose endpoints the light edges already connected before recursing on
+  /// the rest. Partitioning and filtering are parallel; edge lists smaller
+  /// than base_case_size are sorted and merged serially.
+  ///
+  ///   Vitaly Osipov, Peter Sanders and Johannes Singler. The
+  ///   Filter-Kruskal Minimum Spanning Tree Algorithm. ALENEX 2009.
+  static MinimumSpanningForestPlan FilterKruskal(
+      uint32_t base_case_size = kDefaultBaseCaseSize) {
+    return {kCPU, kFilterKruskal, base_case_size};
+  }
+};
+
+/// Compute a minimum spanning forest of pg, taking every edge as undirected.
+/// The edge weights are taken from the property named
+/// edge_weight_property_name (which may be a 32- or 64-bit sign or unsigned
+/// int, or a float or double). Ties are broken by edge ID, so the forest is
+/// the same for all plans and thread counts.
+/// The uint8 edge property named output_property_name is created by this
+/// function and may not exist before the call. It is 1 for the edges in the
+/// forest and 0 otherwise. Only one edge is marked per forest link; on a
+/// symmetric graph the reverse edge is not marked.
+KATANA_EXPORT Result<void> MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    MinimumSpanningForestPlan plan = MinimumSpanningForestPlan());
+
+/// Check that the marked edges form a spanning forest of pg whose weights
+/// are the weights of a minimum spanning forest. This sorts all the edges.
+KATANA_EXPORT Result<void> MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name);
+
+struct KATANA_EXPORT MinimumSpanningForestStatistics {
+  /// The total weight of the forest edges.
+  double total_weight;
+  /// The number of edges in the forest.
+  uint64_t num_forest_edges;
+  /// The number of trees in the forest, i.e., of connected components.
+  uint64_t num_trees;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MinimumSpanningForestStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+      const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_PARTITION_PARTITION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_PARTITION_PARTITION_H_
+
+#include <iostream>
+#include <memory>
+
+#include "katana/GraphTopology.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan to for graph partitioning, specifying the algorithm
+/// and any parameters associated with it.
+class PartitionPlan : public Plan {
+public:
+  /// Algorithm selectors for Partition
+  enum Algorithm { kMultilevel };
+
+  static constexpr double kDefaultMaxImbalance = 1.05;
+  static const uint32_t kDefaultCoarsenTo = 20;
+  static const uint32_t kDefaultNumRefinementPasses = 8;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  double max_imbalance_;
+  uint32_t coarsen_to_;
+  uint32_t num_refinement_passes_;
+
+  PartitionPlan(
+      Architecture architecture, Algorithm algorithm, double max_imbalance,
+      uint32_t coarsen_to, uint32_t num_refinement_passes)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        max_imbalance_(max_imbalance),
+        coarsen_to_(coarsen_to),
+        num_refinement_passes_(num_refinement_passes) {}
+
+public:
+  PartitionPlan() : PartitionPlan{Multilevel()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The largest allowed ratio between the size of a partition and the
+  /// average partition size.
+  double max_imbalance() const { return max_imbalance_; }
+
+  /// Coarsening stops once the graph has fewer than coarsen_to nodes per
+  /// partition. Must be at least 2.
+  uint32_t coarsen_to() const { return coarsen_to_; }
+
+  /// The maximum number of refinement passes at each level.
+  uint32_t num_refinement_passes() const { return num_refinement_passes_; }
+
+  /// Multilevel k-way partitioning in the style of METIS:
+  ///
+  /// 1. Coarsen the graph by contracting a parallel heavy-edge matching
+  ///    until it is small.
+  /// 2. Partition the coarsest graph by greedy graph growing.
+  /// 3. Project the partition back level by level, moving boundary nodes to
+  ///    the neighboring partition they have the most edges to, in parallel,
+  ///    as long as the partitions stay within max_imbalance.
+  ///
+  ///   George Karypis and Vipin Kumar. Multilevel k-way Partitioning Scheme
+  ///   for Irregular Graphs. JPDC 1998.
+  static PartitionPlan Multilevel(
+      double max_imbalance = kDefaultMaxImbalance,
+      uint32_t coarsen_to = kDefaultCoarsenTo,
+      uint32_t num_refinement_passes = kDefaultNumRefinementPasses) {
+    return {
+        kCPU, kMultilevel, max_imbalance, coarsen_to, num_refinement_passes};
+  }
+};
+
+/// Partition the nodes of pg into num_partitions parts of about the same
+/// size while cutting few edges. Every edge counts the same. The graph
+/// should be symmetric; only outgoing edges guide the partitioner.
+/// The uint32 node property named output_property_name is created by this
+/// function and may not exist before the call. It holds the partition of
+/// each node, in [0, num_partitions). If pg has at least num_partitions
+/// nodes, no partition is empty.
+KATANA_EXPORT Result<void> Partition(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name,
+    PartitionPlan plan = PartitionPlan());
+
+/// Check that every node has a partition in [0, num_partitions) and that no
+/// partition is empty unless pg has fewer nodes than partitions.
+KATANA_EXPORT Result<void> PartitionAssertValid(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name);
+
+/// Make a copy of the topology of pg with the nodes grouped by the partition
+/// in the property named property_name, so that each partition is a
+/// contiguous range of nodes. Use node_property_index() to map the nodes of
+/// the copy back to the nodes of pg.
+KATANA_EXPORT Result<std::unique_ptr<ShuffleTopology>>
+MakePartitionOrderedTopology(
+    const PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT PartitionStatistics {
+  /// The number of edges whose endpoints are in different partitions.
+  uint64_t edge_cut;
+  /// The number of nodes in the smallest partition.
+  uint64_t min_partition_size;
+  /// The number of nodes in the largest partition.
+  uint64_t max_partition_size;
+  /// The size of the largest partition over the average partition size.
+  double imbalance;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<PartitionStatistics> Compute(
+      katana::PropertyGraph* pg, uint32_t num_partitions,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -3,9 +3,11 @@
 
 #include <iostream>
 
+#include <arrow/api.h>
 #include <katana/analytics/Plan.h>
 
 #include "katana/AtomicHelpers.h"
+#include "katana/URI.h"
 #include "katana/analytics/Utils.h"
 
 // API
@@ -133,12 +135,40 @@ public:
   }
 };
 
+/// Number of walks RandomWalksToParquet generates before writing them out.
+constexpr uint64_t kDefaultRandomWalksPerBatch = 1 << 20;
+
+/// Name of the column holding the walks in the files of RandomWalksToParquet.
+constexpr const char* kRandomWalksColumnName = "walk";
+
 /// Compute the random-walks for pg. The pg is expected to be symmetric. The
 /// parameters can be specified, but have reasonable defaults. Not all
-/// parameters are used by the algorithms. The generated random-walks generated
-/// are returned as a vector of vectors.
-KATANA_EXPORT Result<std::vector<std::vector<uint32_t>>> RandomWalks(
-    PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
+/// parameters are used by the algorithms. The generated random-walks are
+/// returned as a list<uint32> array with one walk per row. The walks are
+/// written by the threads generating them directly into the flat value buffers
+/// of the chunks.
+///
+/// If edge_weight_property_name is not empty, it names an edge property (which
+/// may be a 32- or 64-bit sign or unsigned int, or a float or double) of
+/// nonnegative weights, and every step proposes an edge with probability
+/// proportional to its weight instead of uniformly. The proposal is drawn in
+/// constant time from per-node alias tables built before the walks start.
+KATANA_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>> RandomWalks(
+    PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan(),
+    const std::string& edge_weight_property_name = "");
+
+/// Compute the random-walks for pg like RandomWalks, but write them out while
+/// they are generated instead of returning them. Each batch of
+/// walks_per_batch walks is written as a parquet file "<prefix>.<i>", where i
+/// is the six-digit, zero-padded index of the batch, with a single
+/// list<uint32> column named kRandomWalksColumnName. A batch is written in the
+/// background while the next one is generated, so consumers can read the files
+/// of finished batches before the last one is written.
+KATANA_EXPORT Result<void> RandomWalksToParquet(
+    PropertyGraph* pg, const katana::Uri& prefix,
+    RandomWalksPlan plan = RandomWalksPlan(),
+    const std::string& edge_weight_property_name = "",
+    uint64_t walks_per_batch = kDefaultRandomWalksPerBatch);
 
 KATANA_EXPORT Result<void> RandomWalksAssertValid(PropertyGraph* pg);
 
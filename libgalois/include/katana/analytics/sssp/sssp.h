@@ -26,6 +26,8 @@ public:
     kDijkstra,
     kTopological,
     kTopologicalTile,
+    /// Choose the algorithm and delta from a sample of the edge weights and
+    /// the degree distribution. The choice is reported in the statistics.
     kAutomatic,
   };
 
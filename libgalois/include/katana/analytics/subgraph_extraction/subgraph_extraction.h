@@ -13,18 +13,24 @@ class SubGraphExtractionPlan : public Plan {
 public:
   enum Algorithm {
     kNodeSet,
+    kKHop,
   };
 
+  static const uint32_t kDefaultNumHops = 1;
+
 private:
   Algorithm algorithm_;
+  uint32_t num_hops_;
 
-  SubGraphExtractionPlan(Architecture architecture, Algorithm algorithm)
-      : Plan(architecture), algorithm_(algorithm) {}
+  SubGraphExtractionPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t num_hops)
+      : Plan(architecture), algorithm_(algorithm), num_hops_(num_hops) {}
 
 public:
-  SubGraphExtractionPlan() : SubGraphExtractionPlan{kCPU, kNodeSet} {}
+  SubGraphExtractionPlan() : SubGraphExtractionPlan{kCPU, kNodeSet, 0} {}
 
   Algorithm algorithm() const { return algorithm_; }
+  uint32_t num_hops() const { return num_hops_; }
 
   // TODO(amp): This algorithm defines the semantics of the call. If there were
   //  an algorithm that, for instance, took a list of edges, that would need to
@@ -38,8 +44,21 @@ public:
    * The node-set algorithm:
    *    Given a set of node ids, this algorithm constructs a new sub-graph
    *    connecting all the nodes in the set along with the properties requested.
+   *    Node i of the sub-graph is the i-th distinct node in the set.
+   */
+  static SubGraphExtractionPlan NodeSet() { return {kCPU, kNodeSet, 0}; }
+
+  /**
+   * The k-hop algorithm:
+   *    Given a set of seed node ids, this algorithm constructs the sub-graph
+   *    induced by the seeds and every node reachable from them in at most
+   *    num_hops out-going edges (the ego network of the seeds). The seeds
+   *    come first in the sub-graph, followed by the nodes of each hop in
+   *    increasing order of id.
    */
-  static SubGraphExtractionPlan NodeSet() { return {kCPU, kNodeSet}; }
+  static SubGraphExtractionPlan KHop(uint32_t num_hops = kDefaultNumHops) {
+    return {kCPU, kKHop, num_hops};
+  }
 };
 
 /**
@@ -47,17 +66,23 @@ public:
  *
  * By default only topology of the sub-graph is constructed.
  * The new sub-graph is independent of the original graph.
+ * The edges of each node are ordered by destination in the sub-graph. The
+ * running time is linear in the size of node_vec and the degrees of the
+ * sub-graph nodes.
  *
  * @param pg The graph to process.
- * @param node_vec Set of node IDs
+ * @param node_vec Set of node IDs; duplicates are ignored
  * @param plan
+ * @param node_properties_to_copy Node properties to copy to the sub-graph
+ * @param edge_properties_to_copy Edge properties to copy to the sub-graph
  */
 KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
 SubGraphExtraction(
     katana::PropertyGraph* pg,
     const std::vector<katana::PropertyGraph::Node>& node_vec,
-    SubGraphExtractionPlan plan = {});
-// const std::vector<std::string>& node_properties_to_copy, const std::vector<std::string>& edge_properties_to_copy);
+    SubGraphExtractionPlan plan = {},
+    const std::vector<std::string>& node_properties_to_copy = {},
+    const std::vector<std::string>& edge_properties_to_copy = {});
 
 }  // namespace katana::analytics
 
@@ -96,7 +96,9 @@ public:
  * Count the total number of triangles in the graph. The graph must be
  * symmetric!
  *
- * This algorithm copies the graph internally.
+ * Unless plan.edges_sorted() is set and no relabeling is done, this
+ * algorithm builds a sorted copy of the topology. The copy is kept in the view
+ * cache of pg and reused by later analytics on the same graph.
  *
  * @param pg The graph to process.
  * @param plan
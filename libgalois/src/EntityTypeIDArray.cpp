@@ -0,0 +1,168 @@
+#include "katana/EntityTypeIDArray.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/gstl.h"
+
+namespace {
+
+constexpr size_t kNumEntityTypeIDs =
+    size_t{std::numeric_limits<katana::EntityTypeID>::max()} + 1;
+
+/// \returns the distinct EntityTypeIDs in ids, in increasing order
+std::vector<katana::EntityTypeID>
+FindUsedEntityTypeIDs(const katana::NUMAArray<katana::EntityTypeID>& ids) {
+  katana::PerThreadStorage<std::vector<bool>> per_thread_used;
+  katana::on_each([&](unsigned tid, unsigned total) {
+    std::vector<bool>& used = *per_thread_used.getLocal();
+    used.resize(kNumEntityTypeIDs);
+    auto [begin, end] = katana::block_range(ids.begin(), ids.end(), tid, total);
+    for (auto it = begin; it != end; ++it) {
+      if (!used[*it]) {
+        used[*it] = true;
+      }
+    }
+  });
+
+  std::vector<katana::EntityTypeID> in_use;
+  for (size_t id = 0; id < kNumEntityTypeIDs; ++id) {
+    for (unsigned t = 0; t < per_thread_used.size(); ++t) {
+      const std::vector<bool>& used = *per_thread_used.getRemote(t);
+      if (!used.empty() && used[id]) {
+        in_use.emplace_back(id);
+        break;
+      }
+    }
+  }
+  return in_use;
+}
+
+}  // namespace
+
+katana::EntityTypeIDArray
+katana::EntityTypeIDArray::Make(NUMAArray<EntityTypeID>&& ids) {
+  std::vector<EntityTypeID> in_use = FindUsedEntityTypeIDs(ids);
+
+  if (in_use.empty() || in_use.back() < kMaxNarrowTypes) {
+    NUMAArray<uint8_t> codes;
+    codes.allocateInterleaved(ids.size());
+    katana::ParallelSTL::transform(
+        ids.begin(), ids.end(), codes.begin(),
+        [](EntityTypeID id) { return static_cast<uint8_t>(id); });
+    return MakeIdentity(std::move(codes));
+  }
+
+  if (in_use.size() > kMaxNarrowTypes) {
+    return MakeWide(std::move(ids));
+  }
+
+  Dictionary dictionary;
+  dictionary.fill(kInvalidEntityType);
+  std::vector<uint8_t> code_of(kNumEntityTypeIDs);
+  for (size_t code = 0; code < in_use.size(); ++code) {
+    dictionary[code] = in_use[code];
+    code_of[in_use[code]] = code;
+  }
+
+  NUMAArray<uint8_t> codes;
+  codes.allocateInterleaved(ids.size());
+  katana::ParallelSTL::transform(
+      ids.begin(), ids.end(), codes.begin(),
+      [&](EntityTypeID id) { return code_of[id]; });
+  return MakeNarrow(dictionary, in_use.size(), std::move(codes));
+}
+
+katana::EntityTypeIDArray
+katana::EntityTypeIDArray::MakeFilled(size_t size, EntityTypeID id) {
+  NUMAArray<uint8_t> codes;
+  codes.allocateInterleaved(size);
+  if (id < kMaxNarrowTypes) {
+    katana::ParallelSTL::fill(
+        codes.begin(), codes.end(), static_cast<uint8_t>(id));
+    return MakeIdentity(std::move(codes));
+  }
+
+  Dictionary dictionary;
+  dictionary.fill(kInvalidEntityType);
+  dictionary[0] = id;
+  katana::ParallelSTL::fill(codes.begin(), codes.end(), uint8_t{0});
+  return MakeNarrow(dictionary, 1, std::move(codes));
+}
+
+katana::EntityTypeIDArray
+katana::EntityTypeIDArray::MakeIdentity(NUMAArray<uint8_t>&& ids) {
+  EntityTypeIDArray array;
+  for (size_t i = 0; i < kMaxNarrowTypes; ++i) {
+    array.dictionary_[i] = i;
+  }
+  array.dictionary_size_ = kMaxNarrowTypes;
+  array.is_identity_ = true;
+  array.codes_ = std::move(ids);
+  return array;
+}
+
+katana::EntityTypeIDArray
+katana::EntityTypeIDArray::MakeNarrow(
+    const Dictionary& dictionary, size_t dictionary_size,
+    NUMAArray<uint8_t>&& codes) {
+  KATANA_LOG_DEBUG_ASSERT(dictionary_size <= kMaxNarrowTypes);
+  EntityTypeIDArray array;
+  std::copy(
+      dictionary.begin(), dictionary.begin() + dictionary_size,
+      array.dictionary_.begin());
+  array.dictionary_size_ = dictionary_size;
+  array.codes_ = std::move(codes);
+  return array;
+}
+
+katana::EntityTypeIDArray
+katana::EntityTypeIDArray::MakeWide(NUMAArray<EntityTypeID>&& ids) {
+  EntityTypeIDArray array;
+  array.is_narrow_ = false;
+  array.ids_ = std::move(ids);
+  return array;
+}
+
+void
+katana::EntityTypeIDArray::FindEntitiesOfTypes(
+    const SetOfEntityTypeIDs& types, DynamicBitset* bitset) const {
+  constexpr size_t kBitsPerWord = 64;
+  size_t num_entities = size();
+  bitset->resize(num_entities);
+  auto& words = bitset->get_vec();
+
+  // compute each word from scratch, so no bits need to be cleared first and
+  // no two threads write the same word
+  auto find = [&](auto is_match) {
+    katana::do_all(
+        katana::iterate(size_t{0}, words.size()),
+        [&](size_t w) {
+          size_t begin = w * kBitsPerWord;
+          size_t end = std::min(num_entities, begin + kBitsPerWord);
+          uint64_t word = 0;
+          for (size_t i = begin; i < end; ++i) {
+            word |= uint64_t{is_match(i)} << (i - begin);
+          }
+          words[w].store(word, std::memory_order_relaxed);
+        },
+        katana::steal(), katana::no_stats());
+  };
+
+  if (!is_narrow_) {
+    find([&](size_t i) { return types.test(ids_[i]); });
+    return;
+  }
+
+  std::array<uint8_t, kMaxNarrowTypes> matches{};
+  for (size_t code = 0; code < dictionary_size_; ++code) {
+    matches[code] = types.test(dictionary_[code]);
+  }
+  const uint8_t* codes = codes_.data();
+  find([&](size_t i) { return matches[codes[i]]; });
+}
@@ -1,10 +1,17 @@
 #include "katana/GraphTopology.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <queue>
+#include <vector>
 
 #include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/PropertyGraph.h"
 #include "katana/Random.h"
+#include "katana/gstl.h"
 
 void
 katana::GraphTopology::Print() noexcept {
@@ -203,6 +210,13 @@ katana::EdgeShuffleTopology::SortEdgesByDestID() noexcept {
         auto e_beg = *Base::edges(node).begin();
         auto e_end = *Base::edges(node).end();
 
+        // inputs are often sorted already; checking is cheaper than sorting
+        if (std::is_sorted(
+                Base::GetDests().begin() + e_beg,
+                Base::GetDests().begin() + e_end)) {
+          return;
+        }
+
         // get iterators to locations to sort in the vector
         auto begin_sort_iter = katana::make_zip_iterator(
             edge_prop_indices_.begin() + e_beg,
@@ -301,7 +315,7 @@ katana::ShuffleTopology::MakeSortedByDegree(
     auto d1 = seed_topo.degree(i1);
     auto d2 = seed_topo.degree(i2);
     if (d1 == d2) {
-      return d1 < d2;
+      return i1 < i2;
     }
     return d1 < d2;
   };
@@ -325,46 +339,421 @@ katana::ShuffleTopology::MakeSortedByNodeType(
   return MakeNodeSortedTopo(seed_topo, cmp, NodeSortKind::kSortedByNodeType);
 }
 
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeSortedByPartition(
+    const katana::EdgeShuffleTopology& seed_topo,
+    const uint32_t* partition_ids) noexcept {
+  auto cmp = [&](const auto& i1, const auto& i2) {
+    auto p1 = partition_ids[i1];
+    auto p2 = partition_ids[i2];
+    if (p1 == p2) {
+      return i1 < i2;
+    }
+    return p1 < p2;
+  };
+
+  return MakeNodeSortedTopo(seed_topo, cmp, NodeSortKind::kAny);
+}
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeNodePermutedTopo(
+    const katana::EdgeShuffleTopology& seed_topo,
+    PropIndexVec&& node_prop_indices,
+    const NodeSortKind& node_sort_todo) noexcept {
+  GraphTopology::AdjIndexVec degrees;
+  degrees.allocateInterleaved(seed_topo.num_nodes());
+
+  katana::NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
+  old_to_new_map.allocateInterleaved(seed_topo.num_nodes());
+  // TODO(amber): given 32-bit node ids, put a check here that
+  // node_prop_indices.size() < 2^32
+  katana::do_all(
+      katana::iterate(size_t{0}, node_prop_indices.size()),
+      [&](auto i) {
+        // node_prop_indices[i] gives old node id
+        old_to_new_map[node_prop_indices[i]] = i;
+        degrees[i] = seed_topo.degree(node_prop_indices[i]);
+      },
+      katana::no_stats());
+
+  KATANA_LOG_DEBUG_ASSERT(
+      node_sort_todo != NodeSortKind::kSortedByDegree ||
+      std::is_sorted(degrees.begin(), degrees.end()));
+
+  katana::ParallelSTL::partial_sum(
+      degrees.begin(), degrees.end(), degrees.begin());
+
+  GraphTopologyTypes::EdgeDestVec new_dest_vec;
+  new_dest_vec.allocateInterleaved(seed_topo.num_edges());
+
+  GraphTopologyTypes::PropIndexVec edge_prop_indices;
+  edge_prop_indices.allocateInterleaved(seed_topo.num_edges());
+
+  katana::do_all(
+      katana::iterate(seed_topo.all_nodes()),
+      [&](auto old_srd_id) {
+        auto new_srd_id = old_to_new_map[old_srd_id];
+        auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
+
+        for (auto e : seed_topo.edges(old_srd_id)) {
+          auto new_edge_dest = old_to_new_map[seed_topo.edge_dest(e)];
+
+          auto new_edge_id = new_out_index;
+          ++new_out_index;
+          KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
+
+          new_dest_vec[new_edge_id] = new_edge_dest;
+
+          // copy over edge_property_index mapping from old edge to new edge
+          edge_prop_indices[new_edge_id] = seed_topo.edge_property_index(e);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  // Relabeling changes the destination IDs, so whatever order the edges of
+  // seed_topo were sorted in no longer holds
+  return std::make_unique<ShuffleTopology>(ShuffleTopology{
+      seed_topo.transpose_state(), node_sort_todo, EdgeSortKind::kAny,
+      std::move(degrees), std::move(node_prop_indices),
+      std::move(new_dest_vec), std::move(edge_prop_indices)});
+}
+
+namespace {
+
+using PropIndexVec = katana::GraphTopologyTypes::PropIndexVec;
+using Node = katana::GraphTopologyTypes::Node;
+
+// Gorder scores a candidate against this many of the last placed nodes
+constexpr size_t kGorderWindow = 5;
+// number of consecutive nodes of the breadth first order that one thread
+// reorders with Gorder
+constexpr size_t kGorderChunkSize = size_t{1} << 14;
+
+PropIndexVec
+NodesByDegree(const katana::EdgeShuffleTopology& topo, bool decreasing) {
+  PropIndexVec nodes;
+  nodes.allocateInterleaved(topo.num_nodes());
+  katana::ParallelSTL::iota(
+      nodes.begin(), nodes.end(), katana::GraphTopologyTypes::PropertyIndex{0});
+  katana::ParallelSTL::sort(
+      nodes.begin(), nodes.end(), [&](const auto& i1, const auto& i2) {
+        auto d1 = topo.degree(i1);
+        auto d2 = topo.degree(i2);
+        if (d1 == d2) {
+          return i1 < i2;
+        }
+        return decreasing ? d1 > d2 : d1 < d2;
+      });
+  return nodes;
+}
+
+/// Breadth first search from root over the nodes not visited yet, appending
+/// them to order at end. With sort_by_degree, the new neighbors of a node
+/// are appended by increasing degree. \returns the new end of order
+size_t
+AppendBreadthFirst(
+    const katana::EdgeShuffleTopology& topo, Node root, bool sort_by_degree,
+    std::vector<uint8_t>* visited, PropIndexVec* order, size_t end) {
+  (*visited)[root] = 1;
+  (*order)[end++] = root;
+  for (size_t head = end - 1; head < end; ++head) {
+    Node node = (*order)[head];
+    size_t first = end;
+    for (auto e : topo.edges(node)) {
+      Node dest = topo.edge_dest(e);
+      if (!(*visited)[dest]) {
+        (*visited)[dest] = 1;
+        (*order)[end++] = dest;
+      }
+    }
+    if (sort_by_degree) {
+      std::sort(
+          order->begin() + first, order->begin() + end,
+          [&](const auto& i1, const auto& i2) {
+            auto d1 = topo.degree(i1);
+            auto d2 = topo.degree(i2);
+            if (d1 == d2) {
+              return i1 < i2;
+            }
+            return d1 < d2;
+          });
+    }
+  }
+  return end;
+}
+
+/// George and Liu's heuristic for a node far from all others in the
+/// component of root: the node of lowest degree in the last level of a
+/// breadth first search from root. The search uses order past end as its
+/// queue and unmarks the nodes it visited before returning.
+Node
+PseudoPeripheralNode(
+    const katana::EdgeShuffleTopology& topo, Node root,
+    std::vector<uint8_t>* visited, PropIndexVec* order, size_t end) {
+  (*visited)[root] = 1;
+  (*order)[end] = root;
+  size_t level_begin = end;
+  size_t level_end = end + 1;
+  size_t tail = level_end;
+  while (true) {
+    for (size_t head = level_begin; head < level_end; ++head) {
+      for (auto e : topo.edges((*order)[head])) {
+        Node dest = topo.edge_dest(e);
+        if (!(*visited)[dest]) {
+          (*visited)[dest] = 1;
+          (*order)[tail++] = dest;
+        }
+      }
+    }
+    if (tail == level_end) {
+      break;
+    }
+    level_begin = level_end;
+    level_end = tail;
+  }
+
+  Node best = (*order)[level_begin];
+  for (size_t i = level_begin; i < level_end; ++i) {
+    Node node = (*order)[i];
+    if (topo.degree(node) < topo.degree(best) ||
+        (topo.degree(node) == topo.degree(best) && node < best)) {
+      best = node;
+    }
+  }
+  for (size_t i = end; i < level_end; ++i) {
+    (*visited)[(*order)[i]] = 0;
+  }
+  return best;
+}
+
+PropIndexVec
+BreadthFirstOrder(const katana::EdgeShuffleTopology& topo) {
+  auto roots = NodesByDegree(topo, true);
+  PropIndexVec order;
+  order.allocateInterleaved(topo.num_nodes());
+  std::vector<uint8_t> visited(topo.num_nodes(), 0);
+  size_t end = 0;
+  for (auto root : roots) {
+    if (!visited[root]) {
+      end = AppendBreadthFirst(topo, root, false, &visited, &order, end);
+    }
+  }
+  return order;
+}
+
+struct GorderScratch {
+  std::vector<int64_t> score;
+  std::vector<uint8_t> placed;
+  // (score, -index in chunk); entries whose score is out of date are
+  // skipped when popped
+  std::priority_queue<std::pair<int64_t, int64_t>> candidates;
+};
+
+/// Greedy Gorder over base[begin, end): repeatedly place the node with the
+/// most neighbors and common neighbors among the last kGorderWindow placed
+/// nodes, or the next node of base if no node scores.
+void
+GorderChunk(
+    const katana::EdgeShuffleTopology& topo, const PropIndexVec& base,
+    const katana::NUMAArray<uint64_t>& position, size_t begin, size_t end,
+    size_t max_sibling_degree, PropIndexVec* order, GorderScratch* scratch) {
+  const size_t size = end - begin;
+  auto& score = scratch->score;
+  auto& placed = scratch->placed;
+  auto& candidates = scratch->candidates;
+  score.assign(size, 0);
+  placed.assign(size, 0);
+  candidates = {};
+
+  auto bump = [&](Node node, int64_t delta) {
+    uint64_t pos = position[node];
+    if (pos < begin || pos >= end || placed[pos - begin]) {
+      return;
+    }
+    int64_t index = pos - begin;
+    score[index] += delta;
+    candidates.emplace(score[index], -index);
+  };
+  auto update = [&](Node node, int64_t delta) {
+    for (auto e : topo.edges(node)) {
+      Node dest = topo.edge_dest(e);
+      bump(dest, delta);
+      // a hub would add to the score of too many nodes to be informative
+      if (topo.degree(dest) > max_sibling_degree) {
+        continue;
+      }
+      for (auto e2 : topo.edges(dest)) {
+        Node sibling = topo.edge_dest(e2);
+        if (sibling != node) {
+          bump(sibling, delta);
+        }
+      }
+    }
+  };
+
+  size_t next_unplaced = 0;
+  for (size_t i = 0; i < size; ++i) {
+    size_t index = size;
+    while (!candidates.empty()) {
+      auto [candidate_score, negated_index] = candidates.top();
+      size_t candidate = -negated_index;
+      if (placed[candidate] || score[candidate] != candidate_score) {
+        candidates.pop();
+        continue;
+      }
+      if (candidate_score > 0) {
+        index = candidate;
+      }
+      break;
+    }
+    if (index == size) {
+      while (placed[next_unplaced]) {
+        ++next_unplaced;
+      }
+      index = next_unplaced;
+    }
+
+    placed[index] = 1;
+    Node node = base[begin + index];
+    (*order)[begin + i] = node;
+    update(node, 1);
+    if (i >= kGorderWindow) {
+      update((*order)[begin + i - kGorderWindow], -1);
+    }
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeReverseCuthillMcKee(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  auto roots = NodesByDegree(seed_topo, false);
+  PropIndexVec order;
+  order.allocateInterleaved(seed_topo.num_nodes());
+  std::vector<uint8_t> visited(seed_topo.num_nodes(), 0);
+  size_t end = 0;
+  for (auto root : roots) {
+    if (visited[root]) {
+      continue;
+    }
+    Node start = PseudoPeripheralNode(seed_topo, root, &visited, &order, end);
+    end = AppendBreadthFirst(seed_topo, start, true, &visited, &order, end);
+  }
+  std::reverse(order.begin(), order.end());
+
+  return MakeNodePermutedTopo(
+      seed_topo, std::move(order), NodeSortKind::kReverseCuthillMcKee);
+}
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeGorder(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  const size_t num_nodes = seed_topo.num_nodes();
+  auto base = BreadthFirstOrder(seed_topo);
+  katana::NUMAArray<uint64_t> position;
+  position.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t i) { position[base[i]] = i; }, katana::no_stats());
+
+  const size_t max_sibling_degree = std::max<size_t>(
+      static_cast<size_t>(std::sqrt(static_cast<double>(num_nodes))), 1);
+  PropIndexVec order;
+  order.allocateInterleaved(num_nodes);
+  katana::PerThreadStorage<GorderScratch> scratch;
+  const size_t num_chunks =
+      (num_nodes + kGorderChunkSize - 1) / kGorderChunkSize;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_chunks),
+      [&](size_t chunk) {
+        size_t begin = chunk * kGorderChunkSize;
+        size_t end = std::min(num_nodes, begin + kGorderChunkSize);
+        GorderChunk(
+            seed_topo, base, position, begin, end, max_sibling_degree, &order,
+            scratch.getLocal());
+      },
+      katana::steal(), katana::chunk_size<1>(), katana::no_stats(),
+      katana::loopname("Gorder"));
+
+  return MakeNodePermutedTopo(
+      seed_topo, std::move(order), NodeSortKind::kGorder);
+}
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeDegreeBucketed(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  // 0 for isolated nodes, else 1 + floor(log2(degree))
+  auto bucket = [&](const auto& node) {
+    uint64_t degree = seed_topo.degree(node);
+    return degree == 0 ? 0 : 64 - __builtin_clzll(degree);
+  };
+  auto cmp = [&](const auto& i1, const auto& i2) {
+    auto b1 = bucket(i1);
+    auto b2 = bucket(i2);
+    if (b1 == b2) {
+      return i1 < i2;
+    }
+    return b1 > b2;
+  };
+
+  return MakeNodeSortedTopo(seed_topo, cmp, NodeSortKind::kDegreeBucketed);
+}
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeBreadthFirst(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  return MakeNodePermutedTopo(
+      seed_topo, BreadthFirstOrder(seed_topo), NodeSortKind::kBreadthFirst);
+}
+
 std::unique_ptr<katana::CondensedTypeIDMap>
 katana::CondensedTypeIDMap::MakeFromEdgeTypes(
     const katana::PropertyGraph* pg) noexcept {
   TypeIDToIndexMap edge_type_to_index;
   IndexToTypeIDMap edge_index_to_type;
 
-  katana::PerThreadStorage<katana::gstl::Set<EntityType>> edgeTypes;
+  constexpr size_t kNumEntityTypes =
+      size_t{std::numeric_limits<EntityType>::max()} + 1;
+  katana::PerThreadStorage<std::vector<bool>> edgeTypes;
 
   const auto& topo = pg->topology();
 
-  katana::do_all(
-      katana::iterate(Edge{0}, topo.num_edges()),
-      [&](const Edge& e) {
-        EntityType type = pg->GetTypeOfEdge(e);
-        edgeTypes.getLocal()->insert(type);
-      },
-      katana::no_stats());
+  katana::on_each([&](unsigned tid, unsigned total) {
+    std::vector<bool>& seen = *edgeTypes.getLocal();
+    seen.resize(kNumEntityTypes);
+    auto [begin, end] = katana::block_range(
+        Edge{0}, Edge{topo.num_edges()}, tid, total);
+    for (Edge e = begin; e != end; ++e) {
+      EntityType type = pg->GetTypeOfEdge(e);
+      if (!seen[type]) {
+        seen[type] = true;
+      }
+    }
+  });
 
-  // ordered map
-  std::set<EntityType> mergedSet;
-  for (uint32_t i = 0; i < katana::activeThreads; ++i) {
-    auto& edgeTypesSet = *edgeTypes.getRemote(i);
-    for (auto edgeType : edgeTypesSet) {
-      mergedSet.insert(edgeType);
+  // in increasing order of type
+  for (size_t type = 0; type < kNumEntityTypes; ++type) {
+    for (uint32_t i = 0; i < edgeTypes.size(); ++i) {
+      const std::vector<bool>& seen = *edgeTypes.getRemote(i);
+      if (!seen.empty() && seen[type]) {
+        edge_index_to_type.emplace_back(type);
+        break;
+      }
     }
   }
 
-  // unordered map
-  uint32_t num_edge_types = 0u;
-  for (const auto& edgeType : mergedSet) {
-    edge_type_to_index[edgeType] = num_edge_types++;
-    edge_index_to_type.emplace_back(edgeType);
+  if (!edge_index_to_type.empty()) {
+    edge_type_to_index.resize(
+        size_t(edge_index_to_type.back()) + 1, kInvalidIndex);
+  }
+  for (uint32_t index = 0; index < edge_index_to_type.size(); ++index) {
+    edge_type_to_index[edge_index_to_type[index]] = index;
   }
-
-  // TODO(amber): introduce a per-thread-container type that frees memory
-  // correctly
-  katana::on_each([&](unsigned, unsigned) {
-    // free up memory by resetting
-    *edgeTypes.getLocal() = gstl::Set<EntityType>();
-  });
 
   return std::make_unique<CondensedTypeIDMap>(CondensedTypeIDMap{
       std::move(edge_type_to_index), std::move(edge_index_to_type)});
@@ -461,10 +850,10 @@ CheckTopology(const katana::PropertyGraph* pg, const Topo* t) noexcept {
 }
 
 katana::EdgeShuffleTopology*
-katana::PGViewCache::BuildOrGetEdgeShuffTopo(
+katana::PGViewCache::FindEdgeShuffTopo(
     const katana::PropertyGraph* pg,
     const katana::EdgeShuffleTopology::TransposeKind& tpose_kind,
-    const katana::EdgeShuffleTopology::EdgeSortKind& sort_kind) noexcept {
+    const katana::EdgeShuffleTopology::EdgeSortKind& sort_kind) const noexcept {
   auto pred = [&](const auto& topo_ptr) {
     return topo_ptr->is_valid() && topo_ptr->has_transpose_state(tpose_kind) &&
            topo_ptr->has_edges_sorted_by(sort_kind);
@@ -472,71 +861,116 @@ katana::PGViewCache::BuildOrGetEdgeShuffTopo(
   auto it =
       std::find_if(edge_shuff_topos_.begin(), edge_shuff_topos_.end(), pred);
 
-  if (it != edge_shuff_topos_.end()) {
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
-    return it->get();
-  } else {
-    edge_shuff_topos_.emplace_back(
-        EdgeShuffleTopology::Make(pg, tpose_kind, sort_kind));
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, edge_shuff_topos_.back().get()));
-    return edge_shuff_topos_.back().get();
+  if (it == edge_shuff_topos_.end()) {
+    return nullptr;
   }
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
+  return it->get();
 }
 
 katana::ShuffleTopology*
-katana::PGViewCache::BuildOrGetShuffTopo(
+katana::PGViewCache::FindShuffTopo(
     const katana::PropertyGraph* pg,
     const katana::EdgeShuffleTopology::TransposeKind& tpose_kind,
     const katana::ShuffleTopology::NodeSortKind& node_sort_todo,
-    const katana::EdgeShuffleTopology::EdgeSortKind& edge_sort_todo) noexcept {
+    const katana::EdgeShuffleTopology::EdgeSortKind& edge_sort_todo)
+    const noexcept {
   auto pred = [&](const auto& topo_ptr) {
     return topo_ptr->is_valid() && topo_ptr->has_transpose_state(tpose_kind) &&
            topo_ptr->has_edges_sorted_by(edge_sort_todo) &&
            topo_ptr->has_nodes_sorted_by(node_sort_todo);
   };
-
   auto it =
       std::find_if(fully_shuff_topos_.begin(), fully_shuff_topos_.end(), pred);
 
-  if (it != fully_shuff_topos_.end()) {
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
-    return it->get();
-  } else {
-    auto e_topo = BuildOrGetEdgeShuffTopo(pg, tpose_kind, edge_sort_todo);
-    KATANA_LOG_DEBUG_ASSERT(e_topo->has_transpose_state(tpose_kind));
-
-    fully_shuff_topos_.emplace_back(ShuffleTopology::MakeFromTopo(
-        pg, *e_topo, node_sort_todo, edge_sort_todo));
-
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, fully_shuff_topos_.back().get()));
-    return fully_shuff_topos_.back().get();
+  if (it == fully_shuff_topos_.end()) {
+    return nullptr;
   }
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
+  return it->get();
 }
 
 katana::EdgeTypeAwareTopology*
-katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
+katana::PGViewCache::FindEdgeTypeAwareTopo(
     const katana::PropertyGraph* pg,
-    const katana::EdgeShuffleTopology::TransposeKind& tpose_kind) noexcept {
+    const katana::EdgeShuffleTopology::TransposeKind& tpose_kind)
+    const noexcept {
   auto pred = [&](const auto& topo_ptr) {
     return topo_ptr->is_valid() && topo_ptr->has_transpose_state(tpose_kind);
   };
   auto it = std::find_if(
       edge_type_aware_topos_.begin(), edge_type_aware_topos_.end(), pred);
 
-  if (it != edge_type_aware_topos_.end()) {
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
-    return it->get();
-  } else {
-    auto sorted_topo = BuildOrGetEdgeShuffTopo(
-        pg, tpose_kind, EdgeShuffleTopology::EdgeSortKind::kSortedByEdgeType);
-    auto edge_type_index = BuildOrGetEdgeTypeIndex(pg);
-    edge_type_aware_topos_.emplace_back(
-        EdgeTypeAwareTopology::MakeFrom(pg, edge_type_index, sorted_topo));
-
-    KATANA_LOG_DEBUG_ASSERT(
-        CheckTopology(pg, edge_type_aware_topos_.back().get()));
-    return edge_type_aware_topos_.back().get();
+  if (it == edge_type_aware_topos_.end()) {
+    return nullptr;
+  }
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
+  return it->get();
+}
+
+katana::EdgeShuffleTopology*
+katana::PGViewCache::BuildOrGetEdgeShuffTopo(
+    const katana::PropertyGraph* pg,
+    const katana::EdgeShuffleTopology::TransposeKind& tpose_kind,
+    const katana::EdgeShuffleTopology::EdgeSortKind& sort_kind) noexcept {
+  if (auto topo = FindEdgeShuffTopo(pg, tpose_kind, sort_kind); topo) {
+    return topo;
+  }
+
+  edge_shuff_topos_.emplace_back(
+      EdgeShuffleTopology::Make(pg, tpose_kind, sort_kind));
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, edge_shuff_topos_.back().get()));
+  return edge_shuff_topos_.back().get();
+}
+
+katana::ShuffleTopology*
+katana::PGViewCache::BuildOrGetShuffTopo(
+    const katana::PropertyGraph* pg,
+    const katana::EdgeShuffleTopology::TransposeKind& tpose_kind,
+    const katana::ShuffleTopology::NodeSortKind& node_sort_todo,
+    const katana::EdgeShuffleTopology::EdgeSortKind& edge_sort_todo) noexcept {
+  if (auto topo = FindShuffTopo(pg, tpose_kind, node_sort_todo, edge_sort_todo);
+      topo) {
+    return topo;
+  }
+
+  // Shuffling the nodes destroys the edge order of the seed, so sorting the
+  // seed first would be wasted work. Reuse any cached topology with the right
+  // transpose state, or else a temporary unsorted copy.
+  std::unique_ptr<EdgeShuffleTopology> tmp_seed;
+  auto e_topo = FindEdgeShuffTopo(
+      pg, tpose_kind, EdgeShuffleTopology::EdgeSortKind::kAny);
+  if (!e_topo) {
+    tmp_seed = EdgeShuffleTopology::Make(
+        pg, tpose_kind, EdgeShuffleTopology::EdgeSortKind::kAny);
+    e_topo = tmp_seed.get();
+  }
+  KATANA_LOG_DEBUG_ASSERT(e_topo->has_transpose_state(tpose_kind));
+
+  fully_shuff_topos_.emplace_back(ShuffleTopology::MakeFromTopo(
+      pg, *e_topo, node_sort_todo, edge_sort_todo));
+
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, fully_shuff_topos_.back().get()));
+  return fully_shuff_topos_.back().get();
+}
+
+katana::EdgeTypeAwareTopology*
+katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
+    const katana::PropertyGraph* pg,
+    const katana::EdgeShuffleTopology::TransposeKind& tpose_kind) noexcept {
+  if (auto topo = FindEdgeTypeAwareTopo(pg, tpose_kind); topo) {
+    return topo;
   }
+
+  auto sorted_topo = BuildOrGetEdgeShuffTopo(
+      pg, tpose_kind, EdgeShuffleTopology::EdgeSortKind::kSortedByEdgeType);
+  auto edge_type_index = BuildOrGetEdgeTypeIndex(pg);
+  edge_type_aware_topos_.emplace_back(
+      EdgeTypeAwareTopology::MakeFrom(pg, edge_type_index, sorted_topo));
+
+  KATANA_LOG_DEBUG_ASSERT(
+      CheckTopology(pg, edge_type_aware_topos_.back().get()));
+  return edge_type_aware_topos_.back().get();
 }
 
 katana::GraphTopology
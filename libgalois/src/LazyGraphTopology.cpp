@@ -0,0 +1,209 @@
+#include "katana/LazyGraphTopology.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "tsuba/Errors.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+/// Whether index is in one of the sorted, disjoint ranges
+bool
+InRanges(
+    const std::vector<std::pair<uint64_t, uint64_t>>& ranges, uint64_t index) {
+  auto it = std::upper_bound(
+      ranges.begin(), ranges.end(), index,
+      [](uint64_t i, const auto& range) { return i < range.first; });
+  return it != ranges.begin() && std::prev(it)->second >= index;
+}
+
+}  // namespace
+
+katana::LazyGraphTopology::LazyGraphTopology(
+    tsuba::RDGPrefix&& prefix, uint64_t max_resident_pages)
+    : prefix_(std::move(prefix)),
+      dests_(prefix_.out_dests()),
+      page_shift_(__builtin_ctzll(prefix_.file_storage().page_size())),
+      first_page_(prefix_.view_offset() >> page_shift_),
+      max_resident_pages_(max_resident_pages) {
+  if (num_edges() > 0) {
+    num_pages_ = page_index(num_edges() - 1) + 1;
+  }
+  pages_ = std::make_unique<std::atomic<uint8_t>[]>(num_pages_);
+  for (uint64_t i = 0; i < num_pages_; ++i) {
+    pages_[i] = kAbsent;
+  }
+  // loading the out indexes loaded the page they share with the
+  // destinations
+  first_page_shared_ =
+      num_pages_ > 0 &&
+      (prefix_.view_offset() & ((1UL << page_shift_) - 1)) != 0;
+  if (first_page_shared_) {
+    pages_[0] = kReady;
+    resident_pages_ = 1;
+  }
+}
+
+katana::Result<std::unique_ptr<katana::LazyGraphTopology>>
+katana::LazyGraphTopology::Make(
+    const std::string& rdg_name, uint64_t max_resident_bytes) {
+  tsuba::RDGHandle handle =
+      KATANA_CHECKED(tsuba::Open(rdg_name, tsuba::kReadOnly));
+  auto prefix_res = tsuba::RDGPrefix::Make(handle);
+  KATANA_CHECKED(tsuba::Close(handle));
+  tsuba::RDGPrefix prefix = KATANA_CHECKED_CONTEXT(
+      std::move(prefix_res), "loading topology prefix of {}", rdg_name);
+
+  if (!prefix.file_storage().Valid()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} has no topology", rdg_name);
+  }
+  if (prefix.version() != 1) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "unsupported topology version {}",
+        prefix.version());
+  }
+  uint64_t dests_end =
+      prefix.view_offset() + prefix.num_edges() * sizeof(Node);
+  if (prefix.file_storage().size() < dests_end) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "topology size: {} expected at least {}",
+        prefix.file_storage().size(), dests_end);
+  }
+
+  uint64_t page_size = prefix.file_storage().page_size();
+  uint64_t max_resident_pages =
+      (max_resident_bytes + page_size - 1) / page_size;
+  return std::unique_ptr<LazyGraphTopology>(
+      new LazyGraphTopology(std::move(prefix), max_resident_pages));
+}
+
+std::pair<uint64_t, uint64_t>
+katana::LazyGraphTopology::PageBytes(uint64_t index) const {
+  uint64_t begin = (first_page_ + index) << page_shift_;
+  return std::make_pair(begin, begin + (1UL << page_shift_));
+}
+
+void
+katana::LazyGraphTopology::Fault(uint64_t index) const {
+  std::lock_guard<std::mutex> lock(fault_mutex_);
+  std::atomic<uint8_t>& state = pages_[index];
+  uint8_t current = state.load(std::memory_order_acquire);
+  if (current == kReady || current == kReferenced) {
+    return;
+  }
+
+  auto [begin, end] = PageBytes(index);
+  // waits for the page if Prefetch already started fetching it
+  if (auto res = prefix_.file_storage().Fill(begin, end, true); !res) {
+    KATANA_LOG_FATAL(
+        "fetching edge destinations at {}: {}", begin, res.error());
+  }
+  if (current == kAbsent) {
+    ++resident_pages_;
+  }
+  ++num_faults_;
+  state.store(kReferenced, std::memory_order_release);
+}
+
+katana::Result<void>
+katana::LazyGraphTopology::Evict(uint64_t target, const PageRanges& keep) {
+  // Two sweeps of the clock are enough to clear every reference bit and
+  // release every page that can be released
+  for (uint64_t step = 0;
+       resident_pages_ > target && step < 2 * num_pages_; ++step) {
+    uint64_t index = clock_hand_;
+    clock_hand_ = (clock_hand_ + 1) % num_pages_;
+    if (index == 0 && first_page_shared_) {
+      continue;
+    }
+
+    std::atomic<uint8_t>& state = pages_[index];
+    uint8_t current = state.load(std::memory_order_relaxed);
+    if (current == kAbsent || InRanges(keep, index)) {
+      continue;
+    }
+    if (current == kReferenced) {
+      state.store(kReady, std::memory_order_relaxed);
+      continue;
+    }
+
+    auto [begin, end] = PageBytes(index);
+    KATANA_CHECKED_CONTEXT(
+        prefix_.file_storage().Release(begin, end),
+        "releasing edge destinations at {}", begin);
+    state.store(kAbsent, std::memory_order_relaxed);
+    --resident_pages_;
+    ++num_released_pages_;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::LazyGraphTopology::Prefetch(const std::vector<Node>& nodes) {
+  PageRanges needed;
+  for (Node node : nodes) {
+    auto range = edges(node);
+    if (range.empty()) {
+      continue;
+    }
+    needed.emplace_back(
+        page_index(*range.begin()), page_index(*range.end() - 1));
+  }
+  std::sort(needed.begin(), needed.end());
+
+  // merge overlapping and adjacent ranges so that each run of missing pages
+  // is fetched with one read
+  PageRanges merged;
+  for (const auto& range : needed) {
+    if (!merged.empty() && range.first <= merged.back().second + 1) {
+      merged.back().second = std::max(merged.back().second, range.second);
+    } else {
+      merged.emplace_back(range);
+    }
+  }
+
+  uint64_t missing = 0;
+  for (const auto& [first, last] : merged) {
+    for (uint64_t i = first; i <= last; ++i) {
+      missing += pages_[i].load(std::memory_order_relaxed) == kAbsent;
+    }
+  }
+  if (resident_pages_ + missing > max_resident_pages_) {
+    uint64_t target =
+        max_resident_pages_ > missing ? max_resident_pages_ - missing : 0;
+    KATANA_CHECKED(Evict(target, merged));
+  }
+
+  for (const auto& [first, last] : merged) {
+    uint64_t i = first;
+    while (i <= last) {
+      if (pages_[i].load(std::memory_order_relaxed) != kAbsent) {
+        ++i;
+        continue;
+      }
+      uint64_t run_end = i;
+      while (run_end + 1 <= last &&
+             pages_[run_end + 1].load(std::memory_order_relaxed) == kAbsent) {
+        ++run_end;
+      }
+      uint64_t begin = PageBytes(i).first;
+      uint64_t end = PageBytes(run_end).second;
+      KATANA_CHECKED_CONTEXT(
+          prefix_.file_storage().Fill(begin, end, false),
+          "prefetching edge destinations at {}", begin);
+      for (uint64_t j = i; j <= run_end; ++j) {
+        pages_[j].store(kFetching, std::memory_order_relaxed);
+      }
+      resident_pages_ += run_end - i + 1;
+      i = run_end + 1;
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::LazyGraphTopology::Trim() {
+  return Evict(max_resident_pages_, PageRanges{});
+}
@@ -3,10 +3,21 @@
 #include <stdio.h>
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <map>
 #include <memory>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "katana/ArrowInterchange.h"
+#include "katana/BitMath.h"
+#include "katana/DynamicBitset.h"
 #include "katana/Iterators.h"
 #include "katana/Logging.h"
 #include "katana/Loops.h"
@@ -14,6 +25,7 @@
 #include "katana/PerThreadStorage.h"
 #include "katana/Platform.h"
 #include "katana/Properties.h"
+#include "katana/PropertyMemoryManager.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
@@ -143,73 +155,433 @@ WriteTopology(const katana::GraphTopology& topology) {
   return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
 }
 
+/// Type ID array files written before EntityTypeIDs were widened hold the
+/// number of entities followed by one EntityTypeID byte per entity. Arrays
+/// that cannot be stored that way start with this marker instead, followed by
+/// the number of entities, the bytes per entity, the size of the dictionary,
+/// the dictionary padded to a multiple of 8 bytes, and the entities.
+constexpr uint64_t kEncodedEntityTypeIDsMarker =
+    std::numeric_limits<uint64_t>::max();
+constexpr uint64_t kEncodedEntityTypeIDsHeaderWords = 4;
+
 /// MapEntityTypeIDsFromFile takes a file buffer of a node or edge Type set ID file
 /// and extracts the property graph type set ids from it. It is an alternative way
 /// of extracting EntityTypeIDs and extraction from properties will be depreciated in
 /// favor of this method.
 katana::Result<katana::PropertyGraph::EntityTypeIDArray>
 MapEntityTypeIDsArray(const tsuba::FileView& file_view) {
-  const auto* data = file_view.ptr<uint64_t>();
-  const int64_t type_ID_array_size = data[0];
-
-  if (file_view.size() == 0) {
+  if (file_view.size() < sizeof(uint64_t)) {
     return katana::ErrorCode::InvalidArgument;
   }
+  const auto* header = file_view.ptr<uint64_t>();
+  const auto* bytes = file_view.ptr<uint8_t>();
+
+  if (header[0] != kEncodedEntityTypeIDsMarker) {
+    const uint64_t type_ID_array_size = header[0];
+    if (file_view.size() - sizeof(uint64_t) < type_ID_array_size) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "type id array of {} entities is only {} bytes", type_ID_array_size,
+          file_view.size());
+    }
+    const uint8_t* type_IDs_array = &bytes[sizeof(uint64_t)];
+
+    katana::NUMAArray<uint8_t> entity_type_id_array;
+    entity_type_id_array.allocateInterleaved(type_ID_array_size);
+    katana::ParallelSTL::copy(
+        &type_IDs_array[0], &type_IDs_array[type_ID_array_size],
+        entity_type_id_array.begin());
+    return katana::EntityTypeIDArray::MakeIdentity(
+        std::move(entity_type_id_array));
+  }
 
-  const katana::EntityTypeID* type_IDs_array =
-      reinterpret_cast<const katana::EntityTypeID*>(&data[1]);
+  uint64_t offset = kEncodedEntityTypeIDsHeaderWords * sizeof(uint64_t);
+  if (file_view.size() < offset) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "type id array header is only {} bytes", file_view.size());
+  }
+  const uint64_t num_entities = header[1];
+  const uint64_t width = header[2];
+  const uint64_t dictionary_size = header[3];
+  uint64_t dictionary_bytes =
+      katana::AlignUp<uint64_t>(dictionary_size * sizeof(katana::EntityTypeID));
+  if (dictionary_size > katana::EntityTypeIDArray::kMaxNarrowTypes ||
+      (width != sizeof(uint8_t) && width != sizeof(katana::EntityTypeID)) ||
+      file_view.size() < offset + dictionary_bytes ||
+      num_entities > (file_view.size() - offset - dictionary_bytes) / width) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "type id array of {} bytes has {} entities of {} bytes and a "
+        "dictionary of {} types",
+        file_view.size(), num_entities, width, dictionary_size);
+  }
 
-  KATANA_LOG_DEBUG_ASSERT(type_IDs_array != nullptr);
+  if (width == sizeof(katana::EntityTypeID)) {
+    const auto* ids =
+        reinterpret_cast<const katana::EntityTypeID*>(&bytes[offset]);
+    katana::NUMAArray<katana::EntityTypeID> entity_type_id_array;
+    entity_type_id_array.allocateInterleaved(num_entities);
+    katana::ParallelSTL::copy(
+        &ids[0], &ids[num_entities], entity_type_id_array.begin());
+    return katana::EntityTypeIDArray::MakeWide(std::move(entity_type_id_array));
+  }
 
-  // allocate type IDs array
-  katana::PropertyGraph::EntityTypeIDArray entity_type_id_array;
-  entity_type_id_array.allocateInterleaved(type_ID_array_size);
+  katana::EntityTypeIDArray::Dictionary dictionary;
+  std::memcpy(
+      dictionary.data(), &bytes[offset],
+      dictionary_size * sizeof(katana::EntityTypeID));
+  offset += dictionary_bytes;
 
+  katana::NUMAArray<uint8_t> codes;
+  codes.allocateInterleaved(num_entities);
   katana::ParallelSTL::copy(
-      &type_IDs_array[0], &type_IDs_array[type_ID_array_size],
-      entity_type_id_array.begin());
+      &bytes[offset], &bytes[offset + num_entities], codes.begin());
+  return katana::EntityTypeIDArray::MakeNarrow(
+      dictionary, dictionary_size, std::move(codes));
+}
 
-  return katana::MakeResult(std::move(entity_type_id_array));
+katana::Result<void>
+WriteToFrame(tsuba::FileFrame* ff, const void* data, uint64_t size) {
+  if (size == 0) {
+    return katana::ResultSuccess();
+  }
+  arrow::Status aro_sts = ff->Write(data, size);
+  if (!aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+  return katana::ResultSuccess();
 }
 
 katana::Result<std::unique_ptr<tsuba::FileFrame>>
 WriteEntityTypeIDsArray(
-    const katana::NUMAArray<katana::EntityTypeID>& entity_type_id_array) {
+    const katana::PropertyGraph::EntityTypeIDArray& entity_type_id_array) {
   auto ff = std::make_unique<tsuba::FileFrame>();
 
   if (auto res = ff->Init(); !res) {
     return res.error();
   }
 
-  uint64_t data[1] = {entity_type_id_array.size()};
-  arrow::Status aro_sts = ff->Write(&data, sizeof(uint64_t));
+  if (entity_type_id_array.is_identity()) {
+    uint64_t data[1] = {entity_type_id_array.size()};
+    KATANA_CHECKED(WriteToFrame(ff.get(), &data, sizeof(data)));
+    KATANA_CHECKED(WriteToFrame(
+        ff.get(), entity_type_id_array.codes().data(),
+        entity_type_id_array.size()));
+    return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+  }
 
-  if (!aro_sts.ok()) {
-    return tsuba::ArrowToTsuba(aro_sts.code());
+  bool is_narrow = entity_type_id_array.is_narrow();
+  uint64_t dictionary_size =
+      is_narrow ? entity_type_id_array.dictionary_size() : 0;
+  uint64_t header[kEncodedEntityTypeIDsHeaderWords] = {
+      kEncodedEntityTypeIDsMarker,
+      entity_type_id_array.size(),
+      is_narrow ? sizeof(uint8_t) : sizeof(katana::EntityTypeID),
+      dictionary_size,
+  };
+  KATANA_CHECKED(WriteToFrame(ff.get(), &header, sizeof(header)));
+
+  if (is_narrow) {
+    // the dictionary is padded with kInvalidEntityType
+    KATANA_CHECKED(WriteToFrame(
+        ff.get(), entity_type_id_array.dictionary().data(),
+        katana::AlignUp<uint64_t>(
+            dictionary_size * sizeof(katana::EntityTypeID))));
+    KATANA_CHECKED(WriteToFrame(
+        ff.get(), entity_type_id_array.codes().data(),
+        entity_type_id_array.size()));
+  } else {
+    KATANA_CHECKED(WriteToFrame(
+        ff.get(), entity_type_id_array.ids().data(),
+        entity_type_id_array.size() * sizeof(katana::EntityTypeID)));
   }
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
 
-  if (entity_type_id_array.size()) {
-    const katana::EntityTypeID* raw = entity_type_id_array.data();
-    auto buf = arrow::Buffer::Wrap(raw, entity_type_id_array.size());
-    aro_sts = ff->Write(buf);
-    if (!aro_sts.ok()) {
-      return tsuba::ArrowToTsuba(aro_sts.code());
+/// \returns the entity types of \p manager that have any of the entity types
+/// \p entity_type_ids, i.e., the union of their supertype closures
+katana::Result<katana::SetOfEntityTypeIDs>
+SupertypesOfAny(
+    const katana::EntityTypeManager& manager,
+    const katana::SetOfEntityTypeIDs& entity_type_ids) {
+  katana::SetOfEntityTypeIDs supertypes;
+  std::optional<katana::EntityTypeID> missing;
+  entity_type_ids.ForEach([&](katana::EntityTypeID id) {
+    if (!manager.HasEntityType(id)) {
+      missing = id;
+      return;
     }
+    supertypes |= manager.GetSupertypeClosure(id);
+  });
+  if (missing) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "entity type {} does not exist",
+        *missing);
   }
-  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+  return supertypes;
 }
 
 katana::PropertyGraph::EntityTypeIDArray
 MakeDefaultEntityTypeIDArray(size_t vec_sz) {
-  katana::PropertyGraph::EntityTypeIDArray type_ids;
-  type_ids.allocateInterleaved(vec_sz);
-  katana::ParallelSTL::fill(
-      type_ids.begin(), type_ids.end(), katana::kUnknownEntityType);
-  return type_ids;
+  return katana::EntityTypeIDArray::MakeFilled(
+      vec_sz, katana::kUnknownEntityType);
+}
+
+/// A uint8 property, which is (always) considered an atomic type
+struct TypeColumn {
+  int field_index;
+  std::shared_ptr<arrow::UInt8Array> array;
+  katana::EntityTypeID atomic_id;
+};
+
+/// The set of TypeColumns, by position, that an entity has
+using TypeColumnSet = katana::SetOfEntityTypeIDs;
+
+/// Entities are typed in blocks of one 64-bit word per column
+constexpr int64_t kTypeBlockSize = 64;
+
+/// The TypeColumnSets of a block, kept per thread so that the storage of the
+/// sets is reused from block to block
+using BlockTypeColumnSets = std::array<TypeColumnSet, kTypeBlockSize>;
+
+/// Compute the TypeColumnSets of the entities [begin, end), at most
+/// kTypeBlockSize of them. Each column is packed into one word with a bit per
+/// entity, masked with its validity, and only the set bits of the word are
+/// scattered into the sets, so sparse type columns cost little.
+void
+TypeColumnSetsOfBlock(
+    const std::vector<TypeColumn>& columns, int64_t begin, int64_t end,
+    TypeColumnSet* sets) {
+  for (int64_t i = 0; i < end - begin; ++i) {
+    sets[i].reset();
+  }
+  for (size_t c = 0; c < columns.size(); ++c) {
+    const arrow::UInt8Array& array = *columns[c].array;
+    const uint8_t* values = array.raw_values();
+    uint64_t word = 0;
+    for (int64_t row = begin; row < end; ++row) {
+      word |= uint64_t{values[row] != 0} << (row - begin);
+    }
+    if (array.null_count() > 0) {
+      const uint8_t* validity = array.null_bitmap_data();
+      uint64_t valid = 0;
+      for (int64_t row = begin; row < end; ++row) {
+        bool is_valid = arrow::BitUtil::GetBit(validity, array.offset() + row);
+        valid |= uint64_t{is_valid} << (row - begin);
+      }
+      word &= valid;
+    }
+    for (; word != 0; word &= word - 1) {
+      sets[__builtin_ctzll(word)].set(c);
+    }
+  }
+}
+
+/// Assign an EntityTypeID to each entity from the uint8 properties in
+/// properties, adding the atomic types and their combinations to manager.
+///
+/// This is done in parallel in two passes over blocks of entities: the first
+/// collects the distinct combinations of types in per-thread sets, which are
+/// merged and given IDs in a deterministic order, and the second looks up the
+/// combination of each entity.
+katana::Result<void>
+InferEntityTypeIDs(
+    uint64_t num_entities, const std::shared_ptr<arrow::Table>& properties,
+    katana::EntityTypeManager* manager,
+    katana::PropertyGraph::EntityTypeIDArray* entity_type_ids) {
+  int64_t num_rows = properties->num_rows();
+  if (num_rows == 0) {
+    *entity_type_ids = katana::EntityTypeIDArray::MakeFilled(
+        num_entities, katana::kUnknownEntityType);
+    return katana::ResultSuccess();
+  }
+  if (static_cast<uint64_t>(num_rows) != num_entities) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "size of property table ({}) doesn't match size of type array ({})",
+        num_rows, num_entities);
+  }
+
+  // a uint8 property is (always) considered a type
+  // TODO(roshan) make this customizable by the user
+  std::vector<TypeColumn> columns;
+  const std::shared_ptr<arrow::Schema>& schema = properties->schema();
+  for (int i = 0, n = schema->num_fields(); i < n; ++i) {
+    const std::shared_ptr<arrow::Field>& field = schema->field(i);
+    if (!field->type()->Equals(arrow::uint8())) {
+      continue;
+    }
+    const std::shared_ptr<arrow::ChunkedArray>& property =
+        properties->column(i);
+    if (property->num_chunks() != 1) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotImplemented,
+          "property {} has {} chunks (1 chunk expected)", field->name(),
+          property->num_chunks());
+    }
+    katana::EntityTypeID atomic_id =
+        KATANA_CHECKED(manager->AddAtomicEntityType(field->name()));
+    columns.emplace_back(TypeColumn{
+        i, std::static_pointer_cast<arrow::UInt8Array>(property->chunk(0)),
+        atomic_id});
+  }
+
+  uint64_t num_blocks = (num_rows + kTypeBlockSize - 1) / kTypeBlockSize;
+  auto block_end = [num_rows](uint64_t block) {
+    return std::min<int64_t>(num_rows, (block + 1) * kTypeBlockSize);
+  };
+
+  katana::PerThreadStorage<BlockTypeColumnSets> per_thread_sets;
+  katana::PerThreadStorage<std::unordered_set<TypeColumnSet>>
+      per_thread_combinations;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        int64_t begin = block * kTypeBlockSize;
+        int64_t end = block_end(block);
+        BlockTypeColumnSets& sets = *per_thread_sets.getLocal();
+        TypeColumnSetsOfBlock(columns, begin, end, sets.data());
+        std::unordered_set<TypeColumnSet>& combinations =
+            *per_thread_combinations.getLocal();
+        for (int64_t i = 0; i < end - begin; ++i) {
+          if (sets[i].count() > 1) {
+            combinations.emplace(sets[i]);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  // Give combinations IDs in the order of their field indices, so that IDs
+  // do not depend on the number of threads
+  std::map<std::vector<int>, TypeColumnSet> ordered_combinations;
+  for (unsigned t = 0; t < per_thread_combinations.size(); ++t) {
+    for (const TypeColumnSet& set : *per_thread_combinations.getRemote(t)) {
+      std::vector<int> field_indices;
+      for (size_t c = 0; c < columns.size(); ++c) {
+        if (set.test(c)) {
+          field_indices.emplace_back(columns[c].field_index);
+        }
+      }
+      ordered_combinations.emplace(std::move(field_indices), set);
+    }
+  }
+
+  std::unordered_map<TypeColumnSet, katana::EntityTypeID> set_to_id;
+  for (size_t c = 0; c < columns.size(); ++c) {
+    TypeColumnSet set;
+    set.set(c);
+    set_to_id.emplace(set, columns[c].atomic_id);
+  }
+  for (const auto& [field_indices, set] : ordered_combinations) {
+    katana::SetOfEntityTypeIDs atomic_ids;
+    for (size_t c = 0; c < columns.size(); ++c) {
+      if (set.test(c)) {
+        atomic_ids.set(columns[c].atomic_id);
+      }
+    }
+    katana::EntityTypeID id =
+        KATANA_CHECKED(manager->AddNonAtomicEntityType(atomic_ids));
+    set_to_id.emplace(set, id);
+  }
+
+  katana::NUMAArray<katana::EntityTypeID> ids;
+  ids.allocateInterleaved(num_entities);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        int64_t begin = block * kTypeBlockSize;
+        int64_t end = block_end(block);
+        BlockTypeColumnSets& sets = *per_thread_sets.getLocal();
+        TypeColumnSetsOfBlock(columns, begin, end, sets.data());
+        for (int64_t i = 0; i < end - begin; ++i) {
+          ids[begin + i] = sets[i].none() ? katana::kUnknownEntityType
+                                          : set_to_id.at(sets[i]);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  *entity_type_ids = katana::EntityTypeIDArray::Make(std::move(ids));
+  return katana::ResultSuccess();
 }
 
 }  // namespace
 
+katana::PropertyGraph::PropertyGraph(PropertyGraph&& other) noexcept
+    : rdg_(std::move(other.rdg_)),
+      file_(std::move(other.file_)),
+      topology_(std::move(other.topology_)),
+      node_entity_type_manager_(std::move(other.node_entity_type_manager_)),
+      edge_entity_type_manager_(std::move(other.edge_entity_type_manager_)),
+      node_entity_type_ids_(std::move(other.node_entity_type_ids_)),
+      edge_entity_type_ids_(std::move(other.edge_entity_type_ids_)),
+      node_indexes_(std::move(other.node_indexes_)),
+      edge_indexes_(std::move(other.edge_indexes_)),
+      unloaded_node_indexes_(std::move(other.unloaded_node_indexes_)),
+      unloaded_edge_indexes_(std::move(other.unloaded_edge_indexes_)),
+      pg_view_cache_(std::move(other.pg_view_cache_)) {
+  PropertyMemoryManager::Get().Move(&other, this);
+}
+
+katana::PropertyGraph&
+katana::PropertyGraph::operator=(PropertyGraph&& other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  PropertyMemoryManager::Get().Forget(this);
+  rdg_ = std::move(other.rdg_);
+  file_ = std::move(other.file_);
+  topology_ = std::move(other.topology_);
+  node_entity_type_manager_ = std::move(other.node_entity_type_manager_);
+  edge_entity_type_manager_ = std::move(other.edge_entity_type_manager_);
+  node_entity_type_ids_ = std::move(other.node_entity_type_ids_);
+  edge_entity_type_ids_ = std::move(other.edge_entity_type_ids_);
+  node_indexes_ = std::move(other.node_indexes_);
+  edge_indexes_ = std::move(other.edge_indexes_);
+  unloaded_node_indexes_ = std::move(other.unloaded_node_indexes_);
+  unloaded_edge_indexes_ = std::move(other.unloaded_edge_indexes_);
+  pg_view_cache_ = std::move(other.pg_view_cache_);
+  PropertyMemoryManager::Get().Move(&other, this);
+  return *this;
+}
+
+katana::PropertyGraph::~PropertyGraph() {
+  PropertyMemoryManager::Get().Forget(this);
+}
+
+void
+katana::PropertyGraph::SyncNodeProperties() {
+  PropertyMemoryManager::Get().Sync(
+      this, tsuba::NodeEdge::kNode, rdg_.node_properties());
+}
+
+void
+katana::PropertyGraph::SyncEdgeProperties() {
+  PropertyMemoryManager::Get().Sync(
+      this, tsuba::NodeEdge::kEdge, rdg_.edge_properties());
+}
+
+katana::Result<void>
+katana::PropertyGraph::EvictProperty(
+    tsuba::NodeEdge node_edge, const std::string& prop_name) {
+  if (node_edge == tsuba::NodeEdge::kNode) {
+    return UnloadNodeProperty(prop_name);
+  }
+  return UnloadEdgeProperty(prop_name);
+}
+
+katana::Result<void>
+katana::PropertyGraph::TrimAfterLoad(
+    tsuba::NodeEdge node_edge, const std::string& prop_name) {
+  auto& manager = PropertyMemoryManager::Get();
+  if (manager.budget() == 0) {
+    return katana::ResultSuccess();
+  }
+  KATANA_CHECKED(manager.Pin(this, node_edge, prop_name));
+  manager.Trim();
+  return manager.Unpin(this, node_edge, prop_name);
+}
+
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Make(
     std::unique_ptr<tsuba::RDGFile> rdg_file, tsuba::RDG&& rdg) {
@@ -245,19 +617,19 @@ katana::PropertyGraph::Make(
 
     EntityTypeManager node_type_manager{};
     EntityTypeIDArray node_type_ids;
-    node_type_ids.allocateInterleaved(topo.num_nodes());
-
-    KATANA_CHECKED(EntityTypeManager::AssignEntityTypeIDsFromProperties(
-        topo.num_nodes(), rdg.node_properties(), &node_type_manager,
-        &node_type_ids));
+    KATANA_CHECKED_CONTEXT(
+        InferEntityTypeIDs(
+            topo.num_nodes(), rdg.node_properties(), &node_type_manager,
+            &node_type_ids),
+        "inferring node types");
 
     EntityTypeManager edge_type_manager{};
     EntityTypeIDArray edge_type_ids;
-    edge_type_ids.allocateInterleaved(topo.num_edges());
-
-    KATANA_CHECKED(EntityTypeManager::AssignEntityTypeIDsFromProperties(
-        topo.num_edges(), rdg.edge_properties(), &edge_type_manager,
-        &edge_type_ids));
+    KATANA_CHECKED_CONTEXT(
+        InferEntityTypeIDs(
+            topo.num_edges(), rdg.edge_properties(), &edge_type_manager,
+            &edge_type_ids),
+        "inferring edge types");
 
     KATANA_ASSERT(topo.num_nodes() == node_type_ids.size());
     KATANA_ASSERT(topo.num_edges() == edge_type_ids.size());
@@ -299,9 +671,10 @@ katana::PropertyGraph::Make(
     EntityTypeManager&& edge_type_manager) {
   return std::make_unique<katana::PropertyGraph>(
       std::unique_ptr<tsuba::RDGFile>(), tsuba::RDG{},
-      std::move(topo_to_assign), std::move(node_entity_type_ids),
-      std::move(edge_entity_type_ids), std::move(node_type_manager),
-      std::move(edge_type_manager));
+      std::move(topo_to_assign),
+      EntityTypeIDArray::Make(std::move(node_entity_type_ids)),
+      EntityTypeIDArray::Make(std::move(edge_entity_type_ids)),
+      std::move(node_type_manager), std::move(edge_type_manager));
 }
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -394,22 +767,32 @@ katana::PropertyGraph::Validate() {
 /// Only call this if every uint8/bool property should be considered a type
 katana::Result<void>
 katana::PropertyGraph::ConstructEntityTypeIDs() {
-  // only relevant to actually construct when EntityTypeIDs are expected in properties
-  // when EntityTypeIDs are not expected in properties then we have nothing to do here
-  KATANA_LOG_WARN("Loading types from properties.");
-  node_entity_type_manager_ = EntityTypeManager{};
-  node_entity_type_ids_ = EntityTypeIDArray{};
-  node_entity_type_ids_.allocateInterleaved(num_nodes());
-  KATANA_CHECKED(EntityTypeManager::AssignEntityTypeIDsFromProperties(
-      num_nodes(), rdg_.node_properties(), &node_entity_type_manager_,
-      &node_entity_type_ids_));
-
-  edge_entity_type_manager_ = EntityTypeManager{};
-  edge_entity_type_ids_ = EntityTypeIDArray{};
-  edge_entity_type_ids_.allocateInterleaved(num_edges());
-  KATANA_CHECKED(EntityTypeManager::AssignEntityTypeIDsFromProperties(
-      num_edges(), rdg_.edge_properties(), &edge_entity_type_manager_,
-      &edge_entity_type_ids_));
+  KATANA_LOG_DEBUG("constructing types from properties");
+  EntityTypeManager node_type_manager{};
+  EntityTypeIDArray node_type_ids;
+  KATANA_CHECKED_CONTEXT(
+      InferEntityTypeIDs(
+          num_nodes(), rdg_.node_properties(), &node_type_manager,
+          &node_type_ids),
+      "inferring node types");
+
+  EntityTypeManager edge_type_manager{};
+  EntityTypeIDArray edge_type_ids;
+  KATANA_CHECKED_CONTEXT(
+      InferEntityTypeIDs(
+          num_edges(), rdg_.edge_properties(), &edge_type_manager,
+          &edge_type_ids),
+      "inferring edge types");
+
+  node_entity_type_manager_ = std::move(node_type_manager);
+  node_entity_type_ids_ = std::move(node_type_ids);
+  edge_entity_type_manager_ = std::move(edge_type_manager);
+  edge_entity_type_ids_ = std::move(edge_type_ids);
+
+  // The stored type ID arrays, if any, are stale now; drop them so that the
+  // next Commit or Write stores the ones just constructed
+  KATANA_CHECKED(rdg_.UnbindNodeEntityTypeIDArrayFileStorage());
+  KATANA_CHECKED(rdg_.UnbindEdgeEntityTypeIDArrayFileStorage());
 
   return katana::ResultSuccess();
 }
@@ -746,6 +1129,7 @@ katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 katana::PropertyGraph::GetNodeProperty(const std::string& name) const {
   auto ret = rdg_.node_properties()->GetColumnByName(name);
   if (ret) {
+    PropertyMemoryManager::Get().Touch(this, tsuba::NodeEdge::kNode, name);
     return MakeResult(std::move(ret));
   }
   return KATANA_ERROR(
@@ -756,6 +1140,7 @@ katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 katana::PropertyGraph::GetEdgeProperty(const std::string& name) const {
   auto ret = rdg_.edge_properties()->GetColumnByName(name);
   if (ret) {
+    PropertyMemoryManager::Get().Touch(this, tsuba::NodeEdge::kEdge, name);
     return MakeResult(std::move(ret));
   }
   return KATANA_ERROR(
@@ -783,7 +1168,9 @@ katana::PropertyGraph::AddNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology().num_nodes(), props->num_rows());
   }
-  return rdg_.AddNodeProperties(props);
+  KATANA_CHECKED(rdg_.AddNodeProperties(props));
+  SyncNodeProperties();
+  return ResultSuccess();
 }
 
 katana::Result<void>
@@ -798,12 +1185,16 @@ katana::PropertyGraph::UpsertNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology().num_nodes(), props->num_rows());
   }
-  return rdg_.UpsertNodeProperties(props);
+  KATANA_CHECKED(rdg_.UpsertNodeProperties(props));
+  SyncNodeProperties();
+  return ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveNodeProperty(int i) {
-  return rdg_.RemoveNodeProperty(i);
+  KATANA_CHECKED(rdg_.RemoveNodeProperty(i));
+  SyncNodeProperties();
+  return ResultSuccess();
 }
 
 katana::Result<void>
@@ -811,25 +1202,45 @@ katana::PropertyGraph::RemoveNodeProperty(const std::string& prop_name) {
   auto col_names = rdg_.node_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
-    return rdg_.RemoveNodeProperty(std::distance(col_names.cbegin(), pos));
+    return RemoveNodeProperty(std::distance(col_names.cbegin(), pos));
   }
   return katana::ErrorCode::PropertyNotFound;
 }
 
 katana::Result<void>
 katana::PropertyGraph::LoadNodeProperty(const std::string& name, int i) {
-  return rdg_.LoadNodeProperty(name, i);
+  KATANA_CHECKED(rdg_.LoadNodeProperty(name, i));
+  SyncNodeProperties();
+  auto pos = std::find(
+      unloaded_node_indexes_.begin(), unloaded_node_indexes_.end(), name);
+  if (pos != unloaded_node_indexes_.end()) {
+    unloaded_node_indexes_.erase(pos);
+    KATANA_CHECKED_CONTEXT(MakeNodeIndex(name), "rebuilding index");
+  }
+  return TrimAfterLoad(tsuba::NodeEdge::kNode, name);
 }
 /// Load a node property by name if it is absent and append its column to
 /// the table do nothing otherwise
 katana::Result<void>
 katana::PropertyGraph::EnsureNodePropertyLoaded(const std::string& name) {
   if (HasNodeProperty(name)) {
+    PropertyMemoryManager::Get().Touch(this, tsuba::NodeEdge::kNode, name);
     return katana::ResultSuccess();
   }
   return LoadNodeProperty(name);
 }
 
+katana::Result<void>
+katana::PropertyGraph::PinNodeProperty(const std::string& name) {
+  KATANA_CHECKED(EnsureNodePropertyLoaded(name));
+  return PropertyMemoryManager::Get().Pin(this, tsuba::NodeEdge::kNode, name);
+}
+
+katana::Result<void>
+katana::PropertyGraph::UnpinNodeProperty(const std::string& name) {
+  return PropertyMemoryManager::Get().Unpin(this, tsuba::NodeEdge::kNode, name);
+}
+
 std::vector<std::string>
 katana::PropertyGraph::ListNodeProperties() const {
   return rdg_.ListNodeProperties();
@@ -842,7 +1253,23 @@ katana::PropertyGraph::ListEdgeProperties() const {
 
 katana::Result<void>
 katana::PropertyGraph::UnloadNodeProperty(const std::string& prop_name) {
-  return rdg_.UnloadNodeProperty(prop_name);
+  KATANA_CHECKED(rdg_.UnloadNodeProperty(prop_name));
+  // the index holds on to the column, so it goes with it
+  auto pos = std::find_if(
+      node_indexes_.begin(), node_indexes_.end(),
+      [&](const auto& index) { return index->column_name() == prop_name; });
+  if (pos != node_indexes_.end()) {
+    node_indexes_.erase(pos);
+    unloaded_node_indexes_.emplace_back(prop_name);
+  }
+  SyncNodeProperties();
+  return ResultSuccess();
+}
+
+void
+katana::PropertyGraph::DropNodeProperties() {
+  rdg_.DropNodeProperties();
+  SyncNodeProperties();
 }
 
 katana::Result<void>
@@ -857,7 +1284,9 @@ katana::PropertyGraph::AddEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology().num_edges(), props->num_rows());
   }
-  return rdg_.AddEdgeProperties(props);
+  KATANA_CHECKED(rdg_.AddEdgeProperties(props));
+  SyncEdgeProperties();
+  return ResultSuccess();
 }
 
 katana::Result<void>
@@ -872,12 +1301,16 @@ katana::PropertyGraph::UpsertEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology().num_edges(), props->num_rows());
   }
-  return rdg_.UpsertEdgeProperties(props);
+  KATANA_CHECKED(rdg_.UpsertEdgeProperties(props));
+  SyncEdgeProperties();
+  return ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveEdgeProperty(int i) {
-  return rdg_.RemoveEdgeProperty(i);
+  KATANA_CHECKED(rdg_.RemoveEdgeProperty(i));
+  SyncEdgeProperties();
+  return ResultSuccess();
 }
 
 katana::Result<void>
@@ -885,19 +1318,43 @@ katana::PropertyGraph::RemoveEdgeProperty(const std::string& prop_name) {
   auto col_names = rdg_.edge_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
-    return rdg_.RemoveEdgeProperty(std::distance(col_names.cbegin(), pos));
+    return RemoveEdgeProperty(std::distance(col_names.cbegin(), pos));
   }
   return katana::ErrorCode::PropertyNotFound;
 }
 
 katana::Result<void>
 katana::PropertyGraph::UnloadEdgeProperty(const std::string& prop_name) {
-  return rdg_.UnloadEdgeProperty(prop_name);
+  KATANA_CHECKED(rdg_.UnloadEdgeProperty(prop_name));
+  // the index holds on to the column, so it goes with it
+  auto pos = std::find_if(
+      edge_indexes_.begin(), edge_indexes_.end(),
+      [&](const auto& index) { return index->column_name() == prop_name; });
+  if (pos != edge_indexes_.end()) {
+    edge_indexes_.erase(pos);
+    unloaded_edge_indexes_.emplace_back(prop_name);
+  }
+  SyncEdgeProperties();
+  return ResultSuccess();
+}
+
+void
+katana::PropertyGraph::DropEdgeProperties() {
+  rdg_.DropEdgeProperties();
+  SyncEdgeProperties();
 }
 
 katana::Result<void>
 katana::PropertyGraph::LoadEdgeProperty(const std::string& name, int i) {
-  return rdg_.LoadEdgeProperty(name, i);
+  KATANA_CHECKED(rdg_.LoadEdgeProperty(name, i));
+  SyncEdgeProperties();
+  auto pos = std::find(
+      unloaded_edge_indexes_.begin(), unloaded_edge_indexes_.end(), name);
+  if (pos != unloaded_edge_indexes_.end()) {
+    unloaded_edge_indexes_.erase(pos);
+    KATANA_CHECKED_CONTEXT(MakeEdgeIndex(name), "rebuilding index");
+  }
+  return TrimAfterLoad(tsuba::NodeEdge::kEdge, name);
 }
 
 /// Load an edge property by name if it is absent and append its column to
@@ -905,11 +1362,23 @@ katana::PropertyGraph::LoadEdgeProperty(const std::string& name, int i) {
 katana::Result<void>
 katana::PropertyGraph::EnsureEdgePropertyLoaded(const std::string& name) {
   if (HasEdgeProperty(name)) {
+    PropertyMemoryManager::Get().Touch(this, tsuba::NodeEdge::kEdge, name);
     return katana::ResultSuccess();
   }
   return LoadEdgeProperty(name);
 }
 
+katana::Result<void>
+katana::PropertyGraph::PinEdgeProperty(const std::string& name) {
+  KATANA_CHECKED(EnsureEdgePropertyLoaded(name));
+  return PropertyMemoryManager::Get().Pin(this, tsuba::NodeEdge::kEdge, name);
+}
+
+katana::Result<void>
+katana::PropertyGraph::UnpinEdgeProperty(const std::string& name) {
+  return PropertyMemoryManager::Get().Unpin(this, tsuba::NodeEdge::kEdge, name);
+}
+
 // Build an index over nodes.
 katana::Result<void>
 katana::PropertyGraph::MakeNodeIndex(const std::string& column_name) {
@@ -1263,6 +1732,30 @@ katana::CreateTransposeGraphTopology(const GraphTopology& topology) {
   return katana::PropertyGraph::Make(std::move(transpose_topo));
 }
 
+katana::Result<void>
+katana::FindNodesWithEntityTypes(
+    const katana::PropertyGraph* pg,
+    const katana::SetOfEntityTypeIDs& node_entity_type_ids,
+    katana::DynamicBitset* nodes) {
+  SetOfEntityTypeIDs matching = KATANA_CHECKED_CONTEXT(
+      SupertypesOfAny(pg->GetNodeTypeManager(), node_entity_type_ids),
+      "finding nodes");
+  pg->node_entity_type_ids().FindEntitiesOfTypes(matching, nodes);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::FindEdgesWithEntityTypes(
+    const katana::PropertyGraph* pg,
+    const katana::SetOfEntityTypeIDs& edge_entity_type_ids,
+    katana::DynamicBitset* edges) {
+  SetOfEntityTypeIDs matching = KATANA_CHECKED_CONTEXT(
+      SupertypesOfAny(pg->GetEdgeTypeManager(), edge_entity_type_ids),
+      "finding edges");
+  pg->edge_entity_type_ids().FindEntitiesOfTypes(matching, edges);
+  return katana::ResultSuccess();
+}
+
 katana::Result<katana::PropertyIndex<katana::GraphTopology::Node>*>
 katana::PropertyGraph::GetNodePropertyIndex(
     const std::string& property_name) const {
@@ -0,0 +1,256 @@
+#include "katana/PropertyMemoryManager.h"
+
+#include <iomanip>
+#include <utility>
+#include <vector>
+
+#include <boost/container_hash/hash.hpp>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+
+namespace {
+
+uint64_t
+ApproxChunkedArrayMemUse(const std::shared_ptr<arrow::ChunkedArray>& column) {
+  uint64_t total_mem_use = 0;
+  for (const auto& array : column->chunks()) {
+    total_mem_use += katana::ApproxArrayMemUse(array);
+  }
+  return total_mem_use;
+}
+
+}  // namespace
+
+std::size_t
+katana::PropertyMemoryManager::KeyHash::operator()(const Key& k) const {
+  std::size_t seed = 0;
+  boost::hash_combine(seed, k.graph);
+  boost::hash_combine(seed, static_cast<int>(k.node_edge));
+  boost::hash_combine(seed, k.name);
+  return seed;
+}
+
+katana::PropertyMemoryManager::PropertyMemoryManager() {
+  int budget_mb = 0;
+  if (katana::GetEnv("KATANA_PROPERTY_MEMORY_BUDGET_MB", &budget_mb) &&
+      budget_mb > 0) {
+    budget_ = static_cast<uint64_t>(budget_mb) << 20;
+  }
+}
+
+katana::PropertyMemoryManager&
+katana::PropertyMemoryManager::Get() {
+  static PropertyMemoryManager manager;
+  return manager;
+}
+
+uint64_t
+katana::PropertyMemoryManager::used() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return used_;
+}
+
+uint64_t
+katana::PropertyMemoryManager::pinned() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pinned_;
+}
+
+uint64_t
+katana::PropertyMemoryManager::num_evictions() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_evictions_;
+}
+
+void
+katana::PropertyMemoryManager::Remove(
+    std::unordered_map<Key, Entry, KeyHash>::iterator it) {
+  used_ -= it->second.bytes;
+  if (it->second.pins > 0) {
+    pinned_ -= it->second.bytes;
+  }
+  lru_.erase(it->second.lru_pos);
+  entries_.erase(it);
+}
+
+void
+katana::PropertyMemoryManager::Sync(
+    PropertyGraph* graph, tsuba::NodeEdge node_edge,
+    const std::shared_ptr<arrow::Table>& table) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (int i = 0; i < table->num_columns(); ++i) {
+    Key key{graph, node_edge, table->field(i)->name()};
+    const std::shared_ptr<arrow::ChunkedArray>& column = table->column(i);
+
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      lru_.push_front(key);
+      it = entries_.emplace(std::move(key), Entry{}).first;
+      it->second.lru_pos = lru_.begin();
+    } else if (it->second.column.lock() == column) {
+      continue;
+    } else {
+      // the column was replaced, e.g., by an upsert
+      used_ -= it->second.bytes;
+      if (it->second.pins > 0) {
+        pinned_ -= it->second.bytes;
+      }
+      lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+    }
+
+    Entry& entry = it->second;
+    entry.column = column;
+    entry.bytes = ApproxChunkedArrayMemUse(column);
+    entry.evictable = true;
+    used_ += entry.bytes;
+    if (entry.pins > 0) {
+      pinned_ += entry.bytes;
+    }
+  }
+
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    auto next = std::next(it);
+    const Key& key = it->first;
+    if (key.graph == graph && key.node_edge == node_edge &&
+        table->schema()->GetFieldIndex(key.name) < 0) {
+      Remove(it);
+    }
+    it = next;
+  }
+}
+
+void
+katana::PropertyMemoryManager::Touch(
+    const PropertyGraph* graph, tsuba::NodeEdge node_edge,
+    const std::string& name) {
+  // without a budget the order of uses does not matter
+  if (budget_ == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  Key key{const_cast<PropertyGraph*>(graph), node_edge, name};
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+  }
+}
+
+katana::Result<void>
+katana::PropertyMemoryManager::Pin(
+    PropertyGraph* graph, tsuba::NodeEdge node_edge, const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(Key{graph, node_edge, name});
+  if (it == entries_.end()) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "property {} is not loaded",
+        std::quoted(name));
+  }
+  if (it->second.pins++ == 0) {
+    pinned_ += it->second.bytes;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyMemoryManager::Unpin(
+    PropertyGraph* graph, tsuba::NodeEdge node_edge, const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(Key{graph, node_edge, name});
+  if (it == entries_.end() || it->second.pins == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "property {} is not pinned",
+        std::quoted(name));
+  }
+  if (--it->second.pins == 0) {
+    pinned_ -= it->second.bytes;
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::PropertyMemoryManager::Forget(PropertyGraph* graph) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    auto next = std::next(it);
+    if (it->first.graph == graph) {
+      Remove(it);
+    }
+    it = next;
+  }
+}
+
+void
+katana::PropertyMemoryManager::Move(PropertyGraph* from, PropertyGraph* to) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Key> keys;
+  for (const auto& [key, entry] : entries_) {
+    if (key.graph == from) {
+      keys.emplace_back(key);
+    }
+  }
+  for (const Key& key : keys) {
+    auto node = entries_.extract(key);
+    node.key().graph = to;
+    node.mapped().lru_pos->graph = to;
+    entries_.insert(std::move(node));
+  }
+}
+
+void
+katana::PropertyMemoryManager::Trim() {
+  for (;;) {
+    Key victim;
+    Entry entry;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (budget_ == 0 || used_ <= budget_) {
+        return;
+      }
+
+      auto victim_it = entries_.end();
+      for (auto pos = lru_.rbegin(); pos != lru_.rend(); ++pos) {
+        auto it = entries_.find(*pos);
+        KATANA_LOG_DEBUG_ASSERT(it != entries_.end());
+        if (it->second.pins > 0 || !it->second.evictable ||
+            pos->graph->rdg_dir().empty()) {
+          continue;
+        }
+        victim_it = it;
+        break;
+      }
+      if (victim_it == entries_.end()) {
+        // everything left is pinned or cannot be written out
+        return;
+      }
+
+      victim = victim_it->first;
+      entry = victim_it->second;
+      Remove(victim_it);
+    }
+
+    // unloading may write the property, so do it without holding the lock
+    auto res = victim.graph->EvictProperty(victim.node_edge, victim.name);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (res) {
+      ++num_evictions_;
+      continue;
+    }
+    KATANA_LOG_WARN(
+        "cannot evict property {}: {}", std::quoted(victim.name), res.error());
+    // keep tracking it, but do not try again until it is replaced
+    if (entries_.find(victim) == entries_.end()) {
+      lru_.push_front(victim);
+      entry.lru_pos = lru_.begin();
+      entry.evictable = false;
+      used_ += entry.bytes;
+      entries_.emplace(std::move(victim), std::move(entry));
+    }
+  }
+}
@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <atomic>
+
+#include "betweenness_centrality_impl.h"
+#include "katana/Bag.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/gstl.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+// type of the num shortest paths variable
+using BatchedShortPathType = double;
+
+// bit i is set if the node is in the frontier of the i-th source of a batch
+using SourceMask = uint64_t;
+
+using BatchedGraph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::BiDirectional, std::tuple<>, std::tuple<>>;
+using BatchedGNode = BatchedGraph::Node;
+
+struct LevelEntry {
+  BatchedGNode node;
+  SourceMask sources;
+};
+
+using LevelWorklistType = katana::InsertBag<LevelEntry, 4096>;
+
+// smaller than Level because each node does work for every source
+constexpr static const unsigned kBatchedChunkSize = 64u;
+
+static_assert(
+    BetweennessCentralityPlan::kMaxBatchSize <= sizeof(SourceMask) * 8,
+    "sources of a batch must fit in a SourceMask");
+
+template <typename Fn>
+void
+ForEachSource(SourceMask sources, const Fn& fn) {
+  while (sources != 0) {
+    fn(static_cast<uint32_t>(__builtin_ctzll(sources)));
+    sources &= sources - 1;
+  }
+}
+
+/// Multi-source Brandes. Every level of the traversal carries the (node,
+/// sources) pairs at that depth, so a node reached at the same depth by
+/// several sources scans its edges once for all of them. Shortest path
+/// counts are pulled from incoming edges once the next level is known and
+/// dependencies are pulled from outgoing edges level by level in reverse,
+/// so no per-edge state is recorded and no floating point value is updated
+/// concurrently.
+class BatchedBrandes {
+  const BatchedGraph& graph_;
+  const uint32_t batch_size_;
+
+  // sources that reached the node so far
+  katana::NUMAArray<SourceMask> seen_;
+  // sources of the level being processed
+  katana::NUMAArray<SourceMask> frontier_;
+  // sources reaching the node in the next level
+  katana::NUMAArray<std::atomic<SourceMask>> next_;
+  // batch_size_ values per node
+  katana::NUMAArray<BatchedShortPathType> num_shortest_paths_;
+  katana::NUMAArray<float> dependency_;
+  katana::NUMAArray<float> bc_;
+
+  size_t Index(BatchedGNode node, uint32_t source) const {
+    return size_t{node} * batch_size_ + source;
+  }
+
+  void SetFrontier(const LevelWorklistType& level) {
+    katana::do_all(
+        katana::iterate(level),
+        [&](const LevelEntry& entry) {
+          frontier_[entry.node] = entry.sources;
+        },
+        katana::no_stats(), katana::loopname("SetFrontier"));
+  }
+
+  void ClearFrontier(const LevelWorklistType& level) {
+    katana::do_all(
+        katana::iterate(level),
+        [&](const LevelEntry& entry) { frontier_[entry.node] = 0; },
+        katana::no_stats(), katana::loopname("ClearFrontier"));
+  }
+
+  /// Find the pairs of the next level and their shortest path counts. The
+  /// current level must be in frontier_.
+  void ForwardStep(
+      const LevelWorklistType& current, LevelWorklistType* next_level) {
+    katana::InsertBag<BatchedGNode> reached;
+
+    katana::do_all(
+        katana::iterate(current),
+        [&](const LevelEntry& entry) {
+          for (auto e : graph_.edges(entry.node)) {
+            auto dest = graph_.edge_dest(e);
+            SourceMask new_sources =
+                entry.sources & ~seen_[dest] &
+                ~next_[dest].load(std::memory_order_relaxed);
+            if (new_sources == 0) {
+              continue;
+            }
+            // only the first thread to add sources to dest adds it
+            if (next_[dest].fetch_or(new_sources) == 0) {
+              reached.push(dest);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<kBatchedChunkSize>(),
+        katana::no_stats(), katana::loopname("BatchedExpand"));
+
+    katana::do_all(
+        katana::iterate(reached),
+        [&](BatchedGNode node) {
+          SourceMask sources = next_[node].load(std::memory_order_relaxed);
+          next_[node] = 0;
+          seen_[node] |= sources;
+
+          BatchedShortPathType* num_paths =
+              &num_shortest_paths_[Index(node, 0)];
+          ForEachSource(sources, [&](uint32_t i) { num_paths[i] = 0; });
+          for (auto e : graph_.in_edges(node)) {
+            auto pred = graph_.in_edge_dest(e);
+            const BatchedShortPathType* pred_num_paths =
+                &num_shortest_paths_[Index(pred, 0)];
+            ForEachSource(frontier_[pred] & sources, [&](uint32_t i) {
+              num_paths[i] += pred_num_paths[i];
+            });
+          }
+          next_level->push(LevelEntry{node, sources});
+        },
+        katana::steal(), katana::chunk_size<kBatchedChunkSize>(),
+        katana::no_stats(), katana::loopname("BatchedPathCounts"));
+  }
+
+  /// Compute the dependencies of the pairs of a level. The next level must
+  /// be in frontier_.
+  void BackwardStep(const LevelWorklistType& current) {
+    katana::do_all(
+        katana::iterate(current),
+        [&](const LevelEntry& entry) {
+          float contrib[BetweennessCentralityPlan::kMaxBatchSize];
+          ForEachSource(entry.sources, [&](uint32_t i) { contrib[i] = 0; });
+
+          for (auto e : graph_.edges(entry.node)) {
+            auto succ = graph_.edge_dest(e);
+            ForEachSource(entry.sources & frontier_[succ], [&](uint32_t i) {
+              contrib[i] += (1 + dependency_[Index(succ, i)]) /
+                            num_shortest_paths_[Index(succ, i)];
+            });
+          }
+
+          float bc = 0;
+          ForEachSource(entry.sources, [&](uint32_t i) {
+            size_t index = Index(entry.node, i);
+            dependency_[index] = contrib[i] * num_shortest_paths_[index];
+            bc += dependency_[index];
+          });
+          bc_[entry.node] += bc;
+        },
+        katana::steal(), katana::chunk_size<kBatchedChunkSize>(),
+        katana::no_stats(), katana::loopname("BatchedBrandes"));
+  }
+
+public:
+  BatchedBrandes(const BatchedGraph& graph, uint32_t batch_size)
+      : graph_(graph), batch_size_(batch_size) {
+    seen_.allocateBlocked(graph.size());
+    frontier_.allocateBlocked(graph.size());
+    next_.allocateBlocked(graph.size());
+    num_shortest_paths_.allocateBlocked(graph.size() * batch_size);
+    dependency_.allocateBlocked(graph.size() * batch_size);
+    bc_.allocateBlocked(graph.size());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](BatchedGNode n) {
+          seen_[n] = 0;
+          frontier_[n] = 0;
+          next_[n] = 0;
+          bc_[n] = 0;
+        },
+        katana::no_stats(), katana::loopname("InitializeGraph"));
+  }
+
+  /// Add the contributions of up to batch_size_ sources.
+  void AddSources(const uint32_t* sources, uint32_t num_sources) {
+    KATANA_LOG_DEBUG_ASSERT(num_sources <= batch_size_);
+
+    katana::gstl::Vector<LevelWorklistType> levels;
+    levels.emplace_back();
+
+    // the same node may be given more than once, it then holds several bits
+    std::vector<BatchedGNode> source_nodes(sources, sources + num_sources);
+    for (uint32_t i = 0; i < num_sources; ++i) {
+      frontier_[sources[i]] |= SourceMask{1} << i;
+      num_shortest_paths_[Index(sources[i], i)] = 1;
+    }
+    std::sort(source_nodes.begin(), source_nodes.end());
+    source_nodes.erase(
+        std::unique(source_nodes.begin(), source_nodes.end()),
+        source_nodes.end());
+    for (BatchedGNode node : source_nodes) {
+      seen_[node] = frontier_[node];
+      levels[0].push(LevelEntry{node, frontier_[node]});
+    }
+
+    // loop as long as current level's worklist is non-empty
+    for (size_t level = 0; !levels[level].empty(); ++level) {
+      levels.emplace_back();
+      ForwardStep(levels[level], &levels[level + 1]);
+      ClearFrontier(levels[level]);
+      SetFrontier(levels[level + 1]);
+    }
+
+    // the last level is empty and the first one holds the sources, which do
+    // not contribute to their own centrality
+    for (size_t level = levels.size() - 2; level > 0; --level) {
+      SetFrontier(levels[level + 1]);
+      BackwardStep(levels[level]);
+      ClearFrontier(levels[level + 1]);
+    }
+
+    for (const auto& level : levels) {
+      katana::do_all(
+          katana::iterate(level),
+          [&](const LevelEntry& entry) { seen_[entry.node] = 0; },
+          katana::no_stats(), katana::loopname("ResetSeen"));
+    }
+  }
+
+  const katana::NUMAArray<float>& bc() const { return bc_; }
+};
+
+}  // namespace
+
+katana::Result<void>
+BetweennessCentralityBatched(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan) {
+  katana::ReportStatSingle(
+      "BetweennessCentrality", "ChunkSize", kBatchedChunkSize);
+  katana::ReportStatSingle(
+      "BetweennessCentrality", "BatchSize", plan.batch_size());
+
+  katana::StatTimer graph_construct_timer(
+      "TimerConstructGraph", "BetweennessCentrality");
+  graph_construct_timer.start();
+  auto graph = KATANA_CHECKED(BatchedGraph::Make(pg, {}, {}));
+  graph_construct_timer.stop();
+
+  auto source_nodes =
+      KATANA_CHECKED(BetweennessCentralitySourceNodes(*pg, sources));
+
+  BatchedBrandes brandes(graph, plan.batch_size());
+
+  katana::StatTimer exec_time("Batched", "BetweennessCentrality");
+  exec_time.start();
+  for (size_t i = 0; i < source_nodes.size(); i += plan.batch_size()) {
+    uint32_t num_sources =
+        std::min<size_t>(plan.batch_size(), source_nodes.size() - i);
+    brandes.AddSources(&source_nodes[i], num_sources);
+  }
+  exec_time.stop();
+  katana::ReportStatSingle(
+      "BetweennessCentrality", "NumBatches",
+      (source_nodes.size() + plan.batch_size() - 1) / plan.batch_size());
+
+  return BetweennessCentralityWriteOutput(
+      pg, brandes.bc(), output_property_name);
+}
@@ -17,10 +17,19 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <numeric>
+
 #include "betweenness_centrality_impl.h"
+#include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
 
+namespace {
+
+struct NodeBC : public katana::PODProperty<float> {};
+
+}  // namespace
+
 const BetweennessCentralitySources
     katana::analytics::kBetweennessCentralityAllNodes =
         std::numeric_limits<uint32_t>::max();
@@ -31,21 +40,71 @@ katana::analytics::BetweennessCentrality(
     const BetweennessCentralitySources& sources,
     BetweennessCentralityPlan plan) {
   switch (plan.algorithm()) {
-    //TODO (gill) Needs bidirectional graph (CSR_CSC)
-    //   case Asynchronous:
-    //     // see AsyncStructs.h
-    //     katana::gInfo("Running async BC");
-    //     doAsyncBC();
-    //     break;
   case BetweennessCentralityPlan::kLevel:
     return BetweennessCentralityLevel(pg, sources, output_property_name, plan);
   case BetweennessCentralityPlan::kOuter:
     return BetweennessCentralityOuter(pg, sources, output_property_name, plan);
+  case BetweennessCentralityPlan::kAsynchronous:
+    return BetweennessCentralityAsynchronous(
+        pg, sources, output_property_name, plan);
+  case BetweennessCentralityPlan::kBatched:
+    if (plan.batch_size() == 0 ||
+        plan.batch_size() > BetweennessCentralityPlan::kMaxBatchSize) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "batch size must be between 1 and {}, got {}",
+          BetweennessCentralityPlan::kMaxBatchSize, plan.batch_size());
+    }
+    return BetweennessCentralityBatched(
+        pg, sources, output_property_name, plan);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
 
+katana::Result<std::vector<uint32_t>>
+BetweennessCentralitySourceNodes(
+    const katana::PropertyGraph& pg,
+    const BetweennessCentralitySources& sources) {
+  if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
+    const auto& source_vector = std::get<std::vector<uint32_t>>(sources);
+    for (uint32_t source : source_vector) {
+      if (source >= pg.num_nodes()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "source {} is not a node of a graph with {} nodes", source,
+            pg.num_nodes());
+      }
+    }
+    return source_vector;
+  }
+
+  uint64_t num_sources = pg.num_nodes();
+  if (sources != kBetweennessCentralityAllNodes) {
+    num_sources = std::min<uint64_t>(std::get<uint32_t>(sources), num_sources);
+  }
+  std::vector<uint32_t> source_vector(num_sources);
+  std::iota(source_vector.begin(), source_vector.end(), 0);
+  return source_vector;
+}
+
+katana::Result<void>
+BetweennessCentralityWriteOutput(
+    katana::PropertyGraph* pg, const katana::NUMAArray<float>& bc,
+    const std::string& output_property_name) {
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeBC>>(
+      pg, {output_property_name}));
+  auto graph = KATANA_CHECKED(
+      (katana::TypedPropertyGraph<std::tuple<NodeBC>, std::tuple<>>::Make(
+          pg, {output_property_name}, {})));
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t node) { graph.GetData<NodeBC>(node) = bc[node]; },
+      katana::loopname("WriteOutput"), katana::no_stats());
+  return katana::ResultSuccess();
+}
+
 void
 BetweennessCentralityStatistics::Print(std::ostream& os) {
   os << "Maximum centrality = " << max_centrality << std::endl;
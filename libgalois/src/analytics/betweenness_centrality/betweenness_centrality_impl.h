@@ -1,6 +1,9 @@
 #ifndef KATANA_LIBGALOIS_ANALYTICS_BETWEENNESSCENTRALITY_BETWEENNESSCENTRALITYIMPL_H_
 #define KATANA_LIBGALOIS_ANALYTICS_BETWEENNESSCENTRALITY_BETWEENNESSCENTRALITYIMPL_H_
 
+#include <vector>
+
+#include "katana/NUMAArray.h"
 #include "katana/analytics/Utils.h"
 #include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
 
@@ -16,4 +19,26 @@ katana::Result<void> BetweennessCentralityLevel(
     const std::string& output_property_name,
     katana::analytics::BetweennessCentralityPlan plan);
 
+katana::Result<void> BetweennessCentralityAsynchronous(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan);
+
+katana::Result<void> BetweennessCentralityBatched(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan);
+
+/// The source nodes selected by sources. Fails if a node is out of range.
+katana::Result<std::vector<uint32_t>> BetweennessCentralitySourceNodes(
+    const katana::PropertyGraph& pg,
+    const katana::analytics::BetweennessCentralitySources& sources);
+
+/// Create the property output_property_name holding the values in bc.
+katana::Result<void> BetweennessCentralityWriteOutput(
+    katana::PropertyGraph* pg, const katana::NUMAArray<float>& bc,
+    const std::string& output_property_name);
+
 #endif
@@ -22,7 +22,6 @@ struct BCLevelNodeDataTy {
   float dependency;
   float bc;
 };
-struct NodeBC : public katana::PODProperty<float> {};
 using NodeDataLevel = std::tuple<>;
 using EdgeDataLevel = std::tuple<>;
 
@@ -212,39 +211,6 @@ LevelBackwardBrandes(
   }
 }
 
-//! Gets the BC value from the AoS node data in the graph and adds it to the
-//! property graph for use by stats/output verification
-katana::Result<void>
-ExtractBC(
-    katana::PropertyGraph* pg, const LevelGraph& array_of_struct_graph,
-    const katana::NUMAArray<BCLevelNodeDataTy>& graph_data,
-    const std::string& output_property_name) {
-  // construct the new property
-  if (auto result =
-          katana::analytics::ConstructNodeProperties<std::tuple<NodeBC>>(
-              pg, {output_property_name});
-      !result) {
-    return result.error();
-  }
-  auto graph_result =
-      katana::TypedPropertyGraph<std::tuple<NodeBC>, std::tuple<>>::Make(
-          pg, {output_property_name}, {});
-  if (!graph_result) {
-    return graph_result.error();
-  }
-  auto new_graph = graph_result.value();
-
-  // extract bc to property
-  katana::do_all(
-      katana::iterate(array_of_struct_graph),
-      [&](LevelGNode node_id) {
-        float bc_value = graph_data[node_id].bc;
-        new_graph.GetData<NodeBC>(node_id) = bc_value;
-      },
-      katana::loopname("ExtractBC"), katana::no_stats());
-  return katana::ResultSuccess();
-}
-
 }  // namespace
 
 katana::Result<void>
@@ -279,23 +245,8 @@ BetweennessCentralityLevel(
   prealloc_time.stop();
   katana::ReportPageAllocGuard page_alloc;
 
-  // If particular set of sources was specified, use them
-  std::vector<uint32_t> source_vector;
-  if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
-    source_vector = std::get<std::vector<uint32_t>>(sources);
-  }
-
-  uint64_t loop_end;
-
-  if (std::holds_alternative<uint32_t>(sources)) {
-    if (sources == kBetweennessCentralityAllNodes) {
-      loop_end = pg->num_nodes();
-    } else {
-      loop_end = std::get<uint32_t>(sources);
-    }
-  } else {
-    loop_end = source_vector.size();
-  }
+  std::vector<uint32_t> source_vector =
+      KATANA_CHECKED(BetweennessCentralitySourceNodes(*pg, sources));
 
   katana::NUMAArray<BCLevelNodeDataTy> graph_data;
   katana::DynamicBitset active_edges;
@@ -305,18 +256,7 @@ BetweennessCentralityLevel(
   katana::StatTimer exec_time("Level", "BetweennessCentrality");
 
   // loop over all specified sources for SSSP/Brandes calculation
-  for (uint64_t i = 0; i < loop_end; i++) {
-    LevelGNode src_node;
-    if (!source_vector.empty()) {
-      if (i > source_vector.size()) {
-        return katana::ErrorCode::AssertionFailed;
-      }
-      src_node = source_vector[i];
-    } else {
-      // all sources
-      src_node = i;
-    }
-
+  for (LevelGNode src_node : source_vector) {
     // here begins main computation
     exec_time.start();
     LevelInitializeIteration(&graph, src_node, &graph_data, &active_edges);
@@ -327,6 +267,12 @@ BetweennessCentralityLevel(
     exec_time.stop();
   }
 
-  // Get the BC proporty into the property graph by extracting from AoS
-  return ExtractBC(pg, graph, graph_data, output_property_name);
+  // Get the BC property into the property graph by extracting from AoS
+  katana::NUMAArray<float> bc;
+  bc.allocateBlocked(graph.size());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](LevelGNode node_id) { bc[node_id] = graph_data[node_id].bc; },
+      katana::loopname("ExtractBC"), katana::no_stats());
+  return BetweennessCentralityWriteOutput(pg, bc, output_property_name);
 }
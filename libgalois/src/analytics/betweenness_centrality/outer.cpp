@@ -1,4 +1,4 @@
-#include <boost/iterator/filter_iterator.hpp>
+#include <algorithm>
 
 #include "betweenness_centrality_impl.h"
 #include "katana/TypedPropertyGraph.h"
@@ -154,28 +154,21 @@ public:
     }
   }
 
-  katana::Result<std::shared_ptr<arrow::FloatArray>> ExtractBCValues(
-      size_t begin, size_t end) {
-    arrow::FloatBuilder builder;
-    if (auto r = builder.Resize(end - begin); !r.ok()) {
-      return katana::ErrorCode::ArrowError;
-    }
-    for (; begin != end; ++begin) {
-      float bc = (*centrality_measure_.getRemote(0))[begin];
-
-      for (unsigned j = 1; j < katana::getActiveThreads(); ++j) {
-        bc += (*centrality_measure_.getRemote(j))[begin];
-      }
-
-      if (auto r = builder.Append(bc); !r.ok()) {
-        return katana::ErrorCode::ArrowError;
-      }
-    }
-    std::shared_ptr<arrow::FloatArray> ret;
-    if (auto r = builder.Finish(&ret); !r.ok()) {
-      return katana::ErrorCode::ArrowError;
-    }
-    return ret;
+  /**
+   * Sums the per-thread centrality values of each node into bc.
+   */
+  void ExtractBCValues(katana::NUMAArray<float>* bc) {
+    bc->allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(0, num_nodes_),
+        [&](int i) {
+          float sum = (*centrality_measure_.getRemote(0))[i];
+          for (unsigned j = 1; j < katana::getActiveThreads(); ++j) {
+            sum += (*centrality_measure_.getRemote(j))[i];
+          }
+          (*bc)[i] = sum;
+        },
+        katana::no_stats(), katana::loopname("ExtractBC"));
   }
 
 private:
@@ -261,51 +254,23 @@ BetweennessCentralityOuter(
       katana::getActiveThreads() * graph.num_nodes() / 1650);
   katana::ReportPageAllocGuard page_alloc;
 
-  // vector of sources to process; initialized if doing outSources
-  std::vector<uint32_t> source_vector;
-  // preprocessing: find the nodes with out edges we will process and skip
-  // over nodes with no out edges; only done if numOfSources isn't specified
-  if (std::holds_alternative<uint32_t>(sources) &&
-      sources != kBetweennessCentralityAllNodes) {
-    // find first node with out edges
-    boost::filter_iterator<HasOut, OuterGraph::iterator> begin =
-        boost::make_filter_iterator(HasOut(graph), graph.begin(), graph.end());
-    boost::filter_iterator<HasOut, OuterGraph::iterator> end =
-        boost::make_filter_iterator(HasOut(graph), graph.end(), graph.end());
-    // adjustedEnd = last node we will process based on how many iterations
-    // (i.e. sources) we want to do
-    boost::filter_iterator<HasOut, OuterGraph::iterator> adjustedEnd =
-        katana::safe_advance(begin, end, (int)std::get<uint32_t>(sources));
-
-    // vector of nodes we want to process
-    for (auto node = begin; node != adjustedEnd; ++node) {
-      source_vector.push_back(*node);
-    }
-  } else if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
-    source_vector = std::get<std::vector<uint32_t>>(sources);
-  }
+  // nodes with no out edges contribute nothing as sources, so skip them
+  std::vector<uint32_t> source_vector =
+      KATANA_CHECKED(BetweennessCentralitySourceNodes(*pg, sources));
+  HasOut has_out(graph);
+  source_vector.erase(
+      std::remove_if(
+          source_vector.begin(), source_vector.end(),
+          [&](uint32_t node) { return !has_out(node); }),
+      source_vector.end());
 
   // execute algorithm
   katana::StatTimer exec_time("Betweenness Centrality Outer");
   exec_time.start();
-  if (sources == kBetweennessCentralityAllNodes) {
-    bc_outer.Run(katana::iterate(*pg));
-  } else {
-    bc_outer.Run(source_vector);
-  }
+  bc_outer.Run(source_vector);
   exec_time.stop();
 
-  auto data_result = bc_outer.ExtractBCValues(0, graph.num_nodes());
-  if (!data_result) {
-    return data_result.error();
-  }
-
-  auto table = arrow::Table::Make(
-      arrow::schema({arrow::field(output_property_name, arrow::float32())}),
-      {data_result.value()});
-  if (auto r = pg->AddNodeProperties(table); !r) {
-    return r.error();
-  }
-
-  return katana::ResultSuccess();
+  katana::NUMAArray<float> bc;
+  bc_outer.ExtractBCValues(&bc);
+  return BetweennessCentralityWriteOutput(pg, bc, output_property_name);
 }
@@ -19,6 +19,9 @@
 
 #include "katana/analytics/connected_components/connected_components.h"
 
+#include <algorithm>
+#include <memory>
+
 #include "katana/ArrowRandomAccessBuilder.h"
 #include "katana/TypedPropertyGraph.h"
 
@@ -1178,6 +1181,136 @@ katana::analytics::ConnectedComponents(
   }
 }
 
+katana::Result<void>
+katana::analytics::ConnectedComponentsIncremental(
+    PropertyGraph* pg, const std::string& property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& new_edges) {
+  using ComponentType = uint64_t;
+  struct NodeComponent : public katana::PODProperty<ComponentType> {};
+
+  using NodeData = std::tuple<NodeComponent>;
+  using EdgeData = std::tuple<>;
+  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+  typedef typename Graph::Node GNode;
+
+  const auto& topology = pg->topology();
+  katana::GReduceLogicalOr out_of_range;
+  katana::do_all(
+      katana::iterate(new_edges),
+      [&](const std::pair<uint32_t, uint32_t>& edge) {
+        if (edge.first >= topology.num_nodes() ||
+            edge.second >= topology.num_nodes()) {
+          out_of_range.update(true);
+        }
+      },
+      katana::no_stats());
+  if (out_of_range.reduce()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "new edges must be between the {} existing nodes",
+        topology.num_nodes());
+  }
+
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+
+  katana::StatTimer exec_time("ConnectedComponentIncremental");
+  exec_time.start();
+
+  // Labels of the components joined by a new edge
+  katana::InsertBag<ComponentType> joined_bag;
+  katana::do_all(
+      katana::iterate(new_edges),
+      [&](const std::pair<uint32_t, uint32_t>& edge) {
+        auto src_comp = graph.GetData<NodeComponent>(edge.first);
+        auto dest_comp = graph.GetData<NodeComponent>(edge.second);
+        if (src_comp != dest_comp) {
+          joined_bag.push(src_comp);
+          joined_bag.push(dest_comp);
+        }
+      },
+      katana::loopname("CC-Incremental-Collect"));
+
+  std::vector<ComponentType> joined(joined_bag.begin(), joined_bag.end());
+  katana::ParallelSTL::sort(joined.begin(), joined.end());
+  joined.erase(std::unique(joined.begin(), joined.end()), joined.end());
+  katana::ReportStatSingle(
+      "CC-Incremental", "JoinedComponents", joined.size());
+  if (joined.empty()) {
+    exec_time.stop();
+    return katana::ResultSuccess();
+  }
+  auto joined_index = [&joined](ComponentType comp) -> uint32_t {
+    return std::lower_bound(joined.begin(), joined.end(), comp) -
+           joined.begin();
+  };
+
+  // Merge the joined labels
+  std::unique_ptr<ConnectedComponentsNode[]> sets(
+      new ConnectedComponentsNode[joined.size()]);
+  katana::do_all(
+      katana::iterate(new_edges),
+      [&](const std::pair<uint32_t, uint32_t>& edge) {
+        auto src_comp = graph.GetData<NodeComponent>(edge.first);
+        auto dest_comp = graph.GetData<NodeComponent>(edge.second);
+        if (src_comp != dest_comp) {
+          sets[joined_index(src_comp)].merge(&sets[joined_index(dest_comp)]);
+        }
+      },
+      katana::steal(), katana::loopname("CC-Incremental-Merge"));
+
+  auto set_of = [&sets](size_t i) -> size_t {
+    return sets[i].findAndCompress() - sets.get();
+  };
+
+  // Each merged set keeps its smallest label
+  katana::NUMAArray<std::atomic<ComponentType>> set_comp;
+  set_comp.allocateBlocked(joined.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, joined.size()),
+      [&](size_t i) {
+        set_comp[i] = std::numeric_limits<ComponentType>::max();
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(size_t{0}, joined.size()),
+      [&](size_t i) { katana::atomicMin(set_comp[set_of(i)], joined[i]); },
+      katana::no_stats());
+
+  katana::NUMAArray<ComponentType> relabel_to;
+  relabel_to.allocateBlocked(joined.size());
+  katana::GAccumulator<uint64_t> lost;
+  katana::do_all(
+      katana::iterate(size_t{0}, joined.size()),
+      [&](size_t i) {
+        relabel_to[i] = set_comp[set_of(i)];
+        if (relabel_to[i] != joined[i]) {
+          lost += 1;
+        }
+      },
+      katana::no_stats());
+
+  // A component may span several parts of the topology that were joined by
+  // edges of earlier batches, so its nodes cannot be found by a traversal
+  // of the topology and all labels are scanned instead
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        auto& comp = graph.GetData<NodeComponent>(node);
+        if (comp < joined.front() || comp > joined.back()) {
+          return;
+        }
+        auto it = std::lower_bound(joined.begin(), joined.end(), comp);
+        if (*it == comp) {
+          comp = relabel_to[it - joined.begin()];
+        }
+      },
+      katana::steal(), katana::loopname("CC-Incremental-Relabel"));
+  exec_time.stop();
+
+  katana::ReportStatSingle("CC-Incremental", "LostLabels", lost.reduce());
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::analytics::ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name) {
@@ -19,9 +19,13 @@
 
 #include "katana/analytics/k_core/k_core.h"
 
+#include <atomic>
+#include <memory>
+
 #include "katana/ArrowRandomAccessBuilder.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/PeelingBuckets.h"
 
 using namespace katana::analytics;
 
@@ -262,6 +266,171 @@ katana::analytics::KCore(
   return KCoreMarkAliveNodes(&graph_final, k_core_number);
 }
 
+/*******************************************************************************
+ * Core decomposition
+ ******************************************************************************/
+struct KCoreNodeCoreNumber : public katana::PODProperty<uint32_t> {};
+
+using CoreNumberGraph =
+    katana::TypedPropertyGraph<std::tuple<KCoreNodeCoreNumber>, std::tuple<>>;
+
+namespace {
+
+/**
+ * Julienne style bucket peeling. Levels are processed in increasing order;
+ * at level k all remaining nodes of degree k are peeled, which may drop the
+ * degree of their neighbors to k and peel them in the next round of the same
+ * level. Remaining nodes are kept in PeelingBuckets by degree.
+ *
+ * @param topo Topology to operate on; must be symmetric
+ * @param graph Graph to write the core number of each node to
+ * @param num_open_buckets Number of buckets in the window
+ */
+void
+BucketPeelingKCoreDecomposition(
+    const katana::GraphTopology& topo, CoreNumberGraph* graph,
+    uint32_t num_open_buckets) {
+  using Node = katana::GraphTopology::Node;
+  using Bag = katana::InsertBag<Node>;
+
+  const size_t num_nodes = topo.num_nodes();
+
+  katana::NUMAArray<std::atomic<uint32_t>> degrees;
+  degrees.allocateInterleaved(num_nodes);
+  katana::NUMAArray<std::atomic<bool>> peeled;
+  peeled.allocateInterleaved(num_nodes);
+  // Nodes whose degree changed in the current level, to be pushed to their
+  // new bucket once the level is done
+  katana::NUMAArray<std::atomic<bool>> moved;
+  moved.allocateInterleaved(num_nodes);
+
+  katana::analytics::PeelingBuckets<Node> buckets(num_open_buckets);
+
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node node) {
+        uint32_t degree = topo.degree(node);
+        degrees[node].store(degree, std::memory_order_relaxed);
+        peeled[node].store(false, std::memory_order_relaxed);
+        moved[node].store(false, std::memory_order_relaxed);
+        buckets.Push(node, degree);
+      },
+      katana::loopname("KCoreDecomposition Initialize"), katana::no_stats());
+
+  auto frontier = std::make_unique<Bag>();
+  auto next = std::make_unique<Bag>();
+  Bag moved_nodes;
+  size_t num_peeled = 0;
+
+  for (uint32_t k = 0; num_peeled < num_nodes; ++k) {
+    if (!buckets.InWindow(k)) {
+      //! All remaining nodes are in overflow; restarting the window at the
+      //! smallest remaining degree skips empty levels.
+      k = buckets.Advance(
+          [&](Node node) { return degrees[node].load(); },
+          [&](Node node) { return !peeled[node].load(); });
+    }
+
+    Bag& bucket = buckets.Bucket(k);
+    if (bucket.empty()) {
+      continue;
+    }
+
+    //! Claim the nodes in this bucket. Stale entries belong to nodes that
+    //! were already peeled at a lower level.
+    katana::do_all(
+        katana::iterate(bucket),
+        [&](Node node) {
+          if (!peeled[node].exchange(true)) {
+            frontier->push(node);
+          }
+        },
+        katana::no_stats());
+    bucket.clear();
+
+    katana::GAccumulator<size_t> level_peeled;
+    while (!frontier->empty()) {
+      katana::do_all(
+          katana::iterate(*frontier),
+          [&](Node node) {
+            level_peeled += 1;
+            graph->GetData<KCoreNodeCoreNumber>(node) = k;
+
+            for (auto e : topo.edges(node)) {
+              auto dest = topo.edge_dest(e);
+              if (peeled[dest].load(std::memory_order_relaxed)) {
+                continue;
+              }
+              uint32_t old_degree = degrees[dest].fetch_sub(1);
+              if (old_degree == k + 1) {
+                //! dest dropped to degree k, so it is peeled at this level.
+                if (!peeled[dest].exchange(true)) {
+                  next->push(dest);
+                }
+              } else if (old_degree > k + 1 && !moved[dest].exchange(true)) {
+                moved_nodes.push(dest);
+              }
+            }
+          },
+          katana::steal(), katana::chunk_size<KCorePlan::kChunkSize>(),
+          katana::loopname("KCoreDecomposition Peel"));
+
+      frontier->clear();
+      std::swap(frontier, next);
+    }
+    num_peeled += level_peeled.reduce();
+
+    //! Nodes of degree beyond the window are still in overflow, so only nodes
+    //! that moved into the window need a new entry.
+    katana::do_all(
+        katana::iterate(moved_nodes),
+        [&](Node node) {
+          moved[node].store(false, std::memory_order_relaxed);
+          if (peeled[node].load(std::memory_order_relaxed)) {
+            return;
+          }
+          buckets.PushMoved(node, degrees[node].load());
+        },
+        katana::no_stats());
+    moved_nodes.clear();
+  }
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::KCoreDecomposition(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    KCoreDecompositionPlan plan) {
+  if (auto result = ConstructNodeProperties<std::tuple<KCoreNodeCoreNumber>>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto graph =
+      KATANA_CHECKED(CoreNumberGraph::Make(pg, {output_property_name}, {}));
+
+  size_t approxNodeData = 16 * (pg->num_nodes() + pg->num_edges());
+  katana::EnsurePreallocated(8, approxNodeData);
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::StatTimer exec_time("KCoreDecomposition");
+  exec_time.start();
+
+  switch (plan.algorithm()) {
+  case KCoreDecompositionPlan::kBucketPeeling:
+    BucketPeelingKCoreDecomposition(
+        pg->topology(), &graph, plan.num_open_buckets());
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  exec_time.stop();
+  return katana::ResultSuccess();
+}
+
 // Doxygen doesn't correctly handle implementation annotations that do not
 // appear in the declaration.
 /// \cond DO_NOT_DOCUMENT
@@ -301,6 +470,76 @@ katana::analytics::KCoreStatistics::Compute(
 
   return KCoreStatistics{alive_nodes.reduce()};
 }
+
+katana::Result<void>
+katana::analytics::KCoreDecompositionAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto graph = KATANA_CHECKED(CoreNumberGraph::Make(pg, {property_name}, {}));
+
+  std::atomic<bool> not_consistent(false);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        uint32_t core = graph.GetData<KCoreNodeCoreNumber>(node);
+        // The core number must be the h-index of the neighbors' core
+        // numbers: at least core neighbors have a core number >= core, and
+        // at most core neighbors have a core number > core.
+        uint64_t num_at_least = 0;
+        uint64_t num_above = 0;
+        for (auto e : graph.edges(node)) {
+          uint32_t dest_core =
+              graph.GetData<KCoreNodeCoreNumber>(graph.GetEdgeDest(e));
+          num_at_least += dest_core >= core;
+          num_above += dest_core > core;
+        }
+        if (num_at_least < core || num_above > core) {
+          not_consistent = true;
+        }
+      },
+      katana::loopname("KCoreDecomposition sanity check"), katana::no_stats());
+
+  if (not_consistent) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<KCoreDecompositionStatistics>
+katana::analytics::KCoreDecompositionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto graph = KATANA_CHECKED(CoreNumberGraph::Make(pg, {property_name}, {}));
+
+  katana::GReduceMax<uint32_t> max_core;
+  katana::GAccumulator<uint64_t> sum_core;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        uint32_t core = graph.GetData<KCoreNodeCoreNumber>(node);
+        max_core.update(core);
+        sum_core += core;
+      },
+      katana::loopname("KCoreDecomposition statistics"), katana::no_stats());
+
+  uint32_t max_core_number = graph.num_nodes() > 0 ? max_core.reduce() : 0;
+
+  katana::GAccumulator<uint64_t> nodes_in_max_core;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        if (graph.GetData<KCoreNodeCoreNumber>(node) == max_core_number) {
+          nodes_in_max_core += 1;
+        }
+      },
+      katana::no_stats());
+
+  double average_core_number =
+      graph.num_nodes() > 0
+          ? static_cast<double>(sum_core.reduce()) / graph.num_nodes()
+          : 0.0;
+
+  return KCoreDecompositionStatistics{
+      max_core_number, nodes_in_max_core.reduce(), average_core_number};
+}
 /// \endcond DO_NOT_DOCUMENT
 
 void
@@ -308,3 +547,11 @@ katana::analytics::KCoreStatistics::Print(std::ostream& os) const {
   os << "Number of nodes in the core = " << number_of_nodes_in_kcore
      << std::endl;
 }
+
+void
+katana::analytics::KCoreDecompositionStatistics::Print(std::ostream& os) const {
+  os << "Max core number = " << max_core_number << std::endl;
+  os << "Number of nodes in the max core = " << number_of_nodes_in_max_core
+     << std::endl;
+  os << "Average core number = " << average_core_number << std::endl;
+}
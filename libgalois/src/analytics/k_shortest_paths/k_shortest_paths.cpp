@@ -0,0 +1,671 @@
+#include "katana/analytics/k_shortest_paths/k_shortest_paths.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <set>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using View = katana::PropertyGraphViews::BiDirectional;
+
+constexpr static const uint32_t kNoParent =
+    std::numeric_limits<uint32_t>::max();
+
+/// Per-thread buffers of the searches. They are sized for the whole graph
+/// once and reset through the lists of touched nodes, so a search only pays
+/// for the nodes it reaches.
+template <typename Distance>
+struct Scratch {
+  constexpr static const Distance kInfinity =
+      std::numeric_limits<Distance>::max();
+
+  /// A path from the source in the search tree of KShortestPaths.
+  struct PathTreeEntry {
+    Node node;
+    Edge edge;
+    uint32_t parent;
+    Distance distance;
+  };
+
+  // distances to the target of the current query
+  std::vector<Distance> to_target;
+  std::vector<Node> to_target_touched;
+
+  std::vector<Distance> distance;
+  std::vector<Node> parent;
+  std::vector<Edge> parent_edge;
+  // times a node was settled
+  std::vector<uint32_t> num_settled;
+  std::vector<uint8_t> banned;
+  std::vector<Node> touched;
+
+  std::vector<std::pair<Distance, uint32_t>> heap;
+  std::vector<PathTreeEntry> path_tree;
+
+  void Reserve(size_t num_nodes) {
+    if (distance.size() >= num_nodes) {
+      return;
+    }
+    to_target.assign(num_nodes, kInfinity);
+    distance.assign(num_nodes, kInfinity);
+    parent.resize(num_nodes);
+    parent_edge.resize(num_nodes);
+    num_settled.assign(num_nodes, 0);
+    banned.assign(num_nodes, 0);
+  }
+
+  void HeapPush(Distance key, uint32_t value) {
+    heap.emplace_back(key, value);
+    std::push_heap(heap.begin(), heap.end(), std::greater<>());
+  }
+
+  std::pair<Distance, uint32_t> HeapPop() {
+    std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+    auto top = heap.back();
+    heap.pop_back();
+    return top;
+  }
+
+  /// Forget the forward search, but not the distances to the target.
+  void ClearSearch() {
+    for (Node n : touched) {
+      distance[n] = kInfinity;
+      num_settled[n] = 0;
+    }
+    touched.clear();
+    heap.clear();
+    path_tree.clear();
+  }
+
+  void ClearDistancesToTarget() {
+    for (Node n : to_target_touched) {
+      to_target[n] = kInfinity;
+    }
+    to_target_touched.clear();
+  }
+};
+
+template <typename Weight>
+class KShortestPathsImpl {
+  // integer weights are nonnegative, so sums of them fit in 64 bits
+  using Distance = std::conditional_t<
+      std::is_floating_point_v<Weight>, double, uint64_t>;
+  using LocalScratch = Scratch<Distance>;
+
+  constexpr static const Distance kInfinity = LocalScratch::kInfinity;
+
+  /// A path found by Yen's algorithm. Deviation is the index of the node
+  /// where it leaves the path it was derived from.
+  struct Candidate {
+    Distance weight;
+    std::vector<Edge> edges;
+    std::vector<Node> nodes;
+    uint32_t deviation;
+
+    bool operator<(const Candidate& other) const {
+      return weight < other.weight ||
+             (weight == other.weight && edges < other.edges);
+    }
+  };
+
+  const View& view_;
+  const Weight* weights_;
+  katana::PerThreadStorage<LocalScratch> scratch_;
+  katana::GAccumulator<uint64_t> num_spur_paths_;
+
+  Weight weight(Edge e) const { return weights_[view_.edge_property_index(e)]; }
+
+  Weight in_weight(Edge e) const {
+    return weights_[view_.in_edge_property_index(e)];
+  }
+
+  LocalScratch* GetScratch() {
+    LocalScratch* scratch = scratch_.getLocal();
+    scratch->Reserve(view_.num_nodes());
+    return scratch;
+  }
+
+  /// Dijkstra's algorithm from target on the incoming edges.
+  void ComputeDistancesToTarget(Node target, LocalScratch* scratch) {
+    auto& to_target = scratch->to_target;
+    to_target[target] = 0;
+    scratch->to_target_touched.push_back(target);
+    scratch->HeapPush(0, target);
+    while (!scratch->heap.empty()) {
+      auto [dist, n] = scratch->HeapPop();
+      if (dist > to_target[n]) {
+        continue;
+      }
+      for (auto e : view_.in_edges(n)) {
+        Node src = view_.in_edge_dest(e);
+        Distance new_dist = dist + in_weight(e);
+        if (new_dist < to_target[src]) {
+          if (to_target[src] == kInfinity) {
+            scratch->to_target_touched.push_back(src);
+          }
+          to_target[src] = new_dist;
+          scratch->HeapPush(new_dist, src);
+        }
+      }
+    }
+  }
+
+  /// A* search for a shortest path from spur to target that does not visit
+  /// the banned nodes or leave spur by one of the banned edges. The
+  /// distances to the target in the full graph are a consistent heuristic,
+  /// so every node is settled once.
+  std::optional<Candidate> FindSpurPath(
+      const std::vector<Distance>& to_target, Node spur, Node target,
+      const std::vector<Edge>& banned_edges, LocalScratch* scratch) {
+    auto& distance = scratch->distance;
+    distance[spur] = 0;
+    scratch->touched.push_back(spur);
+    scratch->HeapPush(to_target[spur], spur);
+    bool found = false;
+    while (!scratch->heap.empty()) {
+      Node n = scratch->HeapPop().second;
+      if (scratch->num_settled[n]++ != 0) {
+        continue;
+      }
+      if (n == target) {
+        found = true;
+        break;
+      }
+      for (auto e : view_.edges(n)) {
+        Node dest = view_.edge_dest(e);
+        if (scratch->banned[dest] || scratch->num_settled[dest] != 0 ||
+            to_target[dest] == kInfinity ||
+            (n == spur && std::find(banned_edges.begin(), banned_edges.end(),
+                                    e) != banned_edges.end())) {
+          continue;
+        }
+        Distance new_dist = distance[n] + weight(e);
+        if (new_dist < distance[dest]) {
+          if (distance[dest] == kInfinity) {
+            scratch->touched.push_back(dest);
+          }
+          distance[dest] = new_dist;
+          scratch->parent[dest] = n;
+          scratch->parent_edge[dest] = e;
+          scratch->HeapPush(new_dist + to_target[dest], dest);
+        }
+      }
+    }
+
+    std::optional<Candidate> path;
+    if (found) {
+      path = Candidate{distance[target], {}, {target}, 0};
+      for (Node n = target; n != spur; n = scratch->parent[n]) {
+        path->edges.push_back(scratch->parent_edge[n]);
+        path->nodes.push_back(scratch->parent[n]);
+      }
+      std::reverse(path->edges.begin(), path->edges.end());
+      std::reverse(path->nodes.begin(), path->nodes.end());
+    }
+    scratch->ClearSearch();
+    return path;
+  }
+
+  /// Best first search over the paths from source, ordered by their weight
+  /// plus the distance from their last node to target. Once k paths ending
+  /// at a node were settled, no other path through that node can be among
+  /// the k shortest ones.
+  std::vector<KShortestPath> FindPaths(
+      const katana::analytics::KShortestPathsQuery& query, uint32_t k,
+      LocalScratch* scratch) {
+    const auto& to_target = scratch->to_target;
+    auto& path_tree = scratch->path_tree;
+    std::vector<KShortestPath> paths;
+
+    path_tree.push_back({query.source, 0, kNoParent, 0});
+    scratch->HeapPush(to_target[query.source], 0);
+    while (!scratch->heap.empty() && paths.size() < k) {
+      uint32_t index = scratch->HeapPop().second;
+      auto entry = path_tree[index];
+      if (scratch->num_settled[entry.node] == 0) {
+        scratch->touched.push_back(entry.node);
+      }
+      if (scratch->num_settled[entry.node]++ >= k) {
+        continue;
+      }
+
+      if (entry.node == query.target) {
+        KShortestPath path;
+        path.weight = entry.distance;
+        for (uint32_t i = index; i != kNoParent; i = path_tree[i].parent) {
+          path.nodes.push_back(path_tree[i].node);
+          if (path_tree[i].parent != kNoParent) {
+            path.edges.push_back(path_tree[i].edge);
+          }
+        }
+        std::reverse(path.nodes.begin(), path.nodes.end());
+        std::reverse(path.edges.begin(), path.edges.end());
+        paths.emplace_back(std::move(path));
+      }
+
+      for (auto e : view_.edges(entry.node)) {
+        Node dest = view_.edge_dest(e);
+        if (to_target[dest] == kInfinity || scratch->num_settled[dest] >= k) {
+          continue;
+        }
+        Distance new_dist = entry.distance + weight(e);
+        KATANA_LOG_DEBUG_ASSERT(path_tree.size() < kNoParent);
+        path_tree.push_back({dest, e, index, new_dist});
+        scratch->HeapPush(
+            new_dist + to_target[dest],
+            static_cast<uint32_t>(path_tree.size() - 1));
+      }
+    }
+    scratch->ClearSearch();
+    return paths;
+  }
+
+  /// Yen's algorithm. The spur paths that deviate from the last path found
+  /// at each of its nodes are independent, so with parallel_spur_paths each
+  /// is found by a separate task with the scratch buffers of its thread.
+  std::vector<KShortestPath> FindSimplePaths(
+      const katana::analytics::KShortestPathsQuery& query, uint32_t k,
+      LocalScratch* scratch, bool parallel_spur_paths) {
+    const auto& to_target = scratch->to_target;
+    std::vector<Candidate> found;
+    std::set<Candidate> candidates;
+
+    auto shortest =
+        FindSpurPath(to_target, query.source, query.target, {}, scratch);
+    if (shortest) {
+      found.emplace_back(std::move(*shortest));
+    }
+
+    while (!found.empty() && found.size() < k) {
+      const Candidate& last = found.back();
+      std::vector<Distance> prefix_weight(last.edges.size() + 1, 0);
+      for (size_t i = 0; i < last.edges.size(); ++i) {
+        prefix_weight[i + 1] = prefix_weight[i] + weight(last.edges[i]);
+      }
+
+      uint32_t num_spur_nodes = last.edges.size();
+      std::vector<std::optional<Candidate>> spur_paths(num_spur_nodes);
+      auto find_spur_path = [&](uint32_t i) {
+        LocalScratch* local = GetScratch();
+        // the edges by which the paths found so far leave the common root
+        std::vector<Edge> banned_edges;
+        for (const auto& path : found) {
+          if (path.edges.size() > i &&
+              std::equal(
+                  path.edges.begin(), path.edges.begin() + i,
+                  last.edges.begin())) {
+            banned_edges.push_back(path.edges[i]);
+          }
+        }
+        for (uint32_t j = 0; j < i; ++j) {
+          local->banned[last.nodes[j]] = 1;
+        }
+        auto spur = FindSpurPath(
+            to_target, last.nodes[i], query.target, banned_edges, local);
+        for (uint32_t j = 0; j < i; ++j) {
+          local->banned[last.nodes[j]] = 0;
+        }
+        num_spur_paths_ += 1;
+        if (!spur) {
+          return;
+        }
+
+        spur->weight += prefix_weight[i];
+        spur->edges.insert(
+            spur->edges.begin(), last.edges.begin(), last.edges.begin() + i);
+        spur->nodes.insert(
+            spur->nodes.begin(), last.nodes.begin(), last.nodes.begin() + i);
+        spur->deviation = i;
+        spur_paths[i] = std::move(spur);
+      };
+
+      if (parallel_spur_paths) {
+        katana::do_all(
+            katana::iterate(last.deviation, num_spur_nodes), find_spur_path,
+            katana::steal(), katana::chunk_size<1>(), katana::no_stats(),
+            katana::loopname("SpurPaths"));
+      } else {
+        for (uint32_t i = last.deviation; i < num_spur_nodes; ++i) {
+          find_spur_path(i);
+        }
+      }
+
+      // the same path may be derived from different paths; the set keeps
+      // one copy
+      for (auto& spur : spur_paths) {
+        if (spur) {
+          candidates.emplace(std::move(*spur));
+        }
+      }
+      if (candidates.empty()) {
+        break;
+      }
+      found.emplace_back(
+          std::move(candidates.extract(candidates.begin()).value()));
+    }
+
+    std::vector<KShortestPath> paths;
+    for (auto& candidate : found) {
+      paths.emplace_back(KShortestPath{
+          std::move(candidate.nodes),
+          std::move(candidate.edges),
+          static_cast<double>(candidate.weight),
+      });
+    }
+    return paths;
+  }
+
+public:
+  KShortestPathsImpl(const View& view, const Weight* weights)
+      : view_(view), weights_(weights) {}
+
+  std::vector<KShortestPath> Answer(
+      const katana::analytics::KShortestPathsQuery& query, uint32_t k,
+      bool simple, bool parallel_spur_paths) {
+    LocalScratch* scratch = GetScratch();
+    ComputeDistancesToTarget(query.target, scratch);
+    std::vector<KShortestPath> paths;
+    if (scratch->to_target[query.source] != kInfinity) {
+      paths = simple ? FindSimplePaths(query, k, scratch, parallel_spur_paths)
+                     : FindPaths(query, k, scratch);
+    }
+    scratch->ClearDistancesToTarget();
+    return paths;
+  }
+
+  uint64_t num_spur_paths() { return num_spur_paths_.reduce(); }
+};
+
+template <typename Weight>
+katana::Result<void>
+CheckWeights(const katana::PropertyGraph& pg, const Weight* weights) {
+  if constexpr (!std::is_unsigned_v<Weight>) {
+    katana::GReduceLogicalOr negative;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, pg.topology().num_edges()),
+        [&](uint64_t e) {
+          // also catches NaN
+          if (!(weights[e] >= 0)) {
+            negative.update(true);
+          }
+        },
+        katana::no_stats());
+    if (negative.reduce()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge weights must be nonnegative");
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename Weight>
+katana::Result<std::vector<std::vector<KShortestPath>>>
+KShortestPathsWithWrap(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::vector<KShortestPathsQuery>& queries, uint32_t k, bool simple,
+    KShortestPathsPlan plan) {
+  if (k == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "k must be positive");
+  }
+  for (const auto& query : queries) {
+    if (query.source >= pg->num_nodes() || query.target >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "query from {} to {} is out of range; the graph has {} nodes",
+          query.source, query.target, pg->num_nodes());
+    }
+  }
+  auto weight_array = KATANA_CHECKED(
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name));
+  const Weight* weights = weight_array->raw_values();
+  KATANA_CHECKED(CheckWeights(*pg, weights));
+
+  const char* region = simple ? "KShortestSimplePaths" : "KShortestPaths";
+  katana::StatTimer exec_time(region);
+  exec_time.start();
+  View view = pg->BuildView<View>();
+  KShortestPathsImpl<Weight> impl(view, weights);
+
+  bool parallel_queries;
+  switch (plan.algorithm()) {
+  case KShortestPathsPlan::kAutomatic:
+    parallel_queries = queries.size() >= katana::getActiveThreads();
+    break;
+  case KShortestPathsPlan::kParallelQueries:
+    parallel_queries = true;
+    break;
+  case KShortestPathsPlan::kParallelSpurPaths:
+    parallel_queries = false;
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  std::vector<std::vector<KShortestPath>> results(queries.size());
+  if (parallel_queries) {
+    katana::do_all(
+        katana::iterate(size_t{0}, queries.size()),
+        [&](size_t i) {
+          results[i] = impl.Answer(queries[i], k, simple, false);
+        },
+        katana::steal(), katana::chunk_size<1>(), katana::no_stats(),
+        katana::loopname("Queries"));
+  } else {
+    for (size_t i = 0; i < queries.size(); ++i) {
+      results[i] = impl.Answer(queries[i], k, simple, true);
+    }
+  }
+  exec_time.stop();
+
+  katana::ReportStatSingle(region, "Queries", queries.size());
+  if (simple) {
+    katana::ReportStatSingle(region, "SpurPaths", impl.num_spur_paths());
+  }
+  return results;
+}
+
+katana::Result<std::vector<std::vector<KShortestPath>>>
+KShortestPathsDispatch(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::vector<KShortestPathsQuery>& queries, uint32_t k, bool simple,
+    KShortestPathsPlan plan) {
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return KShortestPathsWithWrap<uint32_t>(
+        pg, edge_weight_property_name, queries, k, simple, plan);
+  case arrow::Int32Type::type_id:
+    return KShortestPathsWithWrap<int32_t>(
+        pg, edge_weight_property_name, queries, k, simple, plan);
+  case arrow::UInt64Type::type_id:
+    return KShortestPathsWithWrap<uint64_t>(
+        pg, edge_weight_property_name, queries, k, simple, plan);
+  case arrow::Int64Type::type_id:
+    return KShortestPathsWithWrap<int64_t>(
+        pg, edge_weight_property_name, queries, k, simple, plan);
+  case arrow::FloatType::type_id:
+    return KShortestPathsWithWrap<float>(
+        pg, edge_weight_property_name, queries, k, simple, plan);
+  case arrow::DoubleType::type_id:
+    return KShortestPathsWithWrap<double>(
+        pg, edge_weight_property_name, queries, k, simple, plan);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+}  // namespace
+
+katana::Result<std::vector<KShortestPath>>
+katana::analytics::KShortestPaths(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    uint32_t source, uint32_t target, uint32_t k, KShortestPathsPlan plan) {
+  auto results = KATANA_CHECKED(KShortestPathsDispatch(
+      pg, edge_weight_property_name, {{source, target}}, k, false, plan));
+  return std::move(results[0]);
+}
+
+katana::Result<std::vector<std::vector<KShortestPath>>>
+katana::analytics::KShortestPaths(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::vector<KShortestPathsQuery>& queries, uint32_t k,
+    KShortestPathsPlan plan) {
+  return KShortestPathsDispatch(
+      pg, edge_weight_property_name, queries, k, false, plan);
+}
+
+katana::Result<std::vector<KShortestPath>>
+katana::analytics::KShortestSimplePaths(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    uint32_t source, uint32_t target, uint32_t k, KShortestPathsPlan plan) {
+  auto results = KATANA_CHECKED(KShortestPathsDispatch(
+      pg, edge_weight_property_name, {{source, target}}, k, true, plan));
+  return std::move(results[0]);
+}
+
+katana::Result<std::vector<std::vector<KShortestPath>>>
+katana::analytics::KShortestSimplePaths(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::vector<KShortestPathsQuery>& queries, uint32_t k,
+    KShortestPathsPlan plan) {
+  return KShortestPathsDispatch(
+      pg, edge_weight_property_name, queries, k, true, plan);
+}
+
+namespace {
+
+template <typename Weight>
+katana::Result<void>
+KShortestPathsValidateImpl(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const KShortestPathsQuery& query, const std::vector<KShortestPath>& paths,
+    bool simple) {
+  auto weight_array = KATANA_CHECKED(
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name));
+  const Weight* weights = weight_array->raw_values();
+  const auto& topo = pg->topology();
+
+  for (size_t p = 0; p < paths.size(); ++p) {
+    const auto& path = paths[p];
+    if (path.nodes.size() != path.edges.size() + 1 ||
+        path.nodes.front() != query.source ||
+        path.nodes.back() != query.target) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "path {} does not go from {} to {}", p, query.source, query.target);
+    }
+    double weight = 0;
+    for (size_t i = 0; i < path.edges.size(); ++i) {
+      Edge e = path.edges[i];
+      auto edges = topo.edges(path.nodes[i]);
+      if (e < *edges.begin() || e >= *edges.end() ||
+          topo.edge_dest(e) != path.nodes[i + 1]) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "edge {} of path {} does not go from {} to {}", e, p,
+            path.nodes[i], path.nodes[i + 1]);
+      }
+      weight += weights[e];
+    }
+    if (std::abs(weight - path.weight) > 1e-6 * std::max(1.0, weight)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "path {} has weight {} but its edges weigh {}", p, path.weight,
+          weight);
+    }
+    if (p > 0 && path.weight < paths[p - 1].weight) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "path {} is lighter than the path before it", p);
+    }
+    if (simple) {
+      std::vector<Node> nodes = path.nodes;
+      std::sort(nodes.begin(), nodes.end());
+      if (std::adjacent_find(nodes.begin(), nodes.end()) != nodes.end()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed, "path {} is not simple", p);
+      }
+    }
+  }
+
+  std::vector<std::vector<Edge>> edge_lists;
+  for (const auto& path : paths) {
+    edge_lists.emplace_back(path.edges);
+  }
+  std::sort(edge_lists.begin(), edge_lists.end());
+  if (std::adjacent_find(edge_lists.begin(), edge_lists.end()) !=
+      edge_lists.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "a path is returned twice");
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::KShortestPathsAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const KShortestPathsQuery& query, const std::vector<KShortestPath>& paths,
+    bool simple) {
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return KShortestPathsValidateImpl<uint32_t>(
+        pg, edge_weight_property_name, query, paths, simple);
+  case arrow::Int32Type::type_id:
+    return KShortestPathsValidateImpl<int32_t>(
+        pg, edge_weight_property_name, query, paths, simple);
+  case arrow::UInt64Type::type_id:
+    return KShortestPathsValidateImpl<uint64_t>(
+        pg, edge_weight_property_name, query, paths, simple);
+  case arrow::Int64Type::type_id:
+    return KShortestPathsValidateImpl<int64_t>(
+        pg, edge_weight_property_name, query, paths, simple);
+  case arrow::FloatType::type_id:
+    return KShortestPathsValidateImpl<float>(
+        pg, edge_weight_property_name, query, paths, simple);
+  case arrow::DoubleType::type_id:
+    return KShortestPathsValidateImpl<double>(
+        pg, edge_weight_property_name, query, paths, simple);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+void
+KShortestPath::Print(std::ostream& os) const {
+  for (auto node : nodes) {
+    os << node << " ";
+  }
+  os << "weight: " << weight << std::endl;
+}
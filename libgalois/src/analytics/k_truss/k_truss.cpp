@@ -21,6 +21,8 @@
 
 #include "katana/ArrowRandomAccessBuilder.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Intersection.h"
+#include "katana/analytics/PeelingBuckets.h"
 
 using namespace katana::analytics;
 
@@ -35,6 +37,11 @@ typedef typename Graph::Node GNode;
 using SortedGraphView = katana::TypedPropertyGraphView<
     katana::PropertyGraphViews::EdgesSortedByDestID, NodeData, EdgeData>;
 
+using RelabeledPropertyGraphView =
+    katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
+using RelabeledGraphView = katana::TypedPropertyGraphView<
+    RelabeledPropertyGraphView, NodeData, EdgeData>;
+
 using Edge = std::pair<GNode, GNode>;
 using EdgeVec = katana::InsertBag<Edge>;
 using NodeVec = katana::InsertBag<GNode>;
@@ -42,13 +49,16 @@ using NodeVec = katana::InsertBag<GNode>;
 static const uint32_t valid = 0x0;
 static const uint32_t removed = 0x1;
 
+constexpr static const unsigned kTrussChunkSize = 64U;
+
 /// Initialize edge data to valid.
+template <typename GraphView>
 void
-KTrussInitialization(SortedGraphView* g) {
+KTrussInitialization(GraphView* g) {
   //! Initializa all edges to valid.
   katana::do_all(
       katana::iterate(*g),
-      [&g](typename SortedGraphView::Node N) {
+      [&g](typename GraphView::Node N) {
         for (auto e : g->edges(N)) {
           g->template GetEdgeData<EdgeFlag>(e) = valid;
         }
@@ -68,11 +78,12 @@ KTrussInitialization(SortedGraphView* g) {
  * @return true if the target node n has the number of degrees
  *         more than or equal to j
  */
+template <typename GraphView>
 bool
-IsValidDegreeNoLessThanJ(const SortedGraphView& g, GNode n, unsigned int j) {
+IsValidDegreeNoLessThanJ(const GraphView& g, GNode n, unsigned int j) {
   size_t numValid = 0;
   for (auto e : g.edges(n)) {
-    if (!(g.GetEdgeData<EdgeFlag>(e) & removed)) {
+    if (!(g.template GetEdgeData<EdgeFlag>(e) & removed)) {
       numValid += 1;
       if (numValid >= j) {
         return true;
@@ -92,47 +103,34 @@ IsValidDegreeNoLessThanJ(const SortedGraphView& g, GNode n, unsigned int j) {
  *
  * @return true if the src and the dest are included in more than j triangles
  */
+template <typename GraphView>
 bool
 IsSupportNoLessThanJ(
-    const SortedGraphView& g, GNode src, GNode dest, unsigned int j) {
+    const GraphView& g, GNode src, GNode dest, unsigned int j) {
   size_t numValidEqual = 0;
-  auto srcI = g.edges(src).begin(), srcE = g.edges(src).end(),
-       dstI = g.edges(dest).begin(), dstE = g.edges(dest).end();
-
-  while (true) {
-    //! Find the first valid edge.
-    while (srcI != srcE && (g.GetEdgeData<EdgeFlag>(*srcI) & removed)) {
-      ++srcI;
-    }
-    while (dstI != dstE && (g.GetEdgeData<EdgeFlag>(*dstI) & removed)) {
-      ++dstI;
-    }
-
-    if (srcI == srcE || dstI == dstE) {
-      return numValidEqual >= j;
-    }
-
-    //! Check for intersection.
-    auto sN = g.edge_dest(*srcI), dN = g.edge_dest(*dstI);
-    if (sN < dN) {
-      ++srcI;
-    } else if (dN < sN) {
-      ++dstI;
-    } else {
-      numValidEqual += 1;
-      if (numValidEqual >= j) {
-        return true;
-      }
-      ++srcI;
-      ++dstI;
-    }
-  }
+  auto src_first = *g.edges(src).begin();
+  auto dest_first = *g.edges(dest).begin();
+
+  //! Intersect the full adjacency lists and only count common neighbors
+  //! reached through valid edges on both sides.
+  IntersectForEach(
+      SortedNeighbors(g, src), SortedNeighbors(g, dest),
+      [&](size_t src_index, size_t dest_index) {
+        auto src_flag = g.template GetEdgeData<EdgeFlag>(src_first + src_index);
+        auto dest_flag =
+            g.template GetEdgeData<EdgeFlag>(dest_first + dest_index);
+        if (!(src_flag & removed) && !(dest_flag & removed)) {
+          numValidEqual += 1;
+        }
+        return numValidEqual < j;
+      });
 
   return numValidEqual >= j;
 }
 
+template <typename GraphView>
 struct PickUnsupportedEdges {
-  SortedGraphView* g;
+  GraphView* g;
   unsigned int j;
   EdgeVec& r;  ///< unsupported
   EdgeVec& s;  ///< next
@@ -148,8 +146,9 @@ struct PickUnsupportedEdges {
 /// 2. If no unsupported edges are found, done.
 /// 3. Remove unsupported edges in a separated loop.
 /// 4. Go back to 1.
+template <typename GraphView>
 katana::Result<void>
-BSPTrussJacobiAlgo(SortedGraphView* g, uint32_t k) {
+BSPTrussJacobiAlgo(GraphView* g, uint32_t k) {
   if (k <= 2) {
     return katana::ErrorCode::InvalidArgument;
   }
@@ -175,7 +174,8 @@ BSPTrussJacobiAlgo(SortedGraphView* g, uint32_t k) {
   while (true) {
     katana::do_all(
         katana::iterate(*cur),
-        PickUnsupportedEdges{g, k - 2, unsupported, *next}, katana::steal());
+        PickUnsupportedEdges<GraphView>{g, k - 2, unsupported, *next},
+        katana::steal());
 
     if (std::distance(unsupported.begin(), unsupported.end()) == 0) {
       break;
@@ -201,8 +201,9 @@ BSPTrussJacobiAlgo(SortedGraphView* g, uint32_t k) {
   return katana::ResultSuccess();
 }
 
+template <typename GraphView>
 struct KeepSupportedEdges {
-  SortedGraphView* g;
+  GraphView* g;
   unsigned int j;
   EdgeVec& s;
 
@@ -224,8 +225,9 @@ struct KeepSupportedEdges {
 /// 1. Keep supported edges and remove unsupported edges.
 /// 2. If all edges are kept, done.
 /// 3. Go back to 3.
+template <typename GraphView>
 katana::Result<void>
-BSPTrussAlgo(SortedGraphView* g, unsigned int k) {
+BSPTrussAlgo(GraphView* g, unsigned int k) {
   if (k <= 2) {
     return katana::ErrorCode::InvalidArgument;
   }
@@ -252,7 +254,7 @@ BSPTrussAlgo(SortedGraphView* g, unsigned int k) {
   //! Remove unsupported edges until no more edges can be removed.
   while (true) {
     katana::do_all(
-        katana::iterate(*cur), KeepSupportedEdges{g, k - 2, *next},
+        katana::iterate(*cur), KeepSupportedEdges<GraphView>{g, k - 2, *next},
         katana::steal());
     nextSize = std::distance(next->begin(), next->end());
 
@@ -268,8 +270,9 @@ BSPTrussAlgo(SortedGraphView* g, unsigned int k) {
   return katana::ResultSuccess();
 }
 
+template <typename GraphView>
 struct KeepValidNodes {
-  SortedGraphView* g;
+  GraphView* g;
   unsigned int j;
   NodeVec& s;
 
@@ -293,14 +296,16 @@ struct KeepValidNodes {
 /// 1. Keep nodes w/ degree >= k and remove all edges for nodes whose degree < k.
 /// 2. If all nodes are kept, done.
 /// 3. Go back to 1.
+template <typename GraphView>
 katana::Result<void>
-BSPCoreAlgo(SortedGraphView* g, uint32_t k) {
+BSPCoreAlgo(GraphView* g, uint32_t k) {
   auto cur = std::make_unique<NodeVec>();
   auto next = std::make_unique<NodeVec>();
   size_t curSize = g->num_nodes(), nextSize;
 
   katana::do_all(
-      katana::iterate(*g), KeepValidNodes{g, k, *next}, katana::steal());
+      katana::iterate(*g), KeepValidNodes<GraphView>{g, k, *next},
+      katana::steal());
   nextSize = std::distance(next->begin(), next->end());
 
   while (curSize != nextSize) {
@@ -309,7 +314,8 @@ BSPCoreAlgo(SortedGraphView* g, uint32_t k) {
     std::swap(cur, next);
 
     katana::do_all(
-        katana::iterate(*cur), KeepValidNodes{g, k, *next}, katana::steal());
+        katana::iterate(*cur), KeepValidNodes<GraphView>{g, k, *next},
+        katana::steal());
     nextSize = std::distance(next->begin(), next->end());
   }
   return katana::ResultSuccess();
@@ -318,8 +324,9 @@ BSPCoreAlgo(SortedGraphView* g, uint32_t k) {
 /// BSPCoreThenTrussAlgo:
 /// 1. Reduce the graph to k-1 core
 /// 2. Compute k-truss from k-1 core
+template <typename GraphView>
 katana::Result<void>
-BSPCoreThenTrussAlgo(SortedGraphView* g, uint32_t k) {
+BSPCoreThenTrussAlgo(GraphView* g, uint32_t k) {
   if (k <= 2) {
     return katana::ErrorCode::InvalidArgument;
   }
@@ -344,6 +351,26 @@ BSPCoreThenTrussAlgo(SortedGraphView* g, uint32_t k) {
   return katana::ResultSuccess();
 }
 
+template <typename GraphView>
+katana::Result<void>
+KTrussWithView(GraphView* graph, uint32_t k_truss_number, KTrussPlan plan) {
+  KTrussInitialization(graph);
+
+  katana::StatTimer exec_time("KTruss");
+  exec_time.start();
+
+  switch (plan.algorithm()) {
+  case KTrussPlan::kBsp:
+    return BSPTrussAlgo(graph, k_truss_number);
+  case KTrussPlan::kBspJacobi:
+    return BSPTrussJacobiAlgo(graph, k_truss_number);
+  case KTrussPlan::kBspCoreThenTruss:
+    return BSPCoreThenTrussAlgo(graph, k_truss_number);
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+}
+
 katana::Result<void>
 katana::analytics::KTruss(
     katana::PropertyGraph* pg, uint32_t k_truss_number,
@@ -356,40 +383,337 @@ katana::analytics::KTruss(
     return result.error();
   }
 
-  // // TODO(amp): Don't mutate the users topology!
-  // auto result = katana::SortAllEdgesByDest(pg);
-  // if (!result) {
-  // return result.error();
-  // }
-  //
-  // auto pg_result = Graph::Make(pg, {}, {output_property_name});
-  // if (!pg_result) {
-  // return pg_result.error();
-  // }
-  // auto graph = pg_result.value();
-
-  auto gv_res = SortedGraphView::Make(pg, {}, {output_property_name});
-  if (!gv_res) {
-    return gv_res.error();
+  // Truss membership does not depend on node order, so reuse the degree
+  // sorted view triangle count or LCC may have cached instead of sorting the
+  // topology a second time.
+  if (pg->IsViewCached<RelabeledPropertyGraphView>()) {
+    auto graph = KATANA_CHECKED(
+        RelabeledGraphView::Make(pg, {}, {output_property_name}));
+    return KTrussWithView(&graph, k_truss_number, plan);
   }
 
-  auto graph = gv_res.value();
+  auto graph =
+      KATANA_CHECKED(SortedGraphView::Make(pg, {}, {output_property_name}));
+  return KTrussWithView(&graph, k_truss_number, plan);
+}
 
-  KTrussInitialization(&graph);
+/*******************************************************************************
+ * Truss decomposition
+ ******************************************************************************/
+struct EdgeTrussness : public katana::PODProperty<uint32_t> {};
+using TrussnessEdgeData = std::tuple<EdgeTrussness>;
 
-  katana::StatTimer exec_time("KTruss");
+template <typename PGView>
+using TrussnessGraphView =
+    katana::TypedPropertyGraphView<PGView, NodeData, TrussnessEdgeData>;
+
+namespace {
+
+/// Peeling state of an undirected edge.
+enum TrussEdgeState : uint8_t { kAlive, kInFrontier, kPeeled };
+
+/**
+ * An undirected edge {src, dst} is represented by its direction with
+ * src < dst.
+ *
+ * @param e the edge src -> dst
+ * @return the edge min(src, dst) -> max(src, dst)
+ */
+template <typename GraphView>
+typename GraphView::Edge
+CanonicalEdge(
+    const GraphView& g, typename GraphView::Node src,
+    typename GraphView::Node dst, typename GraphView::Edge e) {
+  if (src < dst) {
+    return e;
+  }
+  return *g.find_edge(dst, src);
+}
+
+/**
+ * Count the triangles of each undirected edge. Each triangle u < v < w is
+ * found once, from the edge (u, v), and credited to its three edges.
+ */
+template <typename GraphView>
+void
+ComputeEdgeSupport(
+    const GraphView& g,
+    katana::NUMAArray<std::atomic<uint32_t>>* support) noexcept {
+  using Node = typename GraphView::Node;
+  const Node* dests = g.dest_data();
+
+  katana::do_all(
+      katana::iterate(g),
+      [&](Node u) {
+        auto u_higher = SortedNeighbors(g, u).GreaterThan(u);
+        for (size_t i = 0; i < u_higher.size; ++i) {
+          Node v = u_higher[i];
+          auto w_candidates = u_higher.GreaterThan(v);
+          auto v_higher = SortedNeighbors(g, v).GreaterThan(v);
+
+          uint32_t num_triangles = 0;
+          IntersectForEach(
+              w_candidates, v_higher, [&](size_t uw_index, size_t vw_index) {
+                num_triangles += 1;
+                (*support)[w_candidates.data + uw_index - dests].fetch_add(
+                    1, std::memory_order_relaxed);
+                (*support)[v_higher.data + vw_index - dests].fetch_add(
+                    1, std::memory_order_relaxed);
+              });
+          (*support)[u_higher.data + i - dests].fetch_add(
+              num_triangles, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::chunk_size<kTrussChunkSize>(),
+      katana::loopname("KTrussDecomposition Support"));
+}
+
+/**
+ * Peel undirected edges in increasing order of support. At level l, every
+ * remaining edge with support l gets trussness l + 2 and is removed, which
+ * lowers the support of the other two edges of its remaining triangles.
+ *
+ * When two edges of a triangle are peeled in the same round, only the one
+ * with the smaller index lowers the support of the third edge (PKT).
+ * Support never drops below the current level, because edges at the level
+ * are peeled anyway.
+ */
+template <typename GraphView>
+void
+BucketPeelingKTrussDecomposition(
+    GraphView* g, uint32_t num_open_buckets) noexcept {
+  using Node = typename GraphView::Node;
+  using Edge = typename GraphView::Edge;
+  using Bag = katana::InsertBag<Edge>;
+
+  const size_t num_edges = g->num_edges();
+  const Node* dests = g->dest_data();
+
+  katana::NUMAArray<std::atomic<uint32_t>> support;
+  support.allocateInterleaved(num_edges);
+  katana::NUMAArray<std::atomic<uint8_t>> state;
+  state.allocateInterleaved(num_edges);
+  // Edges whose support changed in the current level, to be pushed to their
+  // new bucket once the level is done
+  katana::NUMAArray<std::atomic<bool>> moved;
+  moved.allocateInterleaved(num_edges);
+
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t e) {
+        support[e].store(0, std::memory_order_relaxed);
+        state[e].store(kAlive, std::memory_order_relaxed);
+        moved[e].store(false, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  ComputeEdgeSupport(*g, &support);
+
+  katana::analytics::PeelingBuckets<Edge> buckets(num_open_buckets);
+  katana::GAccumulator<size_t> num_undirected;
+  katana::do_all(
+      katana::iterate(*g),
+      [&](Node u) {
+        for (auto e : g->edges(u)) {
+          auto v = g->edge_dest(e);
+          if (u < v) {
+            buckets.Push(e, support[e].load(std::memory_order_relaxed));
+            num_undirected += 1;
+          } else if (u == v) {
+            g->template GetEdgeData<EdgeTrussness>(e) = 0;
+          }
+        }
+      },
+      katana::steal(), katana::loopname("KTrussDecomposition Initialize"));
+
+  auto frontier = std::make_unique<Bag>();
+  auto next = std::make_unique<Bag>();
+  Bag moved_edges;
+  const size_t num_to_peel = num_undirected.reduce();
+  size_t num_peeled = 0;
+
+  for (uint32_t l = 0; num_peeled < num_to_peel; ++l) {
+    if (!buckets.InWindow(l)) {
+      //! All remaining edges are in overflow.
+      l = buckets.Advance(
+          [&](Edge e) { return support[e].load(); },
+          [&](Edge e) { return state[e].load() == kAlive; });
+    }
+
+    Bag& bucket = buckets.Bucket(l);
+    if (bucket.empty()) {
+      continue;
+    }
+
+    //! Claim the edges in this bucket. Stale entries belong to edges that
+    //! were already peeled at a lower level.
+    katana::do_all(
+        katana::iterate(bucket),
+        [&](Edge e) {
+          uint8_t expected = kAlive;
+          if (state[e].compare_exchange_strong(expected, kInFrontier)) {
+            frontier->push(e);
+          }
+        },
+        katana::no_stats());
+    bucket.clear();
+
+    auto lower_support = [&](Edge e) {
+      if (support[e].load(std::memory_order_relaxed) <= l) {
+        return;
+      }
+      uint32_t old_support = support[e].fetch_sub(1);
+      if (old_support == l + 1) {
+        //! e dropped to this level, so it is peeled in the next round.
+        next->push(e);
+      } else if (old_support <= l) {
+        support[e].fetch_add(1);
+      } else if (!moved[e].exchange(true)) {
+        moved_edges.push(e);
+      }
+    };
+
+    katana::GAccumulator<size_t> level_peeled;
+    while (!frontier->empty()) {
+      katana::do_all(
+          katana::iterate(*frontier),
+          [&](Edge e) {
+            Node u = g->edge_source(e);
+            Node v = g->edge_dest(e);
+            auto u_neighbors = SortedNeighbors(*g, u);
+            auto v_neighbors = SortedNeighbors(*g, v);
+
+            IntersectForEach(
+                u_neighbors, v_neighbors, [&](size_t u_index, size_t v_index) {
+                  Node w = u_neighbors[u_index];
+                  if (w == u || w == v) {
+                    return;
+                  }
+                  Edge uw = CanonicalEdge(
+                      *g, u, w, u_neighbors.data + u_index - dests);
+                  Edge vw = CanonicalEdge(
+                      *g, v, w, v_neighbors.data + v_index - dests);
+                  uint8_t uw_state = state[uw].load(std::memory_order_relaxed);
+                  uint8_t vw_state = state[vw].load(std::memory_order_relaxed);
+
+                  if (uw_state == kPeeled || vw_state == kPeeled) {
+                    return;
+                  }
+                  if (uw_state == kInFrontier && vw_state == kInFrontier) {
+                    return;
+                  }
+                  if (uw_state == kInFrontier) {
+                    if (e < uw) {
+                      lower_support(vw);
+                    }
+                    return;
+                  }
+                  if (vw_state == kInFrontier) {
+                    if (e < vw) {
+                      lower_support(uw);
+                    }
+                    return;
+                  }
+                  lower_support(uw);
+                  lower_support(vw);
+                });
+          },
+          katana::steal(), katana::chunk_size<kTrussChunkSize>(),
+          katana::loopname("KTrussDecomposition Peel"));
+
+      katana::do_all(
+          katana::iterate(*frontier),
+          [&](Edge e) {
+            state[e].store(kPeeled, std::memory_order_relaxed);
+            g->template GetEdgeData<EdgeTrussness>(e) = l + 2;
+            level_peeled += 1;
+          },
+          katana::no_stats());
+
+      frontier->clear();
+      std::swap(frontier, next);
+
+      katana::do_all(
+          katana::iterate(*frontier),
+          [&](Edge e) { state[e].store(kInFrontier); }, katana::no_stats());
+    }
+    num_peeled += level_peeled.reduce();
+
+    //! Edges of support beyond the window are still in overflow, so only
+    //! edges that moved into the window need a new entry.
+    katana::do_all(
+        katana::iterate(moved_edges),
+        [&](Edge e) {
+          moved[e].store(false, std::memory_order_relaxed);
+          if (state[e].load(std::memory_order_relaxed) == kAlive) {
+            buckets.PushMoved(e, support[e].load());
+          }
+        },
+        katana::no_stats());
+    moved_edges.clear();
+  }
+
+  //! Copy the trussness of each undirected edge to its other direction.
+  katana::do_all(
+      katana::iterate(*g),
+      [&](Node u) {
+        for (auto e : g->edges(u)) {
+          auto v = g->edge_dest(e);
+          if (v < u) {
+            g->template GetEdgeData<EdgeTrussness>(e) =
+                g->template GetEdgeData<EdgeTrussness>(*g->find_edge(v, u));
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+}
+
+template <typename GraphView>
+katana::Result<void>
+KTrussDecompositionWithView(
+    GraphView* graph, KTrussDecompositionPlan plan) noexcept {
+  katana::StatTimer exec_time("KTrussDecomposition");
   exec_time.start();
 
   switch (plan.algorithm()) {
-  case KTrussPlan::kBsp:
-    return BSPTrussAlgo(&graph, k_truss_number);
-  case KTrussPlan::kBspJacobi:
-    return BSPTrussJacobiAlgo(&graph, k_truss_number);
-  case KTrussPlan::kBspCoreThenTruss:
-    return BSPCoreThenTrussAlgo(&graph, k_truss_number);
+  case KTrussDecompositionPlan::kBucketPeeling:
+    BucketPeelingKTrussDecomposition(graph, plan.num_open_buckets());
+    break;
   default:
     return katana::ErrorCode::InvalidArgument;
   }
+
+  exec_time.stop();
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::KTrussDecomposition(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    KTrussDecompositionPlan plan) {
+  katana::ReportPageAllocGuard page_alloc;
+
+  if (auto result = ConstructEdgeProperties<TrussnessEdgeData>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  // The peeling intersects sorted adjacency lists, so it runs on a sorted
+  // view; a relabeled one cached by triangle count or LCC works as well.
+  if (pg->IsViewCached<RelabeledPropertyGraphView>()) {
+    auto graph =
+        KATANA_CHECKED(TrussnessGraphView<RelabeledPropertyGraphView>::Make(
+            pg, {}, {output_property_name}));
+    return KTrussDecompositionWithView(&graph, plan);
+  }
+
+  auto graph = KATANA_CHECKED(
+      TrussnessGraphView<katana::PropertyGraphViews::EdgesSortedByDestID>::Make(
+          pg, {}, {output_property_name}));
+  return KTrussDecompositionWithView(&graph, plan);
 }
 
 // Doxygen doesn't correctly handle implementation annotations that do not
@@ -433,9 +757,112 @@ katana::analytics::KTrussStatistics::Compute(
 
   return KTrussStatistics{alive_edges.reduce()};
 }
+
+katana::Result<void>
+katana::analytics::KTrussDecompositionAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  using GraphView =
+      TrussnessGraphView<katana::PropertyGraphViews::EdgesSortedByDestID>;
+  auto graph = KATANA_CHECKED(GraphView::Make(pg, {}, {property_name}));
+  using Node = GraphView::Node;
+
+  auto trussness = [&](Node src, Node dst, GraphView::Edge e) -> uint32_t {
+    return graph.GetEdgeData<EdgeTrussness>(CanonicalEdge(graph, src, dst, e));
+  };
+  const Node* dests = graph.dest_data();
+
+  std::atomic<bool> not_consistent(false);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node u) {
+        auto u_neighbors = SortedNeighbors(graph, u);
+        for (auto e : graph.edges(u)) {
+          Node v = graph.edge_dest(e);
+          uint32_t t = graph.GetEdgeData<EdgeTrussness>(e);
+          if (u == v) {
+            not_consistent = not_consistent || t != 0;
+            continue;
+          }
+          if (t != graph.GetEdgeData<EdgeTrussness>(*graph.find_edge(v, u))) {
+            not_consistent = true;
+            continue;
+          }
+          if (t < 2) {
+            not_consistent = true;
+            continue;
+          }
+
+          //! The t-truss needs t - 2 triangles whose edges all stay in it.
+          auto v_neighbors = SortedNeighbors(graph, v);
+          uint32_t num_supporting = 0;
+          IntersectForEach(
+              u_neighbors, v_neighbors, [&](size_t u_index, size_t v_index) {
+                Node w = u_neighbors[u_index];
+                if (w == u || w == v) {
+                  return;
+                }
+                if (trussness(u, w, u_neighbors.data + u_index - dests) >= t &&
+                    trussness(v, w, v_neighbors.data + v_index - dests) >= t) {
+                  num_supporting += 1;
+                }
+              });
+          if (num_supporting < t - 2) {
+            not_consistent = true;
+          }
+        }
+      },
+      katana::steal(), katana::loopname("KTrussDecomposition sanity check"));
+
+  if (not_consistent) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<KTrussDecompositionStatistics>
+katana::analytics::KTrussDecompositionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  using TrussnessGraph =
+      katana::TypedPropertyGraph<NodeData, TrussnessEdgeData>;
+  auto graph = KATANA_CHECKED(TrussnessGraph::Make(pg, {}, {property_name}));
+
+  katana::GReduceMax<uint32_t> max_trussness;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        for (auto e : graph.edges(node)) {
+          max_trussness.update(graph.GetEdgeData<EdgeTrussness>(e));
+        }
+      },
+      katana::no_stats());
+  uint32_t max = graph.num_edges() > 0 ? max_trussness.reduce() : 0;
+
+  katana::GAccumulator<uint64_t> edges_in_max_truss;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        for (auto e : graph.edges(node)) {
+          if (node < *graph.GetEdgeDest(e) &&
+              graph.GetEdgeData<EdgeTrussness>(e) == max) {
+            edges_in_max_truss += 1;
+          }
+        }
+      },
+      katana::loopname("KTrussDecomposition statistics"), katana::no_stats());
+
+  return KTrussDecompositionStatistics{max, edges_in_max_truss.reduce()};
+}
 /// \endcond DO_NOT_DOCUMENT
 
 void
 katana::analytics::KTrussStatistics::Print(std::ostream& os) const {
   os << "Number of nodes in the core = " << number_of_edges_left << std::endl;
 }
+
+void
+katana::analytics::KTrussDecompositionStatistics::Print(
+    std::ostream& os) const {
+  os << "Max trussness = " << max_trussness << std::endl;
+  os << "Number of edges in the max truss = " << number_of_edges_in_max_truss
+     << std::endl;
+}
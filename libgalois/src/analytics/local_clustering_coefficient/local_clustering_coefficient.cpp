@@ -20,6 +20,7 @@
 #include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
 
 #include "katana/AtomicHelpers.h"
+#include "katana/analytics/Intersection.h"
 
 using namespace katana::analytics;
 
@@ -32,48 +33,57 @@ using NodeData = typename std::tuple<NodeClusteringCoefficient>;
 using EdgeData = typename std::tuple<>;
 
 using SortedPropertyGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
-using SortedGraphView =
-    katana::TypedPropertyGraphView<SortedPropertyGraphView, NodeData, EdgeData>;
-using Node = SortedGraphView::Node;
+using RelabeledPropertyGraphView =
+    katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
 
+template <typename PGView>
+using TypedGraphView =
+    katana::TypedPropertyGraphView<PGView, NodeData, EdgeData>;
+
+/**
+ * Calls fn(v, w) for each triangle (n, v, w) with w <= v <= n. The adjacency
+ * lists must be sorted.
+ */
+template <typename Graph, typename Fn>
+void
+ForEachOrderedTriangle(
+    const Graph& graph, typename Graph::Node n, const Fn& fn) {
+  using Node = typename Graph::Node;
+
+  auto n_lower = SortedNeighbors(graph, n).LessThanOrEqual(n);
+  for (size_t i = 0; i < n_lower.size; ++i) {
+    Node v = n_lower[i];
+    // n_lower is sorted, so the neighbors of n up to v are its first i + 1
+    SortedSpan<Node> n_prefix{n_lower.data, i + 1};
+    IntersectForEach(
+        n_prefix, SortedNeighbors(graph, v).LessThanOrEqual(v),
+        [&](size_t w_index, size_t) { fn(v, n_prefix[w_index]); });
+  }
+}
+
+template <typename Graph>
 struct LocalClusteringCoefficientAtomics {
+  using Node = typename Graph::Node;
+
   /**
    * Counts the number of triangles for each node
    * in the graph using atomics.
    *
-   * Uses simple 3-level nested algorithm to find
-   * triangles. It assumes that edgelist of each node
+   * Finds triangles by intersecting sorted adjacency
+   * lists. It assumes that edgelist of each node
    * is sorted.
    */
   template <typename CountVec>
   void OrderedCountFunc(
-      const SortedGraphView& graph, Node n, CountVec* count_vec) {
-    // TODO(amber): replace with NodeIteratingAlgo for triangle counting
-    for (auto edges_n : graph.edges(n)) {
-      auto v = graph.edge_dest(edges_n);
-      if (v > n) {
-        break;
-      }
-      auto e_it_n = graph.edges(n).begin();
-
-      for (auto edges_v : graph.edges(v)) {
-        auto dst_v = graph.edge_dest(edges_v);
-        if (dst_v > v) {
-          break;
-        }
-        while (graph.edge_dest(*e_it_n) < dst_v) {
-          e_it_n++;
-        }
-        if (dst_v == graph.edge_dest(*e_it_n)) {
-          __sync_fetch_and_add(&(*count_vec)[n], uint32_t{1});
-          __sync_fetch_and_add(&(*count_vec)[v], uint32_t{1});
-          __sync_fetch_and_add(&(*count_vec)[dst_v], uint32_t{1});
-        }
-      }
-    }
+      const Graph& graph, Node n, CountVec* count_vec) {
+    ForEachOrderedTriangle(graph, n, [&](Node v, Node w) {
+      __sync_fetch_and_add(&(*count_vec)[n], uint32_t{1});
+      __sync_fetch_and_add(&(*count_vec)[v], uint32_t{1});
+      __sync_fetch_and_add(&(*count_vec)[w], uint32_t{1});
+    });
   }
 
-  void ComputeLocalClusteringCoefficient(SortedGraphView* graph) {
+  void ComputeLocalClusteringCoefficient(Graph* graph) {
     katana::NUMAArray<uint32_t> per_node_triangles;
     per_node_triangles.allocateInterleaved(graph->num_nodes());
 
@@ -103,7 +113,7 @@ struct LocalClusteringCoefficientAtomics {
     return;
   }
 
-  katana::Result<void> operator()(SortedGraphView* graph) {
+  katana::Result<void> operator()(Graph* graph) {
     katana::StatTimer execTime(
         "LocalClusteringCoefficient", "LocalClusteringCoefficient");
     execTime.start();
@@ -117,7 +127,9 @@ struct LocalClusteringCoefficientAtomics {
   }
 };
 
+template <typename Graph>
 struct LocalClusteringCoefficientPerThread {
+  using Node = typename Graph::Node;
   using TriangleCountVec = katana::NUMAArray<uint32_t>;
   using IterPair =
       std::pair<TriangleCountVec::iterator, TriangleCountVec::iterator>;
@@ -127,35 +139,17 @@ struct LocalClusteringCoefficientPerThread {
  * Counts the number of triangles for each node
  * in the graph using a per-thread implementation.
  *
- * Uses simple 3-level nested algorithm to find
- * triangles. It assumes that edgelist of each node
+ * Finds triangles by intersecting sorted adjacency
+ * lists. It assumes that edgelist of each node
  * is sorted.
  */
   void OrderedCountFunc(
-      const SortedGraphView& graph, Node n, IterPair per_thread_count_range) {
-    // TODO(amber): replace with NodeIteratingAlgo for triangle counting
-    for (auto edges_n : graph.edges(n)) {
-      auto v = graph.edge_dest(edges_n);
-      if (v > n) {
-        break;
-      }
-      auto e_it_n = graph.edges(n).begin();
-
-      for (auto edges_v : graph.edges(v)) {
-        auto dst_v = graph.edge_dest(edges_v);
-        if (dst_v > v) {
-          break;
-        }
-        while (graph.edge_dest(*e_it_n) < dst_v) {
-          e_it_n++;
-        }
-        if (dst_v == graph.edge_dest(*e_it_n)) {
-          *(per_thread_count_range.first + n) += 1;
-          *(per_thread_count_range.first + v) += 1;
-          *(per_thread_count_range.first + dst_v) += 1;
-        }
-      }
-    }
+      const Graph& graph, Node n, IterPair per_thread_count_range) {
+    ForEachOrderedTriangle(graph, n, [&](Node v, Node w) {
+      *(per_thread_count_range.first + n) += 1;
+      *(per_thread_count_range.first + v) += 1;
+      *(per_thread_count_range.first + w) += 1;
+    });
   }
 
   /*
@@ -163,7 +157,7 @@ struct LocalClusteringCoefficientPerThread {
  * It assumes that edgelist of each node is sorted.
  * This uses a PerThreadStorage implementation.
  */
-  void OrderedCountAlgo(const SortedGraphView& graph) {
+  void OrderedCountAlgo(const Graph& graph) {
     const uint64_t num_nodes = graph.size();
     const uint32_t num_threads = katana::getActiveThreads();
 
@@ -203,7 +197,7 @@ struct LocalClusteringCoefficientPerThread {
         katana::loopname("TriangleCount_Reduce"));
   }
 
-  void ComputeLocalClusteringCoefficient(SortedGraphView* graph) {
+  void ComputeLocalClusteringCoefficient(Graph* graph) {
     katana::do_all(katana::iterate(*graph), [&](Node n) {
       auto degree = graph->degree(n);
       if (degree > 1) {
@@ -218,7 +212,7 @@ struct LocalClusteringCoefficientPerThread {
     return;
   }
 
-  katana::Result<void> operator()(SortedGraphView* graph) {
+  katana::Result<void> operator()(Graph* graph) {
     katana::StatTimer execTime(
         "LocalClusteringCoefficient", "LocalClusteringCoefficient");
     execTime.start();
@@ -239,7 +233,7 @@ struct LocalClusteringCoefficientPerThread {
 };
 }  // namespace
 
-template <typename Algorithm>
+template <template <typename> class Algorithm, typename PGView>
 katana::Result<void>
 LocalClusteringCoefficientWithWrap(
     katana::PropertyGraph* pg, const std::string& output_property_name) {
@@ -248,24 +242,40 @@ LocalClusteringCoefficientWithWrap(
       !result) {
     return result.error();
   }
-  auto sorted_view =
-      KATANA_CHECKED(SortedGraphView::Make(pg, {output_property_name}, {}));
+  auto graph = KATANA_CHECKED(
+      TypedGraphView<PGView>::Make(pg, {output_property_name}, {}));
 
-  Algorithm algo;
-  return algo(&sorted_view);
+  Algorithm<TypedGraphView<PGView>> algo;
+  return algo(&graph);
+}
+
+template <typename PGView>
+katana::Result<void>
+LocalClusteringCoefficientWithView(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    LocalClusteringCoefficientPlan plan) {
+  switch (plan.algorithm()) {
+  case LocalClusteringCoefficientPlan::kOrderedCountAtomics: {
+    return LocalClusteringCoefficientWithWrap<
+        LocalClusteringCoefficientAtomics, PGView>(pg, output_property_name);
+  }
+  case LocalClusteringCoefficientPlan::kOrderedCountPerThread: {
+    return LocalClusteringCoefficientWithWrap<
+        LocalClusteringCoefficientPerThread, PGView>(pg, output_property_name);
+  }
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
 }
 
 katana::Result<void>
 katana::analytics::LocalClusteringCoefficient(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     LocalClusteringCoefficientPlan plan) {
-  katana::StatTimer timer_graph_read(
-      "GraphReadingTime", "LocalClusteringCoefficient");
   katana::StatTimer timer_auto_algo(
       "AutoRelabel", "LocalClusteringCoefficient");
 
-  [[maybe_unused]] bool relabel;
-  timer_graph_read.start();
+  bool relabel = false;
   switch (plan.relabeling()) {
   case LocalClusteringCoefficientPlan::kNoRelabel:
     relabel = false;
@@ -275,52 +285,25 @@ katana::analytics::LocalClusteringCoefficient(
     break;
   case LocalClusteringCoefficientPlan::kAutoRelabel:
     timer_auto_algo.start();
-    relabel = IsApproximateDegreeDistributionPowerLaw(*pg);
+    // A relabeled view left in the cache by an earlier call is free to reuse
+    relabel = pg->IsViewCached<RelabeledPropertyGraphView>() ||
+              IsApproximateDegreeDistributionPowerLaw(*pg);
     timer_auto_algo.stop();
     break;
   default:
     return katana::ErrorCode::AssertionFailed;
   }
 
-  // TODO(amber): For now, we create a sorted view (in
-  // LocalClusteringCoefficientWithWrap) unconditionally. With current triangle
-  // counting algorithm, relabelling is not expected to help, but it will once we
-  // switch to NodeIteratingAlgo, at which point, change the
-  // SortedPropertyGraphView to
-  // PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID
-#if 0
-  if (relabel) {
-    katana::StatTimer timer_relabel(
-        "GraphRelabelTimer", "LocalClusteringCoefficient");
-    timer_relabel.start();
-    if (auto r = katana::SortNodesByDegree(pg); !r) {
-      return r.error();
-    }
-    timer_relabel.stop();
-  }
-
-  // If we relabel we must also sort. Relabeling will break the sorting.
-  if (relabel || !plan.edges_sorted()) {
-    if (auto r = katana::SortAllEdgesByDest(pg); !r) {
-      return r.error();
-    }
-  }
-#endif
-
-  timer_graph_read.stop();
-
   katana::EnsurePreallocated(1, 16 * (pg->num_nodes() + pg->num_edges()));
 
-  switch (plan.algorithm()) {
-  case LocalClusteringCoefficientPlan::kOrderedCountAtomics: {
-    return LocalClusteringCoefficientWithWrap<
-        LocalClusteringCoefficientAtomics>(pg, output_property_name);
-  }
-  case LocalClusteringCoefficientPlan::kOrderedCountPerThread: {
-    return LocalClusteringCoefficientWithWrap<
-        LocalClusteringCoefficientPerThread>(pg, output_property_name);
-  }
-  default:
-    return katana::ErrorCode::InvalidArgument;
+  // The sorted views are cached in pg, so triangle count, k-truss and
+  // repeated calls reuse them instead of sorting again. The views sort the
+  // edges of a node only if they are out of order, which makes
+  // plan.edges_sorted() a cheap check rather than a separate code path.
+  if (relabel) {
+    return LocalClusteringCoefficientWithView<RelabeledPropertyGraphView>(
+        pg, output_property_name, plan);
   }
+  return LocalClusteringCoefficientWithView<SortedPropertyGraphView>(
+      pg, output_property_name, plan);
 }
@@ -19,9 +19,14 @@
 
 #include "katana/analytics/louvain_clustering/louvain_clustering.h"
 
+#include <atomic>
 #include <deque>
+#include <limits>
+#include <string>
 #include <type_traits>
 
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/ClusteringImplementationBase.h"
 
@@ -49,9 +54,12 @@ struct LouvainClusteringImplementation
   using Base = katana::analytics::ClusteringImplementationBase<
       Graph, EdgeWeightType, CommTy>;
 
+  /// Local moving phase. Each node starts in its own cluster, or in the
+  /// cluster given by initial_communities if it is not null.
   katana::Result<double> LouvainWithoutLockingDoAll(
       katana::PropertyGraph* pg, double lower,
-      double modularity_threshold_per_round, uint32_t& iter) {
+      double modularity_threshold_per_round, uint32_t& iter,
+      const katana::NUMAArray<uint64_t>* initial_communities = nullptr) {
     katana::StatTimer TimerClusteringTotal("Timer_Clustering_Total");
     TimerClusteringTotal.start();
 
@@ -83,6 +91,21 @@ struct LouvainClusteringImplementation
     /* Calculate the weighted degree sum for each vertex */
     Base::template SumVertexDegreeWeight<EdgeWeightType>(&graph, c_info);
 
+    if (initial_communities) {
+      katana::do_all(katana::iterate(graph), [&](GNode n) {
+        c_info[n].degree_wt = 0;
+        c_info[n].size = 0;
+      });
+      katana::do_all(katana::iterate(graph), [&](GNode n) {
+        uint64_t c = (*initial_communities)[n];
+        graph.template GetData<CurrentCommunityID>(n) = c;
+        katana::atomicAdd(
+            c_info[c].degree_wt,
+            graph.template GetData<DegreeWeight<EdgeWeightType>>(n));
+        katana::atomicAdd(c_info[c].size, (uint64_t)1);
+      });
+    }
+
     /* Compute the total weight (2m) and 1/2m terms */
     constant_for_second_term =
         Base::template CalConstantForSecondTerm<EdgeWeightType>(graph);
@@ -419,6 +442,18 @@ public:
     double curr_mod = -1;  // Current modularity
     uint32_t phase = 0;
 
+    const bool refine = plan.algorithm() == LouvainClusteringPlan::kLeiden;
+    // With refinement, the nodes of a coarsened graph are subcommunities and
+    // start in the community of the previous level that contains them.
+    katana::NUMAArray<uint64_t> initial_communities;
+    bool has_initial_communities = false;
+
+    auto report_level_stat = [&](const std::string& category, auto value) {
+      katana::ReportStatSingle(
+          "LouvainClustering",
+          "Level" + std::to_string(phase) + "_" + category, value);
+    };
+
     std::unique_ptr<katana::PropertyGraph> pg_curr = std::move(pg_mutable);
     uint32_t iter = 0;
     uint64_t num_nodes_orig = clusters_orig.size();
@@ -427,71 +462,219 @@ public:
       phase++;
 
       Graph graph_curr = KATANA_CHECKED(Graph::Make(pg_curr.get()));
-      if (graph_curr.num_nodes() > plan.min_graph_size()) {
-        switch (plan.algorithm()) {
-        case LouvainClusteringPlan::kDoAll: {
-          curr_mod = KATANA_CHECKED(LouvainWithoutLockingDoAll(
-              pg_curr.get(), curr_mod, plan.modularity_threshold_per_round(),
-              iter));
-          break;
-        }
-        case LouvainClusteringPlan::kDeterministic: {
-          curr_mod = KATANA_CHECKED(LouvainDeterministic(
-              pg_curr.get(), curr_mod, plan.modularity_threshold_per_round(),
-              iter));
-          break;
-        }
-        default:
-          return KATANA_ERROR(
-              katana::ErrorCode::InvalidArgument, "Unknown algorithm");
-        }
-      } else {
+      if (graph_curr.num_nodes() <= plan.min_graph_size()) {
+        break;
+      }
+      report_level_stat("Nodes", graph_curr.num_nodes());
+      report_level_stat("Edges", graph_curr.num_edges());
+
+      katana::Timer local_moving_timer;
+      local_moving_timer.start();
+      switch (plan.algorithm()) {
+      case LouvainClusteringPlan::kDoAll: {
+        curr_mod = KATANA_CHECKED(LouvainWithoutLockingDoAll(
+            pg_curr.get(), curr_mod, plan.modularity_threshold_per_round(),
+            iter));
+        break;
+      }
+      case LouvainClusteringPlan::kDeterministic: {
+        curr_mod = KATANA_CHECKED(LouvainDeterministic(
+            pg_curr.get(), curr_mod, plan.modularity_threshold_per_round(),
+            iter));
+        break;
+      }
+      case LouvainClusteringPlan::kLeiden: {
+        curr_mod = KATANA_CHECKED(LouvainWithoutLockingDoAll(
+            pg_curr.get(), curr_mod, plan.modularity_threshold_per_round(),
+            iter, has_initial_communities ? &initial_communities : nullptr));
         break;
       }
+      default:
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "Unknown algorithm");
+      }
+      local_moving_timer.stop();
+      report_level_stat("LocalMovingTime", local_moving_timer.get());
+      report_level_stat("Modularity", curr_mod);
+
+      if (iter >= plan.max_iterations() ||
+          (curr_mod - prev_mod) <= plan.modularity_threshold_total()) {
+        break;
+      }
+
+      if (refine) {
+        katana::Timer refinement_timer;
+        refinement_timer.start();
+        Base::template RefineCommunities<EdgeWeightType, PreviousCommunityID>(
+            &graph_curr,
+            Base::template CalConstantForSecondTerm<EdgeWeightType>(
+                graph_curr));
+        refinement_timer.stop();
+        report_level_stat("RefinementTime", refinement_timer.get());
+      }
+
+      katana::Timer coarsening_timer;
+      coarsening_timer.start();
 
       uint64_t num_unique_clusters =
           Base::RenumberClustersContiguously(&graph_curr);
+      report_level_stat("Communities", num_unique_clusters);
+      if (refine) {
+        num_unique_clusters = Base::template RenumberClustersContiguously<
+            PreviousCommunityID>(&graph_curr);
+        report_level_stat("Subcommunities", num_unique_clusters);
+      }
 
-      if (iter < plan.max_iterations() &&
-          (curr_mod - prev_mod) > plan.modularity_threshold_total()) {
-        if (!plan.enable_vf() && phase == 1) {
-          KATANA_LOG_DEBUG_ASSERT(num_nodes_orig == graph_curr.num_nodes());
-          katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
-            clusters_orig[n] =
-                graph_curr.template GetData<CurrentCommunityID>(n);
-          });
-        } else {
-          katana::do_all(
-              katana::iterate((uint64_t)0, num_nodes_orig), [&](GNode n) {
-                if (clusters_orig[n] != Base::UNASSIGNED) {
-                  KATANA_LOG_DEBUG_ASSERT(
-                      clusters_orig[n] < graph_curr.num_nodes());
-                  clusters_orig[n] =
-                      graph_curr.template GetData<CurrentCommunityID>(
-                          clusters_orig[n]);
-                }
-              });
+      // The node of the coarsened graph that n is merged into
+      auto coarsened_id = [&](GNode n) -> uint64_t {
+        if (refine) {
+          return graph_curr.template GetData<PreviousCommunityID>(n);
         }
+        return graph_curr.template GetData<CurrentCommunityID>(n);
+      };
 
-        auto coarsened_graph_result =
-            Base::template GraphCoarsening<NodeData, EdgeData, EdgeWeightType>(
-                graph_curr, pg_curr.get(), num_unique_clusters,
-                temp_node_property_names, temp_edge_property_names);
-        if (!coarsened_graph_result) {
-          return coarsened_graph_result.error();
-        }
+      if (!plan.enable_vf() && phase == 1) {
+        KATANA_LOG_DEBUG_ASSERT(num_nodes_orig == graph_curr.num_nodes());
+        katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+          clusters_orig[n] = coarsened_id(n);
+        });
+      } else {
+        katana::do_all(
+            katana::iterate((uint64_t)0, num_nodes_orig), [&](GNode n) {
+              if (clusters_orig[n] != Base::UNASSIGNED) {
+                KATANA_LOG_DEBUG_ASSERT(
+                    clusters_orig[n] < graph_curr.num_nodes());
+                clusters_orig[n] = coarsened_id(clusters_orig[n]);
+              }
+            });
+      }
 
-        pg_curr = std::move(coarsened_graph_result.value());
+      std::unique_ptr<katana::PropertyGraph> pg_next;
+      if (refine) {
+        initial_communities.deallocate();
+        initial_communities.allocateInterleaved(num_unique_clusters);
+        katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+          initial_communities[coarsened_id(n)] =
+              graph_curr.template GetData<CurrentCommunityID>(n);
+        });
+        has_initial_communities = true;
 
-        prev_mod = curr_mod;
+        pg_next = KATANA_CHECKED((Base::template GraphCoarsening<
+                                  NodeData, EdgeData, EdgeWeightType,
+                                  PreviousCommunityID>(
+            graph_curr, pg_curr.get(), num_unique_clusters,
+            temp_node_property_names, temp_edge_property_names)));
       } else {
-        break;
+        pg_next = KATANA_CHECKED((
+            Base::template GraphCoarsening<NodeData, EdgeData, EdgeWeightType>(
+                graph_curr, pg_curr.get(), num_unique_clusters,
+                temp_node_property_names, temp_edge_property_names)));
       }
+      pg_curr = std::move(pg_next);
+
+      coarsening_timer.stop();
+      report_level_stat("CoarseningTime", coarsening_timer.get());
+
+      prev_mod = curr_mod;
+    }
+
+    if (has_initial_communities) {
+      // The moves of the last level were not kept, so each node of the last
+      // graph stays in the community it started the level in.
+      katana::do_all(
+          katana::iterate((uint64_t)0, num_nodes_orig), [&](GNode n) {
+            if (clusters_orig[n] != Base::UNASSIGNED) {
+              clusters_orig[n] = initial_communities[clusters_orig[n]];
+            }
+          });
     }
     return katana::ResultSuccess();
   }
 };
 
+/// Split every cluster into the connected components it induces in topo and
+/// number the results contiguously. Leiden refines communities into well
+/// connected subcommunities, but the clusters of the last level come from
+/// local moving, which can disconnect a community when the levels stop
+/// before the partition converges. Splitting a disconnected cluster never
+/// lowers modularity.
+static void
+SplitDisconnectedClusters(
+    const katana::GraphTopology& topo, katana::NUMAArray<uint64_t>* clusters) {
+  constexpr uint64_t kUnassigned = std::numeric_limits<uint64_t>::max();
+  const uint64_t num_nodes = topo.num_nodes();
+  if (num_nodes == 0) {
+    return;
+  }
+
+  katana::NUMAArray<std::atomic<uint64_t>> parent;
+  parent.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { parent[n] = n; }, katana::no_stats());
+
+  auto find = [&parent](uint64_t n) {
+    for (uint64_t p = parent[n]; p != n; p = parent[n]) {
+      // halve the path
+      uint64_t grandparent = parent[p];
+      parent[n].compare_exchange_weak(p, grandparent);
+      n = grandparent;
+    }
+    return n;
+  };
+
+  // Union the endpoints of the edges inside clusters, linking the larger
+  // root under the smaller one
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t cluster = (*clusters)[n];
+        if (cluster == kUnassigned) {
+          return;
+        }
+        for (auto e : topo.edges(n)) {
+          uint64_t dest = topo.edge_dest(e);
+          if ((*clusters)[dest] != cluster) {
+            continue;
+          }
+          for (;;) {
+            uint64_t a = find(n);
+            uint64_t b = find(dest);
+            if (a == b) {
+              break;
+            }
+            if (a < b) {
+              std::swap(a, b);
+            }
+            if (parent[a].compare_exchange_strong(a, b)) {
+              break;
+            }
+          }
+        }
+      },
+      katana::steal(), katana::loopname("SplitDisconnectedClusters"));
+
+  // Number the components by their roots, keeping their relative order
+  katana::NUMAArray<uint64_t> new_ids;
+  new_ids.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        new_ids[n] = (*clusters)[n] != kUnassigned && find(n) == n;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      new_ids.begin(), new_ids.end(), new_ids.begin());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        if ((*clusters)[n] != kUnassigned) {
+          (*clusters)[n] = new_ids[find(n)] - 1;
+        }
+      },
+      katana::no_stats());
+}
+
 template <typename EdgeWeightType>
 static katana::Result<void>
 AddDefaultEdgeWeight(
@@ -549,6 +732,9 @@ LouvainClusteringWithWrap(
   KATANA_CHECKED(impl.LouvainClustering(
       pg, edge_weight_property_name, temp_node_property_names, clusters_orig,
       plan));
+  if (plan.algorithm() == LouvainClusteringPlan::kLeiden) {
+    SplitDisconnectedClusters(pg->topology(), &clusters_orig);
+  }
 
   KATANA_CHECKED(ConstructNodeProperties<std::tuple<CurrentCommunityID>>(
       pg, {output_property_name}));
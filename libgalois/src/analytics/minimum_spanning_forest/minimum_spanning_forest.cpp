@@ -0,0 +1,489 @@
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/UnionFind.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+template <typename Weight>
+struct MsfEdgeWeight : public katana::PODProperty<Weight> {};
+
+struct MsfForestEdge : public katana::PODProperty<uint8_t> {};
+
+template <typename Weight>
+using MsfGraph = katana::TypedPropertyGraph<
+    std::tuple<>, std::tuple<MsfEdgeWeight<Weight>, MsfForestEdge>>;
+
+struct MsfNode : public katana::UnionFindNode<MsfNode> {
+  MsfNode() : katana::UnionFindNode<MsfNode>(this) {}
+};
+
+constexpr static const uint64_t kNoEdge = std::numeric_limits<uint64_t>::max();
+
+constexpr static const unsigned kMsfChunkSize = 64u;
+
+/// The strict total order in which Kruskal's algorithm adds edges. With it
+/// the minimum spanning forest is unique.
+template <typename Weight>
+bool
+Lighter(Weight weight, uint64_t id, Weight other_weight, uint64_t other_id) {
+  return weight < other_weight || (weight == other_weight && id < other_id);
+}
+
+/// An edge taken as undirected.
+template <typename Weight>
+struct MsfEdge {
+  Weight weight;
+  uint32_t src;
+  uint32_t dest;
+  uint64_t id;
+
+  bool operator<(const MsfEdge& other) const {
+    return Lighter(weight, id, other.weight, other.id);
+  }
+};
+
+template <typename Weight>
+class MinimumSpanningForestImpl {
+  using Graph = MsfGraph<Weight>;
+  using Edge = MsfEdge<Weight>;
+  using EdgeBag = katana::InsertBag<Edge>;
+
+  Graph* graph_;
+  katana::NUMAArray<MsfNode> components_;
+  // lightest edge leaving each component in the current Boruvka round
+  katana::NUMAArray<std::atomic<uint64_t>> lightest_;
+  katana::GAccumulator<uint64_t> num_forest_edges_;
+
+  uint32_t Component(uint32_t node) {
+    return components_[node].findAndCompress() - components_.data();
+  }
+
+  Edge MakeEdge(uint32_t src, uint64_t id) {
+    return Edge{
+        graph_->template GetEdgeData<MsfEdgeWeight<Weight>>(id), src,
+        static_cast<uint32_t>(*graph_->GetEdgeDest(id)), id};
+  }
+
+  /// Add the edge to the forest unless its endpoints are connected already.
+  void Merge(uint32_t src, uint32_t dest, uint64_t id) {
+    if (components_[src].merge(&components_[dest])) {
+      graph_->template GetEdgeData<MsfForestEdge>(id) = 1;
+      num_forest_edges_ += 1;
+    }
+  }
+
+  /// Make edge the lightest edge of comp if it is lighter. The first edge
+  /// offered to a component adds the component to touched.
+  void Offer(
+      uint32_t comp, const Edge& edge, katana::InsertBag<uint32_t>* touched) {
+    std::atomic<uint64_t>& lightest = lightest_[comp];
+    uint64_t old = lightest.load(std::memory_order_relaxed);
+    while (old == kNoEdge ||
+           Lighter(
+               edge.weight, edge.id,
+               graph_->template GetEdgeData<MsfEdgeWeight<Weight>>(old),
+               old)) {
+      if (lightest.compare_exchange_weak(old, edge.id)) {
+        if (old == kNoEdge) {
+          touched->push(comp);
+        }
+        return;
+      }
+    }
+  }
+
+  /// Drop the edge if it is inside a component, otherwise keep it for the
+  /// next round and offer it to the components at both ends.
+  void Filter(
+      const Edge& edge, EdgeBag* kept, katana::InsertBag<uint32_t>* touched) {
+    uint32_t src_comp = Component(edge.src);
+    uint32_t dest_comp = Component(edge.dest);
+    if (src_comp == dest_comp) {
+      return;
+    }
+    kept->push(edge);
+    Offer(src_comp, edge, touched);
+    Offer(dest_comp, edge, touched);
+  }
+
+  /// Sort the edges and add them in order, serially.
+  void Kruskal(Edge* begin, Edge* end) {
+    katana::ParallelSTL::sort(begin, end);
+    for (Edge* edge = begin; edge != end; ++edge) {
+      Merge(edge->src, edge->dest, edge->id);
+    }
+  }
+
+  void FilterKruskal(Edge* begin, Edge* end, uint32_t base_case_size) {
+    // at least three edges, so the median of three leaves both sides of the
+    // partition non-empty
+    while (end - begin > std::max<ptrdiff_t>(base_case_size, 2)) {
+      Edge pivot = std::max(
+          std::min(begin[0], begin[(end - begin) / 2]),
+          std::min(std::max(begin[0], begin[(end - begin) / 2]), end[-1]));
+      Edge* middle = katana::ParallelSTL::partition(
+          begin, end, [&pivot](const Edge& edge) { return !(pivot < edge); });
+      FilterKruskal(begin, middle, base_case_size);
+
+      // drop the heavy edges made redundant by the light ones
+      begin = katana::ParallelSTL::partition(
+          middle, end, [this](const Edge& edge) {
+            return Component(edge.src) == Component(edge.dest);
+          });
+    }
+    Kruskal(begin, end);
+  }
+
+public:
+  MinimumSpanningForestImpl(Graph* graph) : graph_(graph) {
+    components_.allocateBlocked(graph->size());
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](uint32_t n) {
+          components_.constructAt(n);
+          for (auto e : graph_->edges(n)) {
+            graph_->template GetEdgeData<MsfForestEdge>(e) = 0;
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("InitializeComponents"));
+  }
+
+  void Boruvka() {
+    lightest_.allocateBlocked(graph_->size());
+    katana::do_all(
+        katana::iterate(*graph_), [&](uint32_t n) { lightest_[n] = kNoEdge; },
+        katana::no_stats(), katana::loopname("InitializeLightest"));
+
+    auto current = std::make_unique<EdgeBag>();
+    katana::InsertBag<uint32_t> touched;
+    katana::do_all(
+        katana::iterate(*graph_),
+        [&](uint32_t n) {
+          for (auto e : graph_->edges(n)) {
+            Filter(MakeEdge(n, e), current.get(), &touched);
+          }
+        },
+        katana::steal(), katana::chunk_size<kMsfChunkSize>(),
+        katana::loopname("BoruvkaFilter"));
+
+    uint64_t rounds = 0;
+    while (!touched.empty()) {
+      ++rounds;
+      // With a strict order, two components can only pick each other's
+      // edge if it is the same edge, so the picked edges form a forest.
+      katana::do_all(
+          katana::iterate(touched),
+          [&](uint32_t comp) {
+            uint64_t id = lightest_[comp].load(std::memory_order_relaxed);
+            lightest_[comp] = kNoEdge;
+            Merge(
+                graph_->GetPropertyGraph().topology().edge_source(id),
+                *graph_->GetEdgeDest(id), id);
+          },
+          katana::steal(), katana::loopname("BoruvkaMerge"));
+      touched.clear();
+
+      auto next = std::make_unique<EdgeBag>();
+      katana::do_all(
+          katana::iterate(*current),
+          [&](const Edge& edge) { Filter(edge, next.get(), &touched); },
+          katana::steal(), katana::chunk_size<kMsfChunkSize>(),
+          katana::loopname("BoruvkaFilter"));
+      current = std::move(next);
+    }
+    katana::ReportStatSingle("MinimumSpanningForest", "BoruvkaRounds", rounds);
+  }
+
+  void FilterKruskal(uint32_t base_case_size) {
+    katana::NUMAArray<Edge> edges;
+    edges.allocateBlocked(graph_->num_edges());
+    katana::do_all(
+        katana::iterate(*graph_),
+        [&](uint32_t n) {
+          for (auto e : graph_->edges(n)) {
+            edges[e] = MakeEdge(n, e);
+          }
+        },
+        katana::steal(), katana::no_stats(), katana::loopname("CollectEdges"));
+    FilterKruskal(edges.begin(), edges.end(), base_case_size);
+  }
+
+  uint64_t num_forest_edges() { return num_forest_edges_.reduce(); }
+};
+
+template <typename Weight>
+katana::Result<void>
+MinimumSpanningForestWithWrap(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    MinimumSpanningForestPlan plan) {
+  KATANA_CHECKED(ConstructEdgeProperties<std::tuple<MsfForestEdge>>(
+      pg, {output_property_name}));
+  auto graph = KATANA_CHECKED(MsfGraph<Weight>::Make(
+      pg, {}, {edge_weight_property_name, output_property_name}));
+
+  katana::StatTimer exec_time("MinimumSpanningForest");
+  exec_time.start();
+  MinimumSpanningForestImpl<Weight> impl(&graph);
+  switch (plan.algorithm()) {
+  case MinimumSpanningForestPlan::kBoruvka:
+    impl.Boruvka();
+    break;
+  case MinimumSpanningForestPlan::kFilterKruskal:
+    impl.FilterKruskal(plan.base_case_size());
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+
+  katana::ReportStatSingle(
+      "MinimumSpanningForest", "ForestEdges", impl.num_forest_edges());
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, MinimumSpanningForestPlan plan) {
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return MinimumSpanningForestWithWrap<uint32_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int32Type::type_id:
+    return MinimumSpanningForestWithWrap<int32_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::UInt64Type::type_id:
+    return MinimumSpanningForestWithWrap<uint64_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int64Type::type_id:
+    return MinimumSpanningForestWithWrap<int64_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::FloatType::type_id:
+    return MinimumSpanningForestWithWrap<float>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::DoubleType::type_id:
+    return MinimumSpanningForestWithWrap<double>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+namespace {
+
+uint32_t
+FindRoot(std::vector<uint32_t>* parent, uint32_t node) {
+  while ((*parent)[node] != node) {
+    (*parent)[node] = (*parent)[(*parent)[node]];
+    node = (*parent)[node];
+  }
+  return node;
+}
+
+/// Serial union-find; returns false if the nodes were connected already.
+bool
+Union(std::vector<uint32_t>* parent, uint32_t a, uint32_t b) {
+  a = FindRoot(parent, a);
+  b = FindRoot(parent, b);
+  if (a == b) {
+    return false;
+  }
+  (*parent)[a] = b;
+  return true;
+}
+
+template <typename Weight>
+katana::Result<void>
+MinimumSpanningForestValidateImpl(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  auto graph = KATANA_CHECKED(MsfGraph<Weight>::Make(
+      pg, {}, {edge_weight_property_name, output_property_name}));
+
+  std::vector<MsfEdge<Weight>> edges;
+  std::vector<Weight> forest_weights;
+  std::vector<uint32_t> forest(graph.size());
+  for (uint32_t n = 0; n < forest.size(); ++n) {
+    forest[n] = n;
+  }
+  for (uint32_t n = 0; n < graph.size(); ++n) {
+    for (auto e : graph.edges(n)) {
+      uint32_t dest = *graph.GetEdgeDest(e);
+      Weight weight = graph.template GetEdgeData<MsfEdgeWeight<Weight>>(e);
+      edges.emplace_back(MsfEdge<Weight>{weight, n, dest, e});
+      if (graph.template GetEdgeData<MsfForestEdge>(e) == 0) {
+        continue;
+      }
+      if (!Union(&forest, n, dest)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed, "forest edge {} closes a cycle",
+            e);
+      }
+      forest_weights.emplace_back(weight);
+    }
+  }
+
+  // the forest must span the components of pg and be as light as the
+  // forest Kruskal's algorithm finds
+  katana::ParallelSTL::sort(edges.begin(), edges.end());
+  std::vector<uint32_t> kruskal(graph.size());
+  for (uint32_t n = 0; n < kruskal.size(); ++n) {
+    kruskal[n] = n;
+  }
+  std::vector<Weight> kruskal_weights;
+  for (const auto& edge : edges) {
+    if (FindRoot(&forest, edge.src) != FindRoot(&forest, edge.dest)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "nodes {} and {} are adjacent but in different trees", edge.src,
+          edge.dest);
+    }
+    if (Union(&kruskal, edge.src, edge.dest)) {
+      kruskal_weights.emplace_back(edge.weight);
+    }
+  }
+
+  std::sort(forest_weights.begin(), forest_weights.end());
+  if (forest_weights != kruskal_weights) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the forest is not a minimum spanning forest");
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return MinimumSpanningForestValidateImpl<uint32_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::Int32Type::type_id:
+    return MinimumSpanningForestValidateImpl<int32_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::UInt64Type::type_id:
+    return MinimumSpanningForestValidateImpl<uint64_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::Int64Type::type_id:
+    return MinimumSpanningForestValidateImpl<int64_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::FloatType::type_id:
+    return MinimumSpanningForestValidateImpl<float>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::DoubleType::type_id:
+    return MinimumSpanningForestValidateImpl<double>(
+        pg, edge_weight_property_name, output_property_name);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+namespace {
+
+template <typename Weight>
+katana::Result<MinimumSpanningForestStatistics>
+ComputeStatistics(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  auto graph = KATANA_CHECKED(MsfGraph<Weight>::Make(
+      pg, {}, {edge_weight_property_name, output_property_name}));
+
+  katana::GAccumulator<double> total_weight;
+  katana::GAccumulator<uint64_t> num_forest_edges;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) {
+        for (auto e : graph.edges(n)) {
+          if (graph.template GetEdgeData<MsfForestEdge>(e)) {
+            total_weight +=
+                graph.template GetEdgeData<MsfEdgeWeight<Weight>>(e);
+            num_forest_edges += 1;
+          }
+        }
+      },
+      katana::loopname("Compute Statistics"), katana::no_stats());
+
+  // every tree has one edge less than it has nodes
+  return MinimumSpanningForestStatistics{
+      total_weight.reduce(), num_forest_edges.reduce(),
+      graph.num_nodes() - num_forest_edges.reduce()};
+}
+
+}  // namespace
+
+katana::Result<MinimumSpanningForestStatistics>
+MinimumSpanningForestStatistics::Compute(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return ComputeStatistics<uint32_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::Int32Type::type_id:
+    return ComputeStatistics<int32_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::UInt64Type::type_id:
+    return ComputeStatistics<uint64_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::Int64Type::type_id:
+    return ComputeStatistics<int64_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::FloatType::type_id:
+    return ComputeStatistics<float>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::DoubleType::type_id:
+    return ComputeStatistics<double>(
+        pg, edge_weight_property_name, output_property_name);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+void
+MinimumSpanningForestStatistics::Print(std::ostream& os) const {
+  os << "Total weight = " << total_weight << std::endl;
+  os << "Number of forest edges = " << num_forest_edges << std::endl;
+  os << "Number of trees = " << num_trees << std::endl;
+}
@@ -0,0 +1,618 @@
+#include "katana/analytics/partition/partition.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+constexpr static const Node kUnmatched = std::numeric_limits<Node>::max();
+constexpr static const uint32_t kUnassigned =
+    std::numeric_limits<uint32_t>::max();
+
+// stop coarsening once a level removes fewer nodes than this fraction
+constexpr static const double kMinCoarseningRatio = 0.95;
+
+struct NodePartition : public katana::PODProperty<uint32_t> {};
+
+/// One level of the multilevel hierarchy. Level 0 is the topology of the
+/// input graph, where all weights are 1; the weight of a coarse node is the
+/// number of input nodes it holds and the weight of a coarse edge is the
+/// number of input edges it replaces.
+struct PartitionLevel {
+  const katana::GraphTopology* topology{nullptr};
+  std::unique_ptr<katana::GraphTopology> owned_topology;
+  // empty on level 0
+  katana::NUMAArray<uint32_t> node_weights;
+  katana::NUMAArray<uint64_t> edge_weights;
+  // the node of the next coarser level holding each node of this level
+  katana::NUMAArray<Node> coarse_node;
+  uint64_t total_node_weight{0};
+
+  uint32_t node_weight(Node n) const {
+    return node_weights.size() == 0 ? 1 : node_weights[n];
+  }
+  uint64_t edge_weight(Edge e) const {
+    return edge_weights.size() == 0 ? 1 : edge_weights[e];
+  }
+};
+
+/// Scratch space to combine the edges of the nodes merged into one coarse
+/// node, or to sum the edge weights from a node to each partition.
+struct Scratch {
+  std::vector<std::pair<Node, uint64_t>> edges;
+  std::vector<uint64_t> connectivity;
+  std::vector<uint32_t> touched;
+};
+
+class MultilevelPartitioner {
+  const uint32_t num_partitions_;
+  const PartitionPlan& plan_;
+  std::vector<std::unique_ptr<PartitionLevel>> levels_;
+  katana::PerThreadStorage<Scratch> scratch_;
+
+  /// Match nodes with the neighbor they share the heaviest edge with. A
+  /// node proposes to its neighbor by claiming its own slot first and the
+  /// neighbor's slot second; if the neighbor was claimed meanwhile, the
+  /// node releases its slot. Unmatched nodes end up matched with
+  /// themselves.
+  katana::NUMAArray<std::atomic<Node>> Match(
+      const PartitionLevel& level, uint64_t max_node_weight) {
+    const auto& topo = *level.topology;
+    katana::NUMAArray<std::atomic<Node>> match;
+    match.allocateBlocked(topo.num_nodes());
+    katana::do_all(
+        katana::iterate(topo.all_nodes()),
+        [&](Node n) { match[n] = kUnmatched; }, katana::no_stats());
+
+    katana::do_all(
+        katana::iterate(topo.all_nodes()),
+        [&](Node n) {
+          if (match[n].load(std::memory_order_relaxed) != kUnmatched) {
+            return;
+          }
+          Node best = kUnmatched;
+          uint64_t best_weight = 0;
+          for (auto e : topo.edges(n)) {
+            Node dest = topo.edge_dest(e);
+            if (dest == n ||
+                match[dest].load(std::memory_order_relaxed) != kUnmatched ||
+                level.node_weight(n) + level.node_weight(dest) >
+                    max_node_weight) {
+              continue;
+            }
+            if (level.edge_weight(e) > best_weight) {
+              best = dest;
+              best_weight = level.edge_weight(e);
+            }
+          }
+          if (best == kUnmatched) {
+            return;
+          }
+          Node expected = kUnmatched;
+          if (!match[n].compare_exchange_strong(expected, best)) {
+            return;
+          }
+          // best may have proposed to n at the same time
+          expected = kUnmatched;
+          if (!match[best].compare_exchange_strong(expected, n) &&
+              expected != n) {
+            match[n] = kUnmatched;
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("HeavyEdgeMatch"));
+
+    katana::do_all(
+        katana::iterate(topo.all_nodes()),
+        [&](Node n) {
+          if (match[n].load(std::memory_order_relaxed) == kUnmatched) {
+            match[n] = n;
+          }
+        },
+        katana::no_stats());
+    return match;
+  }
+
+  /// Combine the edges of the fine nodes of a coarse node into
+  /// scratch->edges, one per coarse neighbor, without self loops.
+  void GatherCoarseEdges(
+      const PartitionLevel& fine, Node coarse, Node first, Node second,
+      Scratch* scratch) {
+    const auto& topo = *fine.topology;
+    scratch->edges.clear();
+    for (Node n : {first, second}) {
+      for (auto e : topo.edges(n)) {
+        Node dest = fine.coarse_node[topo.edge_dest(e)];
+        if (dest != coarse) {
+          scratch->edges.emplace_back(dest, fine.edge_weight(e));
+        }
+      }
+      if (first == second) {
+        break;
+      }
+    }
+    std::sort(scratch->edges.begin(), scratch->edges.end());
+    size_t num_unique = 0;
+    for (const auto& edge : scratch->edges) {
+      if (num_unique > 0 &&
+          scratch->edges[num_unique - 1].first == edge.first) {
+        scratch->edges[num_unique - 1].second += edge.second;
+      } else {
+        scratch->edges[num_unique++] = edge;
+      }
+    }
+    scratch->edges.resize(num_unique);
+  }
+
+  /// Contract the matching of fine into a new coarser level.
+  std::unique_ptr<PartitionLevel> Contract(
+      PartitionLevel* fine, const katana::NUMAArray<std::atomic<Node>>& match) {
+    const auto& topo = *fine->topology;
+    const size_t num_fine = topo.num_nodes();
+
+    // the smaller node of each pair represents it
+    katana::NUMAArray<Node> prefix;
+    prefix.allocateBlocked(num_fine);
+    katana::do_all(
+        katana::iterate(topo.all_nodes()),
+        [&](Node n) { prefix[n] = n <= match[n] ? 1 : 0; },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        prefix.begin(), prefix.end(), prefix.begin());
+    const size_t num_coarse = num_fine == 0 ? 0 : prefix[num_fine - 1];
+
+    auto coarse = std::make_unique<PartitionLevel>();
+    katana::NUMAArray<Node> representative;
+    representative.allocateBlocked(num_coarse);
+    coarse->node_weights.allocateBlocked(num_coarse);
+    fine->coarse_node.allocateBlocked(num_fine);
+    katana::do_all(
+        katana::iterate(topo.all_nodes()),
+        [&](Node n) {
+          Node rep = std::min<Node>(n, match[n]);
+          Node c = prefix[rep] - 1;
+          fine->coarse_node[n] = c;
+          if (rep == n) {
+            representative[c] = n;
+            coarse->node_weights[c] =
+                fine->node_weight(n) +
+                (match[n] != n ? fine->node_weight(match[n]) : 0);
+          }
+        },
+        katana::no_stats());
+
+    katana::NUMAArray<Edge> adj_indices;
+    adj_indices.allocateBlocked(num_coarse);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_coarse),
+        [&](size_t c) {
+          Node rep = representative[c];
+          Scratch* scratch = scratch_.getLocal();
+          GatherCoarseEdges(*fine, c, rep, match[rep], scratch);
+          adj_indices[c] = scratch->edges.size();
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("CountCoarseEdges"));
+    katana::ParallelSTL::partial_sum(
+        adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+    const size_t num_coarse_edges =
+        num_coarse == 0 ? 0 : adj_indices[num_coarse - 1];
+    katana::NUMAArray<Node> dests;
+    dests.allocateBlocked(num_coarse_edges);
+    coarse->edge_weights.allocateBlocked(num_coarse_edges);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_coarse),
+        [&](size_t c) {
+          Node rep = representative[c];
+          Scratch* scratch = scratch_.getLocal();
+          GatherCoarseEdges(*fine, c, rep, match[rep], scratch);
+          Edge e = c == 0 ? 0 : adj_indices[c - 1];
+          for (const auto& [dest, weight] : scratch->edges) {
+            dests[e] = dest;
+            coarse->edge_weights[e] = weight;
+            ++e;
+          }
+        },
+        katana::steal(), katana::no_stats(), katana::loopname("CoarseEdges"));
+
+    coarse->owned_topology = std::make_unique<katana::GraphTopology>(
+        std::move(adj_indices), std::move(dests));
+    coarse->topology = coarse->owned_topology.get();
+    coarse->total_node_weight = fine->total_node_weight;
+    return coarse;
+  }
+
+  void Coarsen() {
+    const uint64_t target = uint64_t{plan_.coarsen_to()} * num_partitions_;
+    // keep coarse nodes small enough to balance the coarsest partition
+    const uint64_t max_node_weight = std::max<uint64_t>(
+        1.5 * levels_.front()->total_node_weight /
+            std::max<uint64_t>(target, 1),
+        2);
+
+    while (levels_.back()->topology->num_nodes() > target) {
+      PartitionLevel* fine = levels_.back().get();
+      auto match = Match(*fine, max_node_weight);
+      auto coarse = Contract(fine, match);
+      bool shrunk = coarse->topology->num_nodes() <
+                    kMinCoarseningRatio * fine->topology->num_nodes();
+      levels_.emplace_back(std::move(coarse));
+      if (!shrunk) {
+        break;
+      }
+    }
+  }
+
+  /// Grow the partitions one at a time from a seed node by breadth first
+  /// search, adding the frontier node with the most edges into the
+  /// partition first, until the partition has its share of the remaining
+  /// weight. Serial; the coarsest graph is small.
+  void InitialPartition(const PartitionLevel& level, uint32_t* partition) {
+    const auto& topo = *level.topology;
+    const size_t num_nodes = topo.num_nodes();
+    std::fill(partition, partition + num_nodes, kUnassigned);
+    std::vector<uint64_t> gain(num_nodes, 0);
+    std::vector<Node> touched;
+
+    uint64_t remaining_weight = level.total_node_weight;
+    size_t num_unassigned = num_nodes;
+    Node next_seed = 0;
+    for (uint32_t p = 0; p + 1 < num_partitions_; ++p) {
+      uint64_t target = remaining_weight / (num_partitions_ - p);
+      uint64_t weight = 0;
+      std::priority_queue<std::pair<uint64_t, Node>> frontier;
+      for (Node n : touched) {
+        gain[n] = 0;
+      }
+      touched.clear();
+      // leave at least one node for each partition still to grow
+      while (weight < target && num_unassigned > num_partitions_ - p - 1) {
+        if (frontier.empty()) {
+          while (partition[next_seed] != kUnassigned) {
+            ++next_seed;
+          }
+          frontier.emplace(0, next_seed);
+        }
+        auto [node_gain, n] = frontier.top();
+        frontier.pop();
+        if (partition[n] != kUnassigned || node_gain != gain[n]) {
+          continue;
+        }
+        partition[n] = p;
+        weight += level.node_weight(n);
+        --num_unassigned;
+        for (auto e : topo.edges(n)) {
+          Node dest = topo.edge_dest(e);
+          if (partition[dest] == kUnassigned) {
+            if (gain[dest] == 0) {
+              touched.emplace_back(dest);
+            }
+            gain[dest] += level.edge_weight(e);
+            frontier.emplace(gain[dest], dest);
+          }
+        }
+      }
+      remaining_weight -= weight;
+    }
+    std::replace(
+        partition, partition + num_nodes, kUnassigned, num_partitions_ - 1);
+  }
+
+  /// Sum the edge weights from n to each partition into scratch.
+  void Connectivity(
+      const PartitionLevel& level, const uint32_t* partition, Node n,
+      Scratch* scratch) {
+    const auto& topo = *level.topology;
+    for (uint32_t p : scratch->touched) {
+      scratch->connectivity[p] = 0;
+    }
+    scratch->touched.clear();
+    for (auto e : topo.edges(n)) {
+      uint32_t p = partition[topo.edge_dest(e)];
+      if (scratch->connectivity[p] == 0) {
+        scratch->touched.emplace_back(p);
+      }
+      scratch->connectivity[p] += level.edge_weight(e);
+    }
+  }
+
+  /// Move a node of the given weight between partitions if the destination
+  /// has room and the source does not become empty.
+  static bool TryMove(
+      std::vector<std::atomic<uint64_t>>* part_weights, uint32_t from,
+      uint32_t to, uint32_t weight, uint64_t max_part_weight) {
+    auto& to_weight = (*part_weights)[to];
+    auto& from_weight = (*part_weights)[from];
+    if (to_weight.fetch_add(weight) + weight > max_part_weight) {
+      to_weight -= weight;
+      return false;
+    }
+    if (from_weight.fetch_sub(weight) == weight) {
+      from_weight += weight;
+      to_weight -= weight;
+      return false;
+    }
+    return true;
+  }
+
+  /// Move boundary nodes to the partition they are best connected to. Moves
+  /// only go to higher partitions in even passes and to lower ones in odd
+  /// passes, so two neighbors never swap partitions in the same pass. Nodes
+  /// of overweight partitions move even if it cuts more edges.
+  ///
+  /// partition is read and written concurrently; a stale read only makes a
+  /// gain estimate worse.
+  void Refine(const PartitionLevel& level, uint32_t* partition) {
+    const auto& topo = *level.topology;
+    std::vector<std::atomic<uint64_t>> part_weights(num_partitions_);
+    for (auto& weight : part_weights) {
+      weight = 0;
+    }
+    katana::do_all(
+        katana::iterate(topo.all_nodes()),
+        [&](Node n) { part_weights[partition[n]] += level.node_weight(n); },
+        katana::no_stats());
+    const uint64_t max_part_weight = std::max<uint64_t>(
+        plan_.max_imbalance() * level.total_node_weight / num_partitions_, 1);
+
+    for (uint32_t pass = 0; pass < plan_.num_refinement_passes(); ++pass) {
+      katana::GAccumulator<uint64_t> num_moved;
+      katana::do_all(
+          katana::iterate(topo.all_nodes()),
+          [&](Node n) {
+            Scratch* scratch = scratch_.getLocal();
+            Connectivity(level, partition, n, scratch);
+            uint32_t from = partition[n];
+            bool overweight = part_weights[from] > max_part_weight;
+            uint32_t best = from;
+            int64_t best_gain =
+                overweight ? std::numeric_limits<int64_t>::min() : 0;
+            for (uint32_t to : scratch->touched) {
+              if (to == from) {
+                continue;
+              }
+              if (!overweight && (to > from) != (pass % 2 == 0)) {
+                continue;
+              }
+              int64_t gain = static_cast<int64_t>(scratch->connectivity[to]) -
+                             static_cast<int64_t>(scratch->connectivity[from]);
+              if (gain > best_gain) {
+                best = to;
+                best_gain = gain;
+              }
+            }
+            if (overweight && best == from) {
+              // n is inside its partition; move it to the lightest one
+              for (uint32_t to = 0; to < num_partitions_; ++to) {
+                if (part_weights[to] < part_weights[best]) {
+                  best = to;
+                }
+              }
+            }
+            if (best != from &&
+                TryMove(
+                    &part_weights, from, best, level.node_weight(n),
+                    max_part_weight)) {
+              partition[n] = best;
+              num_moved += 1;
+            }
+          },
+          katana::steal(), katana::no_stats(), katana::loopname("Refine"));
+      if (num_moved.reduce() == 0 && pass % 2 == 1) {
+        break;
+      }
+    }
+  }
+
+public:
+  MultilevelPartitioner(uint32_t num_partitions, const PartitionPlan& plan)
+      : num_partitions_(num_partitions), plan_(plan) {
+    for (unsigned i = 0; i < scratch_.size(); ++i) {
+      scratch_.getRemote(i)->connectivity.resize(num_partitions, 0);
+    }
+  }
+
+  /// Partition topo; partition must have room for a value per node.
+  void Run(const katana::GraphTopology& topo, uint32_t* partition) {
+    levels_.emplace_back(std::make_unique<PartitionLevel>());
+    levels_.front()->topology = &topo;
+    levels_.front()->total_node_weight = topo.num_nodes();
+
+    katana::StatTimer coarsen_timer("Coarsening", "Partition");
+    coarsen_timer.start();
+    Coarsen();
+    coarsen_timer.stop();
+
+    // partitions of the current level
+    katana::NUMAArray<uint32_t> current;
+    current.allocateBlocked(levels_.back()->topology->num_nodes());
+    InitialPartition(*levels_.back(), current.data());
+
+    katana::StatTimer refine_timer("Refinement", "Partition");
+    refine_timer.start();
+    Refine(*levels_.back(), current.data());
+    for (size_t i = levels_.size() - 1; i > 0; --i) {
+      const PartitionLevel& fine = *levels_[i - 1];
+      uint32_t* fine_partition = partition;
+      katana::NUMAArray<uint32_t> next;
+      if (i > 1) {
+        next.allocateBlocked(fine.topology->num_nodes());
+        fine_partition = next.data();
+      }
+      katana::do_all(
+          katana::iterate(fine.topology->all_nodes()),
+          [&](Node n) { fine_partition[n] = current[fine.coarse_node[n]]; },
+          katana::no_stats(), katana::loopname("Project"));
+      Refine(fine, fine_partition);
+      current = std::move(next);
+    }
+    if (levels_.size() == 1) {
+      std::copy(current.begin(), current.end(), partition);
+    }
+    refine_timer.stop();
+
+    katana::ReportStatSingle("Partition", "Levels", levels_.size());
+    katana::ReportStatSingle(
+        "Partition", "CoarsestNodes", levels_.back()->topology->num_nodes());
+  }
+};
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::Partition(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, PartitionPlan plan) {
+  if (num_partitions == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "number of partitions must be positive");
+  }
+  if (plan.max_imbalance() < 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "maximum imbalance must be at least 1, got {}", plan.max_imbalance());
+  }
+  if (plan.coarsen_to() < 2) {
+    // coarser graphs could have fewer nodes than partitions
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "coarsen_to must be at least 2, got {}", plan.coarsen_to());
+  }
+
+  katana::ReportPageAllocGuard page_alloc;
+
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodePartition>>(
+      pg, {output_property_name}));
+  auto graph = KATANA_CHECKED(
+      (katana::TypedPropertyGraph<std::tuple<NodePartition>, std::tuple<>>::
+           Make(pg, {output_property_name}, {})));
+
+  katana::NUMAArray<uint32_t> partition;
+  partition.allocateBlocked(pg->num_nodes());
+
+  katana::StatTimer exec_time("Partition");
+  exec_time.start();
+  if (num_partitions == 1) {
+    std::fill(partition.begin(), partition.end(), 0);
+  } else {
+    MultilevelPartitioner partitioner(num_partitions, plan);
+    partitioner.Run(pg->topology(), partition.data());
+  }
+  exec_time.stop();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) { graph.GetData<NodePartition>(n) = partition[n]; },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::PartitionAssertValid(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name) {
+  auto graph = KATANA_CHECKED(
+      (katana::TypedPropertyGraph<std::tuple<NodePartition>, std::tuple<>>::
+           Make(pg, {property_name}, {})));
+
+  std::vector<uint64_t> sizes(num_partitions, 0);
+  for (Node n : graph) {
+    uint32_t p = graph.GetData<NodePartition>(n);
+    if (p >= num_partitions) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "node {} is in partition {} of {}", n, p, num_partitions);
+    }
+    sizes[p] += 1;
+  }
+  if (graph.num_nodes() >= num_partitions &&
+      std::find(sizes.begin(), sizes.end(), 0) != sizes.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "a partition is empty");
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::unique_ptr<katana::ShuffleTopology>>
+katana::analytics::MakePartitionOrderedTopology(
+    const PropertyGraph* pg, const std::string& property_name) {
+  auto partition_ids =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<uint32_t>(property_name));
+  if (partition_ids->null_count() != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "property {} has nulls",
+        property_name);
+  }
+  auto seed_topo = EdgeShuffleTopology::MakeOriginalCopy(pg);
+  return ShuffleTopology::MakeSortedByPartition(
+      *seed_topo, partition_ids->raw_values());
+}
+
+katana::Result<PartitionStatistics>
+PartitionStatistics::Compute(
+    katana::PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name) {
+  auto graph = KATANA_CHECKED(
+      (katana::TypedPropertyGraph<std::tuple<NodePartition>, std::tuple<>>::
+           Make(pg, {property_name}, {})));
+
+  katana::GAccumulator<uint64_t> edge_cut;
+  std::vector<std::atomic<uint64_t>> sizes(num_partitions);
+  for (auto& size : sizes) {
+    size = 0;
+  }
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) {
+        uint32_t p = graph.GetData<NodePartition>(n);
+        if (p < num_partitions) {
+          sizes[p] += 1;
+        }
+        for (auto e : graph.edges(n)) {
+          if (graph.GetData<NodePartition>(*graph.GetEdgeDest(e)) != p) {
+            edge_cut += 1;
+          }
+        }
+      },
+      katana::loopname("Compute Statistics"), katana::no_stats());
+
+  uint64_t min_size = std::numeric_limits<uint64_t>::max();
+  uint64_t max_size = 0;
+  for (const auto& size : sizes) {
+    min_size = std::min<uint64_t>(min_size, size);
+    max_size = std::max<uint64_t>(max_size, size);
+  }
+  double average_size = double(graph.num_nodes()) / num_partitions;
+  return PartitionStatistics{
+      edge_cut.reduce(), num_partitions == 0 ? 0 : min_size, max_size,
+      average_size == 0 ? 0 : max_size / average_size};
+}
+
+void
+PartitionStatistics::Print(std::ostream& os) const {
+  os << "Edge cut = " << edge_cut << std::endl;
+  os << "Smallest partition size = " << min_partition_size << std::endl;
+  os << "Largest partition size = " << max_partition_size << std::endl;
+  os << "Imbalance = " << imbalance << std::endl;
+}
@@ -19,7 +19,15 @@
 
 #include "katana/analytics/random_walks/random_walks.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "katana/ParallelSTL.h"
+#include "katana/Random.h"
 #include "katana/TypedPropertyGraph.h"
+#include "tsuba/ParquetWriter.h"
+#include "tsuba/WriteGroup.h"
 
 using namespace katana::analytics;
 
@@ -29,6 +37,272 @@ namespace {
 
 using SortedPropertyGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 
+/// The most nodes in a walk: the start node and one per step. A walk always
+/// takes at least one step.
+uint32_t
+MaxWalkLength(const RandomWalksPlan& plan) {
+  return std::max(plan.walk_length(), uint32_t{1}) + 1;
+}
+
+/// Storage for a batch of walks with a fixed stride: walk i of the batch is
+/// written in place by the thread generating it at walk(i), and its length is
+/// recorded with set_length(i). A length of zero drops the walk. Finish packs
+/// the walks into an Arrow list array; when every walk has the maximum length
+/// the buffer becomes the values of the list array without a copy.
+class WalkBuffer {
+public:
+  static katana::Result<WalkBuffer> Make(
+      uint64_t num_walks, uint32_t max_walk_length) {
+    KATANA_LOG_DEBUG_ASSERT(
+        num_walks * max_walk_length <=
+        static_cast<uint64_t>(std::numeric_limits<int32_t>::max()));
+    WalkBuffer buffer(num_walks, max_walk_length);
+    buffer.nodes_ = KATANA_CHECKED(
+        arrow::AllocateBuffer(num_walks * max_walk_length * sizeof(uint32_t)));
+    buffer.lengths_.allocateInterleaved(num_walks);
+    return std::move(buffer);
+  }
+
+  uint64_t num_walks() const { return num_walks_; }
+
+  uint32_t* walk(uint64_t i) {
+    return reinterpret_cast<uint32_t*>(nodes_->mutable_data()) +
+           i * max_walk_length_;
+  }
+
+  void set_length(uint64_t i, uint32_t length) { lengths_[i] = length; }
+
+  katana::Result<std::shared_ptr<arrow::ListArray>> Finish() {
+    // Inclusive prefix sums of the number of kept walks and of their nodes
+    katana::NUMAArray<uint64_t> ranks;
+    katana::NUMAArray<uint64_t> ends;
+    ranks.allocateInterleaved(num_walks_);
+    ends.allocateInterleaved(num_walks_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_walks_),
+        [&](uint64_t i) {
+          ranks[i] = lengths_[i] > 0 ? 1 : 0;
+          ends[i] = lengths_[i];
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(ranks.begin(), ranks.end(), ranks.begin());
+    katana::ParallelSTL::partial_sum(ends.begin(), ends.end(), ends.begin());
+
+    uint64_t num_kept = num_walks_ == 0 ? 0 : ranks[num_walks_ - 1];
+    uint64_t num_nodes = num_walks_ == 0 ? 0 : ends[num_walks_ - 1];
+
+    std::shared_ptr<arrow::Buffer> offsets_buffer =
+        KATANA_CHECKED(arrow::AllocateBuffer((num_kept + 1) * sizeof(int32_t)));
+    auto* offsets = reinterpret_cast<int32_t*>(offsets_buffer->mutable_data());
+    offsets[0] = 0;
+
+    std::shared_ptr<arrow::Buffer> values_buffer;
+    if (num_nodes == num_walks_ * max_walk_length_) {
+      values_buffer = nodes_;
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_walks_),
+          [&](uint64_t i) { offsets[i + 1] = ends[i]; }, katana::no_stats());
+    } else {
+      values_buffer =
+          KATANA_CHECKED(arrow::AllocateBuffer(num_nodes * sizeof(uint32_t)));
+      auto* values = reinterpret_cast<uint32_t*>(values_buffer->mutable_data());
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_walks_),
+          [&](uint64_t i) {
+            if (lengths_[i] == 0) {
+              return;
+            }
+            std::copy_n(walk(i), lengths_[i], values + ends[i] - lengths_[i]);
+            offsets[ranks[i]] = ends[i];
+          },
+          katana::no_stats());
+    }
+    nodes_.reset();
+
+    auto values =
+        std::make_shared<arrow::UInt32Array>(num_nodes, values_buffer);
+    return std::make_shared<arrow::ListArray>(
+        arrow::list(arrow::uint32()), num_kept, offsets_buffer, values);
+  }
+
+private:
+  WalkBuffer(uint64_t num_walks, uint32_t max_walk_length)
+      : num_walks_(num_walks), max_walk_length_(max_walk_length) {}
+
+  uint64_t num_walks_;
+  uint32_t max_walk_length_;
+  std::shared_ptr<arrow::Buffer> nodes_;
+  katana::NUMAArray<uint32_t> lengths_;
+};
+
+/// Generate walks [0, total_walks) in batches of at most walks_per_batch
+/// walks and hand each batch to emit as soon as it is complete.
+///
+/// \param generate fills a WalkBuffer with the walks starting at an index
+/// \param emit consumes the list array of a batch
+template <typename GenerateFn, typename EmitFn>
+katana::Result<void>
+GenerateInBatches(
+    uint64_t total_walks, uint64_t walks_per_batch, uint32_t max_walk_length,
+    const GenerateFn& generate, const EmitFn& emit) {
+  // Keep the offsets of a batch in the int32 range of arrow::ListArray
+  uint64_t batch_size = std::min<uint64_t>(
+      walks_per_batch, std::numeric_limits<int32_t>::max() / max_walk_length);
+  batch_size = std::max<uint64_t>(batch_size, 1);
+
+  for (uint64_t first_walk = 0; first_walk < total_walks;
+       first_walk += batch_size) {
+    auto walks = KATANA_CHECKED(WalkBuffer::Make(
+        std::min(batch_size, total_walks - first_walk), max_walk_length));
+    generate(first_walk, &walks);
+    KATANA_CHECKED(emit(KATANA_CHECKED(walks.Finish())));
+  }
+  return katana::ResultSuccess();
+}
+
+/// Walker alias tables to sample the edges of every node in proportion to
+/// their weights in constant time:
+///
+///   Michael D. Vose. A Linear Algorithm for Generating Random Numbers with a
+///   Given Distribution. IEEE Transactions on Software Engineering 17(9), 1991.
+///
+/// The table of a node occupies the entries of its edges. Entry i of a node
+/// takes edge i with probability prob and otherwise edge alias, both counted
+/// from the first edge of the node.
+class EdgeAliasTables {
+public:
+  struct Entry {
+    float prob;
+    uint32_t alias;
+  };
+
+  /// Build the tables for the edges of the sorted view of pg, one node per
+  /// task. Nodes whose edges all have weight zero are sampled uniformly.
+  template <typename Weight>
+  static katana::Result<void> Build(
+      katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+      EdgeAliasTables* tables) {
+    using EdgeWeight = katana::PODProperty<Weight>;
+    using WeightGraph = katana::TypedPropertyGraphView<
+        SortedPropertyGraphView, std::tuple<>, std::tuple<EdgeWeight>>;
+    auto graph = KATANA_CHECKED(
+        WeightGraph::Make(pg, {}, {edge_weight_property_name}));
+
+    auto& entries = tables->entries_;
+    entries.allocateInterleaved(graph.num_edges());
+
+    katana::PerThreadStorage<std::vector<double>> scaled_scratch;
+    katana::PerThreadStorage<std::vector<uint32_t>> small_scratch;
+    katana::PerThreadStorage<std::vector<uint32_t>> large_scratch;
+    katana::GAccumulator<uint64_t> num_invalid;
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](typename WeightGraph::Node n) {
+          auto edges = graph.edges(n);
+          if (edges.empty()) {
+            return;
+          }
+          const uint64_t first = *edges.begin();
+          const uint64_t degree = edges.size();
+
+          auto& scaled = *scaled_scratch.getLocal();
+          scaled.clear();
+          double total = 0;
+          for (auto e : edges) {
+            double w = graph.template GetEdgeData<EdgeWeight>(e);
+            if (!(w >= 0) || !std::isfinite(w)) {
+              num_invalid += 1;
+              w = 0;
+            }
+            scaled.emplace_back(w);
+            total += w;
+          }
+
+          if (total == 0) {
+            for (uint32_t i = 0; i < degree; ++i) {
+              entries[first + i] = Entry{1.0f, i};
+            }
+            return;
+          }
+
+          // Scale to mean 1 and pair each edge below the mean with one above
+          auto& small = *small_scratch.getLocal();
+          auto& large = *large_scratch.getLocal();
+          small.clear();
+          large.clear();
+          for (uint32_t i = 0; i < degree; ++i) {
+            scaled[i] = scaled[i] * degree / total;
+            (scaled[i] < 1.0 ? small : large).emplace_back(i);
+          }
+          while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back();
+            small.pop_back();
+            uint32_t l = large.back();
+            entries[first + s] = Entry{static_cast<float>(scaled[s]), l};
+            scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+            if (scaled[l] < 1.0) {
+              large.pop_back();
+              small.emplace_back(l);
+            }
+          }
+          // Whatever is left has probability one up to rounding
+          for (uint32_t i : large) {
+            entries[first + i] = Entry{1.0f, i};
+          }
+          for (uint32_t i : small) {
+            entries[first + i] = Entry{1.0f, i};
+          }
+        },
+        katana::steal(), katana::loopname("BuildAliasTables"));
+
+    if (num_invalid.reduce() > 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "{} edge weights are negative or not finite", num_invalid.reduce());
+    }
+    return katana::ResultSuccess();
+  }
+
+  /// Sample an edge of a node with a single uniform draw in [0, 1): the
+  /// integer part of draw * degree picks the entry and the fraction decides
+  /// between the entry and its alias.
+  ///
+  /// \returns the index of the edge counted from the first edge of the node
+  uint64_t Sample(uint64_t first_edge, uint64_t degree, double draw) const {
+    double x = draw * degree;
+    uint64_t i = std::min(static_cast<uint64_t>(x), degree - 1);
+    const Entry& entry = entries_[first_edge + i];
+    return (x - i) < entry.prob ? i : entry.alias;
+  }
+
+private:
+  katana::NUMAArray<Entry> entries_;
+};
+
+/// Sample an edge of a node with degree > 0 uniformly, or by weight when
+/// alias tables are given.
+///
+/// \returns the index of the edge counted from the first edge of the node
+uint64_t
+SampleEdge(
+    const EdgeAliasTables* alias_tables, uint64_t first_edge, uint64_t degree,
+    double draw) {
+  if (alias_tables) {
+    return alias_tables->Sample(first_edge, degree, draw);
+  }
+  return std::floor(draw * degree);
+}
+
+/// Give every thread its own random sequence.
+void
+SeedGenerators(
+    katana::PerThreadStorage<katana::Xoshiro256StarStar>* generators) {
+  for (unsigned i = 0; i < generators->size(); ++i) {
+    generators->getRemote(i)->Seed(i);
+  }
+}
+
 struct Node2VecAlgo {
   using NodeData = std::tuple<>;
   using EdgeData = std::tuple<>;
@@ -38,7 +312,15 @@ struct Node2VecAlgo {
   using GNode = typename SortedGraphView::Node;
 
   const RandomWalksPlan& plan_;
-  Node2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
+  const EdgeAliasTables* alias_tables_;
+  Node2VecAlgo(
+      const RandomWalksPlan& plan, const EdgeAliasTables* alias_tables)
+      : plan_(plan), alias_tables_(alias_tables) {
+    SeedGenerators(&generator_);
+  }
+
+  // Shared by all batches so that each batch continues the random sequence
+  katana::PerThreadStorage<katana::Xoshiro256StarStar> generator_;
 
   GNode FindSampleNeighbor(
       const SortedGraphView& graph, const GNode& n,
@@ -46,26 +328,16 @@ struct Node2VecAlgo {
     if (degree[n] == 0) {
       return graph.num_nodes();
     }
-    double total_wt = degree[n];
-
-    uint32_t edge_index = std::floor(prob * total_wt);
-    auto ei = graph.edges(n).begin() + edge_index;
+    auto first_edge = graph.edges(n).begin();
+    uint64_t edge_index =
+        SampleEdge(alias_tables_, *first_edge, degree[n], prob);
+    auto ei = first_edge + edge_index;
     return graph.edge_dest(*ei);
   }
 
   void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
-    }
-
+      const SortedGraphView& graph, const katana::NUMAArray<uint64_t>& degree,
+      uint64_t first_walk, WalkBuffer* walks) {
     double prob_forward = 1.0 / plan_.forward_probability();
     double prob_backward = 1.0 / plan_.backward_probability();
 
@@ -79,32 +351,31 @@ struct Node2VecAlgo {
     lower_bound = (lower_bound < prob_forward) ? lower_bound : prob_forward;
     lower_bound = (lower_bound < prob_backward) ? lower_bound : prob_backward;
 
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
-
     katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
-        [&](uint64_t idx) {
-          GNode n = idx % graph.size();
+        katana::iterate(uint64_t(0), walks->num_walks()),
+        [&](uint64_t i) {
+          GNode n = (first_walk + i) % graph.size();
 
           //check if n has no neighbor
           if (degree[n] == 0) {
+            walks->set_length(i, 0);
             return;
           }
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
+          auto& generator = *generator_.getLocal();
 
-          std::vector<uint32_t> walk;
-          walk.push_back(n);
+          uint32_t* walk = walks->walk(i);
+          uint32_t length = 0;
+          walk[length++] = n;
 
           //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
+          double prob = generator.NextDouble();
 
           //Assumption: All edges have weight 1
           auto nbr = FindSampleNeighbor(graph, n, degree, prob);
           KATANA_LOG_ASSERT(nbr < graph.num_nodes());
 
-          walk.push_back(std::move(nbr));
+          walk[length++] = nbr;
 
           for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
                current_walk++) {
@@ -118,18 +389,18 @@ struct Node2VecAlgo {
             //acceptance-rejection sampling
             while (true) {
               //sample x
-              double prob = (*dist)(*generator.getLocal());
+              double prob = generator.NextDouble();
 
               auto nbr = FindSampleNeighbor(graph, curr, degree, prob);
               KATANA_LOG_ASSERT(nbr < graph.num_nodes());
 
               //sample y
-              double y = (*dist)(*generator.getLocal());
+              double y = generator.NextDouble();
               y = y * upper_bound;
 
               if (y <= lower_bound) {
                 //accept this sample
-                walk.push_back(std::move(nbr));
+                walk[length++] = nbr;
                 break;
               } else {
                 //compute transition probability
@@ -147,28 +418,30 @@ struct Node2VecAlgo {
 
                 if (y <= alpha) {
                   //accept y
-                  walk.push_back(std::move(nbr));
+                  walk[length++] = nbr;
                   break;
                 }
               }
             }
           }
 
-          walks->push(std::move(walk));
+          walks->set_length(i, length);
         },
         katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
         katana::loopname("Node2vec walks"), katana::no_stats());
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      delete (*distribution.getRemote(i));
-    }
   }
 
-  void operator()(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    GraphRandomWalk(graph, walks, degree);
+  template <typename EmitFn>
+  katana::Result<void> operator()(
+      const SortedGraphView& graph, const katana::NUMAArray<uint64_t>& degree,
+      uint64_t walks_per_batch, const EmitFn& emit) {
+    return GenerateInBatches(
+        graph.size() * plan_.number_of_walks(), walks_per_batch,
+        MaxWalkLength(plan_),
+        [&](uint64_t first_walk, WalkBuffer* walks) {
+          GraphRandomWalk(graph, degree, first_walk, walks);
+        },
+        emit);
   }
 };
 
@@ -183,11 +456,34 @@ struct Edge2VecAlgo {
   using GNode = typename SortedGraphView::Node;
 
   const RandomWalksPlan& plan_;
-  Edge2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
+  const EdgeAliasTables* alias_tables_;
+  Edge2VecAlgo(
+      const RandomWalksPlan& plan, const EdgeAliasTables* alias_tables)
+      : plan_(plan), alias_tables_(alias_tables) {
+    SeedGenerators(&generator_);
+  }
 
   //transition matrix
   std::vector<std::vector<double>> transition_matrix_;
 
+  // Shared by all batches so that each batch continues the random sequence
+  katana::PerThreadStorage<katana::Xoshiro256StarStar> generator_;
+  katana::PerThreadStorage<std::vector<uint32_t>> types_scratch_;
+
+  /// The histogram of edge types of each walk of an iteration, stored by
+  /// type: the number of edges of type t in walk w is at
+  /// t * total_walks + w. Only the walks with walked[w] set are counted.
+  struct TypeHistograms {
+    uint64_t total_walks;
+    katana::NUMAArray<uint32_t> counts;
+    katana::NUMAArray<uint8_t> walked;
+    uint64_t num_walked;
+
+    uint32_t count(uint32_t type, uint64_t walk) const {
+      return counts[type * total_walks + walk];
+    }
+  };
+
   void Initialize() {
     transition_matrix_.resize(plan_.number_of_edge_types() + 1);
     //initialize transition matrix
@@ -204,28 +500,17 @@ struct Edge2VecAlgo {
     if (degree[n] == 0) {
       return std::make_pair(graph.num_nodes(), 1);
     }
-    double total_wt = degree[n];
-
-    uint32_t edge_index = std::floor(prob * total_wt);
-    auto ei = graph.edges(n).begin() + edge_index;
+    auto first_edge = graph.edges(n).begin();
+    uint64_t edge_index =
+        SampleEdge(alias_tables_, *first_edge, degree[n], prob);
+    auto ei = first_edge + edge_index;
     return std::make_pair(
         graph.edge_dest(*ei), graph.GetEdgeData<EdgeType>(*ei));
   }
 
   void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      katana::InsertBag<std::vector<uint32_t>>* types_walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
-    }
-
+      const SortedGraphView& graph, const katana::NUMAArray<uint64_t>& degree,
+      uint64_t first_walk, WalkBuffer* walks, TypeHistograms* histograms) {
     double prob_forward = 1.0 / plan_.forward_probability();
     double prob_backward = 1.0 / plan_.backward_probability();
 
@@ -234,51 +519,54 @@ struct Edge2VecAlgo {
     upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
     upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
 
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
-
     katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
-        [&](uint64_t idx) {
+        katana::iterate(uint64_t(0), walks->num_walks()),
+        [&](uint64_t i) {
+          uint64_t idx = first_walk + i;
           GNode n = idx % graph.size();
 
+          // The walk is dropped unless it reaches its full length
+          walks->set_length(i, 0);
+
           //check if n has no neighbor
           if (degree[n] == 0) {
             return;
           }
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
+          auto& generator = *generator_.getLocal();
 
-          std::vector<uint32_t> walk;
-          std::vector<uint32_t> types_vec;
+          uint32_t* walk = walks->walk(i);
+          uint32_t length = 0;
+          std::vector<uint32_t>& types_vec = *types_scratch_.getLocal();
+          types_vec.clear();
 
-          walk.push_back(n);
+          walk[length++] = n;
 
           //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
+          double prob = generator.NextDouble();
 
           //Assumption: All edges have weight 1
           auto nbr_pair = FindSampleNeighbor(graph, n, degree, prob);
           KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
 
-          walk.push_back(std::move(nbr_pair.first));
+          walk[length++] = nbr_pair.first;
           types_vec.push_back(nbr_pair.second);
 
           for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
                current_walk++) {
-            uint32_t curr = walk[walk.size() - 1];
+            uint32_t curr = walk[length - 1];
             //check if n has no neighbor
             if (degree[curr] == 0) {
               return;
             }
-            uint32_t prev = walk[walk.size() - 2];
+            uint32_t prev = walk[length - 2];
 
             uint32_t p1 = types_vec.back();  //last element of types_vec
 
             //acceptance-rejection sampling
             while (true) {
               //sample x
-              double prob = (*dist)(*generator.getLocal());
+              double prob = generator.NextDouble();
 
               auto nbr_type_pair =
                   FindSampleNeighbor(graph, curr, degree, prob);
@@ -288,7 +576,7 @@ struct Edge2VecAlgo {
               EdgeType::ViewType::value_type p2 = nbr_type_pair.second;
 
               //sample y
-              double y = (*dist)(*generator.getLocal());
+              double y = generator.NextDouble();
               y = y * upper_bound;
 
               //compute transition probability
@@ -307,7 +595,7 @@ struct Edge2VecAlgo {
               alpha = alpha * transition_matrix_[p1][p2];
               if (alpha >= y) {
                 //accept y
-                walk.push_back(std::move(nbr));
+                walk[length++] = nbr;
                 types_vec.push_back(p2);
                 break;
               }
@@ -315,73 +603,44 @@ struct Edge2VecAlgo {
 
           }  //end for
 
-          (*walks).push(std::move(walk));
-          (*types_walks).push(std::move(types_vec));
+          walks->set_length(i, length);
+          for (auto type : types_vec) {
+            histograms->counts[type * histograms->total_walks + idx]++;
+          }
+          histograms->walked[idx] = 1;
         },
         katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
         katana::loopname("Edge2vec walks"), katana::no_stats());
   }
 
-  //compute the histogram of edge types for each walk
-  std::vector<std::vector<uint32_t>> ComputeNumEdgeTypeVectors(
-      const katana::InsertBag<std::vector<uint32_t>>& types_walks) {
-    std::vector<std::vector<uint32_t>> num_edge_types_walks;
-
-    katana::PerThreadStorage<std::vector<std::vector<uint32_t>>>
-        per_thread_num_edge_types_walks;
+  void ResetHistograms(TypeHistograms* histograms) {
     katana::do_all(
-        katana::iterate(types_walks),
-        [&](const std::vector<uint32_t>& types_walk) {
-          std::vector<uint32_t> num_edge_types(
-              plan_.number_of_edge_types() + 1, 0);
-
-          for (auto type : types_walk) {
-            num_edge_types[type]++;
-          }
-
-          per_thread_num_edge_types_walks.getLocal()->emplace_back(
-              std::move(num_edge_types));
-        });
-
-    for (unsigned j = 0; j < katana::getActiveThreads(); ++j) {
-      for (auto num_edge_types :
-           *per_thread_num_edge_types_walks.getRemote(j)) {
-        num_edge_types_walks.push_back(std::move(num_edge_types));
-      }
-    }
-
-    return num_edge_types_walks;
+        katana::iterate(uint64_t{0}, histograms->counts.size()),
+        [&](uint64_t i) { histograms->counts[i] = 0; }, katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, histograms->total_walks),
+        [&](uint64_t i) { histograms->walked[i] = 0; }, katana::no_stats());
   }
 
-  std::vector<std::vector<uint32_t>> TransformVectors(
-      const std::vector<std::vector<uint32_t>>& num_edge_types_walks) {
-    uint32_t rows = num_edge_types_walks.size();
-    std::vector<std::vector<uint32_t>> transformed_num_edge_types_walks;
-    transformed_num_edge_types_walks.resize(plan_.number_of_edge_types() + 1);
-
+  void CountWalked(TypeHistograms* histograms) {
+    katana::GAccumulator<uint64_t> num_walked;
     katana::do_all(
-        katana::iterate(uint32_t(0), plan_.number_of_edge_types() + 1),
-        [&](uint32_t j) {
-          for (uint32_t i = 0; i < rows; i++) {
-            transformed_num_edge_types_walks[j].push_back(
-                num_edge_types_walks[i][j]);
-          }
-        });
-
-    return transformed_num_edge_types_walks;
+        katana::iterate(uint64_t{0}, histograms->total_walks),
+        [&](uint64_t i) { num_walked += histograms->walked[i]; },
+        katana::no_stats());
+    histograms->num_walked = num_walked.reduce();
   }
 
-  std::vector<double> ComputeMeans(const std::vector<std::vector<uint32_t>>&
-                                       transformed_num_edge_types_walks) {
+  std::vector<double> ComputeMeans(const TypeHistograms& histograms) {
     std::vector<double> means(plan_.number_of_edge_types() + 1);
 
     for (uint32_t i = 1; i <= plan_.number_of_edge_types(); i++) {
-      uint32_t sum = 0;
-      for (auto n : transformed_num_edge_types_walks[i]) {
-        sum += n;
+      uint64_t sum = 0;
+      for (uint64_t m = 0; m < histograms.total_walks; m++) {
+        sum += histograms.count(i, m);
       }
 
-      means[i] = ((double)sum) / (transformed_num_edge_types_walks[i].size());
+      means[i] = ((double)sum) / histograms.num_walked;
     }
 
     return means;
@@ -392,29 +651,29 @@ struct Edge2VecAlgo {
   }
 
   double pearsonCorr(
-      const uint32_t i, const uint32_t j,
-      const std::vector<std::vector<uint32_t>>&
-          transformed_num_edge_types_walks,
+      const uint32_t i, const uint32_t j, const TypeHistograms& histograms,
       const std::vector<double>& means) {
-    const std::vector<uint32_t>& x = transformed_num_edge_types_walks[i];
-    const std::vector<uint32_t>& y = transformed_num_edge_types_walks[j];
-
     double sum = 0.0;
     double sig1 = 0.0;
     double sig2 = 0.0;
 
-    for (uint32_t m = 0; m < x.size(); m++) {
-      sum += ((double)x[m] - means[i]) * ((double)y[m] - means[j]);
-      sig1 += ((double)x[m] - means[i]) * ((double)x[m] - means[i]);
-      sig2 += ((double)y[m] - means[j]) * ((double)y[m] - means[j]);
+    for (uint64_t m = 0; m < histograms.total_walks; m++) {
+      if (!histograms.walked[m]) {
+        continue;
+      }
+      double x = histograms.count(i, m);
+      double y = histograms.count(j, m);
+      sum += (x - means[i]) * (y - means[j]);
+      sig1 += (x - means[i]) * (x - means[i]);
+      sig2 += (y - means[j]) * (y - means[j]);
     }
 
-    sum = sum / x.size();
+    sum = sum / histograms.num_walked;
 
-    sig1 = sig1 / x.size();
+    sig1 = sig1 / histograms.num_walked;
     sig1 = sqrt(sig1);
 
-    sig2 = sig2 / x.size();
+    sig2 = sig2 / histograms.num_walked;
     sig2 = sqrt(sig2);
 
     double corr = sum / (sig1 * sig2);
@@ -422,15 +681,12 @@ struct Edge2VecAlgo {
   }
 
   void ComputeTransitionMatrix(
-      const std::vector<std::vector<uint32_t>>&
-          transformed_num_edge_types_walks,
-      const std::vector<double>& means) {
+      const TypeHistograms& histograms, const std::vector<double>& means) {
     katana::do_all(
         katana::iterate(uint32_t(1), plan_.number_of_edge_types() + 1),
         [&](uint32_t i) {
           for (uint32_t j = 1; j <= plan_.number_of_edge_types(); j++) {
-            double pearson_corr =
-                pearsonCorr(i, j, transformed_num_edge_types_walks, means);
+            double pearson_corr = pearsonCorr(i, j, histograms, means);
             double sigmoid = sigmoidCal(pearson_corr);
 
             transition_matrix_[i][j] = sigmoid;
@@ -438,32 +694,37 @@ struct Edge2VecAlgo {
         });
   }
 
-  void operator()(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
+  template <typename EmitFn>
+  katana::Result<void> operator()(
+      const SortedGraphView& graph, const katana::NUMAArray<uint64_t>& degree,
+      uint64_t walks_per_batch, const EmitFn& emit) {
     uint32_t iterations = plan_.max_iterations();
 
     Initialize();
 
+    TypeHistograms histograms;
+    histograms.total_walks = graph.size() * plan_.number_of_walks();
+    histograms.counts.allocateInterleaved(
+        (plan_.number_of_edge_types() + 1) * histograms.total_walks);
+    histograms.walked.allocateInterleaved(histograms.total_walks);
+
     for (uint32_t iter = 0; iter < iterations; iter++) {
       //E step; generate walks
-      katana::InsertBag<std::vector<uint32_t>> types_walks;
-
-      GraphRandomWalk(graph, walks, &types_walks, degree);
+      ResetHistograms(&histograms);
+      KATANA_CHECKED(GenerateInBatches(
+          histograms.total_walks, walks_per_batch, MaxWalkLength(plan_),
+          [&](uint64_t first_walk, WalkBuffer* walks) {
+            GraphRandomWalk(graph, degree, first_walk, walks, &histograms);
+          },
+          emit));
 
       //Update transition matrix
-      std::vector<std::vector<uint32_t>> num_edge_types_walks =
-          ComputeNumEdgeTypeVectors(types_walks);
+      CountWalked(&histograms);
+      std::vector<double> means = ComputeMeans(histograms);
 
-      std::vector<std::vector<uint32_t>> transformed_num_edge_types_walks =
-          TransformVectors(num_edge_types_walks);
-
-      std::vector<double> means =
-          ComputeMeans(transformed_num_edge_types_walks);
-
-      ComputeTransitionMatrix(transformed_num_edge_types_walks, means);
+      ComputeTransitionMatrix(histograms, means);
     }
+    return katana::ResultSuccess();
   }
 };
 
@@ -477,15 +738,15 @@ InitializeDegrees(const Graph& graph, katana::NUMAArray<uint64_t>* degree) {
   });
 }
 
-}  //namespace
-
-template <typename Algorithm>
-static katana::Result<std::vector<std::vector<uint32_t>>>
+template <typename Algorithm, typename EmitFn>
+katana::Result<void>
 RandomWalksWithWrap(
-    const typename Algorithm::SortedGraphView& graph, RandomWalksPlan plan) {
+    const typename Algorithm::SortedGraphView& graph, RandomWalksPlan plan,
+    const EdgeAliasTables* alias_tables, uint64_t walks_per_batch,
+    const EmitFn& emit) {
   katana::ReportPageAllocGuard page_alloc;
 
-  Algorithm algo(plan);
+  Algorithm algo(plan, alias_tables);
 
   katana::NUMAArray<uint64_t> degree;
   degree.allocateBlocked(graph.size());
@@ -493,33 +754,129 @@ RandomWalksWithWrap(
 
   katana::StatTimer execTime("RandomWalks");
   execTime.start();
-  katana::InsertBag<std::vector<uint32_t>> walks;
-  algo(graph, &walks, degree);
+  auto res = algo(graph, degree, walks_per_batch, emit);
   execTime.stop();
+  return res;
+}
 
-  std::vector<std::vector<uint32_t>> walks_in_vector;
-  walks_in_vector.reserve(plan.number_of_walks());
-  std::move(walks.begin(), walks.end(), std::back_inserter(walks_in_vector));
-  return walks_in_vector;
+katana::Result<void>
+BuildAliasTables(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    EdgeAliasTables* tables) {
+  katana::StatTimer timer("RandomWalksAliasTables");
+  timer.start();
+  auto weights = KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name));
+  katana::Result<void> res = katana::ResultSuccess();
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    res = EdgeAliasTables::Build<uint32_t>(
+        pg, edge_weight_property_name, tables);
+    break;
+  case arrow::Int32Type::type_id:
+    res =
+        EdgeAliasTables::Build<int32_t>(pg, edge_weight_property_name, tables);
+    break;
+  case arrow::UInt64Type::type_id:
+    res = EdgeAliasTables::Build<uint64_t>(
+        pg, edge_weight_property_name, tables);
+    break;
+  case arrow::Int64Type::type_id:
+    res =
+        EdgeAliasTables::Build<int64_t>(pg, edge_weight_property_name, tables);
+    break;
+  case arrow::FloatType::type_id:
+    res = EdgeAliasTables::Build<float>(pg, edge_weight_property_name, tables);
+    break;
+  case arrow::DoubleType::type_id:
+    res = EdgeAliasTables::Build<double>(pg, edge_weight_property_name, tables);
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        weights->type()->ToString());
+  }
+  timer.stop();
+  return res;
 }
 
-katana::Result<std::vector<std::vector<uint32_t>>>
-katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
+template <typename EmitFn>
+katana::Result<void>
+RunRandomWalks(
+    katana::PropertyGraph* pg, RandomWalksPlan plan,
+    const std::string& edge_weight_property_name, uint64_t walks_per_batch,
+    const EmitFn& emit) {
+  EdgeAliasTables alias_tables;
+  const EdgeAliasTables* tables = nullptr;
+  if (!edge_weight_property_name.empty()) {
+    KATANA_CHECKED(
+        BuildAliasTables(pg, edge_weight_property_name, &alias_tables));
+    tables = &alias_tables;
+  }
+
   switch (plan.algorithm()) {
   case RandomWalksPlan::kNode2Vec: {
     auto graph =
         KATANA_CHECKED(Node2VecAlgo::SortedGraphView::Make(pg, {}, {}));
-    return RandomWalksWithWrap<Node2VecAlgo>(graph, plan);
+    return RandomWalksWithWrap<Node2VecAlgo>(
+        graph, plan, tables, walks_per_batch, emit);
   }
   case RandomWalksPlan::kEdge2Vec: {
     TemporaryPropertyGuard tmp_edge_prop{pg->NodeMutablePropertyView()};
     auto graph = KATANA_CHECKED(
         Edge2VecAlgo::SortedGraphView::Make(pg, {}, {tmp_edge_prop.name()}));
-    return RandomWalksWithWrap<Edge2VecAlgo>(graph, plan);
+    return RandomWalksWithWrap<Edge2VecAlgo>(
+        graph, plan, tables, walks_per_batch, emit);
   }
   default:
-    return ErrorCode::InvalidArgument;
+    return katana::ErrorCode::InvalidArgument;
+  }
+}
+
+}  //namespace
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::analytics::RandomWalks(
+    PropertyGraph* pg, RandomWalksPlan plan,
+    const std::string& edge_weight_property_name) {
+  std::vector<std::shared_ptr<arrow::Array>> chunks;
+  KATANA_CHECKED(RunRandomWalks(
+      pg, plan, edge_weight_property_name,
+      std::numeric_limits<uint64_t>::max(),
+      [&](std::shared_ptr<arrow::ListArray> walks) -> katana::Result<void> {
+        chunks.emplace_back(std::move(walks));
+        return katana::ResultSuccess();
+      }));
+  return KATANA_CHECKED(arrow::ChunkedArray::Make(
+      std::move(chunks), arrow::list(arrow::uint32())));
+}
+
+katana::Result<void>
+katana::analytics::RandomWalksToParquet(
+    PropertyGraph* pg, const katana::Uri& prefix, RandomWalksPlan plan,
+    const std::string& edge_weight_property_name, uint64_t walks_per_batch) {
+  auto group = KATANA_CHECKED(tsuba::WriteGroup::Make());
+
+  uint64_t num_batches = 0;
+  auto ret = RunRandomWalks(
+      pg, plan, edge_weight_property_name, walks_per_batch,
+      [&](std::shared_ptr<arrow::ListArray> walks) -> katana::Result<void> {
+        auto writer = KATANA_CHECKED(tsuba::ParquetWriter::Make(
+            std::make_shared<arrow::ChunkedArray>(std::move(walks)),
+            kRandomWalksColumnName));
+        // The write proceeds in the background while the next batch is
+        // generated
+        return writer->WriteToUri(
+            prefix + fmt::format(".{:06}", num_batches++), group.get());
+      });
+
+  auto final_ret = group->Finish();
+  if (!ret) {
+    if (!final_ret) {
+      KATANA_LOG_ERROR("multiple errors, masking: {}", final_ret.error());
+    }
+    return ret;
   }
+  return final_ret;
 }
 
 /// \cond DO_NOT_DOCUMENT
@@ -19,6 +19,9 @@
 
 #include "katana/analytics/sssp/sssp.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "katana/Reduction.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
@@ -65,6 +68,12 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
   static constexpr unsigned kChunkSize = 64;
   static constexpr Dist kDistanceInfinity = Base::kDistanceInfinity;
 
+  // parameters of the automatic plan
+  static constexpr uint64_t kNumWeightSamples = 1 << 14;
+  static constexpr uint64_t kSmallGraphNodes = 1 << 12;
+  static constexpr double kUniformWeightSpread = 4;
+  static constexpr unsigned kMaxDelta = 30;
+
   using PSchunk = katana::PerSocketChunkFIFO<kChunkSize>;
   using OBIM = katana::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
   using OBIMBarrier = typename katana::OrderedByIntegerMetric<
@@ -400,6 +409,82 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     katana::ReportStatSingle("SSSP-Topo", "rounds", rounds);
   }
 
+  static const char* AlgorithmName(SsspPlan::Algorithm algorithm) {
+    switch (algorithm) {
+    case SsspPlan::kDeltaStep:
+      return "DeltaStep";
+    case SsspPlan::kDeltaStepBarrier:
+      return "DeltaStepBarrier";
+    case SsspPlan::kDijkstra:
+      return "Dijkstra";
+    case SsspPlan::kTopological:
+      return "Topological";
+    default:
+      return "Other";
+    }
+  }
+
+  /// Choose the algorithm and delta from a strided sample of the edge
+  /// weights and from the degree distribution, and report the choice as
+  /// statistics:
+  ///
+  /// - small graphs, or a single thread: Dijkstra;
+  /// - low diameter graphs whose weights are all within a small factor of
+  ///   their mean: Topological, since every round settles many nodes;
+  /// - otherwise delta stepping as before, with delta set as Meyer and
+  ///   Sanders suggest for weights uniform in [0, W]: W over the average
+  ///   degree. Twice the mean weight estimates W.
+  static SsspPlan AutomaticPlan(
+      const katana::PropertyGraph& pg,
+      const katana::NUMAArray<Weight>& edge_data) {
+    katana::StatTimer plan_timer("SSSP-AutomaticPlan");
+    plan_timer.start();
+
+    const uint64_t num_edges = edge_data.size();
+    const uint64_t num_samples = std::min(num_edges, kNumWeightSamples);
+    katana::GAccumulator<double> weight_sum;
+    katana::GReduceMax<double> max_weight;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_samples),
+        [&](uint64_t i) {
+          double weight = edge_data[i * num_edges / num_samples];
+          weight_sum += weight;
+          max_weight.update(weight);
+        },
+        katana::no_stats());
+    double mean_weight =
+        num_samples == 0 ? 0 : weight_sum.reduce() / num_samples;
+    double average_degree =
+        pg.num_nodes() == 0 ? 0 : double(pg.num_edges()) / pg.num_nodes();
+
+    double step = 2 * mean_weight / std::max(average_degree, 1.0);
+    unsigned delta =
+        step < 2 ? 0
+                 : std::min(static_cast<unsigned>(std::log2(step)), kMaxDelta);
+
+    SsspPlan plan;
+    if (pg.num_nodes() < kSmallGraphNodes || katana::getActiveThreads() == 1) {
+      plan = SsspPlan::Dijkstra();
+    } else if (IsApproximateDegreeDistributionPowerLaw(pg)) {
+      if (max_weight.reduce() <= kUniformWeightSpread * mean_weight) {
+        plan = SsspPlan::Topological();
+      } else {
+        plan = SsspPlan::DeltaStep(delta);
+      }
+    } else {
+      plan = SsspPlan::DeltaStepBarrier(delta);
+    }
+    plan_timer.stop();
+
+    katana::ReportParam(
+        "SSSP", "AutomaticAlgorithm", AlgorithmName(plan.algorithm()));
+    katana::ReportStatSingle("SSSP", "AutomaticDelta", plan.delta());
+    katana::ReportStatSingle("SSSP", "SampledMeanWeight", mean_weight);
+    katana::ReportStatSingle("SSSP", "SampledMaxWeight", max_weight.reduce());
+    katana::ReportStatSingle("SSSP", "AverageDegree", average_degree);
+    return plan;
+  }
+
 public:
   katana::Result<void> SSSP(Graph& graph, size_t start_node, SsspPlan plan) {
     if (start_node >= graph.size()) {
@@ -440,27 +525,35 @@ public:
     execTime.start();
 
     if (plan.algorithm() == SsspPlan::kAutomatic) {
-      plan = SsspPlan(&graph.GetPropertyGraph());
+      plan = AutomaticPlan(graph.GetPropertyGraph(), edge_data);
     }
 
+    // the parallel delta stepping algorithms work on node_data; the others
+    // on the output property directly
+    bool in_node_data = false;
+
     switch (plan.algorithm()) {
     case SsspPlan::kDeltaTile:
       DeltaStepAlgo<SrcEdgeTile>(
           &node_data, &edge_data, &graph, source,
           SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(), plan.delta());
+      in_node_data = true;
       break;
     case SsspPlan::kDeltaStep:
       DeltaStepAlgo<UpdateRequest>(
           &node_data, &edge_data, &graph, source, ReqPushWrap(),
           OutEdgeRangeFn{&graph}, plan.delta());
+      in_node_data = true;
       break;
     case SsspPlan::kDeltaStepBarrier:
       DeltaStepAlgo<UpdateRequest, OBIMBarrier>(
           &node_data, &edge_data, &graph, source, ReqPushWrap(),
           OutEdgeRangeFn{&graph}, plan.delta());
+      in_node_data = true;
       break;
     case SsspPlan::kDeltaStepFusion:
       DeltaStepFusionAlgo(&node_data, &edge_data, &graph, source, plan.delta());
+      in_node_data = true;
       break;
     case SsspPlan::kSerialDeltaTile:
       SerDeltaAlgo<SrcEdgeTile>(
@@ -491,9 +584,12 @@ public:
 
     execTime.stop();
 
-    katana::do_all(katana::iterate(graph), [&](const typename Graph::Node& n) {
-      graph.template GetData<NodeDistance>(n) = node_data[n].load();
-    });
+    if (in_node_data) {
+      katana::do_all(
+          katana::iterate(graph), [&](const typename Graph::Node& n) {
+            graph.template GetData<NodeDistance>(n) = node_data[n].load();
+          });
+    }
 
     return katana::ResultSuccess();
   }
@@ -19,48 +19,164 @@
 
 #include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
 
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <limits>
 
+#include <arrow/compute/api.h>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Bag.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/PropertyGraph.h"
-#include "katana/TypedPropertyGraph.h"
+#include "katana/Timer.h"
 #include "katana/analytics/Utils.h"
 
 namespace {
 
 using namespace katana::analytics;
-using edge_iterator = boost::counting_iterator<uint64_t>;
 
-using SortedGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
-using Node = SortedGraphView::Node;
-using Edge = SortedGraphView::Edge;
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// Marks nodes of the graph that are not in the subgraph.
+constexpr uint64_t kNotSelected = std::numeric_limits<uint64_t>::max();
+/// Marks nodes claimed by the current hop that have no subgraph id yet.
+constexpr uint64_t kClaimed = kNotSelected - 1;
+
+/// The nodes of the subgraph: selected[i] is the node of the graph that
+/// becomes node i, and new_ids is the inverse map, dense over the nodes of
+/// the graph.
+struct NodeSelection {
+  std::vector<Node> selected;
+  katana::NUMAArray<std::atomic<uint64_t>> new_ids;
+};
+
+/**
+ * Select the nodes in node_vec, numbered in order of first occurrence.
+ */
+katana::Result<void>
+SelectNodes(
+    const katana::GraphTopology& topo, const std::vector<Node>& node_vec,
+    NodeSelection* selection) {
+  const uint64_t num_nodes = topo.num_nodes();
+  for (Node n : node_vec) {
+    if (n >= num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "node {} is not in the graph",
+          n);
+    }
+  }
+
+  auto& new_ids = selection->new_ids;
+  new_ids.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { new_ids[n].store(kNotSelected); }, katana::no_stats());
+
+  //! Find the first occurrence of each node.
+  katana::do_all(
+      katana::iterate(size_t{0}, node_vec.size()),
+      [&](size_t i) { katana::atomicMin(new_ids[node_vec[i]], uint64_t{i}); },
+      katana::no_stats());
+
+  katana::NUMAArray<uint64_t> ranks;
+  ranks.allocateInterleaved(node_vec.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, node_vec.size()),
+      [&](size_t i) { ranks[i] = (new_ids[node_vec[i]].load() == i) ? 1 : 0; },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(ranks.begin(), ranks.end(), ranks.begin());
+
+  const uint64_t num_selected = node_vec.empty() ? 0 : ranks[ranks.size() - 1];
+  selection->selected.resize(num_selected);
+  katana::do_all(
+      katana::iterate(size_t{0}, node_vec.size()),
+      [&](size_t i) {
+        uint64_t first_or_earlier = (i == 0) ? 0 : ranks[i - 1];
+        if (ranks[i] != first_or_earlier) {
+          selection->selected[ranks[i] - 1] = node_vec[i];
+          new_ids[node_vec[i]].store(ranks[i] - 1);
+        }
+      },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+/**
+ * Add the nodes within num_hops outgoing hops of the selected nodes. Nodes
+ * reached at the same hop are numbered in increasing order of id after
+ * the nodes of the previous hops.
+ */
+void
+ExpandHops(
+    const katana::GraphTopology& topo, uint32_t num_hops,
+    NodeSelection* selection) {
+  auto& new_ids = selection->new_ids;
+  auto& selected = selection->selected;
+
+  size_t frontier_begin = 0;
+  for (uint32_t hop = 0; hop < num_hops; ++hop) {
+    katana::InsertBag<Node> next;
+    katana::do_all(
+        katana::iterate(selected.begin() + frontier_begin, selected.end()),
+        [&](Node src) {
+          for (auto e : topo.edges(src)) {
+            Node dest = topo.edge_dest(e);
+            uint64_t expected = kNotSelected;
+            if (new_ids[dest].load(std::memory_order_relaxed) == kNotSelected &&
+                new_ids[dest].compare_exchange_strong(expected, kClaimed)) {
+              next.push(dest);
+            }
+          }
+        },
+        katana::steal(), katana::loopname("SubgraphExtraction Hop"));
+
+    if (next.empty()) {
+      break;
+    }
+    frontier_begin = selected.size();
+    selected.insert(selected.end(), next.begin(), next.end());
+    std::sort(selected.begin() + frontier_begin, selected.end());
+
+    katana::do_all(
+        katana::iterate(frontier_begin, selected.size()),
+        [&](size_t i) { new_ids[selected[i]].store(i); }, katana::no_stats());
+  }
+}
 
+/**
+ * Build the subgraph induced by the selected nodes. Each selected node's
+ * adjacency is scanned once, so the cost is linear in the sum of their
+ * degrees. The edges of a node are ordered by subgraph destination id.
+ *
+ * @param[out] edge_ids the property index in the graph of each subgraph edge
+ */
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
-SubGraphNodeSet(
-    const SortedGraphView& graph, const std::vector<Node>& node_set) {
-  uint64_t num_nodes = node_set.size();
+InducedSubgraph(
+    const katana::GraphTopology& topo, const NodeSelection& selection,
+    katana::NUMAArray<uint64_t>* edge_ids) {
+  const auto& selected = selection.selected;
+  const auto& new_ids = selection.new_ids;
+  const uint64_t num_nodes = selected.size();
+
   // Subgraph topology : out indices
   katana::NUMAArray<Edge> out_indices;
   out_indices.allocateInterleaved(num_nodes);
 
-  katana::gstl::Vector<katana::gstl::Vector<Node>> subgraph_edges;
-  subgraph_edges.resize(num_nodes);
-
   katana::do_all(
-      katana::iterate(Node(0), Node(num_nodes)),
-      [&](const Node& n) {
-        Node src = node_set[n];
-
-        auto last = graph.edges(src).end();
-        for (Node m = 0; m < num_nodes; ++m) {
-          auto dest = node_set[m];
-          // Binary search on the edges sorted by destination id
-          for (auto edge_it = graph.find_edge(src, dest);
-               edge_it != last && graph.edge_dest(*edge_it) == dest;
-               ++edge_it) {
-            subgraph_edges[n].push_back(m);
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t degree = 0;
+        for (auto e : topo.edges(selected[n])) {
+          if (new_ids[topo.edge_dest(e)].load(std::memory_order_relaxed) !=
+              kNotSelected) {
+            ++degree;
           }
         }
-        out_indices[n] = subgraph_edges[n].size();
+        out_indices[n] = degree;
       },
       katana::steal(), katana::loopname("SubgraphExtraction"));
 
@@ -72,13 +188,29 @@ SubGraphNodeSet(
   // Subgraph topology : out dests
   katana::NUMAArray<Node> out_dests;
   out_dests.allocateInterleaved(num_edges);
+  edge_ids->allocateInterleaved(num_edges);
 
+  katana::PerThreadStorage<std::vector<std::pair<Node, uint64_t>>> scratch;
   katana::do_all(
-      katana::iterate(Node(0), Node(num_nodes)),
-      [&](const Node& n) {
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto& edges = *scratch.getLocal();
+        edges.clear();
+        for (auto e : topo.edges(selected[n])) {
+          uint64_t dest =
+              new_ids[topo.edge_dest(e)].load(std::memory_order_relaxed);
+          if (dest != kNotSelected) {
+            edges.emplace_back(dest, topo.edge_property_index(e));
+          }
+        }
+        std::stable_sort(
+            edges.begin(), edges.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
         uint64_t offset = n == 0 ? 0 : out_indices[n - 1];
-        for (Node dest : subgraph_edges[n]) {
+        for (const auto& [dest, edge_id] : edges) {
           out_dests[offset] = dest;
+          (*edge_ids)[offset] = edge_id;
           offset++;
         }
       },
@@ -86,41 +218,111 @@ SubGraphNodeSet(
 
   katana::GraphTopology sub_g_topo{
       std::move(out_indices), std::move(out_dests)};
-  auto sub_g_res = katana::PropertyGraph::Make(std::move(sub_g_topo));
+  return katana::PropertyGraph::Make(std::move(sub_g_topo));
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+MakeIndexArray(const uint64_t* indices, size_t size) {
+  arrow::UInt64Builder builder;
+  KATANA_CHECKED(builder.AppendValues(indices, size));
+  return KATANA_CHECKED(builder.Finish());
+}
+
+/**
+ * Gather the rows of the named properties at the given indices with Arrow
+ * Take into a table for the subgraph.
+ */
+template <typename GetProperty>
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeProperties(
+    const std::vector<std::string>& names, const GetProperty& get_property,
+    const std::shared_ptr<arrow::Array>& indices) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& name : names) {
+    std::shared_ptr<arrow::ChunkedArray> property =
+        KATANA_CHECKED(get_property(name));
+    arrow::Datum taken = KATANA_CHECKED(
+        arrow::compute::Take(arrow::Datum(property), arrow::Datum(indices)));
+    fields.emplace_back(arrow::field(name, property->type()));
+    columns.emplace_back(taken.chunked_array());
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+katana::Result<void>
+CopyProperties(
+    const katana::PropertyGraph& pg, const NodeSelection& selection,
+    const katana::NUMAArray<uint64_t>& edge_ids,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy,
+    katana::PropertyGraph* subgraph) {
+  if (!node_properties_to_copy.empty()) {
+    std::vector<uint64_t> node_ids(selection.selected.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, node_ids.size()),
+        [&](size_t i) {
+          node_ids[i] =
+              pg.topology().node_property_index(selection.selected[i]);
+        },
+        katana::no_stats());
+    auto indices =
+        KATANA_CHECKED(MakeIndexArray(node_ids.data(), node_ids.size()));
+    auto table = KATANA_CHECKED(TakeProperties(
+        node_properties_to_copy,
+        [&](const std::string& name) { return pg.GetNodeProperty(name); },
+        indices));
+    KATANA_CHECKED(subgraph->AddNodeProperties(table));
+  }
 
-  return sub_g_res;
+  if (!edge_properties_to_copy.empty()) {
+    auto indices =
+        KATANA_CHECKED(MakeIndexArray(edge_ids.data(), edge_ids.size()));
+    auto table = KATANA_CHECKED(TakeProperties(
+        edge_properties_to_copy,
+        [&](const std::string& name) { return pg.GetEdgeProperty(name); },
+        indices));
+    KATANA_CHECKED(subgraph->AddEdgeProperties(table));
+  }
+  return katana::ResultSuccess();
 }
+
 }  // namespace
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::analytics::SubGraphExtraction(
     katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
-    SubGraphExtractionPlan plan) {
-  // Remove duplicates from the node vector
-  std::unordered_set<uint32_t> set;
-  std::vector<uint32_t> dedup_node_vec;
-  for (auto n : node_vec) {
-    if (set.insert(n).second) {  // If n wasn't already present.
-      dedup_node_vec.push_back(n);
-    }
-  }
-
-  if (dedup_node_vec.empty()) {
+    SubGraphExtractionPlan plan,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy) {
+  if (node_vec.empty()) {
     return std::make_unique<katana::PropertyGraph>();
   }
 
-  SortedGraphView sg = pg->BuildView<SortedGraphView>();
+  const katana::GraphTopology& topo = pg->topology();
 
   katana::StatTimer execTime("SubGraph-Extraction");
+  execTime.start();
+
+  NodeSelection selection;
+  KATANA_CHECKED(SelectNodes(topo, node_vec, &selection));
+
   switch (plan.algorithm()) {
-  case SubGraphExtractionPlan::kNodeSet: {
-    execTime.start();
-    auto subgraph = SubGraphNodeSet(sg, dedup_node_vec);
-    execTime.stop();
-    KATANA_LOG_DEBUG_ASSERT(subgraph);
-    return std::move(subgraph.value());
-  }
+  case SubGraphExtractionPlan::kNodeSet:
+    break;
+  case SubGraphExtractionPlan::kKHop:
+    ExpandHops(topo, plan.num_hops(), &selection);
+    break;
   default:
     return katana::ErrorCode::InvalidArgument;
   }
+
+  katana::NUMAArray<uint64_t> edge_ids;
+  auto subgraph = KATANA_CHECKED(InducedSubgraph(topo, selection, &edge_ids));
+  execTime.stop();
+
+  KATANA_CHECKED(CopyProperties(
+      *pg, selection, edge_ids, node_properties_to_copy,
+      edge_properties_to_copy, subgraph.get()));
+  return std::move(subgraph);
 }
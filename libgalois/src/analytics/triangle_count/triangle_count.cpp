@@ -19,14 +19,14 @@
 
 #include "katana/analytics/triangle_count/triangle_count.h"
 
+#include "katana/analytics/Intersection.h"
 #include "katana/analytics/Utils.h"
 
 using namespace katana::analytics;
 
-using SortedGraphView =
+using RelabeledGraphView =
     katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
-using Node = SortedGraphView::Node;
-using edge_iterator = SortedGraphView::edge_iterator;
+using SortedGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 
 constexpr static const unsigned kChunkSize = 64U;
 
@@ -59,31 +59,6 @@ LowerBound(Iterator first, Iterator last, Compare comp) {
   return first;
 }
 
-/**
- * std::set_intersection over edge_iterators.
- */
-template <typename G>
-size_t
-CountEqual(
-    const G& g, typename G::edge_iterator aa, typename G::edge_iterator ea,
-    typename G::edge_iterator bb, typename G::edge_iterator eb) {
-  size_t retval = 0;
-  while (aa != ea && bb != eb) {
-    typename G::Node a = g.edge_dest(*aa);
-    typename G::Node b = g.edge_dest(*bb);
-    if (a < b) {
-      ++aa;
-    } else if (b < a) {
-      ++bb;
-    } else {
-      retval += 1;
-      ++aa;
-      ++bb;
-    }
-  }
-  return retval;
-}
-
 template <typename G>
 struct LessThan {
   const G& g;
@@ -114,8 +89,12 @@ struct GreaterThanOrEqual {
  * Thomas Schank. Algorithmic Aspects of Triangle-Based Network Analysis. PhD
  * Thesis. Universitat Karlsruhe. 2007.
  */
+template <typename Graph>
 size_t
-NodeIteratingAlgo(const SortedGraphView* graph) {
+NodeIteratingAlgo(const Graph* graph) {
+  using Node = typename Graph::Node;
+  using edge_iterator = typename Graph::edge_iterator;
+
   katana::GAccumulator<size_t> numTriangles;
 
   katana::do_all(
@@ -126,9 +105,9 @@ NodeIteratingAlgo(const SortedGraphView* graph) {
         edge_iterator first = graph->edges(n).begin();
         edge_iterator last = graph->edges(n).end();
         edge_iterator ea =
-            LowerBound(first, last, LessThan<SortedGraphView>(*graph, n));
+            LowerBound(first, last, LessThan<Graph>(*graph, n));
         edge_iterator bb = LowerBound(
-            first, last, GreaterThanOrEqual<SortedGraphView>(*graph, n));
+            first, last, GreaterThanOrEqual<Graph>(*graph, n));
 
         for (; bb != last; ++bb) {
           Node B = graph->edge_dest(*bb);
@@ -137,7 +116,7 @@ NodeIteratingAlgo(const SortedGraphView* graph) {
             edge_iterator vv = graph->edges(A).begin();
             edge_iterator ev = graph->edges(A).end();
             edge_iterator it =
-                LowerBound(vv, ev, LessThan<SortedGraphView>(*graph, B));
+                LowerBound(vv, ev, LessThan<Graph>(*graph, B));
             if (it != ev && graph->edge_dest(*it) == B) {
               numTriangles += 1;
             }
@@ -151,31 +130,39 @@ NodeIteratingAlgo(const SortedGraphView* graph) {
 }
 
 /**
- * Lambda function to count triangles
+ * Count the triangles (n, v, w) with w <= v <= n.
+ *
+ * For each neighbor v <= n, the neighbors of n and v up to v are intersected.
+ * If n is a hub, its neighbors are marked in a per-thread bitmap once so each
+ * intersection costs O(degree(v)) instead of a merge over both lists.
  */
+template <typename Graph>
 void
 OrderedCountFunc(
-    const SortedGraphView* graph, Node n,
+    const Graph* graph, typename Graph::Node n,
+    katana::PerThreadStorage<IntersectionBitmap>* hub_bitmaps,
     katana::GAccumulator<size_t>& numTriangles) {
   size_t numTriangles_local = 0;
-  for (auto edges_n : graph->edges(n)) {
-    Node v = graph->edge_dest(edges_n);
-    if (v > n) {
-      break;
+  auto n_lower = SortedNeighbors(*graph, n).LessThanOrEqual(n);
+
+  if (n_lower.size >= IntersectionBitmap::kHubDegree) {
+    IntersectionBitmap* bitmap = hub_bitmaps->getLocal();
+    if (bitmap->universe_size() < graph->num_nodes()) {
+      bitmap->Resize(graph->num_nodes());
     }
-    edge_iterator it_n = graph->edges(n).begin();
-
-    for (auto edges_v : graph->edges(v)) {
-      auto dst_v = graph->edge_dest(edges_v);
-      if (dst_v > v) {
-        break;
-      }
-      while (graph->edge_dest(*it_n) < dst_v) {
-        it_n++;
-      }
-      if (dst_v == graph->edge_dest(*it_n)) {
-        numTriangles_local += 1;
-      }
+    bitmap->Mark(n_lower);
+    for (auto v : n_lower) {
+      numTriangles_local +=
+          bitmap->Count(SortedNeighbors(*graph, v).LessThanOrEqual(v));
+    }
+    bitmap->Unmark(n_lower);
+  } else {
+    for (size_t i = 0; i < n_lower.size; ++i) {
+      auto v = n_lower[i];
+      // n_lower is sorted, so the neighbors of n up to v are its first i + 1
+      SortedSpan<typename Graph::Node> n_prefix{n_lower.data, i + 1};
+      numTriangles_local += IntersectCount(
+          n_prefix, SortedNeighbors(*graph, v).LessThanOrEqual(v));
     }
   }
   numTriangles += numTriangles_local;
@@ -184,12 +171,16 @@ OrderedCountFunc(
 /*
  * Simple counting loop, instead of binary searching.
  */
+template <typename Graph>
 size_t
-OrderedCountAlgo(const SortedGraphView* graph) {
+OrderedCountAlgo(const Graph* graph) {
   katana::GAccumulator<size_t> numTriangles;
+  katana::PerThreadStorage<IntersectionBitmap> hub_bitmaps;
   katana::do_all(
       katana::iterate(*graph),
-      [&](const Node& n) { OrderedCountFunc(graph, n, numTriangles); },
+      [&](const typename Graph::Node& n) {
+        OrderedCountFunc(graph, n, &hub_bitmaps, numTriangles);
+      },
       katana::chunk_size<kChunkSize>(), katana::steal(),
       katana::loopname("TriangleCount_OrderedCountAlgo"));
 
@@ -209,8 +200,11 @@ OrderedCountAlgo(const SortedGraphView* graph) {
  * Thomas Schank. Algorithmic Aspects of Triangle-Based Network Analysis. PhD
  * Thesis. Universitat Karlsruhe. 2007.
  */
+template <typename Graph>
 size_t
-EdgeIteratingAlgo(const SortedGraphView* graph) {
+EdgeIteratingAlgo(const Graph* graph) {
+  using Node = typename Graph::Node;
+
   struct WorkItem {
     Node src;
     Node dst;
@@ -237,21 +231,12 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
       [&](const WorkItem& w) {
         // Compute intersection of range (w.src, w.dst) in neighbors of
         // w.src and w.dst
-        edge_iterator abegin = graph->edges(w.src).begin();
-        edge_iterator aend = graph->edges(w.src).end();
-        edge_iterator bbegin = graph->edges(w.dst).begin();
-        edge_iterator bend = graph->edges(w.dst).end();
-
-        edge_iterator aa = LowerBound(
-            abegin, aend, GreaterThanOrEqual<SortedGraphView>(*graph, w.src));
-        edge_iterator ea =
-            LowerBound(abegin, aend, LessThan<SortedGraphView>(*graph, w.dst));
-        edge_iterator bb = LowerBound(
-            bbegin, bend, GreaterThanOrEqual<SortedGraphView>(*graph, w.src));
-        edge_iterator eb =
-            LowerBound(bbegin, bend, LessThan<SortedGraphView>(*graph, w.dst));
+        auto a = SortedNeighbors(*graph, w.src).GreaterThan(w.src).LessThan(
+            w.dst);
+        auto b = SortedNeighbors(*graph, w.dst).GreaterThan(w.src).LessThan(
+            w.dst);
 
-        numTriangles += CountEqual(*graph, aa, ea, bb, eb);
+        numTriangles += IntersectCount(a, b);
       },
       katana::loopname("TriangleCount_EdgeIteratingAlgo"),
       katana::chunk_size<kChunkSize>(), katana::steal());
@@ -259,20 +244,41 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
   return numTriangles.reduce();
 }
 
+template <typename Graph>
+katana::Result<uint64_t>
+TriangleCountWithGraph(const Graph* graph, const TriangleCountPlan& plan) {
+  katana::EnsurePreallocated(
+      1, 16 * (graph->num_nodes() + graph->num_edges()));
+  katana::ReportPageAllocGuard page_alloc;
+
+  size_t total_count;
+  katana::StatTimer execTime("TriangleCount", "TriangleCount");
+  execTime.start();
+  switch (plan.algorithm()) {
+  case TriangleCountPlan::kNodeIteration:
+    total_count = NodeIteratingAlgo(graph);
+    break;
+  case TriangleCountPlan::kEdgeIteration:
+    total_count = EdgeIteratingAlgo(graph);
+    break;
+  case TriangleCountPlan::kOrderedCount:
+    total_count = OrderedCountAlgo(graph);
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  execTime.stop();
+
+  return total_count;
+}
+
 katana::Result<uint64_t>
 katana::analytics::TriangleCount(
     katana::PropertyGraph* pg, TriangleCountPlan plan) {
   katana::StatTimer timer_graph_read("GraphReadingTime", "TriangleCount");
   katana::StatTimer timer_auto_algo("AutoRelabel", "TriangleCount");
 
-  timer_graph_read.start();
-
-  SortedGraphView sorted_view = pg->BuildView<SortedGraphView>();
-
-  // TODO(amber): Today we sort unconditionally. Figure out a way to re-enable the
-  // logic below
-#if 0
-  bool relabel = false;;
+  bool relabel = false;
 
   switch (plan.relabeling()) {
   case TriangleCountPlan::kNoRelabel:
@@ -283,63 +289,34 @@ katana::analytics::TriangleCount(
     break;
   case TriangleCountPlan::kAutoRelabel:
     timer_auto_algo.start();
-    relabel = IsApproximateDegreeDistributionPowerLaw(*pg);
+    // A relabeled view left in the cache by an earlier call is free to reuse
+    relabel = pg->IsViewCached<RelabeledGraphView>() ||
+              IsApproximateDegreeDistributionPowerLaw(*pg);
     timer_auto_algo.stop();
     break;
   default:
     return katana::ErrorCode::AssertionFailed;
   }
 
-  std::unique_ptr<katana::PropertyGraph> mutable_pfg;
-  if (relabel || !plan.edges_sorted()) {
-    // Copy the graph so we don't mutate the users graph.
-    auto mutable_pfg_result = pg->Copy({}, {});
-    if (!mutable_pfg_result) {
-      return mutable_pfg_result.error();
-    }
-    mutable_pfg = std::move(mutable_pfg_result.value());
-    pg = mutable_pfg.get();
-  }
-
+  // The views are kept in the view cache of pg, so only the first call
+  // pays for relabeling and sorting. Relabeling breaks the edge order, so a
+  // relabeled view is always sorted regardless of plan.edges_sorted().
   if (relabel) {
     katana::StatTimer timer_relabel("GraphRelabelTimer", "TriangleCount");
+    timer_graph_read.start();
     timer_relabel.start();
-    if (auto r = katana::SortNodesByDegree(pg); !r) {
-      return r.error();
-    }
+    RelabeledGraphView relabeled_view = pg->BuildView<RelabeledGraphView>();
     timer_relabel.stop();
+    timer_graph_read.stop();
+    return TriangleCountWithGraph(&relabeled_view, plan);
   }
 
-  // If we relabel we must also sort. Relabeling will break the sorting.
-  if (relabel || !plan.edges_sorted()) {
-    if (auto r = katana::SortAllEdgesByDest(pg); !r) {
-      return r.error();
-    }
+  if (plan.edges_sorted()) {
+    return TriangleCountWithGraph(&pg->topology(), plan);
   }
 
+  timer_graph_read.start();
+  SortedGraphView sorted_view = pg->BuildView<SortedGraphView>();
   timer_graph_read.stop();
-#endif
-
-  katana::EnsurePreallocated(1, 16 * (pg->num_nodes() + pg->num_edges()));
-  katana::ReportPageAllocGuard page_alloc;
-
-  size_t total_count;
-  katana::StatTimer execTime("TriangleCount", "TriangleCount");
-  execTime.start();
-  switch (plan.algorithm()) {
-  case TriangleCountPlan::kNodeIteration:
-    total_count = NodeIteratingAlgo(&sorted_view);
-    break;
-  case TriangleCountPlan::kEdgeIteration:
-    total_count = EdgeIteratingAlgo(&sorted_view);
-    break;
-  case TriangleCountPlan::kOrderedCount:
-    total_count = OrderedCountAlgo(&sorted_view);
-    break;
-  default:
-    return katana::ErrorCode::InvalidArgument;
-  }
-  execTime.stop();
-
-  return total_count;
+  return TriangleCountWithGraph(&sorted_view, plan);
 }
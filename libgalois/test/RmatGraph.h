@@ -0,0 +1,101 @@
+#ifndef KATANA_LIBGALOIS_RMATGRAPH_H_
+#define KATANA_LIBGALOIS_RMATGRAPH_H_
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+
+/// Generate skewed random graphs for tests and benchmarks.
+///
+/// \file RmatGraph.h
+
+/// Generate a symmetric, duplicate free R-MAT graph. R-MAT graphs have a
+/// skewed degree distribution similar to social networks.
+inline std::unique_ptr<katana::PropertyGraph>
+MakeRmatGraph(uint32_t scale, uint32_t edge_factor) {
+  uint32_t num_nodes = uint32_t{1} << scale;
+  uint64_t num_generated = uint64_t{num_nodes} * edge_factor;
+
+  std::mt19937_64 gen(scale);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  edges.reserve(2 * num_generated);
+  for (uint64_t i = 0; i < num_generated; ++i) {
+    uint32_t src = 0;
+    uint32_t dst = 0;
+    for (uint32_t bit = 0; bit < scale; ++bit) {
+      double p = dist(gen);
+      // Quadrant probabilities a = 0.57, b = 0.19, c = 0.19, d = 0.05
+      if (p < 0.57) {
+      } else if (p < 0.76) {
+        dst |= uint32_t{1} << bit;
+      } else if (p < 0.95) {
+        src |= uint32_t{1} << bit;
+      } else {
+        src |= uint32_t{1} << bit;
+        dst |= uint32_t{1} << bit;
+      }
+    }
+    if (src != dst) {
+      edges.emplace_back(src, dst);
+      edges.emplace_back(dst, src);
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  std::vector<katana::GraphTopology::Edge> adj_indices(num_nodes, 0);
+  std::vector<katana::GraphTopology::Node> dests(edges.size());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    adj_indices[edges[i].first] += 1;
+    dests[i] = edges[i].second;
+  }
+  std::partial_sum(adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  katana::GraphTopology topo(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size());
+  auto res = katana::PropertyGraph::Make(std::move(topo));
+  if (!res) {
+    KATANA_LOG_FATAL("could not make property graph: {}", res.error());
+  }
+  return std::move(res.value());
+}
+
+/// A pseudo-random weight in [0, 16) with few distinct values, so that many
+/// edges tie. Both directions of an edge get the same weight.
+inline uint32_t
+RmatEdgeWeight(uint32_t src, uint32_t dest) {
+  uint32_t a = std::min(src, dest);
+  uint32_t b = std::max(src, dest);
+  return (a * 7919 + b * 104729) % 16;
+}
+
+/// Add an edge property named name with weight(src, dest) for each edge,
+/// built with BuilderType as arrow type type.
+template <typename BuilderType, typename ArrowType, typename WeightFn>
+void
+AddEdgeWeights(
+    katana::PropertyGraph* pg, const std::string& name,
+    const std::shared_ptr<ArrowType>& type, const WeightFn& weight) {
+  const auto& topo = pg->topology();
+  BuilderType builder;
+  for (uint32_t n = 0; n < topo.num_nodes(); ++n) {
+    for (auto e : topo.edges(n)) {
+      KATANA_LOG_ASSERT(builder.Append(weight(n, topo.edge_dest(e))).ok());
+    }
+  }
+  auto weights = builder.Finish();
+  KATANA_LOG_ASSERT(weights.ok());
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(name, type)}), {weights.ValueOrDie()});
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(table));
+}
+
+#endif
@@ -0,0 +1,154 @@
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "RmatGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
+
+namespace {
+
+using katana::analytics::BetweennessCentrality;
+using katana::analytics::BetweennessCentralityPlan;
+using katana::analytics::BetweennessCentralitySources;
+
+std::vector<float>
+RunBetweennessCentrality(
+    katana::PropertyGraph* pg, const BetweennessCentralitySources& sources,
+    BetweennessCentralityPlan plan, const std::string& name) {
+  auto res = BetweennessCentrality(pg, name, sources, plan);
+  KATANA_LOG_VASSERT(res, "{} failed: {}", name, res.error());
+  auto values_res = pg->GetNodePropertyTyped<float>(name);
+  KATANA_LOG_ASSERT(values_res);
+  auto values = values_res.value();
+  return std::vector<float>(
+      values->raw_values(), values->raw_values() + values->length());
+}
+
+void
+AssertNear(
+    const std::vector<float>& expected, const std::vector<float>& actual,
+    const std::string& name) {
+  KATANA_LOG_ASSERT(expected.size() == actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        std::abs(expected[i] - actual[i]) <= 1e-3 * (1 + expected[i]),
+        "{}: node {} has centrality {}, expected {}", name, i, actual[i],
+        expected[i]);
+  }
+}
+
+/// A directed diamond 0 -> {1, 2} -> 3 followed by 3 -> 4.
+void
+TestDirected() {
+  std::vector<katana::GraphTopology::Edge> adj_indices{2, 3, 4, 5, 5};
+  std::vector<katana::GraphTopology::Node> dests{1, 2, 3, 3, 4};
+  katana::GraphTopology topo(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size());
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  auto pg = std::move(pg_res.value());
+
+  std::vector<float> expected{0, 1, 1, 3, 0};
+  const auto all_nodes = katana::analytics::kBetweennessCentralityAllNodes;
+  AssertNear(
+      expected,
+      RunBetweennessCentrality(
+          pg.get(), all_nodes, BetweennessCentralityPlan::Level(), "level"),
+      "level");
+  AssertNear(
+      expected,
+      RunBetweennessCentrality(
+          pg.get(), all_nodes, BetweennessCentralityPlan::Outer(), "outer"),
+      "outer");
+  AssertNear(
+      expected,
+      RunBetweennessCentrality(
+          pg.get(), all_nodes, BetweennessCentralityPlan::Asynchronous(),
+          "async"),
+      "async");
+  AssertNear(
+      expected,
+      RunBetweennessCentrality(
+          pg.get(), all_nodes, BetweennessCentralityPlan::Batched(2),
+          "batched"),
+      "batched");
+
+  KATANA_LOG_ASSERT(!BetweennessCentrality(
+      pg.get(), "too-wide", all_nodes,
+      BetweennessCentralityPlan::Batched(
+          BetweennessCentralityPlan::kMaxBatchSize + 1)));
+  KATANA_LOG_ASSERT(!BetweennessCentrality(
+      pg.get(), "bad-source", std::vector<uint32_t>{5},
+      BetweennessCentralityPlan::Batched()));
+  KATANA_LOG_ASSERT(!BetweennessCentrality(
+      pg.get(), "bad-source-level", std::vector<uint32_t>{5},
+      BetweennessCentralityPlan::Level()));
+  KATANA_LOG_ASSERT(!BetweennessCentrality(
+      pg.get(), "bad-source-outer", std::vector<uint32_t>{5},
+      BetweennessCentralityPlan::Outer()));
+
+  // a source count larger than the graph is clamped to all nodes
+  for (auto plan :
+       {BetweennessCentralityPlan::Level(), BetweennessCentralityPlan::Outer(),
+        BetweennessCentralityPlan::Asynchronous(),
+        BetweennessCentralityPlan::Batched()}) {
+    std::string name =
+        fmt::format("clamped-{}", static_cast<int>(plan.algorithm()));
+    AssertNear(
+        expected,
+        RunBetweennessCentrality(pg.get(), uint32_t{100}, plan, name), name);
+  }
+}
+
+/// All plans agree on a skewed graph, including with partial batches and
+/// repeated sources.
+void
+TestAgreement() {
+  auto pg = MakeRmatGraph(10, 8);
+
+  std::vector<uint32_t> sources;
+  for (uint32_t i = 0; i < 150; ++i) {
+    sources.emplace_back((i * 7) % pg->num_nodes());
+  }
+  sources.emplace_back(sources.front());
+
+  auto expected = RunBetweennessCentrality(
+      pg.get(), sources, BetweennessCentralityPlan::Level(), "level");
+  AssertNear(
+      expected,
+      RunBetweennessCentrality(
+          pg.get(), sources, BetweennessCentralityPlan::Outer(), "outer"),
+      "outer");
+  AssertNear(
+      expected,
+      RunBetweennessCentrality(
+          pg.get(), sources, BetweennessCentralityPlan::Asynchronous(),
+          "async"),
+      "async");
+  AssertNear(
+      expected,
+      RunBetweennessCentrality(
+          pg.get(), sources, BetweennessCentralityPlan::Batched(), "batched"),
+      "batched");
+  AssertNear(
+      expected,
+      RunBetweennessCentrality(
+          pg.get(), sources, BetweennessCentralityPlan::Batched(7),
+          "batched-7"),
+      "batched-7");
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestDirected();
+  TestAgreement();
+
+  return 0;
+}
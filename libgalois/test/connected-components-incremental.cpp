@@ -0,0 +1,159 @@
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "RmatGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/connected_components/connected_components.h"
+
+namespace {
+
+using katana::analytics::ConnectedComponents;
+using katana::analytics::ConnectedComponentsIncremental;
+using Edges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+uint32_t
+Find(std::vector<uint32_t>* parent, uint32_t node) {
+  while ((*parent)[node] != node) {
+    (*parent)[node] = (*parent)[(*parent)[node]];
+    node = (*parent)[node];
+  }
+  return node;
+}
+
+/// Components of the graph plus new_edges, by serial union-find.
+std::vector<uint32_t>
+ExpectedComponents(const katana::PropertyGraph& pg, const Edges& new_edges) {
+  const auto& topo = pg.topology();
+  std::vector<uint32_t> parent(topo.num_nodes());
+  for (uint32_t i = 0; i < parent.size(); ++i) {
+    parent[i] = i;
+  }
+  auto merge = [&](uint32_t a, uint32_t b) {
+    parent[Find(&parent, a)] = Find(&parent, b);
+  };
+  for (uint32_t n = 0; n < topo.num_nodes(); ++n) {
+    for (auto e : topo.edges(n)) {
+      merge(n, topo.edge_dest(e));
+    }
+  }
+  for (const auto& edge : new_edges) {
+    merge(edge.first, edge.second);
+  }
+  for (uint32_t i = 0; i < parent.size(); ++i) {
+    parent[i] = Find(&parent, i);
+  }
+  return parent;
+}
+
+/// Labels and expected components must partition the nodes the same way.
+void
+AssertSamePartition(
+    katana::PropertyGraph* pg, const std::string& property_name,
+    const std::vector<uint32_t>& expected) {
+  auto labels_res = pg->GetNodePropertyTyped<uint64_t>(property_name);
+  KATANA_LOG_ASSERT(labels_res);
+  auto labels = labels_res.value();
+
+  std::unordered_map<uint64_t, uint32_t> label_to_expected;
+  std::unordered_map<uint32_t, uint64_t> expected_to_label;
+  for (uint32_t n = 0; n < expected.size(); ++n) {
+    uint64_t label = labels->Value(n);
+    auto [it, inserted] = label_to_expected.emplace(label, expected[n]);
+    KATANA_LOG_VASSERT(
+        it->second == expected[n], "node {} is in too large a component", n);
+    auto [it2, inserted2] = expected_to_label.emplace(expected[n], label);
+    KATANA_LOG_VASSERT(
+        it2->second == label, "node {} is in a split component", n);
+  }
+}
+
+void
+TestIncremental(uint32_t num_new_edges) {
+  // a sparse graph with many components
+  auto pg = MakeRmatGraph(10, 1);
+  KATANA_LOG_ASSERT(ConnectedComponents(pg.get(), "component"));
+
+  std::mt19937 gen(num_new_edges);
+  std::uniform_int_distribution<uint32_t> dist(0, pg->num_nodes() - 1);
+  Edges all_new_edges;
+  for (uint32_t round = 0; round < 3; ++round) {
+    Edges new_edges;
+    for (uint32_t i = 0; i < num_new_edges; ++i) {
+      new_edges.emplace_back(dist(gen), dist(gen));
+    }
+    KATANA_LOG_ASSERT(
+        ConnectedComponentsIncremental(pg.get(), "component", new_edges));
+    all_new_edges.insert(
+        all_new_edges.end(), new_edges.begin(), new_edges.end());
+    AssertSamePartition(
+        pg.get(), "component", ExpectedComponents(*pg, all_new_edges));
+  }
+
+  KATANA_LOG_ASSERT(!ConnectedComponentsIncremental(
+      pg.get(), "component", {{0, static_cast<uint32_t>(pg->num_nodes())}}));
+  KATANA_LOG_ASSERT(
+      !ConnectedComponentsIncremental(pg.get(), "no-such-property", {{0, 1}}));
+}
+
+/// Earlier batches join parts of the topology into one component without
+/// adding edges to it, so a later batch must relabel all those parts.
+void
+TestComponentAcrossBatches() {
+  // topology components {0, 1}, {2, 3} and {4, 5, 6}, where node 4 has the
+  // highest degree of all endpoints
+  Edges topology_edges{{0, 1}, {2, 3}, {4, 5}, {4, 6}};
+  constexpr uint32_t kNumNodes = 7;
+  std::vector<std::vector<uint32_t>> adjacency(kNumNodes);
+  for (const auto& [src, dest] : topology_edges) {
+    adjacency[src].emplace_back(dest);
+    adjacency[dest].emplace_back(src);
+  }
+  katana::NUMAArray<katana::GraphTopology::Edge> adj_indices;
+  katana::NUMAArray<katana::GraphTopology::Node> dests;
+  adj_indices.allocateInterleaved(kNumNodes);
+  dests.allocateInterleaved(2 * topology_edges.size());
+  uint64_t num_edges = 0;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    for (uint32_t dest : adjacency[n]) {
+      dests[num_edges++] = dest;
+    }
+    adj_indices[n] = num_edges;
+  }
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::GraphTopology(std::move(adj_indices), std::move(dests)));
+  KATANA_LOG_ASSERT(pg_res);
+  auto pg = std::move(pg_res.value());
+  KATANA_LOG_ASSERT(ConnectedComponents(pg.get(), "component"));
+
+  // {0, 1, 2, 3} is one component, but not in the topology
+  Edges all_new_edges{{1, 2}};
+  KATANA_LOG_ASSERT(
+      ConnectedComponentsIncremental(pg.get(), "component", all_new_edges));
+  AssertSamePartition(
+      pg.get(), "component", ExpectedComponents(*pg, all_new_edges));
+
+  // joined from node 3, which is not connected to 0 and 1 in the topology
+  Edges new_edges{{3, 4}};
+  KATANA_LOG_ASSERT(
+      ConnectedComponentsIncremental(pg.get(), "component", new_edges));
+  all_new_edges.insert(all_new_edges.end(), new_edges.begin(), new_edges.end());
+  AssertSamePartition(
+      pg.get(), "component", ExpectedComponents(*pg, all_new_edges));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestIncremental(4);
+  TestIncremental(2000);
+  TestComponentAcrossBatches();
+
+  return 0;
+}
@@ -0,0 +1,285 @@
+#include "katana/EntityTypeIDArray.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/DynamicBitset.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+#include "tsuba/RDG.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+enum class Encoding { kIdentity, kNarrow, kWide };
+
+/// not a multiple of 64, so that bitsets have a partial last word
+constexpr size_t kNumEntities = 1000;
+
+/// A manager with atomic types 1 to num_atomic, followed by num_intersections
+/// intersection types of two consecutive atomic types each, the first of
+/// types 1 and 2
+katana::EntityTypeManager
+MakeManager(size_t num_atomic, size_t num_intersections) {
+  katana::EntityTypeManager manager;
+  for (size_t i = 0; i < num_atomic; ++i) {
+    auto res = manager.AddAtomicEntityType("type-" + std::to_string(i));
+    KATANA_LOG_VASSERT(res, "adding type {}: {}", i, res.error());
+  }
+  for (size_t i = 0; i < num_intersections; ++i) {
+    std::vector<std::string> names{
+        "type-" + std::to_string(2 * i), "type-" + std::to_string(2 * i + 1)};
+    auto res = manager.GetOrAddNonAtomicEntityTypeFromStrings(names);
+    KATANA_LOG_VASSERT(res, "adding intersection {}: {}", i, res.error());
+    KATANA_LOG_ASSERT(res.value() == num_atomic + i + 1);
+  }
+  return manager;
+}
+
+/// Give entity i type first_type + i % num_types, except for every 7th
+/// entity, which has no type
+katana::NUMAArray<katana::EntityTypeID>
+MakeIDs(katana::EntityTypeID first_type, size_t num_types) {
+  katana::NUMAArray<katana::EntityTypeID> ids;
+  ids.allocateInterleaved(kNumEntities);
+  for (size_t i = 0; i < kNumEntities; ++i) {
+    ids[i] = i % 7 == 0 ? katana::kUnknownEntityType
+                        : static_cast<katana::EntityTypeID>(
+                              first_type + i % num_types);
+  }
+  return ids;
+}
+
+/// A ring of kNumEntities nodes and edges whose node and edge types use
+/// num_types of the types of MakeManager(num_atomic, num_intersections),
+/// starting at first_type
+std::unique_ptr<katana::PropertyGraph>
+MakeTypedGraph(
+    katana::EntityTypeID first_type, size_t num_types, size_t num_atomic,
+    size_t num_intersections) {
+  katana::NUMAArray<katana::GraphTopology::Edge> adj_indices;
+  katana::NUMAArray<katana::GraphTopology::Node> dests;
+  adj_indices.allocateInterleaved(kNumEntities);
+  dests.allocateInterleaved(kNumEntities);
+  for (size_t i = 0; i < kNumEntities; ++i) {
+    adj_indices[i] = i + 1;
+    dests[i] = (i + 1) % kNumEntities;
+  }
+
+  auto res = katana::PropertyGraph::Make(
+      katana::GraphTopology(std::move(adj_indices), std::move(dests)),
+      MakeIDs(first_type, num_types), MakeIDs(first_type, num_types),
+      MakeManager(num_atomic, num_intersections),
+      MakeManager(num_atomic, num_intersections));
+  KATANA_LOG_VASSERT(res, "making graph: {}", res.error());
+  return std::move(res.value());
+}
+
+void
+CheckEncoding(const katana::EntityTypeIDArray& ids, Encoding encoding) {
+  switch (encoding) {
+  case Encoding::kIdentity:
+    KATANA_LOG_ASSERT(ids.is_identity());
+    break;
+  case Encoding::kNarrow:
+    KATANA_LOG_ASSERT(ids.is_narrow() && !ids.is_identity());
+    break;
+  case Encoding::kWide:
+    KATANA_LOG_ASSERT(!ids.is_narrow());
+    break;
+  }
+}
+
+void
+CheckSameIDs(
+    const katana::EntityTypeIDArray& expected,
+    const katana::EntityTypeIDArray& actual) {
+  KATANA_LOG_ASSERT(expected.size() == actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        expected[i] == actual[i], "entity {}: expected {} found {}", i,
+        expected[i], actual[i]);
+  }
+}
+
+/// \returns the first word of the stored node type id array of rdg_dir
+uint64_t
+ReadTypeIDArrayHeader(const std::string& rdg_dir) {
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    std::string name = entry.path().filename().string();
+    if (name.rfind("node_entity_type_id_array", 0) != 0) {
+      continue;
+    }
+    std::ifstream in(entry.path().string(), std::ios_base::binary);
+    uint64_t header = 0;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    KATANA_LOG_VASSERT(in, "reading {}", name);
+    return header;
+  }
+  KATANA_LOG_FATAL("no node type id array in {}", rdg_dir);
+}
+
+/// Write g, load it again and check that its types were kept, in the same
+/// encoding
+void
+TestRoundTrip(
+    std::unique_ptr<katana::PropertyGraph> g, Encoding encoding,
+    bool legacy_file) {
+  CheckEncoding(g->node_entity_type_ids(), encoding);
+  CheckEncoding(g->edge_entity_type_ids(), encoding);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/entity-type-id-array");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());
+  auto write_res = g->Write(rdg_dir, "");
+  KATANA_LOG_VASSERT(write_res, "writing: {}", write_res.error());
+
+  // files whose ids fit in a byte each keep the format of older versions,
+  // which starts with the number of entities
+  uint64_t header = ReadTypeIDArrayHeader(rdg_dir);
+  KATANA_LOG_VASSERT(
+      (header == kNumEntities) == legacy_file, "type id array starts with {}",
+      header);
+
+  auto g2_res = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  KATANA_LOG_VASSERT(g2_res, "loading: {}", g2_res.error());
+  auto g2 = std::move(g2_res.value());
+
+  KATANA_LOG_ASSERT(g->Equals(g2.get()));
+  CheckEncoding(g2->node_entity_type_ids(), encoding);
+  CheckEncoding(g2->edge_entity_type_ids(), encoding);
+  CheckSameIDs(g->node_entity_type_ids(), g2->node_entity_type_ids());
+  CheckSameIDs(g->edge_entity_type_ids(), g2->edge_entity_type_ids());
+
+  fs::remove_all(rdg_dir);
+}
+
+/// Check FindNodesWithEntityTypes and FindEdgesWithEntityTypes against
+/// DoesNodeHaveType and DoesEdgeHaveType for each entity
+void
+CheckFind(
+    const katana::PropertyGraph& g, const katana::SetOfEntityTypeIDs& types) {
+  katana::DynamicBitset nodes;
+  auto nodes_res = katana::FindNodesWithEntityTypes(&g, types, &nodes);
+  KATANA_LOG_VASSERT(nodes_res, "finding nodes: {}", nodes_res.error());
+  KATANA_LOG_ASSERT(nodes.size() == g.num_nodes());
+  for (katana::GraphTopology::Node n = 0; n < g.num_nodes(); ++n) {
+    bool expected = false;
+    types.ForEach([&](katana::EntityTypeID id) {
+      expected = expected || g.DoesNodeHaveType(n, id);
+    });
+    KATANA_LOG_VASSERT(
+        nodes.test(n) == expected, "node {} of type {} in {}: expected {}", n,
+        g.GetTypeOfNode(n), types, expected);
+  }
+
+  katana::DynamicBitset edges;
+  auto edges_res = katana::FindEdgesWithEntityTypes(&g, types, &edges);
+  KATANA_LOG_VASSERT(edges_res, "finding edges: {}", edges_res.error());
+  KATANA_LOG_ASSERT(edges.size() == g.num_edges());
+  for (katana::GraphTopology::Edge e = 0; e < g.num_edges(); ++e) {
+    bool expected = false;
+    types.ForEach([&](katana::EntityTypeID id) {
+      expected = expected || g.DoesEdgeHaveType(e, id);
+    });
+    KATANA_LOG_VASSERT(
+        edges.test(e) == expected, "edge {} of type {} in {}: expected {}", e,
+        g.GetTypeOfEdge(e), types, expected);
+  }
+}
+
+void
+TestFind(
+    std::unique_ptr<katana::PropertyGraph> g, Encoding encoding,
+    katana::EntityTypeID first_type, size_t num_types) {
+  CheckEncoding(g->node_entity_type_ids(), encoding);
+  CheckEncoding(g->edge_entity_type_ids(), encoding);
+
+  auto last_type =
+      static_cast<katana::EntityTypeID>(first_type + num_types - 1);
+  // not the id of any type
+  auto num_entity_types = static_cast<katana::EntityTypeID>(
+      g->GetNodeTypeManager().GetNumEntityTypes());
+
+  // the first query is empty, so it finds nothing
+  std::vector<katana::SetOfEntityTypeIDs> queries(6);
+  // the first atomic type is part of the first intersection type
+  queries[1].set(1);
+  queries[2].set(first_type);
+  // an intersection type
+  queries[3].set(last_type);
+  queries[4].set(1).set(first_type + 1).set(last_type);
+  // every type
+  for (katana::EntityTypeID id = 1; id < num_entity_types; ++id) {
+    queries[5].set(id);
+  }
+  for (const auto& types : queries) {
+    CheckFind(*g, types);
+  }
+
+  katana::SetOfEntityTypeIDs unknown;
+  unknown.set(1).set(num_entity_types);
+  katana::DynamicBitset bitset;
+  auto nodes_res = katana::FindNodesWithEntityTypes(g.get(), unknown, &bitset);
+  KATANA_LOG_ASSERT(
+      !nodes_res && nodes_res.error() == katana::ErrorCode::NotFound);
+  auto edges_res = katana::FindEdgesWithEntityTypes(g.get(), unknown, &bitset);
+  KATANA_LOG_ASSERT(
+      !edges_res && edges_res.error() == katana::ErrorCode::NotFound);
+}
+
+// Each encoding, with node and edge types that cover some intersection types
+// at the end of their ranges
+
+std::unique_ptr<katana::PropertyGraph>
+MakeIdentityGraph() {
+  // types below 256
+  return MakeTypedGraph(1, 15, 10, 5);
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeNarrowGraph() {
+  // ids of 256 and more, but no more than 256 distinct ones
+  return MakeTypedGraph(250, 161, 400, 10);
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeWideGraph() {
+  // more than 256 distinct ids
+  return MakeTypedGraph(1, 310, 300, 10);
+}
+
+void
+TestStorage() {
+  // arrays of types below 256 are stored as bytes in the legacy format
+  TestRoundTrip(MakeIdentityGraph(), Encoding::kIdentity, true);
+  TestRoundTrip(MakeNarrowGraph(), Encoding::kNarrow, false);
+  TestRoundTrip(MakeWideGraph(), Encoding::kWide, false);
+}
+
+void
+TestFindEntities() {
+  TestFind(MakeIdentityGraph(), Encoding::kIdentity, 1, 15);
+  TestFind(MakeNarrowGraph(), Encoding::kNarrow, 250, 161);
+  TestFind(MakeWideGraph(), Encoding::kWide, 1, 310);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestStorage();
+  TestFindEntities();
+
+  return 0;
+}
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "RmatGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/Intersection.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+namespace {
+
+std::vector<uint32_t>
+RandomSortedList(std::mt19937* gen, size_t len, uint32_t universe) {
+  std::uniform_int_distribution<uint32_t> dist(0, universe - 1);
+  std::vector<uint32_t> r(len);
+  for (auto& v : r) {
+    v = dist(*gen);
+  }
+  std::sort(r.begin(), r.end());
+  r.erase(std::unique(r.begin(), r.end()), r.end());
+  return r;
+}
+
+/// Arguments are {length of the short list, length ratio of long to short}.
+void
+MakeListArguments(benchmark::internal::Benchmark* b) {
+  for (long len : {16, 256, 4096}) {
+    for (long ratio : {1, 8, 64, 1024}) {
+      b->Args({len, ratio});
+    }
+  }
+}
+
+template <typename Fn>
+void
+RunListBenchmark(benchmark::State& state, const Fn& fn) {
+  std::mt19937 gen(state.range(0));
+  size_t short_len = state.range(0);
+  size_t long_len = short_len * state.range(1);
+  uint32_t universe = long_len * 4;
+  auto a = RandomSortedList(&gen, short_len, universe);
+  auto b = RandomSortedList(&gen, long_len, universe);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(fn(a, b));
+  }
+  state.SetItemsProcessed(state.iterations() * (a.size() + b.size()));
+}
+
+void
+IntersectMerge(benchmark::State& state) {
+  RunListBenchmark(state, [](const auto& a, const auto& b) {
+    return katana::analytics::IntersectCountMerge(
+        a.data(), a.size(), b.data(), b.size());
+  });
+}
+
+void
+IntersectAdaptive(benchmark::State& state) {
+  RunListBenchmark(state, [](const auto& a, const auto& b) {
+    return katana::analytics::IntersectCount(
+        a.data(), a.size(), b.data(), b.size());
+  });
+}
+
+/// The ordered count loop that preceded the shared intersection kernel, kept
+/// as a baseline.
+size_t
+ScalarOrderedCount(const katana::GraphTopology& topo) {
+  katana::GAccumulator<size_t> num_triangles;
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](auto n) {
+        size_t local = 0;
+        for (auto e_n : topo.edges(n)) {
+          auto v = topo.edge_dest(e_n);
+          if (v > n) {
+            break;
+          }
+          auto it_n = topo.edges(n).begin();
+          for (auto e_v : topo.edges(v)) {
+            auto w = topo.edge_dest(e_v);
+            if (w > v) {
+              break;
+            }
+            while (topo.edge_dest(*it_n) < w) {
+              ++it_n;
+            }
+            if (w == topo.edge_dest(*it_n)) {
+              local += 1;
+            }
+          }
+        }
+        num_triangles += local;
+      },
+      katana::steal(), katana::no_stats());
+  return num_triangles.reduce();
+}
+
+void
+MakeGraphArguments(benchmark::internal::Benchmark* b) {
+  for (long scale : {14, 17}) {
+    b->Args({scale, 16});
+  }
+}
+
+void
+TriangleCountScalar(benchmark::State& state) {
+  auto pg = MakeRmatGraph(state.range(0), state.range(1));
+
+  size_t triangles = 0;
+  for (auto _ : state) {
+    triangles = ScalarOrderedCount(pg->topology());
+  }
+  state.counters["triangles"] = triangles;
+  state.counters["triangles_per_second"] = benchmark::Counter(
+      triangles * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+void
+TriangleCountIntersection(benchmark::State& state) {
+  auto pg = MakeRmatGraph(state.range(0), state.range(1));
+
+  size_t triangles = 0;
+  for (auto _ : state) {
+    auto res = katana::analytics::TriangleCount(
+        pg.get(), katana::analytics::TriangleCountPlan::OrderedCount());
+    if (!res) {
+      KATANA_LOG_FATAL("triangle count failed: {}", res.error());
+    }
+    triangles = res.value();
+  }
+  state.counters["triangles"] = triangles;
+  state.counters["triangles_per_second"] = benchmark::Counter(
+      triangles * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(IntersectMerge)->Apply(MakeListArguments);
+BENCHMARK(IntersectAdaptive)->Apply(MakeListArguments);
+BENCHMARK(TriangleCountScalar)
+    ->Apply(MakeGraphArguments)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(TriangleCountIntersection)
+    ->Apply(MakeGraphArguments)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
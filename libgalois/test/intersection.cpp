@@ -0,0 +1,115 @@
+#include <random>
+#include <set>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/analytics/Intersection.h"
+
+namespace {
+
+using katana::analytics::IntersectCount;
+using katana::analytics::IntersectCountGalloping;
+using katana::analytics::IntersectCountMerge;
+using katana::analytics::IntersectCountSimd;
+using katana::analytics::IntersectForEach;
+using katana::analytics::IntersectionBitmap;
+using katana::analytics::SortedSpan;
+
+std::vector<uint32_t>
+RandomSortedList(std::mt19937* gen, size_t len, uint32_t universe) {
+  std::set<uint32_t> values;
+  std::uniform_int_distribution<uint32_t> dist(0, universe - 1);
+  while (values.size() < len && values.size() < universe) {
+    values.insert(dist(*gen));
+  }
+  return std::vector<uint32_t>(values.begin(), values.end());
+}
+
+size_t
+ExpectedCount(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+  std::set<uint32_t> b_set(b.begin(), b.end());
+  size_t count = 0;
+  for (auto v : a) {
+    count += b_set.count(v);
+  }
+  return count;
+}
+
+void
+TestKernels(size_t a_len, size_t b_len, uint32_t universe) {
+  std::mt19937 gen(a_len * 31 + b_len);
+  auto a = RandomSortedList(&gen, a_len, universe);
+  auto b = RandomSortedList(&gen, b_len, universe);
+  SortedSpan<uint32_t> a_span{a.data(), a.size()};
+  SortedSpan<uint32_t> b_span{b.data(), b.size()};
+
+  size_t expected = ExpectedCount(a, b);
+
+  KATANA_LOG_ASSERT(
+      IntersectCountMerge(a.data(), a.size(), b.data(), b.size()) == expected);
+  KATANA_LOG_ASSERT(
+      IntersectCountSimd(a.data(), a.size(), b.data(), b.size()) == expected);
+  KATANA_LOG_ASSERT(IntersectCount(a_span, b_span) == expected);
+  KATANA_LOG_ASSERT(IntersectCount(b_span, a_span) == expected);
+  if (a.size() <= b.size()) {
+    KATANA_LOG_ASSERT(
+        IntersectCountGalloping(a.data(), a.size(), b.data(), b.size()) ==
+        expected);
+  }
+
+  size_t for_each_count = 0;
+  IntersectForEach(a_span, b_span, [&](size_t i, size_t j) {
+    KATANA_LOG_ASSERT(a[i] == b[j]);
+    ++for_each_count;
+  });
+  KATANA_LOG_ASSERT(for_each_count == expected);
+
+  if (expected > 0) {
+    size_t stopped_count = 0;
+    IntersectForEach(a_span, b_span, [&](size_t, size_t) {
+      ++stopped_count;
+      return false;
+    });
+    KATANA_LOG_ASSERT(stopped_count == 1);
+  }
+
+  IntersectionBitmap bitmap(universe);
+  bitmap.Mark(a_span);
+  KATANA_LOG_ASSERT(bitmap.Count(b_span) == expected);
+  bitmap.Unmark(a_span);
+  for (uint32_t v = 0; v < universe; ++v) {
+    KATANA_LOG_ASSERT(!bitmap.Test(v));
+  }
+}
+
+void
+TestTrim() {
+  std::vector<uint32_t> list{1, 3, 5, 7, 9};
+  SortedSpan<uint32_t> span{list.data(), list.size()};
+
+  KATANA_LOG_ASSERT(span.LessThan(5).size == 2);
+  KATANA_LOG_ASSERT(span.LessThanOrEqual(5).size == 3);
+  KATANA_LOG_ASSERT(span.GreaterThan(5).size == 2);
+  KATANA_LOG_ASSERT(span.GreaterThan(5)[0] == 7);
+  KATANA_LOG_ASSERT(span.GreaterThan(1).LessThan(9).size == 3);
+}
+
+}  // namespace
+
+int
+main() {
+  TestTrim();
+
+  TestKernels(0, 10, 100);
+  TestKernels(10, 0, 100);
+  TestKernels(7, 9, 20);
+  TestKernels(64, 64, 128);
+  TestKernels(100, 100, 1000);
+  TestKernels(1000, 1000, 3000);
+  // Skewed lengths exercise the galloping path
+  TestKernels(10, 5000, 20000);
+  TestKernels(5000, 10, 20000);
+  TestKernels(33, 4000, 5000);
+
+  return 0;
+}
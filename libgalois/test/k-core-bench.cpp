@@ -0,0 +1,103 @@
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "RmatGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/k_core/k_core.h"
+
+namespace {
+
+using katana::analytics::KCore;
+using katana::analytics::KCoreDecomposition;
+using katana::analytics::KCoreDecompositionStatistics;
+using katana::analytics::KCoreStatistics;
+
+const std::string kCoreNumberProperty = "core-number";
+const std::string kInCoreProperty = "in-core";
+
+void
+MakeGraphArguments(benchmark::internal::Benchmark* b) {
+  for (long scale : {12, 15, 18}) {
+    b->Args({scale, 16});
+  }
+}
+
+uint32_t
+ComputeCoreNumbers(katana::PropertyGraph* pg) {
+  if (auto r = KCoreDecomposition(pg, kCoreNumberProperty); !r) {
+    KATANA_LOG_FATAL("core decomposition failed: {}", r.error());
+  }
+  auto stats = KCoreDecompositionStatistics::Compute(pg, kCoreNumberProperty);
+  if (!stats) {
+    KATANA_LOG_FATAL("could not compute statistics: {}", stats.error());
+  }
+  if (auto r = pg->RemoveNodeProperty(kCoreNumberProperty); !r) {
+    KATANA_LOG_FATAL("could not remove property: {}", r.error());
+  }
+  return stats.value().max_core_number;
+}
+
+/// Number of nodes in the k-core computed by KCore.
+uint64_t
+KCoreSize(katana::PropertyGraph* pg, uint32_t k) {
+  if (auto r = KCore(pg, k, kInCoreProperty); !r) {
+    KATANA_LOG_FATAL("k-core failed: {}", r.error());
+  }
+  auto stats = KCoreStatistics::Compute(pg, k, kInCoreProperty);
+  if (!stats) {
+    KATANA_LOG_FATAL("could not compute statistics: {}", stats.error());
+  }
+  if (auto r = pg->RemoveNodeProperty(kInCoreProperty); !r) {
+    KATANA_LOG_FATAL("could not remove property: {}", r.error());
+  }
+  return stats.value().number_of_nodes_in_kcore;
+}
+
+void
+CoreNumbersDecomposition(benchmark::State& state) {
+  auto pg = MakeRmatGraph(state.range(0), state.range(1));
+
+  uint32_t max_core = 0;
+  for (auto _ : state) {
+    max_core = ComputeCoreNumbers(pg.get());
+  }
+  state.counters["max_core"] = max_core;
+}
+
+/// The core hierarchy computed with one KCore call per k, the only way to get
+/// it before KCoreDecomposition.
+void
+CoreNumbersRepeatedKCore(benchmark::State& state) {
+  auto pg = MakeRmatGraph(state.range(0), state.range(1));
+
+  uint32_t max_core = ComputeCoreNumbers(pg.get());
+  // The max core is nonempty and the next one is empty
+  KATANA_LOG_ASSERT(KCoreSize(pg.get(), max_core) > 0);
+  KATANA_LOG_ASSERT(KCoreSize(pg.get(), max_core + 1) == 0);
+
+  for (auto _ : state) {
+    for (uint32_t k = 1; k <= max_core; ++k) {
+      benchmark::DoNotOptimize(KCoreSize(pg.get(), k));
+    }
+  }
+  state.counters["max_core"] = max_core;
+}
+
+BENCHMARK(CoreNumbersDecomposition)
+    ->Apply(MakeGraphArguments)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(CoreNumbersRepeatedKCore)
+    ->Apply(MakeGraphArguments)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
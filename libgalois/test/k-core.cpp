@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <string>
+
+#include "RmatGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/k_core/k_core.h"
+
+namespace {
+
+using katana::analytics::KCore;
+using katana::analytics::KCoreDecomposition;
+using katana::analytics::KCoreDecompositionAssertValid;
+using katana::analytics::KCoreDecompositionPlan;
+
+/// Check the core numbers against one KCore run per k.
+void
+TestDecompositionMatchesKCore(uint32_t num_open_buckets) {
+  auto pg = MakeRmatGraph(10, 8);
+
+  auto r = KCoreDecomposition(
+      pg.get(), "core-number",
+      KCoreDecompositionPlan::BucketPeeling(num_open_buckets));
+  KATANA_LOG_ASSERT(r);
+  KATANA_LOG_ASSERT(KCoreDecompositionAssertValid(pg.get(), "core-number"));
+
+  auto core_res = pg->GetNodePropertyTyped<uint32_t>("core-number");
+  KATANA_LOG_ASSERT(core_res);
+  auto core_numbers = core_res.value();
+
+  uint32_t max_core = 0;
+  for (int64_t i = 0; i < core_numbers->length(); ++i) {
+    max_core = std::max(max_core, core_numbers->Value(i));
+  }
+  KATANA_LOG_ASSERT(max_core > 0);
+
+  for (uint32_t k = 1; k <= max_core + 1; ++k) {
+    std::string name = "in-core-" + std::to_string(k);
+    KATANA_LOG_ASSERT(KCore(pg.get(), k, name));
+    auto in_core_res = pg->GetNodePropertyTyped<uint32_t>(name);
+    KATANA_LOG_ASSERT(in_core_res);
+    auto in_core = in_core_res.value();
+
+    for (int64_t i = 0; i < core_numbers->length(); ++i) {
+      bool expected = core_numbers->Value(i) >= k;
+      KATANA_LOG_VASSERT(
+          expected == (in_core->Value(i) != 0),
+          "node {} with core number {} disagrees with the {}-core", i,
+          core_numbers->Value(i), k);
+    }
+    KATANA_LOG_ASSERT(pg->RemoveNodeProperty(name));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestDecompositionMatchesKCore(
+      KCoreDecompositionPlan::kDefaultNumOpenBuckets);
+  // A small window exercises moving the window through the overflow bucket
+  TestDecompositionMatchesKCore(2);
+
+  return 0;
+}
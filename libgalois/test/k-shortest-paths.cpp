@@ -0,0 +1,165 @@
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "RmatGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/k_shortest_paths/k_shortest_paths.h"
+
+namespace {
+
+using katana::analytics::KShortestPath;
+using katana::analytics::KShortestPaths;
+using katana::analytics::KShortestPathsAssertValid;
+using katana::analytics::KShortestPathsPlan;
+using katana::analytics::KShortestPathsQuery;
+using katana::analytics::KShortestSimplePaths;
+
+constexpr uint32_t kNumPaths = 8;
+
+/// Positive weights, so that every path has a positive length.
+uint32_t
+EdgeWeight(uint32_t src, uint32_t dest) {
+  return 1 + RmatEdgeWeight(src, dest);
+}
+
+/// Distance from source to target by serial Dijkstra.
+double
+ShortestDistance(
+    const katana::PropertyGraph& pg, const KShortestPathsQuery& q) {
+  const auto& topo = pg.topology();
+  std::vector<double> dist(
+      topo.num_nodes(), std::numeric_limits<double>::infinity());
+  using Entry = std::pair<double, uint32_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> heap;
+  dist[q.source] = 0;
+  heap.emplace(0, q.source);
+  while (!heap.empty()) {
+    auto [d, n] = heap.top();
+    heap.pop();
+    if (d > dist[n]) {
+      continue;
+    }
+    for (auto e : topo.edges(n)) {
+      uint32_t dest = topo.edge_dest(e);
+      if (d + EdgeWeight(n, dest) < dist[dest]) {
+        dist[dest] = d + EdgeWeight(n, dest);
+        heap.emplace(dist[dest], dest);
+      }
+    }
+  }
+  return dist[q.target];
+}
+
+bool
+SamePaths(
+    const std::vector<KShortestPath>& a, const std::vector<KShortestPath>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].edges != b[i].edges || a[i].weight != b[i].weight) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void
+TestQueries(katana::PropertyGraph* pg, const std::string& weight_name) {
+  std::vector<KShortestPathsQuery> queries;
+  for (uint32_t i = 0; i < 16; ++i) {
+    queries.push_back({(i * 37) % 256, (i * 101 + 5) % 256});
+  }
+  // a path from a node to itself
+  queries.push_back({3, 3});
+
+  auto walks_res = KShortestPaths(pg, weight_name, queries, kNumPaths);
+  KATANA_LOG_VASSERT(walks_res, "KShortestPaths failed: {}", walks_res.error());
+  auto simple_res = KShortestSimplePaths(pg, weight_name, queries, kNumPaths);
+  KATANA_LOG_VASSERT(
+      simple_res, "KShortestSimplePaths failed: {}", simple_res.error());
+  auto walks = std::move(walks_res.value());
+  auto simple = std::move(simple_res.value());
+  KATANA_LOG_ASSERT(walks.size() == queries.size());
+  KATANA_LOG_ASSERT(simple.size() == queries.size());
+
+  for (size_t q = 0; q < queries.size(); ++q) {
+    const auto& query = queries[q];
+    KATANA_LOG_ASSERT(
+        KShortestPathsAssertValid(pg, weight_name, query, walks[q], false));
+    KATANA_LOG_ASSERT(
+        KShortestPathsAssertValid(pg, weight_name, query, simple[q], true));
+
+    double expected = ShortestDistance(*pg, query);
+    if (expected == std::numeric_limits<double>::infinity()) {
+      KATANA_LOG_ASSERT(walks[q].empty() && simple[q].empty());
+      continue;
+    }
+    KATANA_LOG_VASSERT(
+        !simple[q].empty() && simple[q][0].weight == expected,
+        "query {}: shortest path should weigh {}", q, expected);
+    // the graph is symmetric, so walks can go back and forth on any edge
+    if (pg->topology().degree(query.source) > 0) {
+      KATANA_LOG_ASSERT(walks[q].size() == kNumPaths);
+    }
+    KATANA_LOG_ASSERT(walks[q][0].weight == expected);
+    // every simple path is a walk
+    for (size_t i = 0; i < simple[q].size(); ++i) {
+      KATANA_LOG_ASSERT(walks[q][i].weight <= simple[q][i].weight);
+    }
+    if (query.source == query.target) {
+      KATANA_LOG_ASSERT(simple[q].size() == 1);
+      KATANA_LOG_ASSERT(simple[q][0].edges.empty());
+    }
+  }
+
+  // the plans only change how the work is spread over the threads
+  for (auto plan :
+       {KShortestPathsPlan::ParallelQueries(),
+        KShortestPathsPlan::ParallelSpurPaths()}) {
+    auto other_walks =
+        KShortestPaths(pg, weight_name, queries, kNumPaths, plan);
+    auto other_simple =
+        KShortestSimplePaths(pg, weight_name, queries, kNumPaths, plan);
+    KATANA_LOG_ASSERT(other_walks && other_simple);
+    for (size_t q = 0; q < queries.size(); ++q) {
+      KATANA_LOG_ASSERT(SamePaths(walks[q], other_walks.value()[q]));
+      KATANA_LOG_ASSERT(SamePaths(simple[q], other_simple.value()[q]));
+    }
+  }
+
+  auto single = KShortestSimplePaths(
+      pg, weight_name, queries[0].source, queries[0].target, kNumPaths);
+  KATANA_LOG_ASSERT(single && SamePaths(single.value(), simple[0]));
+
+  KATANA_LOG_ASSERT(!KShortestPaths(pg, weight_name, 0, 1, 0));
+  KATANA_LOG_ASSERT(
+      !KShortestSimplePaths(pg, weight_name, 0, pg->num_nodes(), kNumPaths));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  auto pg = MakeRmatGraph(8, 4);
+  AddEdgeWeights<arrow::UInt32Builder>(
+      pg.get(), "uint32", arrow::uint32(), EdgeWeight);
+  AddEdgeWeights<arrow::DoubleBuilder>(
+      pg.get(), "double", arrow::float64(), EdgeWeight);
+
+  TestQueries(pg.get(), "uint32");
+  TestQueries(pg.get(), "double");
+
+  KATANA_LOG_ASSERT(!KShortestPaths(pg.get(), "no-such-weight", 0, 1, 1));
+
+  return 0;
+}
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <string>
+
+#include "RmatGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/k_truss/k_truss.h"
+
+namespace {
+
+using katana::analytics::KTruss;
+using katana::analytics::KTrussDecomposition;
+using katana::analytics::KTrussDecompositionAssertValid;
+using katana::analytics::KTrussDecompositionPlan;
+
+/// Check the trussness of every edge against one KTruss run per k.
+void
+TestDecompositionMatchesKTruss(uint32_t num_open_buckets) {
+  auto pg = MakeRmatGraph(9, 8);
+
+  auto r = KTrussDecomposition(
+      pg.get(), "trussness",
+      KTrussDecompositionPlan::BucketPeeling(num_open_buckets));
+  KATANA_LOG_ASSERT(r);
+  KATANA_LOG_ASSERT(KTrussDecompositionAssertValid(pg.get(), "trussness"));
+
+  auto trussness_res = pg->GetEdgePropertyTyped<uint32_t>("trussness");
+  KATANA_LOG_ASSERT(trussness_res);
+  auto trussness = trussness_res.value();
+
+  uint32_t max_trussness = 0;
+  for (int64_t i = 0; i < trussness->length(); ++i) {
+    max_trussness = std::max(max_trussness, trussness->Value(i));
+  }
+  KATANA_LOG_ASSERT(max_trussness > 3);
+
+  for (uint32_t k = 3; k <= max_trussness + 1; ++k) {
+    std::string name = "in-truss-" + std::to_string(k);
+    KATANA_LOG_ASSERT(KTruss(pg.get(), k, name));
+    auto flags_res = pg->GetEdgePropertyTyped<uint32_t>(name);
+    KATANA_LOG_ASSERT(flags_res);
+    auto flags = flags_res.value();
+
+    for (int64_t i = 0; i < trussness->length(); ++i) {
+      bool expected = trussness->Value(i) >= k;
+      KATANA_LOG_VASSERT(
+          expected == (flags->Value(i) == 0),
+          "edge {} with trussness {} disagrees with the {}-truss", i,
+          trussness->Value(i), k);
+    }
+    KATANA_LOG_ASSERT(pg->RemoveEdgeProperty(name));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestDecompositionMatchesKTruss(
+      KTrussDecompositionPlan::kDefaultNumOpenBuckets);
+  // A small window exercises moving the window through the overflow bucket
+  TestDecompositionMatchesKTruss(2);
+
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include <string>
+#include <vector>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "katana/LazyGraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "tsuba/RDG.h"
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input rdg>"), cll::Required);
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// Breadth first search from node 0, checking every neighbor list against the
+/// eagerly loaded topology
+void
+TestTraversal(
+    const katana::GraphTopology& expected, katana::LazyGraphTopology* lazy) {
+  std::vector<bool> visited(expected.num_nodes());
+  std::vector<Node> frontier{0};
+  visited[0] = true;
+  while (!frontier.empty()) {
+    auto res = lazy->Prefetch(frontier);
+    KATANA_LOG_VASSERT(res, "prefetching: {}", res.error());
+
+    std::vector<Node> next;
+    for (Node n : frontier) {
+      KATANA_LOG_ASSERT(lazy->degree(n) == expected.degree(n));
+      for (auto e : lazy->edges(n)) {
+        Node dest = lazy->edge_dest(e);
+        KATANA_LOG_ASSERT(dest == expected.edge_dest(e));
+        if (!visited[dest]) {
+          visited[dest] = true;
+          next.emplace_back(dest);
+        }
+      }
+    }
+    frontier = std::move(next);
+  }
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  cll::ParseCommandLineOptions(argc, argv);
+
+  auto pg_res = katana::PropertyGraph::Make(inputFile, tsuba::RDGLoadOptions());
+  KATANA_LOG_VASSERT(pg_res, "loading {}: {}", inputFile, pg_res.error());
+  const katana::GraphTopology& expected = pg_res.value()->topology();
+
+  // a budget of a single page makes every frontier release pages
+  auto lazy_res = katana::LazyGraphTopology::Make(inputFile, 1);
+  KATANA_LOG_VASSERT(lazy_res, "making lazy topology: {}", lazy_res.error());
+  auto lazy = std::move(lazy_res.value());
+  KATANA_LOG_ASSERT(lazy->num_nodes() == expected.num_nodes());
+  KATANA_LOG_ASSERT(lazy->num_edges() == expected.num_edges());
+  KATANA_LOG_ASSERT(lazy->max_resident_pages() == 1);
+
+  TestTraversal(expected, lazy.get());
+  KATANA_LOG_ASSERT(lazy->Trim());
+  KATANA_LOG_ASSERT(lazy->resident_pages() <= 1);
+
+  // without prefetching, every page is faulted in
+  uint64_t faults = lazy->num_faults();
+  for (Node n : expected.all_nodes()) {
+    for (auto e : lazy->edges(n)) {
+      KATANA_LOG_ASSERT(lazy->edge_dest(e) == expected.edge_dest(e));
+    }
+  }
+  KATANA_LOG_ASSERT(lazy->num_edges() == 0 || lazy->num_faults() > faults);
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "RmatGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+namespace {
+
+using katana::analytics::MinimumSpanningForest;
+using katana::analytics::MinimumSpanningForestAssertValid;
+using katana::analytics::MinimumSpanningForestPlan;
+using katana::analytics::MinimumSpanningForestStatistics;
+
+/// Weight of a minimum spanning forest by serial Kruskal.
+double
+ExpectedWeight(const katana::PropertyGraph& pg) {
+  const auto& topo = pg.topology();
+  std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> edges;
+  for (uint32_t n = 0; n < topo.num_nodes(); ++n) {
+    for (auto e : topo.edges(n)) {
+      uint32_t dest = topo.edge_dest(e);
+      edges.emplace_back(RmatEdgeWeight(n, dest), n, dest);
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+
+  std::vector<uint32_t> parent(topo.num_nodes());
+  for (uint32_t i = 0; i < parent.size(); ++i) {
+    parent[i] = i;
+  }
+  auto find = [&](uint32_t node) {
+    while (parent[node] != node) {
+      node = parent[node] = parent[parent[node]];
+    }
+    return node;
+  };
+  double weight = 0;
+  for (const auto& [w, src, dest] : edges) {
+    uint32_t a = find(src);
+    uint32_t b = find(dest);
+    if (a != b) {
+      parent[a] = b;
+      weight += w;
+    }
+  }
+  return weight;
+}
+
+std::vector<uint8_t>
+ForestEdges(katana::PropertyGraph* pg, const std::string& name) {
+  auto values_res = pg->GetEdgePropertyTyped<uint8_t>(name);
+  KATANA_LOG_ASSERT(values_res);
+  auto values = values_res.value();
+  return std::vector<uint8_t>(
+      values->raw_values(), values->raw_values() + values->length());
+}
+
+void
+TestPlans(const std::string& weight_name) {
+  // a sparse graph, so the forest has several trees
+  auto pg = MakeRmatGraph(10, 2);
+  AddEdgeWeights<arrow::UInt32Builder>(
+      pg.get(), "uint32", arrow::uint32(), RmatEdgeWeight);
+  AddEdgeWeights<arrow::DoubleBuilder>(
+      pg.get(), "double", arrow::float64(), RmatEdgeWeight);
+  double expected_weight = ExpectedWeight(*pg);
+
+  std::vector<std::pair<std::string, MinimumSpanningForestPlan>> plans{
+      {"boruvka", MinimumSpanningForestPlan::Boruvka()},
+      {"filter-kruskal", MinimumSpanningForestPlan::FilterKruskal()},
+      {"filter-kruskal-16", MinimumSpanningForestPlan::FilterKruskal(16)},
+  };
+  std::vector<uint8_t> first_forest;
+  for (const auto& [name, plan] : plans) {
+    auto res = MinimumSpanningForest(pg.get(), weight_name, name, plan);
+    KATANA_LOG_VASSERT(res, "{} failed: {}", name, res.error());
+    KATANA_LOG_ASSERT(
+        MinimumSpanningForestAssertValid(pg.get(), weight_name, name));
+
+    auto stats_res =
+        MinimumSpanningForestStatistics::Compute(pg.get(), weight_name, name);
+    KATANA_LOG_ASSERT(stats_res);
+    auto stats = stats_res.value();
+    KATANA_LOG_VASSERT(
+        stats.total_weight == expected_weight, "{}: weight {}, expected {}",
+        name, stats.total_weight, expected_weight);
+    KATANA_LOG_ASSERT(
+        stats.num_forest_edges + stats.num_trees == pg->num_nodes());
+
+    // ties are broken by edge ID, so all plans pick the same edges
+    auto forest = ForestEdges(pg.get(), name);
+    if (first_forest.empty()) {
+      first_forest = forest;
+    }
+    KATANA_LOG_VASSERT(forest == first_forest, "{} picked other edges", name);
+  }
+
+  KATANA_LOG_ASSERT(!MinimumSpanningForest(pg.get(), "no-such-weight", "out"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestPlans("uint32");
+  TestPlans("double");
+
+  return 0;
+}
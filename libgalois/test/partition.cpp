@@ -0,0 +1,83 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RmatGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/partition/partition.h"
+
+namespace {
+
+using katana::analytics::MakePartitionOrderedTopology;
+using katana::analytics::Partition;
+using katana::analytics::PartitionAssertValid;
+using katana::analytics::PartitionPlan;
+using katana::analytics::PartitionStatistics;
+
+void
+TestPartition(katana::PropertyGraph* pg, uint32_t num_partitions) {
+  std::string name = "partition-" + std::to_string(num_partitions);
+  auto plan = PartitionPlan::Multilevel();
+  auto res = Partition(pg, num_partitions, name, plan);
+  KATANA_LOG_VASSERT(res, "partition failed: {}", res.error());
+  KATANA_LOG_ASSERT(PartitionAssertValid(pg, num_partitions, name));
+
+  auto stats_res = PartitionStatistics::Compute(pg, num_partitions, name);
+  KATANA_LOG_ASSERT(stats_res);
+  auto stats = stats_res.value();
+  KATANA_LOG_VASSERT(
+      stats.imbalance <= plan.max_imbalance(), "{} parts: imbalance {}",
+      num_partitions, stats.imbalance);
+  // a random partition cuts (1 - 1/k) of the edges
+  double random_cut =
+      (1.0 - 1.0 / num_partitions) * pg->topology().num_edges();
+  KATANA_LOG_VASSERT(
+      stats.edge_cut <= 0.9 * random_cut, "{} parts: cut {}, random cut {}",
+      num_partitions, stats.edge_cut, random_cut);
+
+  auto ids_res = pg->GetNodePropertyTyped<uint32_t>(name);
+  KATANA_LOG_ASSERT(ids_res);
+  const uint32_t* ids = ids_res.value()->raw_values();
+  auto topo_res = MakePartitionOrderedTopology(pg, name);
+  KATANA_LOG_ASSERT(topo_res);
+  auto topo = std::move(topo_res.value());
+  KATANA_LOG_ASSERT(topo->num_nodes() == pg->topology().num_nodes());
+  KATANA_LOG_ASSERT(topo->num_edges() == pg->topology().num_edges());
+
+  std::vector<bool> seen(topo->num_nodes(), false);
+  uint32_t prev_partition = 0;
+  for (uint32_t n = 0; n < topo->num_nodes(); ++n) {
+    auto original = topo->node_property_index(n);
+    KATANA_LOG_ASSERT(!seen[original]);
+    seen[original] = true;
+    KATANA_LOG_ASSERT(topo->degree(n) == pg->topology().degree(original));
+    // partitions are contiguous and in order
+    KATANA_LOG_ASSERT(ids[original] >= prev_partition);
+    prev_partition = ids[original];
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  auto pg = MakeRmatGraph(10, 8);
+  for (uint32_t num_partitions : {1, 2, 8, 16}) {
+    TestPartition(pg.get(), num_partitions);
+  }
+
+  KATANA_LOG_ASSERT(!Partition(pg.get(), 0, "zero"));
+  KATANA_LOG_ASSERT(!Partition(pg.get(), 2, "partition-2"));
+  for (uint32_t coarsen_to : {0, 1}) {
+    KATANA_LOG_ASSERT(!Partition(
+        pg.get(), 2, "coarsen-to",
+        PartitionPlan::Multilevel(
+            PartitionPlan::kDefaultMaxImbalance, coarsen_to)));
+  }
+
+  return 0;
+}
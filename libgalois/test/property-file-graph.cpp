@@ -1,3 +1,8 @@
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include <arrow/api.h>
 #include <boost/filesystem.hpp>
 
@@ -5,6 +10,7 @@
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
 #include "katana/URI.h"
 
 namespace {
@@ -118,6 +124,68 @@ TestTypesFromPropertiesCompareTypesFromStorage() {
   KATANA_LOG_ASSERT(g->Equals(g2.get()));
 }
 
+/// The entity types inferred from properties are the same for any number of
+/// threads
+void
+TestTypesFromPropertiesIndependentOfThreads() {
+  constexpr size_t kNumNodes = 5000;
+  constexpr size_t kNumTypeProperties = 6;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  // sparse type properties with many combinations spread over the nodes
+  arrow::FieldVector fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (size_t c = 0; c < kNumTypeProperties; ++c) {
+    arrow::UInt8Builder builder;
+    for (size_t i = 0; i < kNumNodes; ++i) {
+      bool has_type = (i * 7919 + c * 104729) % (c + 2) == 0;
+      KATANA_LOG_ASSERT(builder.Append(has_type).ok());
+    }
+    std::shared_ptr<arrow::Array> column;
+    KATANA_LOG_ASSERT(builder.Finish(&column).ok());
+    fields.emplace_back(
+        arrow::field(fmt::format("node-type-{}", c), arrow::uint8()));
+    columns.emplace_back(std::move(column));
+  }
+  auto add_node_result =
+      g->AddNodeProperties(arrow::Table::Make(arrow::schema(fields), columns));
+  KATANA_LOG_ASSERT(add_node_result);
+
+  auto infer = [&g](unsigned num_threads) {
+    katana::setActiveThreads(num_threads);
+    auto type_construction_result = g->ConstructEntityTypeIDs();
+    KATANA_LOG_ASSERT(type_construction_result);
+    std::vector<katana::EntityTypeID> type_ids;
+    for (uint32_t n = 0; n < g->num_nodes(); ++n) {
+      type_ids.emplace_back(g->GetTypeOfNode(n));
+    }
+    return std::make_pair(
+        type_ids,
+        g->GetNodeTypeManager().GetEntityTypeIDToAtomicEntityTypeIDs());
+  };
+
+  unsigned active_threads = katana::getActiveThreads();
+  unsigned max_threads = std::max(1U, std::thread::hardware_concurrency());
+  auto expected = infer(1);
+  KATANA_LOG_VASSERT(
+      expected.second.size() > kNumTypeProperties + 1,
+      "only {} entity types inferred", expected.second.size());
+  for (unsigned num_threads : {2U, 3U, max_threads}) {
+    auto inferred = infer(num_threads);
+    KATANA_LOG_VASSERT(
+        inferred.first == expected.first,
+        "type IDs with {} threads differ from those with 1 thread",
+        num_threads);
+    KATANA_LOG_VASSERT(
+        inferred.second == expected.second,
+        "atomic types with {} threads differ from those with 1 thread",
+        num_threads);
+  }
+  katana::setActiveThreads(active_threads);
+}
+
 void
 TestCompositeTypesFromPropertiesCompareCompositeTypesFromStorage() {
   /*
@@ -335,6 +403,61 @@ TestRoundTrip() {
   }
 }
 
+/// Per property write options apply only to the node or the edge property
+/// they are given for, even when both have the same name.
+void
+TestWriteOptions() {
+  constexpr size_t test_length = 10;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<double>("value", test_length)));
+  KATANA_LOG_ASSERT(
+      g->AddEdgeProperties(MakeProps<int64_t>("value", test_length)));
+
+  tsuba::RDGWriteOptions::ColumnOpts split;
+  split.use_dictionary = false;
+  split.encoding = parquet::Encoding::BYTE_STREAM_SPLIT;
+
+  tsuba::RDGWriteOptions opts;
+  opts.file_opts.compression = arrow::Compression::ZSTD;
+  opts.node_property_opts.emplace("value", split);
+  g->set_property_write_opts(opts);
+  KATANA_LOG_ASSERT(
+      g->property_write_opts().node_property_opts.count("value") == 1);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g->Equals(g2.get()));
+
+  // byte stream split is rejected for the int64 edge property
+  tsuba::RDGWriteOptions bad_opts;
+  bad_opts.edge_property_opts.emplace("value", split);
+  g2->set_property_write_opts(bad_opts);
+  auto bad_uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(bad_uri_res);
+  std::string bad_rdg_dir(bad_uri_res.value().path());
+  auto bad_write_result = g2->Write(bad_rdg_dir, command_line);
+  fs::remove_all(bad_rdg_dir);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(!bad_write_result);
+}
+
 void
 TestGarbageMetadata() {
   auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
@@ -452,11 +575,13 @@ main(int argc, char** argv) {
   command_line = cmdout.str();
 
   TestRoundTrip();
+  TestWriteOptions();
   TestGarbageMetadata();
   TestSimplePGs();
   TestTopologyAccess();
   TestTypesFromPropertiesCompareTypesFromStorage();
   TestCompositeTypesFromPropertiesCompareCompositeTypesFromStorage();
+  TestTypesFromPropertiesIndependentOfThreads();
 
   return 0;
 }
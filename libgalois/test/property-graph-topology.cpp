@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <vector>
+
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
@@ -12,6 +15,110 @@ TestEdgeSource(const katana::GraphTopology& topo) noexcept {
   }
 }
 
+template <typename View>
+void
+TestEdgesSorted(const View& view) noexcept {
+  for (auto node : view.all_nodes()) {
+    auto edges = view.edges(node);
+    KATANA_LOG_ASSERT(std::is_sorted(
+        view.dest_data() + *edges.begin(), view.dest_data() + *edges.end()));
+  }
+}
+
+/// Check that View relabels the nodes of pg without changing the graph
+template <typename View>
+View
+TestReorderedView(katana::PropertyGraph* pg) noexcept {
+  KATANA_LOG_ASSERT(!pg->IsViewCached<View>());
+  auto view = pg->BuildView<View>();
+  KATANA_LOG_ASSERT(pg->IsViewCached<View>());
+  TestEdgesSorted(view);
+
+  const auto& topo = pg->topology();
+  KATANA_LOG_ASSERT(view.num_nodes() == topo.num_nodes());
+  KATANA_LOG_ASSERT(view.num_edges() == topo.num_edges());
+  std::vector<bool> seen(topo.num_nodes(), false);
+  for (auto node : view.all_nodes()) {
+    auto original = view.original_node_id(node);
+    KATANA_LOG_ASSERT(!seen[original]);
+    seen[original] = true;
+    KATANA_LOG_ASSERT(view.degree(node) == topo.degree(original));
+    for (auto e : view.edges(node)) {
+      auto original_dest = view.original_node_id(view.edge_dest(e));
+      KATANA_LOG_ASSERT(
+          topo.edge_dest(view.original_edge_id(e)) == original_dest);
+    }
+  }
+
+  KATANA_LOG_ASSERT(pg->BuildView<View>().dest_data() == view.dest_data());
+  return view;
+}
+
+void
+TestReorderedViews(katana::GraphTopology&& topo) noexcept {
+  using Views = katana::PropertyGraphViews;
+
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  auto pg = std::move(pg_res.value());
+
+  TestReorderedView<Views::NodesReverseCuthillMcKeeEdgesSortedByDestID>(
+      pg.get());
+  TestReorderedView<Views::NodesGorderEdgesSortedByDestID>(pg.get());
+
+  auto bucketed =
+      TestReorderedView<Views::NodesDegreeBucketedEdgesSortedByDestID>(
+          pg.get());
+  for (auto node : bucketed.all_nodes()) {
+    if (node > 0) {
+      // buckets are powers of two, in decreasing order
+      auto prev = bucketed.degree(node - 1);
+      KATANA_LOG_ASSERT(
+          prev == 0 ? bucketed.degree(node) == 0
+                    : bucketed.degree(node) < 2 * prev);
+    }
+  }
+
+  auto bfs =
+      TestReorderedView<Views::NodesBreadthFirstEdgesSortedByDestID>(pg.get());
+  for (auto node : bfs.all_nodes()) {
+    KATANA_LOG_ASSERT(bfs.degree(node) <= bfs.degree(0));
+  }
+}
+
+void
+TestViewCache(katana::GraphTopology&& topo) noexcept {
+  using SortedView = katana::PropertyGraphViews::EdgesSortedByDestID;
+  using RelabeledView =
+      katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
+
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  auto pg = std::move(pg_res.value());
+
+  KATANA_LOG_ASSERT(!pg->IsViewCached<SortedView>());
+  KATANA_LOG_ASSERT(!pg->IsViewCached<RelabeledView>());
+
+  auto relabeled = pg->BuildView<RelabeledView>();
+  KATANA_LOG_ASSERT(pg->IsViewCached<RelabeledView>());
+  TestEdgesSorted(relabeled);
+  for (auto node : relabeled.all_nodes()) {
+    if (node > 0) {
+      KATANA_LOG_ASSERT(relabeled.degree(node - 1) <= relabeled.degree(node));
+    }
+  }
+
+  auto sorted = pg->BuildView<SortedView>();
+  KATANA_LOG_ASSERT(pg->IsViewCached<SortedView>());
+  TestEdgesSorted(sorted);
+
+  // Building a cached view again must not copy the topology
+  KATANA_LOG_ASSERT(
+      pg->BuildView<RelabeledView>().dest_data() == relabeled.dest_data());
+  KATANA_LOG_ASSERT(
+      pg->BuildView<SortedView>().dest_data() == sorted.dest_data());
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -24,5 +131,10 @@ main() {
 
   TestEdgeSource(topo);
 
+  TestViewCache(std::move(topo));
+
+  TestReorderedViews(
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+
   return 0;
 }
@@ -0,0 +1,255 @@
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <llvm/Support/CommandLine.h>
+
+#include "katana/Logging.h"
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/PropertyIndex.h"
+#include "katana/PropertyMemoryManager.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/URI.h"
+#include "katana/analytics/Utils.h"
+#include "tsuba/RDG.h"
+
+namespace cll = llvm::cl;
+namespace fs = boost::filesystem;
+
+static cll::opt<std::string> ldbc_003InputFile(
+    cll::Positional, cll::desc("<ldbc_003 input file>"), cll::Required);
+
+namespace {
+
+std::unique_ptr<katana::PropertyGraph>
+LoadGraph(const std::string& rdg_name) {
+  auto g_res = katana::PropertyGraph::Make(rdg_name, tsuba::RDGLoadOptions());
+  KATANA_LOG_VASSERT(g_res, "making {}: {}", rdg_name, g_res.error());
+  return std::move(g_res.value());
+}
+
+/// Store a copy of the input so that evicting properties never writes to it
+std::string
+CopyInput() {
+  auto g = LoadGraph(ldbc_003InputFile);
+  auto uri_res = katana::Uri::MakeRand("/tmp/property-memory-manager");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());
+  auto write_res = g->Write(rdg_dir, "");
+  KATANA_LOG_VASSERT(write_res, "writing: {}", write_res.error());
+  return rdg_dir;
+}
+
+bool
+IsLoaded(const katana::PropertyGraph& g, const std::string& name) {
+  return g.HasNodeProperty(name);
+}
+
+void
+TestEviction(const std::string& rdg_dir) {
+  auto& manager = katana::PropertyMemoryManager::Get();
+  KATANA_LOG_ASSERT(manager.used() == 0);
+
+  auto g1 = LoadGraph(rdg_dir);
+  auto g2 = LoadGraph(rdg_dir);
+  std::vector<std::string> names = g1->loaded_node_schema()->field_names();
+  KATANA_LOG_ASSERT(names.size() >= 2);
+  uint64_t used = manager.used();
+  KATANA_LOG_ASSERT(used > 0);
+
+  // setting a budget does not evict; a budget of half of what is loaded
+  // makes Trim evict from both graphs, least recently used first
+  manager.set_budget(used / 2);
+  KATANA_LOG_ASSERT(manager.used() == used);
+  manager.Trim();
+  KATANA_LOG_ASSERT(manager.used() <= used / 2);
+  KATANA_LOG_ASSERT(manager.num_evictions() > 0);
+  for (const auto& name : names) {
+    KATANA_LOG_ASSERT(!IsLoaded(*g1, name) || IsLoaded(*g2, name));
+  }
+
+  // pinned properties stay loaded even over budget
+  KATANA_LOG_ASSERT(g1->PinNodeProperty(names[0]));
+  KATANA_LOG_ASSERT(g1->PinNodeProperty(names[0]));
+  manager.set_budget(1);
+  manager.Trim();
+  KATANA_LOG_ASSERT(IsLoaded(*g1, names[0]));
+  KATANA_LOG_ASSERT(manager.used() == manager.pinned());
+
+  // loading a property over budget evicts other unpinned properties, but
+  // not the one just loaded
+  KATANA_LOG_ASSERT(g1->EnsureNodePropertyLoaded(names[1]));
+  KATANA_LOG_ASSERT(IsLoaded(*g1, names[1]));
+  KATANA_LOG_ASSERT(g2->EnsureNodePropertyLoaded(names[1]));
+  KATANA_LOG_ASSERT(IsLoaded(*g2, names[1]));
+  KATANA_LOG_ASSERT(!IsLoaded(*g1, names[1]));
+  KATANA_LOG_ASSERT(IsLoaded(*g1, names[0]));
+  manager.Trim();
+  KATANA_LOG_ASSERT(!IsLoaded(*g2, names[1]));
+
+  // unpinning does not evict
+  KATANA_LOG_ASSERT(g1->UnpinNodeProperty(names[0]));
+  KATANA_LOG_ASSERT(g1->UnpinNodeProperty(names[0]));
+  KATANA_LOG_ASSERT(IsLoaded(*g1, names[0]));
+  manager.Trim();
+  KATANA_LOG_ASSERT(!IsLoaded(*g1, names[0]));
+  KATANA_LOG_ASSERT(!g1->UnpinNodeProperty(names[0]));
+  KATANA_LOG_ASSERT(manager.used() == 0);
+
+  // moving a graph keeps its properties tracked
+  manager.set_budget(0);
+  KATANA_LOG_ASSERT(g2->EnsureNodePropertyLoaded(names[1]));
+  used = manager.used();
+  KATANA_LOG_ASSERT(used > 0);
+  katana::PropertyGraph moved = std::move(*g2);
+  g2.reset();
+  KATANA_LOG_ASSERT(manager.used() == used);
+  KATANA_LOG_ASSERT(moved.UnloadNodeProperty(names[1]));
+  KATANA_LOG_ASSERT(manager.used() == 0);
+
+  for (const auto& name : names) {
+    KATANA_LOG_ASSERT(g1->EnsureNodePropertyLoaded(name));
+  }
+  KATANA_LOG_ASSERT(manager.used() > 0);
+  g1.reset();
+  KATANA_LOG_ASSERT(manager.used() == 0);
+}
+
+struct Value : public katana::UInt32Property {};
+using NodeData = std::tuple<Value>;
+using EdgeData = std::tuple<>;
+
+/// Views into properties stay valid when properties are added and unpinned
+/// over budget, and when properties are loaded while theirs are pinned
+void
+TestViewsOverBudget(const std::string& rdg_dir) {
+  auto& manager = katana::PropertyMemoryManager::Get();
+  manager.set_budget(0);
+
+  auto g = LoadGraph(rdg_dir);
+  std::vector<std::string> names = g->loaded_node_schema()->field_names();
+  KATANA_LOG_ASSERT(
+      katana::analytics::ConstructNodeProperties<NodeData>(g.get(), {"a"}));
+  auto typed_res =
+      katana::TypedPropertyGraph<NodeData, EdgeData>::Make(g.get(), {"a"}, {});
+  KATANA_LOG_VASSERT(typed_res, "making typed graph: {}", typed_res.error());
+  auto typed = std::move(typed_res.value());
+  for (auto n : typed) {
+    typed.GetData<Value>(n) = n;
+  }
+
+  manager.set_budget(1);
+  KATANA_LOG_ASSERT(
+      katana::analytics::ConstructNodeProperties<NodeData>(g.get(), {"b"}));
+  KATANA_LOG_ASSERT(g->PinNodeProperty(names[0]));
+  KATANA_LOG_ASSERT(g->UnpinNodeProperty(names[0]));
+  KATANA_LOG_ASSERT(manager.used() > manager.budget());
+  KATANA_LOG_ASSERT(IsLoaded(*g, "a"));
+  KATANA_LOG_ASSERT(IsLoaded(*g, "b"));
+
+  // loading evicts unpinned properties, so the property of the view is
+  // pinned across it; the evicted new property is written out first
+  KATANA_LOG_ASSERT(g->PinNodeProperty("a"));
+  KATANA_LOG_ASSERT(g->UnloadNodeProperty(names[0]));
+  KATANA_LOG_ASSERT(g->EnsureNodePropertyLoaded(names[0]));
+  KATANA_LOG_ASSERT(IsLoaded(*g, names[0]));
+  KATANA_LOG_ASSERT(!IsLoaded(*g, "b"));
+  KATANA_LOG_ASSERT(IsLoaded(*g, "a"));
+  for (auto n : typed) {
+    KATANA_LOG_VASSERT(
+        typed.GetData<Value>(n) == n, "node {} has {}", n,
+        typed.GetData<Value>(n));
+  }
+  KATANA_LOG_ASSERT(g->UnpinNodeProperty("a"));
+
+  // Trim writes out the new properties before unloading them
+  manager.Trim();
+  KATANA_LOG_ASSERT(!IsLoaded(*g, "a"));
+  manager.set_budget(0);
+  KATANA_LOG_ASSERT(g->EnsureNodePropertyLoaded("a"));
+  auto reloaded_res =
+      katana::TypedPropertyGraph<NodeData, EdgeData>::Make(g.get(), {"a"}, {});
+  KATANA_LOG_ASSERT(reloaded_res);
+  auto reloaded = std::move(reloaded_res.value());
+  for (auto n : reloaded) {
+    KATANA_LOG_ASSERT(reloaded.GetData<Value>(n) == n);
+  }
+}
+
+struct Key : public katana::PODProperty<int64_t> {};
+using IndexedNodeData = std::tuple<Key>;
+
+/// Evicting a property drops its index, and loading it again rebuilds the
+/// index over the reloaded column
+void
+TestIndexOverEviction(const std::string& rdg_dir) {
+  constexpr int64_t kNumKeys = 10;
+  auto& manager = katana::PropertyMemoryManager::Get();
+  manager.set_budget(0);
+
+  auto g = LoadGraph(rdg_dir);
+  KATANA_LOG_ASSERT(
+      katana::analytics::ConstructNodeProperties<IndexedNodeData>(
+          g.get(), {"key"}));
+  {
+    auto typed_res =
+        katana::TypedPropertyGraph<IndexedNodeData, EdgeData>::Make(
+            g.get(), {"key"}, {});
+    KATANA_LOG_ASSERT(typed_res);
+    auto typed = std::move(typed_res.value());
+    for (auto n : typed) {
+      typed.GetData<Key>(n) = (n * 7) % kNumKeys;
+    }
+  }
+  KATANA_LOG_ASSERT(g->MakeNodeIndex("key"));
+
+  manager.set_budget(1);
+  manager.Trim();
+  KATANA_LOG_ASSERT(!IsLoaded(*g, "key"));
+  KATANA_LOG_ASSERT(!g->HasNodePropertyIndex("key"));
+
+  manager.set_budget(0);
+  KATANA_LOG_ASSERT(g->EnsureNodePropertyLoaded("key"));
+  auto index_res = g->GetNodePropertyIndex("key");
+  KATANA_LOG_VASSERT(index_res, "index not rebuilt: {}", index_res.error());
+  auto* index = static_cast<
+      katana::PrimitivePropertyIndex<katana::GraphTopology::Node, int64_t>*>(
+      index_res.value());
+
+  auto keys_res = g->GetNodePropertyTyped<int64_t>("key");
+  KATANA_LOG_ASSERT(keys_res);
+  auto keys = keys_res.value();
+  for (int64_t key = 0; key < kNumKeys; ++key) {
+    uint64_t found = 0;
+    for (auto it = index->Find(key);
+         it != index->end() && keys->Value(*it) == key; ++it) {
+      ++found;
+    }
+    uint64_t expected = 0;
+    for (uint64_t n = 0; n < g->num_nodes(); ++n) {
+      expected += keys->Value(n) == key;
+    }
+    KATANA_LOG_VASSERT(
+        found == expected, "key {}: found {} nodes, expected {}", key, found,
+        expected);
+  }
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  cll::ParseCommandLineOptions(argc, argv);
+
+  std::string rdg_dir = CopyInput();
+  TestEviction(rdg_dir);
+  TestViewsOverBudget(rdg_dir);
+  TestIndexOverEviction(rdg_dir);
+  fs::remove_all(rdg_dir);
+
+  return 0;
+}
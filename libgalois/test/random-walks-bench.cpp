@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+
+#include <arrow/api.h>
+#include <benchmark/benchmark.h>
+
+#include "RmatGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/random_walks/random_walks.h"
+
+namespace {
+
+using katana::analytics::RandomWalks;
+using katana::analytics::RandomWalksPlan;
+
+const std::string kWeightProperty = "weight";
+constexpr uint32_t kWalkLength = 80;
+
+void
+MakeGraphArguments(benchmark::internal::Benchmark* b) {
+  for (long scale : {12, 15, 18}) {
+    b->Args({scale, 16});
+  }
+}
+
+/// Add heavy-tailed integer edge weights, so the weighted walks sample from
+/// skewed distributions at the hubs as well.
+void
+AddParetoWeights(katana::PropertyGraph* pg) {
+  std::mt19937_64 gen(pg->topology().num_edges());
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+  arrow::UInt32Builder builder;
+  KATANA_LOG_ASSERT(builder.Reserve(pg->topology().num_edges()).ok());
+  for (uint64_t i = 0; i < pg->topology().num_edges(); ++i) {
+    // Pareto with shape 1.5 and scale 1, capped to keep sums in range
+    double w = std::pow(1.0 - dist(gen), -1.0 / 1.5);
+    builder.UnsafeAppend(static_cast<uint32_t>(std::min(w, 1e6)));
+  }
+  auto weights = builder.Finish();
+  KATANA_LOG_ASSERT(weights.ok());
+
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(kWeightProperty, arrow::uint32())}),
+      {weights.ValueOrDie()});
+  if (auto r = pg->AddEdgeProperties(table); !r) {
+    KATANA_LOG_FATAL("could not add weights: {}", r.error());
+  }
+}
+
+void
+RunWalks(
+    benchmark::State& state, const RandomWalksPlan& plan,
+    const std::string& edge_weight_property_name) {
+  auto pg = MakeRmatGraph(state.range(0), state.range(1));
+  if (!edge_weight_property_name.empty()) {
+    AddParetoWeights(pg.get());
+  }
+
+  uint64_t num_walks = 0;
+  for (auto _ : state) {
+    auto walks = RandomWalks(pg.get(), plan, edge_weight_property_name);
+    if (!walks) {
+      KATANA_LOG_FATAL("random walks failed: {}", walks.error());
+    }
+    num_walks += walks.value()->length();
+  }
+  state.counters["walks_per_second"] =
+      benchmark::Counter(num_walks, benchmark::Counter::kIsRate);
+  state.counters["steps_per_second"] =
+      benchmark::Counter(num_walks * kWalkLength, benchmark::Counter::kIsRate);
+}
+
+/// First order walks: every step is a single draw.
+void
+UniformWalks(benchmark::State& state) {
+  RunWalks(state, RandomWalksPlan::Node2Vec(kWalkLength, 1), "");
+}
+
+/// Node2vec walks biased toward exploring away from the previous node, which
+/// rejects many proposals and probes the adjacency of hubs.
+void
+BiasedWalks(benchmark::State& state) {
+  RunWalks(state, RandomWalksPlan::Node2Vec(kWalkLength, 1, 4.0, 0.25), "");
+}
+
+void
+WeightedWalks(benchmark::State& state) {
+  RunWalks(state, RandomWalksPlan::Node2Vec(kWalkLength, 1), kWeightProperty);
+}
+
+void
+WeightedBiasedWalks(benchmark::State& state) {
+  RunWalks(
+      state, RandomWalksPlan::Node2Vec(kWalkLength, 1, 4.0, 0.25),
+      kWeightProperty);
+}
+
+BENCHMARK(UniformWalks)
+    ->Apply(MakeGraphArguments)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BiasedWalks)
+    ->Apply(MakeGraphArguments)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(WeightedWalks)
+    ->Apply(MakeGraphArguments)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(WeightedBiasedWalks)
+    ->Apply(MakeGraphArguments)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
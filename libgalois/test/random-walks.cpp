@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "RmatGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+#include "katana/analytics/random_walks/random_walks.h"
+#include "tsuba/ParquetReader.h"
+
+namespace {
+
+using katana::analytics::RandomWalks;
+using katana::analytics::RandomWalksPlan;
+
+bool
+HasEdge(const katana::GraphTopology& topo, uint32_t src, uint32_t dest) {
+  for (auto e : topo.edges(src)) {
+    if (topo.edge_dest(e) == dest) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Check the layout of the walks: one row per walk from a node with
+/// neighbors, in order of start node, and every step follows an edge.
+void
+TestNode2VecWalks() {
+  constexpr uint32_t kWalkLength = 4;
+  constexpr uint32_t kNumberOfWalks = 2;
+
+  auto pg = MakeRmatGraph(9, 8);
+  const auto& topo = pg->topology();
+
+  auto walks_res = RandomWalks(
+      pg.get(), RandomWalksPlan::Node2Vec(kWalkLength, kNumberOfWalks));
+  KATANA_LOG_ASSERT(walks_res);
+  auto walks = walks_res.value();
+  KATANA_LOG_ASSERT(walks->type()->Equals(arrow::list(arrow::uint32())));
+
+  std::vector<uint32_t> expected_starts;
+  for (uint64_t i = 0; i < topo.num_nodes() * kNumberOfWalks; ++i) {
+    uint32_t n = i % topo.num_nodes();
+    if (topo.edges(n).size() > 0) {
+      expected_starts.emplace_back(n);
+    }
+  }
+  // Nodes without neighbors start no walk, so rows must be packed
+  KATANA_LOG_ASSERT(
+      expected_starts.size() < topo.num_nodes() * kNumberOfWalks);
+  KATANA_LOG_ASSERT(
+      static_cast<uint64_t>(walks->length()) == expected_starts.size());
+
+  uint64_t row = 0;
+  for (const auto& chunk : walks->chunks()) {
+    auto list = std::static_pointer_cast<arrow::ListArray>(chunk);
+    auto nodes = std::static_pointer_cast<arrow::UInt32Array>(list->values());
+    for (int64_t i = 0; i < list->length(); ++i, ++row) {
+      int32_t begin = list->value_offset(i);
+      int32_t end = list->value_offset(i + 1);
+      // Walks in a symmetric graph never get stuck
+      KATANA_LOG_ASSERT(end - begin == kWalkLength + 1);
+      KATANA_LOG_ASSERT(nodes->Value(begin) == expected_starts[row]);
+      for (int32_t j = begin + 1; j < end; ++j) {
+        KATANA_LOG_VASSERT(
+            HasEdge(topo, nodes->Value(j - 1), nodes->Value(j)),
+            "walk {} steps from {} to {} without an edge", row,
+            nodes->Value(j - 1), nodes->Value(j));
+      }
+    }
+  }
+}
+
+/// A star where node 0 has edges to 1, 2 and 3 with "weight"s 3, 1 and 0,
+/// and each leaf has an edge of weight 1 back to 0
+std::unique_ptr<katana::PropertyGraph>
+MakeWeightedStar() {
+  std::vector<katana::GraphTopology::Edge> adj_indices{3, 4, 5, 6};
+  std::vector<katana::GraphTopology::Node> dests{1, 2, 3, 0, 0, 0};
+  katana::GraphTopology topo(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size());
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  auto pg = std::move(pg_res.value());
+
+  arrow::UInt32Builder builder;
+  KATANA_LOG_ASSERT(builder.AppendValues({3, 1, 0, 1, 1, 1}).ok());
+  auto weights = builder.Finish();
+  KATANA_LOG_ASSERT(weights.ok());
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {weights.ValueOrDie()});
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(table));
+  return pg;
+}
+
+/// Steps from node 0 of a star with weights 3, 1 and 0 follow the weights.
+void
+TestWeightedWalks() {
+  constexpr uint32_t kNumberOfWalks = 20000;
+
+  auto pg = MakeWeightedStar();
+  auto walks_res = RandomWalks(
+      pg.get(), RandomWalksPlan::Node2Vec(1, kNumberOfWalks), "weight");
+  KATANA_LOG_ASSERT(walks_res);
+  auto walks = walks_res.value();
+
+  std::vector<uint64_t> steps_from_hub(4, 0);
+  for (const auto& chunk : walks->chunks()) {
+    auto list = std::static_pointer_cast<arrow::ListArray>(chunk);
+    auto nodes = std::static_pointer_cast<arrow::UInt32Array>(list->values());
+    for (int64_t i = 0; i < list->length(); ++i) {
+      int32_t begin = list->value_offset(i);
+      KATANA_LOG_ASSERT(list->value_length(i) == 2);
+      if (nodes->Value(begin) == 0) {
+        steps_from_hub[nodes->Value(begin + 1)] += 1;
+      } else {
+        KATANA_LOG_ASSERT(nodes->Value(begin + 1) == 0);
+      }
+    }
+  }
+
+  KATANA_LOG_ASSERT(steps_from_hub[0] == 0);
+  KATANA_LOG_ASSERT(steps_from_hub[3] == 0);
+  KATANA_LOG_ASSERT(steps_from_hub[1] + steps_from_hub[2] == kNumberOfWalks);
+  // Expect 3/4 of the steps to go to node 1, within about ten deviations
+  KATANA_LOG_VASSERT(
+      steps_from_hub[1] > 14400 && steps_from_hub[1] < 15600,
+      "{} of {} steps took the edge of weight 3", steps_from_hub[1],
+      kNumberOfWalks);
+
+  KATANA_LOG_ASSERT(!RandomWalks(
+      pg.get(), RandomWalksPlan::Node2Vec(1, 1), "no-such-property"));
+}
+
+/// Weighted walks written in batches to parquet files read back as the
+/// walks of every batch, and never take the edge of weight 0.
+void
+TestWeightedWalksToParquet() {
+  constexpr uint32_t kNumberOfWalks = 1000;
+  constexpr uint64_t kWalksPerBatch = 300;
+  namespace fs = boost::filesystem;
+
+  auto pg = MakeWeightedStar();
+  auto prefix_res = katana::Uri::MakeRand("/tmp/random-walks");
+  KATANA_LOG_ASSERT(prefix_res);
+  katana::Uri prefix = prefix_res.value();
+
+  auto write_res = katana::analytics::RandomWalksToParquet(
+      pg.get(), prefix, RandomWalksPlan::Node2Vec(1, kNumberOfWalks),
+      "weight", kWalksPerBatch);
+  KATANA_LOG_VASSERT(write_res, "writing walks: {}", write_res.error());
+
+  auto reader_res = tsuba::ParquetReader::Make();
+  KATANA_LOG_ASSERT(reader_res);
+  auto reader = std::move(reader_res.value());
+
+  uint64_t num_walks = 0;
+  uint64_t num_batches = 0;
+  for (;; ++num_batches) {
+    katana::Uri batch = prefix + fmt::format(".{:06}", num_batches);
+    if (!fs::exists(batch.path())) {
+      break;
+    }
+    auto table_res = reader->ReadTable(batch);
+    KATANA_LOG_VASSERT(table_res, "reading {}: {}", batch, table_res.error());
+    auto table = table_res.value();
+    KATANA_LOG_ASSERT(table->num_columns() == 1);
+    KATANA_LOG_ASSERT(
+        table->field(0)->name() == katana::analytics::kRandomWalksColumnName);
+    KATANA_LOG_ASSERT(
+        static_cast<uint64_t>(table->num_rows()) <= kWalksPerBatch);
+
+    for (const auto& chunk : table->column(0)->chunks()) {
+      auto list = std::static_pointer_cast<arrow::ListArray>(chunk);
+      auto nodes =
+          std::static_pointer_cast<arrow::UInt32Array>(list->values());
+      for (int64_t i = 0; i < list->length(); ++i) {
+        int32_t begin = list->value_offset(i);
+        KATANA_LOG_ASSERT(list->value_length(i) == 2);
+        KATANA_LOG_ASSERT(nodes->Value(begin + 1) != 3);
+      }
+      num_walks += list->length();
+    }
+    fs::remove(batch.path());
+  }
+
+  // every node starts kNumberOfWalks walks
+  uint64_t expected_walks = pg->num_nodes() * kNumberOfWalks;
+  KATANA_LOG_ASSERT(num_walks == expected_walks);
+  KATANA_LOG_ASSERT(
+      num_batches == (expected_walks + kWalksPerBatch - 1) / kWalksPerBatch);
+
+  KATANA_LOG_ASSERT(!katana::analytics::RandomWalksToParquet(
+      pg.get(), prefix, RandomWalksPlan::Node2Vec(1, 1), "no-such-property"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestNode2VecWalks();
+  TestWeightedWalks();
+  TestWeightedWalksToParquet();
+
+  return 0;
+}
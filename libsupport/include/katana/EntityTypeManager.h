@@ -1,6 +1,8 @@
 #pragma once
 
-#include <bitset>
+#include <cstdint>
+#include <limits>
+#include <map>
 #include <optional>
 #include <set>
 #include <string>
@@ -19,15 +21,120 @@ namespace katana {
 /// EntityTypeID uniquely identifies an entity (node or edge) type
 /// EntityTypeID for nodes is distinct from EntityTypeID for edges
 /// This type may either be an atomic type or an intersection of atomic types
-/// EntityTypeID is represented using 8 bits
-using EntityTypeID = uint8_t;
+/// EntityTypeID is represented using 16 bits; arrays of EntityTypeIDs are
+/// stored with 8 bits per entity when they can be (see EntityTypeIDArray)
+using EntityTypeID = uint16_t;
 static constexpr EntityTypeID kUnknownEntityType = EntityTypeID{0};
 static constexpr std::string_view kUnknownEntityTypeName = "kUnknownName";
 static constexpr EntityTypeID kInvalidEntityType =
     std::numeric_limits<EntityTypeID>::max();
+
 /// A set of EntityTypeIDs
-using SetOfEntityTypeIDs =
-    std::bitset<std::numeric_limits<EntityTypeID>::max() + 1>;
+///
+/// This is a bitset that grows to hold the largest EntityTypeID in it, so that
+/// sets stay small for the common case of graphs with few types even though
+/// there may be up to 2^16 of them.
+class KATANA_EXPORT SetOfEntityTypeIDs {
+public:
+  /// \returns true iff \p id is in the set
+  bool test(size_t id) const noexcept {
+    size_t word = id / kBitsPerWord;
+    return word < words_.size() &&
+           ((words_[word] >> (id % kBitsPerWord)) & 1) != 0;
+  }
+
+  bool operator[](size_t id) const noexcept { return test(id); }
+
+  /// add \p id to the set
+  SetOfEntityTypeIDs& set(size_t id) {
+    size_t word = id / kBitsPerWord;
+    if (word >= words_.size()) {
+      words_.resize(word + 1, 0);
+    }
+    words_[word] |= uint64_t{1} << (id % kBitsPerWord);
+    return *this;
+  }
+
+  /// remove \p id from the set
+  SetOfEntityTypeIDs& reset(size_t id) noexcept {
+    size_t word = id / kBitsPerWord;
+    if (word < words_.size()) {
+      words_[word] &= ~(uint64_t{1} << (id % kBitsPerWord));
+      Trim();
+    }
+    return *this;
+  }
+
+  /// remove every EntityTypeID from the set
+  SetOfEntityTypeIDs& reset() noexcept {
+    words_.clear();
+    return *this;
+  }
+
+  /// \returns a bound on the EntityTypeIDs in the set: every member is less
+  /// than size()
+  size_t size() const noexcept { return words_.size() * kBitsPerWord; }
+
+  /// \returns the number of EntityTypeIDs in the set
+  size_t count() const noexcept;
+
+  /// \returns true iff every EntityTypeID in the set is in \p other
+  bool IsSubsetOf(const SetOfEntityTypeIDs& other) const noexcept;
+
+  bool none() const noexcept { return words_.empty(); }
+
+  bool any() const noexcept { return !none(); }
+
+  /// Call \p fn with each EntityTypeID in the set, in increasing order
+  template <typename F>
+  void ForEach(F fn) const {
+    for (size_t word = 0; word < words_.size(); ++word) {
+      for (uint64_t bits = words_[word]; bits != 0; bits &= bits - 1) {
+        fn(static_cast<EntityTypeID>(
+            word * kBitsPerWord + __builtin_ctzll(bits)));
+      }
+    }
+  }
+
+  SetOfEntityTypeIDs& operator&=(const SetOfEntityTypeIDs& other) noexcept;
+  SetOfEntityTypeIDs& operator|=(const SetOfEntityTypeIDs& other);
+
+  friend SetOfEntityTypeIDs operator&(
+      SetOfEntityTypeIDs lhs, const SetOfEntityTypeIDs& rhs) noexcept {
+    return lhs &= rhs;
+  }
+
+  friend SetOfEntityTypeIDs operator|(
+      SetOfEntityTypeIDs lhs, const SetOfEntityTypeIDs& rhs) {
+    return lhs |= rhs;
+  }
+
+  bool operator==(const SetOfEntityTypeIDs& other) const noexcept {
+    return words_ == other.words_;
+  }
+
+  bool operator!=(const SetOfEntityTypeIDs& other) const noexcept {
+    return !(*this == other);
+  }
+
+  size_t Hash() const noexcept;
+
+  /// \returns the members of the set, e.g., "{1, 4}"
+  std::string ToString() const;
+
+private:
+  static constexpr size_t kBitsPerWord = 64;
+
+  void Trim() noexcept {
+    while (!words_.empty() && words_.back() == 0) {
+      words_.pop_back();
+    }
+  }
+
+  /// never ends with a zero word, so that equal sets have equal words
+  std::vector<uint64_t> words_;
+};
+
 /// A map from EntityTypeID to a set of EntityTypeIDs
 using EntityTypeIDToSetOfEntityTypeIDsMap = std::vector<SetOfEntityTypeIDs>;
 /// A map from the atomic type name to its EntityTypeID
@@ -63,12 +170,12 @@ public:
     size_t num_entity_types = entity_type_id_to_atomic_entity_type_ids_.size();
     atomic_entity_type_id_to_entity_type_ids_.resize(num_entity_types);
     for (size_t i = 0, ni = num_entity_types; i < ni; ++i) {
-      for (size_t j = 0, nj = num_entity_types; j < nj; ++j) {
-        if (entity_type_id_to_atomic_entity_type_ids_[i].test(j)) {
-          atomic_entity_type_id_to_entity_type_ids_[j].set(i);
-        }
-      }
+      entity_type_id_to_atomic_entity_type_ids_[i].ForEach(
+          [&](EntityTypeID j) {
+            atomic_entity_type_id_to_entity_type_ids_.at(j).set(i);
+          });
     }
+    ComputeSupertypeClosures();
   }
 
   EntityTypeManager(
@@ -85,74 +192,8 @@ public:
         entity_type_id_to_atomic_entity_type_ids_(
             std::move(entity_type_id_to_atomic_entity_type_ids)),
         atomic_entity_type_id_to_entity_type_ids_(
-            std::move(atomic_entity_type_id_to_entity_type_ids)) {}
-
-  /// This function can be used to convert "old style" graphs (storage format 1,
-  /// where types are represented by uint8 properties) and "new style"
-  /// graphs (version > 2, where types are represented in our native type
-  /// represenation). This function is serial but it likely iterates over
-  /// O(nodes) and O(edges) vectors, so it is very slow. It should only be used
-  /// for updating old graphs.
-  ///
-  /// The length of entity_type_ids should be equal to topo_size.
-  /// properties->num_rows() should be equal to the length of entity_type_ids or
-  /// 0.
-  template <typename EntityTypeArray>
-  static Result<void> AssignEntityTypeIDsFromProperties(
-      const size_t topo_size,  // == either num_nodes() or  num_edges()
-      const std::shared_ptr<arrow::Table>& properties,
-      katana::EntityTypeManager* entity_type_manager,
-      EntityTypeArray* entity_type_ids) {
-    KATANA_LOG_WARN("assigning entity type ids from properties");
-    static_assert(
-        std::is_same_v<typename EntityTypeArray::value_type, EntityTypeID>);
-    if (entity_type_ids->size() != topo_size) {
-      return KATANA_ERROR(
-          katana::ErrorCode::InvalidArgument,
-          "size of topology array ({}) doesn't match size of type array ({})",
-          topo_size, entity_type_ids->size());
-    }
-    int64_t num_rows = properties->num_rows();
-    if (num_rows == 0) {
-      std::fill(
-          entity_type_ids->begin(), entity_type_ids->end(), kUnknownEntityType);
-      return ResultSuccess();
-    }
-    auto num_rows_for_comparison = static_cast<size_t>(num_rows);
-    if (entity_type_ids->size() != num_rows_for_comparison) {
-      return KATANA_ERROR(
-          katana::ErrorCode::InvalidArgument,
-          "size of property table ({}) doesn't match size of type array ({})",
-          num_rows, entity_type_ids->size());
-    }
-
-    // We cannot use KATANA_CHECKED here because nvcc cannot handle it.
-    auto res =
-        DoAssignEntityTypeIDsFromProperties(properties, entity_type_manager);
-    if (!res) {
-      return ResultError(std::move(res.error()));
-    }
-    TypeProperties type_properties = std::move(res.value());
-
-    // assign the type ID for each row
-    for (int64_t row = 0; row < num_rows; ++row) {
-      TypeProperties::FieldEntity field_indices;
-      for (auto& uint8_property : type_properties.uint8_properties) {
-        if (uint8_property.array->IsValid(row) &&
-            uint8_property.array->Value(row)) {
-          field_indices.emplace_back(uint8_property.field_index);
-        }
-      }
-      if (field_indices.empty()) {
-        entity_type_ids->at(row) = katana::kUnknownEntityType;
-      } else {
-        katana::EntityTypeID entity_type_id =
-            type_properties.type_field_indices_to_id.at(field_indices);
-        entity_type_ids->at(row) = entity_type_id;
-      }
-    }
-
-    return ResultSuccess();
+            std::move(atomic_entity_type_id_to_entity_type_ids)) {
+    ComputeSupertypeClosures();
   }
 
   /// adds a new entity type for the atomic type with name \p name
@@ -292,7 +333,7 @@ public:
           return KATANA_ERROR(
               ErrorCode::InvalidArgument, "duplicate name: {}", name);
         }
-        res[id] = true;
+        res.set(id);
       } else {
         return KATANA_ERROR(
             ErrorCode::NotFound, "type {} does not exist", name);
@@ -320,7 +361,7 @@ public:
         return KATANA_ERROR(
             ErrorCode::InvalidArgument, "duplicate name: {}", name);
       }
-      res[id] = true;
+      res.set(id);
     }
     return MakeResult(std::move(res));
   }
@@ -353,6 +394,17 @@ public:
     return atomic_entity_type_id_to_entity_type_ids_.at(entity_type_id);
   }
 
+  /// \returns the set of entity types that the entity type \p entity_type_id
+  /// is a sub-type of, including itself; i.e., the types whose atomic types
+  /// include all of the atomic types of \p entity_type_id. For an atomic type,
+  /// this is GetSupertypes(entity_type_id).
+  /// (assumes that the entity type exists)
+  const SetOfEntityTypeIDs& GetSupertypeClosure(
+      EntityTypeID entity_type_id) const {
+    KATANA_LOG_DEBUG_ASSERT(HasEntityType(entity_type_id));
+    return entity_type_id_to_supertype_closure_[entity_type_id];
+  }
+
   /// \returns the set of atomic types that are intersected
   /// by the entity type \p entity_type_id
   /// (assumes that the entity type exists)
@@ -365,10 +417,8 @@ public:
   /// sub-type of the type \p super_type
   /// (assumes that the sub_type and super_type EntityTypeIDs exists)
   bool IsSubtypeOf(EntityTypeID sub_type, EntityTypeID super_type) const {
-    const auto& super_atomic_types = GetAtomicSubtypes(super_type);
-    const auto& sub_atomic_types = GetAtomicSubtypes(sub_type);
-    // return true if sub_atomic_types is a subset of super_atomic_types
-    return (sub_atomic_types & super_atomic_types) == sub_atomic_types;
+    KATANA_LOG_DEBUG_ASSERT(HasEntityType(super_type));
+    return GetSupertypeClosure(sub_type).test(super_type);
   }
 
   const EntityTypeIDToSetOfEntityTypeIDsMap&
@@ -388,26 +438,12 @@ public:
   std::string ReportDiff(const EntityTypeManager& other) const;
 
 private:
-  // Used by AssignEntityTypeIDsFromProperties()
-  template <typename ArrowType>
-  struct PropertyColumn {
-    int field_index;
-    std::shared_ptr<ArrowType> array;
-
-    PropertyColumn(int i, std::shared_ptr<ArrowType>& a)
-        : field_index(i), array(a) {}
-  };
-
-  // Used by AssignEntityTypeIDsFromProperties()
-  struct TypeProperties {
-    std::vector<PropertyColumn<arrow::UInt8Array>> uint8_properties;
-    using FieldEntity = std::vector<int>;
-    std::map<FieldEntity, katana::EntityTypeID> type_field_indices_to_id;
-  };
-
-  static Result<TypeProperties> DoAssignEntityTypeIDsFromProperties(
-      const std::shared_ptr<arrow::Table>& properties,
-      EntityTypeManager* entity_type_manager);
+  /// \returns the types that have all of \p atomic_entity_type_ids
+  SetOfEntityTypeIDs SupertypeClosureOf(
+      const SetOfEntityTypeIDs& atomic_entity_type_ids) const;
+
+  /// Compute entity_type_id_to_supertype_closure_ from the other maps
+  void ComputeSupertypeClosures();
 
   void Init() {
     // assume kUnknownEntityType is 0
@@ -440,6 +476,31 @@ private:
   /// ex: atomic_entity_type_id_to_entity_type_ids_[atomic_id][atomic_id] == 1
   /// but atomic_entity_type_id_to_entity_type_ids_[non_atomic_id][non_atomic_id] == 0
   EntityTypeIDToSetOfEntityTypeIDsMap atomic_entity_type_id_to_entity_type_ids_;
+
+  /// A map from the EntityTypeID to the EntityTypeIDs it is a sub-type of,
+  /// including itself:
+  /// derived from the two maps above, so that IsSubtypeOf is a single test
+  EntityTypeIDToSetOfEntityTypeIDsMap entity_type_id_to_supertype_closure_;
 };
 
 }  // namespace katana
+
+template <>
+struct KATANA_EXPORT fmt::formatter<katana::SetOfEntityTypeIDs>
+    : formatter<std::string> {
+  template <typename FormatContext>
+  auto format(const katana::SetOfEntityTypeIDs& set, FormatContext& ctx) {
+    return formatter<std::string>::format(set.ToString(), ctx);
+  }
+};
+
+namespace std {
+
+template <>
+struct hash<katana::SetOfEntityTypeIDs> {
+  size_t operator()(const katana::SetOfEntityTypeIDs& set) const noexcept {
+    return set.Hash();
+  }
+};
+
+}  // namespace std
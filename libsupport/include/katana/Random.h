@@ -2,6 +2,8 @@
 #define KATANA_LIBSUPPORT_KATANA_RANDOM_H_
 
 #include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <random>
 #include <string>
 
@@ -11,6 +13,63 @@ namespace katana {
 
 using RandGenerator = std::mt19937;
 
+/// The xoshiro256** generator:
+///
+///   David Blackman and Sebastiano Vigna. Scrambled Linear Pseudorandom Number
+///   Generators. ACM Transactions on Mathematical Software 47(4), 2021.
+///
+/// Its state is 32 bytes instead of the 5KB of std::mt19937 and a draw is a
+/// handful of shifts and rotates, so it suits per-thread generators in
+/// parallel loops that draw in their innermost step. It satisfies
+/// UniformRandomBitGenerator. It is not suitable for cryptography.
+class Xoshiro256StarStar {
+public:
+  using result_type = uint64_t;
+
+  explicit Xoshiro256StarStar(uint64_t seed = 0) { Seed(seed); }
+
+  /// Reset the state from a 64-bit seed with splitmix64 as recommended by the
+  /// authors, so that nearby seeds give unrelated sequences.
+  void Seed(uint64_t seed) {
+    for (uint64_t& word : state_) {
+      seed += 0x9e3779b97f4a7c15;
+      uint64_t z = seed;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+      word = z ^ (z >> 31);
+    }
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() {
+    const uint64_t result = Rotl(state_[1] * 5, 7) * 9;
+    const uint64_t t = state_[1] << 17;
+
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+
+    state_[2] ^= t;
+    state_[3] = Rotl(state_[3], 45);
+
+    return result;
+  }
+
+  /// \returns a uniformly distributed double in [0, 1) built from the top 53
+  /// bits of a draw, which is cheaper than std::uniform_real_distribution
+  double NextDouble() { return ((*this)() >> 11) * 0x1.0p-53; }
+
+private:
+  static uint64_t Rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+  uint64_t state_[4];
+};
+
 /// Generate a random alphanumeric string of length \param len using
 /// \param gen if provided. If no generator is specified, use the output of
 /// GetGenerator
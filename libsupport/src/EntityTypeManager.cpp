@@ -1,104 +1,71 @@
 #include "katana/EntityTypeManager.h"
 
-katana::Result<katana::EntityTypeManager::TypeProperties>
-katana::EntityTypeManager::DoAssignEntityTypeIDsFromProperties(
-    const std::shared_ptr<arrow::Table>& properties,
-    EntityTypeManager* entity_type_manager) {
-  // throw an error if each column/property has more than 1 chunk
-  for (int i = 0, n = properties->num_columns(); i < n; i++) {
-    std::shared_ptr<arrow::ChunkedArray> property = properties->column(i);
-    if (property->num_chunks() != 1) {
-      return KATANA_ERROR(
-          katana::ErrorCode::NotImplemented,
-          "property {} has {} chunks (1 chunk expected)",
-          properties->schema()->field(i)->name(), property->num_chunks());
-    }
-  }
-
-  // collect the list of types
-  TypeProperties type_properties;
-  TypeProperties::FieldEntity type_field_indices;
-  const std::shared_ptr<arrow::Schema>& schema = properties->schema();
+#include <boost/container_hash/hash.hpp>
 
-  KATANA_LOG_DEBUG_ASSERT(schema->num_fields() == properties->num_columns());
-  for (int i = 0, n = schema->num_fields(); i < n; i++) {
-    const std::shared_ptr<arrow::Field>& current_field = schema->field(i);
-
-    // a uint8 property is (always) considered a type
-    // TODO(roshan) make this customizable by the user
-    if (current_field->type()->Equals(arrow::uint8())) {
-      type_field_indices.push_back(i);
-      KATANA_LOG_DEBUG_ASSERT(properties->column(i)->num_chunks() == 1);
-      std::shared_ptr<arrow::Array> property = properties->column(i)->chunk(0);
-      auto uint8_property =
-          std::static_pointer_cast<arrow::UInt8Array>(property);
-      type_properties.uint8_properties.emplace_back(i, uint8_property);
-    }
+size_t
+katana::SetOfEntityTypeIDs::count() const noexcept {
+  size_t num = 0;
+  for (uint64_t word : words_) {
+    num += __builtin_popcountll(word);
   }
+  return num;
+}
 
-  // assign a new ID to each type
-  // NB: cannot use unordered_map without defining a hash function for vectors;
-  // performance is not affected here because the map is very small (<=256)
-  for (int i : type_field_indices) {
-    const std::shared_ptr<arrow::Field>& current_field = schema->field(i);
-    const std::string& field_name = current_field->name();
-    katana::EntityTypeID new_entity_type_id =
-        KATANA_CHECKED(entity_type_manager->AddAtomicEntityType(field_name));
-
-    std::vector<int> field_indices = {i};
-    type_properties.type_field_indices_to_id.emplace(
-        field_indices, new_entity_type_id);
+bool
+katana::SetOfEntityTypeIDs::IsSubsetOf(
+    const katana::SetOfEntityTypeIDs& other) const noexcept {
+  if (words_.size() > other.words_.size()) {
+    return false;
   }
-
-  // NB: cannot use unordered_set without defining a hash function for vectors;
-  // performance is not affected here because the set is very small (<=256)
-  using FieldEntityTypeSet = std::set<TypeProperties::FieldEntity>;
-  FieldEntityTypeSet type_combinations;
-  for (int64_t row = 0, num_rows = properties->num_rows(); row < num_rows;
-       ++row) {
-    TypeProperties::FieldEntity field_indices;
-    for (auto uint8_property : type_properties.uint8_properties) {
-      if (uint8_property.array->IsValid(row) &&
-          uint8_property.array->Value(row)) {
-        field_indices.emplace_back(uint8_property.field_index);
-      }
-    }
-    if (field_indices.size() > 1) {
-      type_combinations.emplace(field_indices);
+  for (size_t i = 0; i < words_.size(); ++i) {
+    if ((words_[i] & ~other.words_[i]) != 0) {
+      return false;
     }
   }
+  return true;
+}
 
-  // assign a new ID to each unique combination of types
-  for (const TypeProperties::FieldEntity& field_indices : type_combinations) {
-    std::vector<std::string> field_names;
-    for (int i : field_indices) {
-      const std::shared_ptr<arrow::Field>& current_field = schema->field(i);
-      const std::string& field_name = current_field->name();
-      field_names.emplace_back(field_name);
-    }
-    katana::EntityTypeID new_entity_type_id = KATANA_CHECKED(
-        entity_type_manager->AddNonAtomicEntityType(KATANA_CHECKED(
-            entity_type_manager->template GetOrAddEntityTypeIDs(field_names))));
-    type_properties.type_field_indices_to_id.emplace(
-        field_indices, new_entity_type_id);
+katana::SetOfEntityTypeIDs&
+katana::SetOfEntityTypeIDs::operator&=(
+    const katana::SetOfEntityTypeIDs& other) noexcept {
+  if (words_.size() > other.words_.size()) {
+    words_.resize(other.words_.size());
+  }
+  for (size_t i = 0; i < words_.size(); ++i) {
+    words_[i] &= other.words_[i];
   }
+  Trim();
+  return *this;
+}
 
-  // assert that all type IDs (including kUnknownEntityType) and
-  // 1 special type ID (kInvalidEntityType)
-  // can be stored in 8 bits
-  if (entity_type_manager->GetNumEntityTypes() >
-      (std::numeric_limits<katana::EntityTypeID>::max() - size_t{1})) {
-    return KATANA_ERROR(
-        katana::ErrorCode::NotImplemented,
-        "number of unique combination of types is {} "
-        "but only up to {} is supported currently",
-        // exclude kUnknownEntityType
-        entity_type_manager->GetNumEntityTypes() - 1,
-        // exclude kUnknownEntityType and kInvalidEntityType
-        std::numeric_limits<katana::EntityTypeID>::max() - 2);
+katana::SetOfEntityTypeIDs&
+katana::SetOfEntityTypeIDs::operator|=(
+    const katana::SetOfEntityTypeIDs& other) {
+  if (words_.size() < other.words_.size()) {
+    words_.resize(other.words_.size(), 0);
   }
+  for (size_t i = 0; i < other.words_.size(); ++i) {
+    words_[i] |= other.words_[i];
+  }
+  return *this;
+}
+
+size_t
+katana::SetOfEntityTypeIDs::Hash() const noexcept {
+  return boost::hash_range(words_.begin(), words_.end());
+}
 
-  return type_properties;
+std::string
+katana::SetOfEntityTypeIDs::ToString() const {
+  fmt::memory_buffer buf;
+  fmt::format_to(std::back_inserter(buf), "{{");
+  bool first = true;
+  ForEach([&](EntityTypeID id) {
+    fmt::format_to(std::back_inserter(buf), first ? "{}" : ", {}", id);
+    first = false;
+  });
+  fmt::format_to(std::back_inserter(buf), "}}");
+  return std::string(buf.begin(), buf.end());
 }
 
 katana::Result<katana::EntityTypeID>
@@ -114,13 +81,20 @@ katana::EntityTypeManager::AddNonAtomicEntityType(
 
   entity_type_id_to_atomic_entity_type_ids_.emplace_back(type_id_set);
   atomic_entity_type_id_to_entity_type_ids_.emplace_back(SetOfEntityTypeIDs());
-  for (size_t atomic_entity_type_id = 0;
-       atomic_entity_type_id < type_id_set.size(); ++atomic_entity_type_id) {
-    if (type_id_set[atomic_entity_type_id]) {
-      atomic_entity_type_id_to_entity_type_ids_.at(atomic_entity_type_id)
-          .set(new_entity_type_id);
+  type_id_set.ForEach([&](EntityTypeID atomic_entity_type_id) {
+    atomic_entity_type_id_to_entity_type_ids_.at(atomic_entity_type_id)
+        .set(new_entity_type_id);
+  });
+
+  // the new type is a super-type of every type whose atomic types it has
+  for (size_t i = 0; i < entity_type_id_to_supertype_closure_.size(); ++i) {
+    if (entity_type_id_to_atomic_entity_type_ids_[i].IsSubsetOf(type_id_set)) {
+      entity_type_id_to_supertype_closure_[i].set(new_entity_type_id);
     }
   }
+  entity_type_id_to_supertype_closure_.emplace_back(
+      SupertypeClosureOf(type_id_set));
+  entity_type_id_to_supertype_closure_.back().set(new_entity_type_id);
 
   // Ideally this would return an error instead of failing. But checking is
   // probably too slow. Remember kids, fast is more important than correct.
@@ -198,10 +172,42 @@ katana::EntityTypeManager::AddAtomicEntityType(const std::string& name) {
   entity_type_ids.set(new_entity_type_id);
   entity_type_id_to_atomic_entity_type_ids_.emplace_back(entity_type_ids);
   atomic_entity_type_id_to_entity_type_ids_.emplace_back(entity_type_ids);
+  entity_type_id_to_supertype_closure_.emplace_back(entity_type_ids);
 
   return Result<EntityTypeID>(new_entity_type_id);
 }
 
+katana::SetOfEntityTypeIDs
+katana::EntityTypeManager::SupertypeClosureOf(
+    const katana::SetOfEntityTypeIDs& atomic_entity_type_ids) const {
+  // a type has all of the atomic types iff it is a super-type of each of them
+  SetOfEntityTypeIDs closure;
+  bool first = true;
+  atomic_entity_type_ids.ForEach([&](EntityTypeID atomic_entity_type_id) {
+    const SetOfEntityTypeIDs& supertypes =
+        atomic_entity_type_id_to_entity_type_ids_.at(atomic_entity_type_id);
+    if (first) {
+      closure = supertypes;
+      first = false;
+    } else {
+      closure &= supertypes;
+    }
+  });
+  return closure;
+}
+
+void
+katana::EntityTypeManager::ComputeSupertypeClosures() {
+  size_t num_entity_types = entity_type_id_to_atomic_entity_type_ids_.size();
+  entity_type_id_to_supertype_closure_.clear();
+  entity_type_id_to_supertype_closure_.reserve(num_entity_types);
+  for (size_t i = 0; i < num_entity_types; ++i) {
+    entity_type_id_to_supertype_closure_.emplace_back(
+        SupertypeClosureOf(entity_type_id_to_atomic_entity_type_ids_[i]));
+    entity_type_id_to_supertype_closure_.back().set(i);
+  }
+}
+
 std::string
 katana::EntityTypeManager::ReportDiff(
     const katana::EntityTypeManager& other) const {
@@ -304,13 +310,10 @@ katana::EntityTypeManager::EntityTypeToTypeNameSet(
         ErrorCode::InvalidArgument,
         "no string representation for invalid type");
   }
-  auto type_set = GetAtomicSubtypes(type_id);
-  for (size_t idx = 0; idx < type_set.size(); ++idx) {
-    if (type_set[idx]) {
-      auto name = GetAtomicTypeName(idx);
-      KATANA_LOG_ASSERT(name.has_value());
-      type_name_set.insert(name.value());
-    }
-  }
+  GetAtomicSubtypes(type_id).ForEach([&](EntityTypeID idx) {
+    auto name = GetAtomicTypeName(idx);
+    KATANA_LOG_ASSERT(name.has_value());
+    type_name_set.insert(name.value());
+  });
   return type_name_set;
 }
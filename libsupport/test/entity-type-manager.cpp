@@ -0,0 +1,114 @@
+#include "katana/EntityTypeManager.h"
+
+#include <string>
+#include <vector>
+
+#include "katana/Logging.h"
+
+namespace {
+
+void
+TestSetOfEntityTypeIDs() {
+  katana::SetOfEntityTypeIDs a;
+  KATANA_LOG_ASSERT(a.none());
+  KATANA_LOG_ASSERT(a.size() == 0);
+
+  a.set(1).set(300);
+  KATANA_LOG_ASSERT(a.test(1) && a[300] && !a[2] && !a[70000]);
+  KATANA_LOG_ASSERT(a.count() == 2);
+  KATANA_LOG_ASSERT(a.size() > 300);
+  KATANA_LOG_ASSERT(a.ToString() == "{1, 300}");
+
+  katana::SetOfEntityTypeIDs b;
+  b.set(1);
+  KATANA_LOG_ASSERT((a & b) == b);
+  KATANA_LOG_ASSERT((a | b) == a);
+
+  // sets are equal regardless of how large they once were
+  a.reset(300);
+  KATANA_LOG_ASSERT(a == b);
+  KATANA_LOG_ASSERT(std::hash<katana::SetOfEntityTypeIDs>{}(a) == b.Hash());
+
+  std::vector<katana::EntityTypeID> members;
+  a.set(64).set(65535);
+  a.ForEach([&](katana::EntityTypeID id) { members.emplace_back(id); });
+  KATANA_LOG_ASSERT(
+      (members == std::vector<katana::EntityTypeID>{1, 64, 65535}));
+
+  a.reset();
+  KATANA_LOG_ASSERT(a.none() && a != b);
+}
+
+void
+TestManyTypes() {
+  constexpr size_t kNumAtomicTypes = 1000;
+
+  katana::EntityTypeManager manager;
+  std::vector<katana::EntityTypeID> atomic_ids;
+  for (size_t i = 0; i < kNumAtomicTypes; ++i) {
+    auto res = manager.AddAtomicEntityType("type-" + std::to_string(i));
+    KATANA_LOG_VASSERT(res, "adding atomic type {}: {}", i, res.error());
+    atomic_ids.emplace_back(res.value());
+  }
+  KATANA_LOG_ASSERT(atomic_ids.back() == kNumAtomicTypes);
+
+  std::vector<std::string> names{"type-3", "type-999"};
+  auto res = manager.GetOrAddNonAtomicEntityTypeFromStrings(names);
+  KATANA_LOG_VASSERT(res, "adding intersection type: {}", res.error());
+  katana::EntityTypeID id = res.value();
+  KATANA_LOG_ASSERT(id > kNumAtomicTypes);
+
+  KATANA_LOG_ASSERT(manager.IsSubtypeOf(atomic_ids[999], id));
+  KATANA_LOG_ASSERT(!manager.IsSubtypeOf(atomic_ids[4], id));
+  KATANA_LOG_ASSERT(manager.GetSupertypes(atomic_ids[999]).test(id));
+  KATANA_LOG_ASSERT(manager.GetAtomicSubtypes(id).count() == 2);
+
+  auto names_res = manager.EntityTypeToTypeNameSet(id);
+  KATANA_LOG_ASSERT(names_res);
+  KATANA_LOG_ASSERT(
+      (names_res.value() == katana::TypeNameSet{"type-3", "type-999"}));
+}
+
+void
+TestSupertypeClosure() {
+  katana::EntityTypeManager manager;
+  auto ab_res = manager.GetOrAddNonAtomicEntityTypeFromStrings(
+      std::vector<std::string>{"a", "b"});
+  KATANA_LOG_ASSERT(ab_res);
+  auto abc_res = manager.GetOrAddNonAtomicEntityTypeFromStrings(
+      std::vector<std::string>{"a", "b", "c"});
+  KATANA_LOG_ASSERT(abc_res);
+  katana::EntityTypeID a = manager.GetEntityTypeID("a");
+  katana::EntityTypeID c = manager.GetEntityTypeID("c");
+  katana::EntityTypeID ab = ab_res.value();
+  katana::EntityTypeID abc = abc_res.value();
+
+  katana::SetOfEntityTypeIDs expected;
+  expected.set(ab).set(abc);
+  KATANA_LOG_ASSERT(manager.GetSupertypeClosure(ab) == expected);
+  KATANA_LOG_ASSERT(manager.GetSupertypeClosure(a) == manager.GetSupertypes(a));
+  KATANA_LOG_ASSERT(manager.IsSubtypeOf(a, abc));
+  KATANA_LOG_ASSERT(manager.IsSubtypeOf(ab, abc));
+  KATANA_LOG_ASSERT(!manager.IsSubtypeOf(abc, ab));
+  KATANA_LOG_ASSERT(!manager.IsSubtypeOf(c, ab));
+
+  // closures are recomputed when a manager is rebuilt from its maps
+  katana::EntityTypeManager copy(
+      katana::EntityTypeIDToAtomicTypeNameMap(
+          manager.GetEntityTypeIDToAtomicTypeNameMap()),
+      katana::EntityTypeIDToSetOfEntityTypeIDsMap(
+          manager.GetEntityTypeIDToAtomicEntityTypeIDs()));
+  for (size_t i = 0; i < manager.GetNumEntityTypes(); ++i) {
+    KATANA_LOG_ASSERT(
+        copy.GetSupertypeClosure(i) == manager.GetSupertypeClosure(i));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  TestSetOfEntityTypeIDs();
+  TestManyTypes();
+  TestSupertypeClosure();
+}
@@ -48,5 +48,32 @@ main() {
         first_val, val);
   }
 
+  // test the fast generator: seeded generators are deterministic, distinct
+  // seeds diverge and doubles are uniform in [0, 1)
+  katana::Xoshiro256StarStar fast_a(8675309);
+  katana::Xoshiro256StarStar fast_b(8675309);
+  katana::Xoshiro256StarStar fast_c(8675310);
+  bool diverged = false;
+  for (int i = 0; i < 1000; ++i) {
+    uint64_t a = fast_a();
+    KATANA_LOG_ASSERT(a == fast_b());
+    diverged |= a != fast_c();
+  }
+  KATANA_LOG_ASSERT(diverged);
+
+  constexpr int kNumDraws = 100000;
+  double sum = 0;
+  for (int i = 0; i < kNumDraws; ++i) {
+    double d = fast_a.NextDouble();
+    KATANA_LOG_ASSERT(d >= 0.0 && d < 1.0);
+    sum += d;
+  }
+  double mean = sum / kNumDraws;
+  KATANA_LOG_VASSERT(
+      mean > 0.49 && mean < 0.51, "mean of uniform doubles is {}", mean);
+
+  std::uniform_int_distribution<int> dist(0, 9);
+  KATANA_LOG_ASSERT(dist(fast_a) <= 9);
+
   return 0;
 }
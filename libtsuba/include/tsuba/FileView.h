@@ -3,8 +3,10 @@
 
 #include <cstdint>
 #include <future>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <parquet/arrow/reader.h>
 
@@ -15,10 +17,46 @@
 namespace tsuba {
 
 class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
+public:
+  /// Counters of how well prefetching served the reads of a FileView
+  struct PrefetchStats {
+    /// reads whose pages were already fetched or being fetched
+    uint64_t hits{0};
+    /// reads that had to fetch pages from storage
+    uint64_t misses{0};
+    /// pages fetched ahead of reads, by the prefetcher or for WillNeed
+    uint64_t prefetched_pages{0};
+    /// prefetched pages that were not read before they were unbound
+    uint64_t wasted_pages{0};
+    /// pages fetched from storage; a page is fetched again only after it
+    /// was released
+    uint64_t fetched_pages{0};
+  };
+
+private:
   struct FillingRange {
     uint64_t first_page;
     uint64_t last_page;
-    std::future<katana::CopyableResult<void>> work;
+    // shared so that concurrent reads of the range can all wait for it
+    std::shared_future<katana::CopyableResult<void>> work;
+  };
+  using PendingFetches =
+      std::vector<std::shared_future<katana::CopyableResult<void>>>;
+  // inclusive ranges of pages
+  using PageRuns = std::vector<std::pair<uint64_t, uint64_t>>;
+
+  /// The stream of reads the prefetcher has detected. Reads that start where
+  /// the last one ended are sequential; reads that start a fixed distance
+  /// after the last one, like the column chunk of the same column in
+  /// consecutive parquet row groups, are strided.
+  struct AccessPattern {
+    int64_t last_start{-1};
+    int64_t last_size{0};
+    int64_t stride{0};
+    /// bytes to read ahead of a sequential stream
+    int64_t readahead{0};
+    /// strides to read ahead of a strided stream
+    int64_t strides{0};
   };
 
   uint8_t* map_start_{nullptr};
@@ -29,7 +67,16 @@ class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
   std::string filename_;
   bool valid_{false};
   std::vector<uint64_t> filling_;
+  // pages that were prefetched and have not been read yet
+  std::vector<uint64_t> prefetched_;
   std::unique_ptr<std::vector<FillingRange>> fetches_;
+  AccessPattern pattern_;
+  PrefetchStats stats_;
+  // Guards the bookkeeping above (filling_, prefetched_, fetches_,
+  // mem_start_, pattern_ and stats_) so that positional reads can run
+  // concurrently; reads do not hold it while they wait for storage. Bind,
+  // Unbind and the cursor (Seek and Read) are not thread safe.
+  std::mutex mutex_;
 
 public:
   FileView() = default;
@@ -45,7 +92,10 @@ public:
         filename_(std::move(other.filename_)),
         valid_(other.valid_),
         filling_(std::move(other.filling_)),
-        fetches_(std::move(other.fetches_)) {
+        prefetched_(std::move(other.prefetched_)),
+        fetches_(std::move(other.fetches_)),
+        pattern_(other.pattern_),
+        stats_(other.stats_) {
     other.valid_ = false;
   }
 
@@ -62,8 +112,11 @@ public:
       filename_ = std::move(other.filename_);
       valid_ = other.valid_;
       filling_ = std::move(other.filling_);
+      prefetched_ = std::move(other.prefetched_);
       fetches_ =
           std::unique_ptr<std::vector<FillingRange>>(std::move(other.fetches_));
+      pattern_ = other.pattern_;
+      stats_ = other.stats_;
       other.valid_ = false;
     }
     return *this;
@@ -91,8 +144,17 @@ public:
     return Bind(filename, 0, std::numeric_limits<uint64_t>::max(), resolve);
   }
 
+  /// Fetch the missing pages of the byte range [begin, end). With resolve,
+  /// also wait for pages of the range that earlier fills or prefetches are
+  /// still fetching.
   katana::Result<void> Fill(uint64_t begin, uint64_t end, bool resolve);
 
+  /// Drop the pages that lie entirely in the byte range [begin, end) from
+  /// memory; later reads and fills fetch them again. Pointers into released
+  /// pages must not be dereferenced, and valid_ptr returns nullptr if the
+  /// first bytes present in memory were released.
+  katana::Result<void> Release(uint64_t begin, uint64_t end);
+
   bool Valid() const { return valid_; }
 
   katana::Result<void> Unbind();
@@ -127,6 +189,17 @@ public:
 
   uint64_t size() const { return file_size_; }
 
+  /// The unit in which the file is fetched and released
+  uint64_t page_size() const { return UINT64_C(1) << page_shift_; }
+
+  /// Number of pages fetched or being fetched
+  uint64_t resident_pages();
+
+  /// Prefetching counters since this FileView was constructed. Pages that
+  /// were prefetched and are still bound but unread are not counted as
+  /// wasted until Unbind.
+  const PrefetchStats& prefetch_stats() const { return stats_; }
+
   // support iterating through characters
   const char* begin() const { return ptr<char>(); }
   const char* end() const { return ptr<char>() + size(); }
@@ -139,7 +212,17 @@ public:
   arrow::Status Seek(int64_t) override;
   arrow::Result<int64_t> Read(int64_t, void*) override;
   arrow::Result<std::shared_ptr<arrow::Buffer>> Read(int64_t) override;
+  arrow::Result<int64_t> ReadAt(int64_t, int64_t, void*) override;
+  arrow::Result<std::shared_ptr<arrow::Buffer>> ReadAt(
+      int64_t, int64_t) override;
+  /// Start fetching the range right away and complete the read on the I/O
+  /// executor of the context
+  arrow::Future<std::shared_ptr<arrow::Buffer>> ReadAsync(
+      const arrow::io::IOContext&, int64_t, int64_t) override;
   arrow::Result<int64_t> GetSize() override;
+  /// Start fetching ranges that are about to be read, e.g., the column chunks
+  /// parquet is going to read
+  arrow::Status WillNeed(const std::vector<arrow::io::ReadRange>&) override;
 
   ///// End arrow::io::RandomAccessFile methods ///////
 
@@ -147,28 +230,41 @@ private:
   // Given the size of some region, how many pages does it take up?
   uint64_t page_number(uint64_t size);
 
-  // helper functions for MustFill
-  /// These functions do not validate their input. In particular, if
-  /// bitmap[block_num] contains no zeroes, they may never terminate
-  inline uint64_t LastPage(
-      uint64_t* bitmap, uint64_t block_num, uint64_t start, uint64_t end);
-  inline uint64_t FirstPage(
-      uint64_t* bitmap, uint64_t block_num, uint64_t start, uint64_t end);
-
-  // Given a starting and ending page, return an inclusive region that describes
-  // which pages must be fetched from storage. Or an empty std::optional if no
-  // pages need to be fetched.
+  // Given a starting and ending page, return the first inclusive run of
+  // pages in it that are not set in bitmap, i.e., that must be fetched from
+  // storage. Or an empty std::optional if no pages need to be fetched.
   std::optional<std::pair<uint64_t, uint64_t>> MustFill(
-      uint64_t* bitmap, uint64_t begin, uint64_t end);
+      const uint64_t* bitmap, uint64_t begin, uint64_t end);
 
   katana::Result<void> MarkFilled(
       uint64_t* bitmap, uint64_t begin, uint64_t end);
 
+  // Fetch the missing pages of the byte range [begin, end), one fetch per
+  // run of missing pages, returning the runs that were fetched. Pages that
+  // are resident or being fetched by another read are left alone.
+  katana::Result<PageRuns> FillPages(uint64_t begin, uint64_t end);
+
+  // Fetch the byte range [begin, end) ahead of reads
+  katana::Result<void> FillAhead(uint64_t begin, uint64_t end);
+
+  // Start fetching what a read of nbytes at position, clamped to the end of
+  // the file, needs and add the fetches the read must wait for to pending;
+  // returns the number of bytes the read gets
+  katana::Result<int64_t> StartRead(
+      int64_t position, int64_t nbytes, PendingFetches* pending);
+
+  // Wait for fetches returned by StartRead
+  static katana::Result<void> Wait(const PendingFetches& pending);
+
+  // StartRead and Wait
+  katana::Result<int64_t> PrepareRead(int64_t position, int64_t nbytes);
+
   // Resolve all outstanding reads that overlap with the range [cursor_, nbytes]
   katana::Result<void> Resolve(int64_t start, int64_t size);
 
   // Start asynchronously fetching data that we think we might need from storage
-  // @start and @size give the location and range of the previous read
+  // @start and @size give the location and range of the previous read, which
+  // update the access pattern that decides what to fetch
   katana::Result<void> PreFetch(int64_t start, int64_t size);
 };
 }  // namespace tsuba
@@ -2,9 +2,14 @@
 #define KATANA_LIBTSUBA_TSUBA_PARQUETWRITER_H_
 
 #include <limits>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <arrow/api.h>
+#include <arrow/util/compression.h>
 #include <parquet/properties.h>
 
 #include "katana/Result.h"
@@ -31,6 +36,42 @@ public:
 
     /// control the approximate size of blocked files when writing blocked
     uint64_t mbs_per_block{256};
+
+    /// codec for the data pages, e.g., ZSTD, LZ4 or SNAPPY; readers detect
+    /// the codec, so files written with different codecs can be mixed
+    arrow::Compression::type compression{arrow::Compression::UNCOMPRESSED};
+    /// codec specific level; the default is the codec's default level
+    int compression_level{arrow::util::kUseDefaultCompressionLevel};
+
+    /// dictionary encode columns; parquet falls back to the column encoding
+    /// when a dictionary gets too large
+    bool use_dictionary{true};
+
+    /// maximum number of rows in a parquet row group. Smaller row groups
+    /// make column statistics more selective at the cost of more metadata.
+    int64_t max_row_group_length{std::numeric_limits<int64_t>::max()};
+
+    /// write min/max and null count statistics for each column chunk
+    bool write_statistics{true};
+
+    /// Settings for a single column that override the ones above
+    struct ColumnOpts {
+      std::optional<arrow::Compression::type> compression;
+      std::optional<int> compression_level;
+      std::optional<bool> use_dictionary;
+      /// encoding used when the column is not dictionary encoded, e.g.,
+      /// BYTE_STREAM_SPLIT, which makes float and double columns compress
+      /// better (only allowed for those types)
+      std::optional<parquet::Encoding::type> encoding;
+      std::optional<bool> write_statistics;
+    };
+
+    /// per column settings by column name; the settings of a nested column
+    /// apply to all of its leaf columns, and a dotted parquet path, e.g.,
+    /// "a.list.item", names a single leaf. RDG stores each property in its
+    /// own file and takes per property settings from RDGWriteOptions
+    std::unordered_map<std::string, ColumnOpts> column_opts;
+
     static WriteOpts Defaults() { return WriteOpts{}; }
   };
 
@@ -57,10 +98,17 @@ public:
   katana::Result<void> WriteToUri(
       const katana::Uri& uri, WriteGroup* group = nullptr);
 
+  /// column settings by the path of the parquet leaf column they apply to
+  using ColumnOptsByPath =
+      std::vector<std::pair<std::string, WriteOpts::ColumnOpts>>;
+
 private:
   ParquetWriter(
-      std::vector<std::shared_ptr<arrow::Table>> tables, WriteOpts opts)
-      : tables_(std::move(tables)), opts_(opts) {}
+      std::vector<std::shared_ptr<arrow::Table>> tables, WriteOpts opts,
+      ColumnOptsByPath column_opts)
+      : tables_(std::move(tables)),
+        opts_(opts),
+        column_opts_(std::move(column_opts)) {}
 
   std::shared_ptr<parquet::WriterProperties> StandardWriterProperties();
 
@@ -75,6 +123,7 @@ private:
 
   std::vector<std::shared_ptr<arrow::Table>> tables_;
   WriteOpts opts_;
+  ColumnOptsByPath column_opts_;
 };
 
 }  // namespace tsuba
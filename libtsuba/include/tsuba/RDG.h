@@ -18,6 +18,7 @@
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
 #include "tsuba/FileView.h"
+#include "tsuba/ParquetWriter.h"
 #include "tsuba/PartitionMetadata.h"
 #include "tsuba/PropertyCache.h"
 #include "tsuba/RDGLineage.h"
@@ -48,6 +49,23 @@ struct KATANA_EXPORT RDGLoadOptions {
   tsuba::PropertyCache* prop_cache{nullptr};
 };
 
+struct KATANA_EXPORT RDGWriteOptions {
+  using ColumnOpts = ParquetWriter::WriteOpts::ColumnOpts;
+
+  /// Options, like compression and encodings, for the parquet files that
+  /// properties are stored in. Its column_opts are ignored; per property
+  /// settings go in node_property_opts and edge_property_opts.
+  ParquetWriter::WriteOpts file_opts;
+  /// Settings for single node properties, by property name
+  std::unordered_map<std::string, ColumnOpts> node_property_opts;
+  /// Settings for single edge properties, by property name
+  std::unordered_map<std::string, ColumnOpts> edge_property_opts;
+
+  /// The options for the file of the node or edge property named name
+  ParquetWriter::WriteOpts PropertyOpts(
+      NodeEdge node_edge, const std::string& name) const;
+};
+
 class KATANA_EXPORT RDG {
 public:
   enum RDGVersioningPolicy { RetainVersion = 0, IncrementVersion };
@@ -306,8 +324,14 @@ public:
 
   void set_view_name(const std::string& v) { view_type_ = v; }
 
+  /// Options, like compression and encodings, for the parquet files that
+  /// Store and Unload*Property write properties to
+  const RDGWriteOptions& write_opts() const { return write_opts_; }
+  void set_write_opts(RDGWriteOptions opts) { write_opts_ = std::move(opts); }
+
 private:
   std::string view_type_;
+  RDGWriteOptions write_opts_;
   RDG(std::unique_ptr<RDGCore>&& core);
 
   void InitEmptyTables();
@@ -37,6 +37,18 @@ public:
     return std::vector<uint64_t>(out_indexes + first, out_indexes + second);
   }
 
+  /// The whole topology file, of which Make only loads the prefix. The edge
+  /// destinations start at view_offset() and can be loaded and released a
+  /// range at a time with Fill and Release.
+  FileView& file_storage() { return prefix_storage_; }
+  const FileView& file_storage() const { return prefix_storage_; }
+
+  /// The destinations of the edges, which may only be read where they have
+  /// been loaded through file_storage()
+  const uint32_t* out_dests() const {
+    return prefix_storage_.ptr<uint32_t>(view_offset_);
+  }
+
 private:
   RDGPrefix(FileView&& prefix_storage, uint64_t view_offset)
       : prefix_storage_(std::move(prefix_storage)),
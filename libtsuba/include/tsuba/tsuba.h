@@ -110,14 +110,24 @@ KATANA_EXPORT katana::Result<std::vector<std::pair<katana::Uri, katana::Uri>>>
 CreateSrcDestFromViewsForCopy(
     const std::string& src_dir, const std::string& dst_dir, uint64_t version);
 
+/// Default bound on the number of files CopyRDG copies at once
+constexpr uint32_t kDefaultMaxParallelCopies = 16;
+
 /// CopyRDG copies RDG files from a source to a destination.
 /// E.g. SRC_DIR/part_vers0003_rdg_node00000 -> DST_DIR/part_vers0001_rdg_node_00000
 /// The argument is a list of source and destination pairs as an RDG consists of many files.
 /// See CreateSrcDestFromViewsForCopy for how to generate this list from an RDG prefix and version
+/// Files are copied in parallel by up to max_parallel_copies workers, and
+/// files on the same storage back-end are streamed by RemoteCopy rather than
+/// read into memory. No new copies start after the first failure. The
+/// manifest files are written after all other files, so a copy is complete
+/// once its manifest exists.
 /// \param src_dst_files is a vector of src-dest pairs for individual RDG files
+/// \param max_parallel_copies bounds the number of files copied at once
 /// \returns a Result to indicate whether the method succeeded or failed
 KATANA_EXPORT katana::Result<void> CopyRDG(
-    std::vector<std::pair<katana::Uri, katana::Uri>> src_dst_files);
+    std::vector<std::pair<katana::Uri, katana::Uri>> src_dst_files,
+    uint32_t max_parallel_copies = kDefaultMaxParallelCopies);
 
 // Setup and tear down
 KATANA_EXPORT katana::Result<void> Init(katana::CommBackend* comm);
@@ -3,10 +3,16 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdio>
+#include <cstring>
 #include <string>
 
+#include <arrow/util/future.h>
+#include <arrow/util/thread_pool.h>
+
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
@@ -30,6 +36,52 @@
  * somehow and also tell users to not modify our files?
  */
 
+namespace {
+
+// Readahead limit in bytes for sequential and strided streams
+constexpr int64_t kMaxReadahead = INT64_C(64) << 20;
+// Limit of strides read ahead of a strided stream, so that tiny strided
+// reads do not start a fetch per stride over a large part of the file
+constexpr int64_t kMaxStrides = 16;
+
+// The bits of a block of the page bitmap that belong to the pages in [begin,
+// end]. Page i of a block is bit 63 - i, so that the first page of a range is
+// the leading zero count of a block and the last one is 63 minus the trailing
+// zero count.
+uint64_t
+BlockMask(uint64_t block, uint64_t begin, uint64_t end) {
+  uint64_t low = block == begin / 64 ? begin % 64 : 0;
+  uint64_t high = block == end / 64 ? end % 64 : 63;
+  return (~UINT64_C(0) >> low) & (~UINT64_C(0) << (63 - high));
+}
+
+void
+ClearPages(uint64_t* bitmap, uint64_t begin, uint64_t end) {
+  for (uint64_t i = begin / 64; i <= end / 64; ++i) {
+    bitmap[i] &= ~BlockMask(i, begin, end);
+  }
+}
+
+uint64_t
+CountPages(const std::vector<uint64_t>& bitmap) {
+  uint64_t count = 0;
+  for (uint64_t block : bitmap) {
+    count += __builtin_popcountll(block);
+  }
+  return count;
+}
+
+uint64_t
+CountPages(const uint64_t* bitmap, uint64_t begin, uint64_t end) {
+  uint64_t count = 0;
+  for (uint64_t i = begin / 64; i <= end / 64; ++i) {
+    count += __builtin_popcountll(bitmap[i] & BlockMask(i, begin, end));
+  }
+  return count;
+}
+
+}  // namespace
+
 namespace tsuba {
 
 FileView::~FileView() {
@@ -51,6 +103,8 @@ FileView::Unbind() {
         return KATANA_ERROR(katana::ResultErrno(), "unmapping buffer");
       }
     }
+    stats_.wasted_pages += CountPages(prefetched_);
+    pattern_ = AccessPattern{};
     valid_ = false;
   }
   return katana::ResultSuccess();
@@ -94,7 +148,8 @@ FileView::Bind(
 
   map_start_ = static_cast<uint8_t*>(tmp);
   mem_start_ = -1;
-  filling_.resize(page_number(buf.size) / 64 + 1, 0);
+  filling_.assign(page_number(buf.size) / 64 + 1, 0);
+  prefetched_.assign(filling_.size(), 0);
   file_size_ = buf.size;
   fetches_ = std::make_unique<std::vector<FillingRange>>();
   if (auto res = Fill(begin, in_end, resolve); !res) {
@@ -108,11 +163,67 @@ FileView::Bind(
 
 katana::Result<void>
 FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  KATANA_CHECKED(FillPages(begin, end));
+  uint64_t in_end = std::min<uint64_t>(end, file_size_);
+  if (resolve && begin < in_end) {
+    // also wait for pages of the range that earlier fills or prefetches are
+    // still fetching
+    KATANA_CHECKED_CONTEXT(Resolve(begin, in_end - begin), "resolving fill");
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+FileView::Release(uint64_t begin, uint64_t end) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!valid_) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
+  }
+  uint64_t in_end = std::min<uint64_t>(end, file_size_);
+  // the last page of the file is whole if the range reaches the end
+  uint64_t first_page = page_number(begin + page_size() - 1);
+  uint64_t end_page = in_end == static_cast<uint64_t>(file_size_)
+                          ? page_number(in_end + page_size() - 1)
+                          : page_number(in_end);
+  if (first_page >= end_page) {
+    return katana::ResultSuccess();
+  }
+  uint64_t last_page = end_page - 1;
+  uint64_t file_off = first_page << page_shift_;
+  uint64_t map_size =
+      std::min<uint64_t>(end_page << page_shift_, file_size_) - file_off;
+
+  // fetches must not write to the pages once they are gone
+  KATANA_CHECKED_CONTEXT(
+      Resolve(file_off, map_size), "resolving fetches to release");
+  if (madvise(map_start_ + file_off, map_size, MADV_DONTNEED) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "releasing buffer");
+  }
+  if (mprotect(map_start_ + file_off, map_size, PROT_NONE) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "mprotecting buffer");
+  }
+
+  stats_.wasted_pages += CountPages(&prefetched_[0], first_page, last_page);
+  ClearPages(&filling_[0], first_page, last_page);
+  ClearPages(&prefetched_[0], first_page, last_page);
+  if (mem_start_ >= static_cast<int64_t>(file_off) &&
+      mem_start_ < static_cast<int64_t>(file_off + map_size)) {
+    mem_start_ = -1;
+  }
+  return katana::ResultSuccess();
+}
+
+uint64_t
+FileView::resident_pages() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return CountPages(filling_);
+}
+
+katana::Result<FileView::PageRuns>
+FileView::FillPages(uint64_t begin, uint64_t end) {
   uint64_t in_end = std::min<uint64_t>(end, file_size_);
   uint64_t in_begin = std::min<uint64_t>(begin, in_end);
-  uint64_t first_page = 0;
-  uint64_t last_page = 0;
-  bool found_empty = false;
 
   // We would check !valid_ but we want to call this in Bind before we have
   // set valid_. fetches_ should be default constructed to
@@ -120,49 +231,122 @@ FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   if (!fetches_) {
     return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
   }
+  PageRuns runs;
   // Gracefully handle the fill zero case here to simplify Bind
-  if (in_end != in_begin) {
-    if (auto opt =
-            MustFill(&filling_[0], page_number(in_begin), page_number(in_end));
-        opt.has_value()) {
-      std::tie(first_page, last_page) = opt.value();
-      found_empty = true;
+  if (in_end == in_begin) {
+    return runs;
+  }
+  uint64_t last_page = page_number(in_end - 1);
+  for (uint64_t page = page_number(in_begin); page <= last_page;) {
+    auto run = MustFill(&filling_[0], page, last_page);
+    if (!run.has_value()) {
+      break;
+    }
+    auto [run_first, run_last] = run.value();
+
+    uint64_t file_off = run_first << page_shift_;
+    uint64_t map_size = std::min<uint64_t>(
+        ((run_last + 1) << page_shift_) - file_off, file_size_ - file_off);
+    // Get physical pages for the region we are about to write
+    int err = mprotect(map_start_ + file_off, map_size, PROT_READ | PROT_WRITE);
+    if (err == -1) {
+      return KATANA_ERROR(katana::ResultErrno(), "mprotecting buffer");
     }
 
-    uint64_t file_off = first_page * (1UL << page_shift_);
-    uint64_t map_size = std::min(
-        (last_page + 1) * (1UL << page_shift_) - file_off,
-        file_size_ - file_off);
-    if (found_empty) {
-      // Get physical pages for the region we are about to write
-      int err =
-          mprotect(map_start_ + file_off, map_size, PROT_READ | PROT_WRITE);
-      if (err == -1) {
-        return KATANA_ERROR(katana::ResultErrno(), "mprotecting buffer");
-      }
+    auto peek_fut =
+        FileGetAsync(filename_, map_start_ + file_off, file_off, map_size);
+    KATANA_LOG_ASSERT(peek_fut.valid());
+    FillingRange fetch = {run_first, run_last, std::move(peek_fut)};
+    fetches_->push_back(std::move(fetch));
+    if (auto res = MarkFilled(&filling_[0], run_first, run_last); !res) {
+      return res.error().WithContext("updating bookkeeping data");
+    }
+    stats_.fetched_pages += run_last - run_first + 1;
+    runs.emplace_back(run_first, run_last);
+    page = run_last + 1;
+  }
+  if (runs.empty()) {
+    return runs;
+  }
+  int64_t signed_begin = static_cast<int64_t>(in_begin);
+  if (mem_start_ < 0 || signed_begin < mem_start_) {
+    mem_start_ = signed_begin;
+  }
+  return runs;
+}
 
-      auto peek_fut =
-          FileGetAsync(filename_, map_start_ + file_off, file_off, map_size);
-      KATANA_LOG_ASSERT(peek_fut.valid());
-      FillingRange fetch = {first_page, last_page, std::move(peek_fut)};
-      fetches_->push_back(std::move(fetch));
-      if (auto res = MarkFilled(&filling_[0], first_page, last_page); !res) {
-        return res.error().WithContext("updating bookkeeping data");
-      }
-      if (resolve) {
-        if (auto res = Resolve(file_off, map_size); !res) {
-          return res.error().WithContext("resolving fill");
-        }
-      }
-      int64_t signed_begin = static_cast<int64_t>(in_begin);
-      if (mem_start_ < 0 || signed_begin < mem_start_) {
-        mem_start_ = signed_begin;
-      }
+katana::Result<void>
+FileView::FillAhead(uint64_t begin, uint64_t end) {
+  auto runs = KATANA_CHECKED(FillPages(begin, end));
+  for (const auto& [first_page, last_page] : runs) {
+    KATANA_CHECKED(MarkFilled(&prefetched_[0], first_page, last_page));
+    stats_.prefetched_pages += last_page - first_page + 1;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<int64_t>
+FileView::StartRead(int64_t position, int64_t nbytes, PendingFetches* pending) {
+  int64_t nbytes_internal = std::min(nbytes, file_size_ - position);
+  if (nbytes_internal <= 0) {
+    return 0;
+  }
+  uint64_t begin = position;
+  uint64_t end = position + nbytes_internal;
+  uint64_t first_page = page_number(begin);
+  uint64_t last_page = page_number(end - 1);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // fetch data from storage if necessary
+  auto fetched = KATANA_CHECKED_CONTEXT(
+      FillPages(begin, end), "fetching {} bytes at {}", nbytes_internal,
+      position);
+  if (!fetched.empty()) {
+    stats_.misses++;
+  } else {
+    stats_.hits++;
+  }
+
+  // Collect the outstanding fetches of the range and drop the ones that
+  // have completed; failed fetches stay so that every read of their range
+  // sees the error
+  for (auto it = fetches_->begin(); it != fetches_->end();) {
+    if (it->work.wait_for(std::chrono::seconds(0)) ==
+            std::future_status::ready &&
+        it->work.get()) {
+      it = fetches_->erase(it);
+      continue;
+    }
+    if (it->first_page <= last_page && it->last_page >= first_page) {
+      pending->emplace_back(it->work);
+    }
+    ++it;
+  }
+  ClearPages(&prefetched_[0], first_page, last_page);
+
+  KATANA_CHECKED_CONTEXT(PreFetch(position, nbytes_internal), "prefetching");
+  return nbytes_internal;
+}
+
+katana::Result<void>
+FileView::Wait(const PendingFetches& pending) {
+  for (const auto& work : pending) {
+    if (const auto& res = work.get(); !res) {
+      return katana::ErrorInfo(res.error())
+          .WithContext("resolving asynchronous reads");
     }
   }
   return katana::ResultSuccess();
 }
 
+katana::Result<int64_t>
+FileView::PrepareRead(int64_t position, int64_t nbytes) {
+  PendingFetches pending;
+  int64_t available = KATANA_CHECKED(StartRead(position, nbytes, &pending));
+  KATANA_CHECKED(Wait(pending));
+  return available;
+}
+
 bool
 FileView::Equals(const FileView& other) const {
   if (!valid_ || !other.valid_) {
@@ -228,29 +412,13 @@ FileView::Read(int64_t nbytes) {
   if (!valid_) {
     return arrow::Status(arrow::StatusCode::Invalid, "Unbound FileView");
   }
-  int64_t nbytes_internal = nbytes;
-  if (cursor_ + nbytes > file_size_) {
-    nbytes_internal = file_size_ - cursor_;
-  }
-  // fetch data from storage if necessary
-  if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
-    return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
-  }
-  // resolve outstanding relevant fetches
-  if (auto res = Resolve(cursor_, nbytes_internal); !res) {
-    // TODO (scober): Include res.error() as part of arrow Status
-    return arrow::Status(
-        arrow::StatusCode::IOError, "Resolving asynchronous reads");
-  }
-  // prefetch
-  if (auto res = PreFetch(cursor_, nbytes_internal); !res) {
-    // TODO (scober): Include res.error() as part of arrow Status
-    return arrow::Status(arrow::StatusCode::IOError, "prefetching");
+  auto res = PrepareRead(cursor_, nbytes);
+  if (!res) {
+    return arrow::Status::IOError("FileView::Read: ", res.error());
   }
   // and return the requested data
-  auto ret =
-      std::make_shared<arrow::Buffer>(map_start_ + cursor_, nbytes_internal);
-  cursor_ += nbytes_internal;
+  auto ret = std::make_shared<arrow::Buffer>(map_start_ + cursor_, res.value());
+  cursor_ += res.value();
   return ret;
 }
 
@@ -263,29 +431,101 @@ FileView::Read(int64_t nbytes, void* out) {
   if (!valid_) {
     return arrow::Status(arrow::StatusCode::Invalid, "Unbound FileView");
   }
-  int64_t nbytes_internal = nbytes;
-  if (cursor_ + nbytes > file_size_) {
-    nbytes_internal = file_size_ - cursor_;
+  auto res = PrepareRead(cursor_, nbytes);
+  if (!res) {
+    return arrow::Status::IOError("FileView::Read: ", res.error());
   }
-  // fetch data from storage if necessary
-  if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
-    return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
+  // and return the requested data
+  std::memcpy(out, map_start_ + cursor_, res.value());
+  cursor_ += res.value();
+  return res.value();
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>>
+FileView::ReadAt(int64_t position, int64_t nbytes) {
+  if (!valid_) {
+    return arrow::Status(arrow::StatusCode::Invalid, "Unbound FileView");
   }
-  // resolve outstanding relevant fetches
-  if (auto res = Resolve(cursor_, nbytes_internal); !res) {
-    // TODO (scober): Include res.error() as part of arrow Status
-    return arrow::Status(
-        arrow::StatusCode::IOError, "Resolving asynchronous reads");
+  if (position < 0 || position > file_size_) {
+    return arrow::Status::Invalid(
+        "Cannot read at ", position, " in file of size ", file_size_);
   }
-  // prefetch
-  if (auto res = PreFetch(cursor_, nbytes_internal); !res) {
-    // TODO (scober): Include res.error() as part of arrow Status
-    return arrow::Status(arrow::StatusCode::IOError, "prefetching");
+  auto res = PrepareRead(position, std::max<int64_t>(nbytes, 0));
+  if (!res) {
+    return arrow::Status::IOError("FileView::ReadAt: ", res.error());
   }
-  // and return the requested data
-  std::memcpy(out, map_start_ + cursor_, nbytes_internal);
-  cursor_ += nbytes_internal;
-  return nbytes_internal;
+  return std::make_shared<arrow::Buffer>(map_start_ + position, res.value());
+}
+
+arrow::Result<int64_t>
+FileView::ReadAt(int64_t position, int64_t nbytes, void* out) {
+  if (!valid_) {
+    return arrow::Status(arrow::StatusCode::Invalid, "Unbound FileView");
+  }
+  if (position < 0 || position > file_size_) {
+    return arrow::Status::Invalid(
+        "Cannot read at ", position, " in file of size ", file_size_);
+  }
+  auto res = PrepareRead(position, std::max<int64_t>(nbytes, 0));
+  if (!res) {
+    return arrow::Status::IOError("FileView::ReadAt: ", res.error());
+  }
+  std::memcpy(out, map_start_ + position, res.value());
+  return res.value();
+}
+
+arrow::Future<std::shared_ptr<arrow::Buffer>>
+FileView::ReadAsync(
+    const arrow::io::IOContext& ctx, int64_t position, int64_t nbytes) {
+  using BufferFuture = arrow::Future<std::shared_ptr<arrow::Buffer>>;
+  if (!valid_) {
+    return BufferFuture::MakeFinished(
+        arrow::Status(arrow::StatusCode::Invalid, "Unbound FileView"));
+  }
+  if (position < 0 || position > file_size_) {
+    return BufferFuture::MakeFinished(arrow::Status::Invalid(
+        "Cannot read at ", position, " in file of size ", file_size_));
+  }
+  PendingFetches pending;
+  auto res = StartRead(position, std::max<int64_t>(nbytes, 0), &pending);
+  if (!res) {
+    return BufferFuture::MakeFinished(
+        arrow::Status::IOError("FileView::ReadAsync: ", res.error()));
+  }
+  uint8_t* data = map_start_ + position;
+  int64_t available = res.value();
+  if (pending.empty()) {
+    return BufferFuture::MakeFinished(
+        std::make_shared<arrow::Buffer>(data, available));
+  }
+  // Like arrow's own readers, this relies on the caller keeping the file
+  // open until its reads complete
+  return arrow::DeferNotOk(ctx.executor()->Submit(
+      [data, available, pending = std::move(pending)]()
+          -> arrow::Result<std::shared_ptr<arrow::Buffer>> {
+        if (auto res = Wait(pending); !res) {
+          return arrow::Status::IOError("FileView::ReadAsync: ", res.error());
+        }
+        return std::make_shared<arrow::Buffer>(data, available);
+      }));
+}
+
+arrow::Status
+FileView::WillNeed(const std::vector<arrow::io::ReadRange>& ranges) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!valid_) {
+    return arrow::Status(arrow::StatusCode::Invalid, "Unbound FileView");
+  }
+  for (const auto& range : ranges) {
+    if (range.offset < 0 || range.length < 0) {
+      return arrow::Status::Invalid(
+          "Invalid range ", range.offset, "+", range.length);
+    }
+    if (auto res = FillAhead(range.offset, range.offset + range.length); !res) {
+      return arrow::Status::IOError("FileView::WillNeed: ", res.error());
+    }
+  }
+  return arrow::Status::OK();
 }
 
 arrow::Result<int64_t>
@@ -300,156 +540,38 @@ FileView::page_number(uint64_t size) {
   return size >> page_shift_;
 }
 
-inline uint64_t
-FileView::FirstPage(
-    uint64_t* bitmap, uint64_t block_num, uint64_t start, uint64_t end) {
-  uint64_t working = ~bitmap[block_num];
-  uint64_t mask = 1UL << (63 - start);
-  uint64_t page_low_bits = start;
-  while (!(working & mask) && page_low_bits <= end) {
-    mask >>= 1;
-    page_low_bits += 1;
-  }
-  return block_num * 64 + page_low_bits;
-}
-
-inline uint64_t
-FileView::LastPage(
-    uint64_t* bitmap, uint64_t block_num, uint64_t start, uint64_t end) {
-  uint64_t working = ~bitmap[block_num];
-  uint64_t mask = 1UL << (63 - end);
-  uint64_t page_low_bits = end;
-  while (!(working & mask) && page_low_bits >= start) {
-    mask <<= 1;
-    page_low_bits -= 1;
-  }
-  return block_num * 64 + page_low_bits;
-}
-
 std::optional<std::pair<uint64_t, uint64_t>>
-FileView::MustFill(uint64_t* bitmap, uint64_t begin, uint64_t end) {
-  /*
-   * We want to search for 0 bits in the bit array bitmap.
-   *
-   * For "internal" blocks, we just need to find any 0 bits in a uint64_t
-   * and this is relatively straightforward (i.e. A)
-   *
-   * But the first and last block might be only partially covered by [begin,
-   * end] (i.e. the range [60, 70] would cover the last 4 bits of block 0 and
-   * the first 7 bits of block 1).
-   *
-   * So we construct masks at B with ones in the bit positions we want to
-   * check. So for the above example,
-   * 0000000000000000000000000000000000000000000000000000000000001111
-   * and
-   * 1111111000000000000000000000000000000000000000000000000000000000
-   *
-   * Then we AND the mask against the block in question to zero out the bits
-   * we don't care about and XOR the mask against what is left to determine if
-   * there are zeroes left in the region we care about (the zeroed region will
-   * give all zeroes and the meaningful region will produce a 1 only if there
-   * is a zero present). This process occurs at C.
-   *
-   * Finally, we special case the situation where we only want to check part
-   * of one block (i.e. [13, 45]). (D) is the same as C except that we have to
-   * create and use The Mask in order to check the right region.
-   */
-  uint64_t begin_mask; /* B */
-  if (begin % 64) {
-    // This should work even if begin % 64 == 0, but it doesn't?
-    begin_mask = (UINT64_C(1) << (64 - begin % 64)) - UINT64_C(1);
-  } else {
-    begin_mask = ~UINT64_C(0);
-  }
-  uint64_t end_mask = ~((UINT64_C(1) << (63 - end % 64)) - UINT64_C(1));
-
-  uint64_t begin_block = begin / 64;
+FileView::MustFill(const uint64_t* bitmap, uint64_t begin, uint64_t end) {
+  // Find the first 0 bit in [begin, end] and then the first 1 bit after it,
+  // a block at a time
   uint64_t end_block = end / 64;
 
-  if (begin_block == end_block) { /* D */
-    uint64_t jim_carrey = begin_mask & end_mask;
-    if ((bitmap[begin_block] & jim_carrey) ^ jim_carrey) {
-      return std::make_pair(
-          FirstPage(bitmap, begin_block, begin % 64, end % 64),
-          LastPage(bitmap, begin_block, begin % 64, end % 64));
+  std::optional<uint64_t> first_page;
+  for (uint64_t i = begin / 64; i <= end_block; ++i) {
+    if (uint64_t missing = ~bitmap[i] & BlockMask(i, begin, end); missing) {
+      first_page = i * 64 + __builtin_clzll(missing);
+      break;
     }
-    return std::nullopt;
   }
-
-  /* C */
-  uint64_t begin_block_zeroes = (bitmap[begin_block] & begin_mask) ^ begin_mask;
-  uint64_t end_block_zeroes = (bitmap[end_block] & end_mask) ^ end_mask;
-
-  bool found_first = begin_block_zeroes;
-  bool found_last = end_block_zeroes;
-  uint64_t first_page =
-      found_first ? FirstPage(bitmap, begin_block, begin % 64, 63) : 0;
-  uint64_t last_page =
-      found_last ? LastPage(bitmap, end_block, 0, end % 64) : 0;
-
-  if (!found_first) {
-    // search forward for first missing page, skip begin block
-    for (uint64_t i = begin_block + 1; i < end_block && !found_first; ++i) {
-      if (~bitmap[i]) { /* A */
-        first_page = FirstPage(bitmap, i, 0, 63);
-        found_first = true;
-      }
-    }
-
-    if (!found_first && end_block_zeroes) {
-      first_page = FirstPage(bitmap, end_block, 0, end % 64);
-      found_first = true;
-    }
+  if (!first_page) {
+    return std::nullopt;
   }
 
-  // If we were unsuccessful searching forward we are unlikely to succeed
-  // searching backward
-  if (found_first && !found_last) {
-    // search backward for last page, skip end_block
-    for (uint64_t i = end_block - 1; i > begin_block && !found_last; ++i) {
-      if (~bitmap[i]) {
-        last_page = LastPage(bitmap, i, 0, 63);
-        found_last = true;
-      }
-    }
-
-    if (!found_last && begin_block_zeroes) {
-      last_page = LastPage(bitmap, begin_block, begin % 64, 63);
-      found_last = true;
+  for (uint64_t i = first_page.value() / 64; i <= end_block; ++i) {
+    if (uint64_t present = bitmap[i] & BlockMask(i, first_page.value(), end);
+        present) {
+      return std::make_pair(
+          first_page.value(), i * 64 + __builtin_clzll(present) - 1);
     }
   }
-
-  if (found_first) {
-    KATANA_LOG_DEBUG_ASSERT(found_last);
-    return std::make_pair(first_page, last_page);
-  } else {
-    return std::nullopt;
-  }
+  return std::make_pair(first_page.value(), end);
 }
 
 katana::Result<void>
 FileView::MarkFilled(uint64_t* bitmap, uint64_t begin, uint64_t end) {
-  uint64_t begin_mask;
-  if (begin % 64) {
-    begin_mask = (UINT64_C(1) << (64 - begin % 64)) - UINT64_C(1);
-  } else {
-    begin_mask = ~UINT64_C(0);
-  }
-  uint64_t end_mask = ~((UINT64_C(1) << (63 - end % 64)) - UINT64_C(1));
-
-  uint64_t begin_block = begin / 64;
-  uint64_t end_block = end / 64;
-
-  if (begin_block == end_block) {
-    bitmap[begin_block] |= (begin_mask & end_mask);
-  } else {
-    bitmap[begin_block] |= begin_mask;
-    for (uint64_t i = begin_block + 1; i < end_block; ++i) {
-      bitmap[i] |= (uint64_t)(-1);
-    }
-    bitmap[end_block] |= end_mask;
+  for (uint64_t i = begin / 64; i <= end / 64; ++i) {
+    bitmap[i] |= BlockMask(i, begin, end);
   }
-
   return katana::ResultSuccess();
 }
 
@@ -460,7 +582,7 @@ FileView::Resolve(int64_t start, int64_t size) {
   // bottleneck
   for (auto it = fetches_->begin(); it != fetches_->end();) {
     auto fetch = it;
-    if (fetch->first_page <= page_number(start + size) ||
+    if (fetch->first_page <= page_number(start + size) &&
         fetch->last_page >= page_number(start)) {
       // Complete the remaining work if there is some
       if (fetch->work.valid()) {
@@ -480,18 +602,49 @@ FileView::Resolve(int64_t start, int64_t size) {
 
 katana::Result<void>
 FileView::PreFetch(int64_t start, int64_t size) {
-  // Our highly sophisticated prefetching algorithm is to crudely approximate
-  // the size of the last read plus 10%. This is largely motivated by parquet
-  // files, which consecutively read row groups that are (in theory)
-  // approximately the same size.
-  int64_t fetch_size = (size / 10) * 11;
-  // Make sure we haven't overflown
-  KATANA_LOG_DEBUG_ASSERT(fetch_size >= 0);
-  uint64_t begin = static_cast<uint64_t>(start + size);
-  uint64_t end = static_cast<uint64_t>(start + size + fetch_size);
-  if (auto res = Fill(begin, end, false); !res) {
-    return res.error();
+  AccessPattern& p = pattern_;
+  int64_t stride = start - p.last_start;
+  bool sequential = p.last_start >= 0 && start == p.last_start + p.last_size;
+  bool strided = p.last_start >= 0 && stride > 0 && stride == p.stride;
+  p.last_start = start;
+  p.last_size = size;
+
+  if (sequential) {
+    // Double the readahead as long as the stream stays sequential. Ranges
+    // that are already fetched are skipped, so this only fetches the part
+    // of the window past the previous one.
+    p.stride = 0;
+    p.strides = 0;
+    p.readahead = std::min(std::max(2 * p.readahead, size), kMaxReadahead);
+    return FillAhead(start + size, start + size + p.readahead);
+  }
+
+  if (strided) {
+    // Likewise double the number of strides read ahead, as long as the
+    // bytes they read fit the readahead limit
+    p.readahead = 0;
+    int64_t max_strides = std::min(kMaxStrides, kMaxReadahead / size);
+    if (max_strides == 0) {
+      p.strides = 0;
+      return katana::ResultSuccess();
+    }
+    p.strides = std::clamp<int64_t>(2 * p.strides, 1, max_strides);
+    for (int64_t i = 1; i <= p.strides; ++i) {
+      int64_t next = start + i * stride;
+      if (next >= file_size_) {
+        break;
+      }
+      KATANA_CHECKED(FillAhead(next, next + size));
+    }
+    return katana::ResultSuccess();
   }
+
+  // A random read, or the first read of a new stream, whose stride is
+  // confirmed by the next read. Do not fetch anything we are not confident
+  // about.
+  p.stride = stride > 0 ? stride : 0;
+  p.readahead = 0;
+  p.strides = 0;
   return katana::ResultSuccess();
 }
 }  // namespace tsuba
@@ -0,0 +1,264 @@
+#include "LocalIOPool.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#include <boost/filesystem.hpp>
+#include <boost/system/error_code.hpp>
+
+#include "katana/Logging.h"
+#include "tsuba/Errors.h"
+#include "tsuba/file.h"
+
+namespace fs = boost::filesystem;
+
+/// The state shared by the chunks of a request. The file descriptors are
+/// closed once the last chunk is done with them.
+struct tsuba::LocalIOPool::Request {
+  int fd{-1};
+  // only for reads that may use O_DIRECT
+  int direct_fd{-1};
+  bool write{false};
+  uint64_t start{0};
+
+  std::atomic<uint64_t> pending_chunks{0};
+  // bytes past the end of the file
+  std::atomic<uint64_t> missing{0};
+
+  std::mutex mutex;
+  katana::CopyableResult<void> result{katana::CopyableResultSuccess()};
+  std::promise<katana::CopyableResult<void>> promise;
+
+  void Fail(const katana::ErrorInfo& error) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (result) {
+      result = katana::CopyableErrorInfo{error};
+    }
+  }
+
+  void Finish() {
+    if (!write && missing > kBlockSize) {
+      Fail(KATANA_ERROR(
+          ErrorCode::LocalStorageError, "failed to read {} bytes past the end",
+          missing.load()));
+    }
+    promise.set_value(result);
+  }
+
+  ~Request() {
+    if (fd >= 0) {
+      close(fd);
+    }
+    if (direct_fd >= 0) {
+      close(direct_fd);
+    }
+  }
+};
+
+namespace {
+
+bool
+IsDirectAligned(uint64_t value) {
+  return (value & (tsuba::LocalIOPool::kDirectAlignment - 1)) == 0;
+}
+
+std::future<katana::CopyableResult<void>>
+MakeReadyFuture(katana::CopyableResult<void> result) {
+  std::promise<katana::CopyableResult<void>> promise;
+  promise.set_value(std::move(result));
+  return promise.get_future();
+}
+
+}  // namespace
+
+tsuba::LocalIOPool::~LocalIOPool() { Stop(); }
+
+void
+tsuba::LocalIOPool::Start(uint32_t queue_depth, bool direct_io) {
+  Stop();
+  direct_io_ = direct_io;
+  for (uint32_t i = 0; i < queue_depth; ++i) {
+    workers_.emplace_back([this]() { Work(); });
+  }
+}
+
+void
+tsuba::LocalIOPool::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  stopping_ = false;
+}
+
+void
+tsuba::LocalIOPool::Work() {
+  for (;;) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    Chunk chunk = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+
+    Run(chunk);
+  }
+}
+
+void
+tsuba::LocalIOPool::Run(const Chunk& chunk) {
+  Request& request = *chunk.request;
+  uint64_t file_offset = request.start + chunk.offset;
+  bool direct = request.direct_fd >= 0 && IsDirectAligned(file_offset) &&
+                IsDirectAligned(chunk.size) &&
+                IsDirectAligned(reinterpret_cast<uintptr_t>(chunk.data));
+
+  uint64_t done = 0;
+  while (done < chunk.size) {
+    ssize_t ret = 0;
+    if (request.write) {
+      ret = pwrite(
+          request.fd, chunk.data + done, chunk.size - done,
+          file_offset + done);
+    } else {
+      ret = pread(
+          direct ? request.direct_fd : request.fd, chunk.data + done,
+          chunk.size - done, file_offset + done);
+    }
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // the file system may not support O_DIRECT after all
+      if (direct && errno == EINVAL) {
+        direct = false;
+        continue;
+      }
+      request.Fail(KATANA_ERROR(
+          ErrorCode::LocalStorageError, "{} at offset {}: {}",
+          request.write ? "writing" : "reading", file_offset + done,
+          std::strerror(errno)));
+      break;
+    }
+    if (ret == 0) {
+      if (request.write) {
+        request.Fail(KATANA_ERROR(
+            ErrorCode::LocalStorageError, "writing at offset {}: no progress",
+            file_offset + done));
+      } else {
+        request.missing += chunk.size - done;
+      }
+      break;
+    }
+    done += ret;
+    // after a short O_DIRECT read the rest is no longer aligned
+    direct = direct && IsDirectAligned(done);
+  }
+
+  if (--request.pending_chunks == 0) {
+    request.Finish();
+  }
+}
+
+void
+tsuba::LocalIOPool::Submit(
+    const std::shared_ptr<Request>& request, uint64_t size, uint8_t* data) {
+  std::vector<Chunk> chunks;
+  for (uint64_t offset = 0; offset < size; offset += kChunkSize) {
+    chunks.emplace_back(Chunk{
+        request, offset, std::min(kChunkSize, size - offset), data + offset});
+  }
+  request->pending_chunks = chunks.size();
+  if (chunks.empty()) {
+    request->Finish();
+    return;
+  }
+
+  if (workers_.empty()) {
+    for (const auto& chunk : chunks) {
+      Run(chunk);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.insert(queue_.end(), chunks.begin(), chunks.end());
+  }
+  cv_.notify_all();
+}
+
+std::future<katana::CopyableResult<void>>
+tsuba::LocalIOPool::Read(
+    const std::string& path, uint64_t start, uint64_t size, uint8_t* data) {
+  auto request = std::make_shared<Request>();
+  request->start = start;
+  request->fd = open(path.c_str(), O_RDONLY);
+  if (request->fd < 0) {
+    return MakeReadyFuture(katana::CopyableErrorInfo{KATANA_ERROR(
+        ErrorCode::LocalStorageError, "opening {}: {}", path,
+        std::strerror(errno))});
+  }
+#ifdef O_DIRECT
+  if (direct_io_ && size >= kDirectMinSize) {
+    // without O_DIRECT support, reads go through the page cache
+    request->direct_fd = open(path.c_str(), O_RDONLY | O_DIRECT);
+  }
+#endif
+
+  auto future = request->promise.get_future();
+  Submit(request, size, data);
+  return future;
+}
+
+katana::Result<void>
+tsuba::LocalIOPool::CreateParentDirectories(const std::string& path) {
+  fs::path m_path{path};
+  fs::path dir = m_path.parent_path();
+  if (!dir.empty()) {
+    if (boost::system::error_code err; !fs::create_directories(dir, err)) {
+      if (err) {
+        return KATANA_ERROR(
+            std::error_code(err.value(), err.category()),
+            "creating parent directories: {}", err.message());
+      }
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+std::future<katana::CopyableResult<void>>
+tsuba::LocalIOPool::Write(
+    const std::string& path, const uint8_t* data, uint64_t size) {
+  if (auto res = CreateParentDirectories(path); !res) {
+    return MakeReadyFuture(katana::CopyableErrorInfo{res.error()});
+  }
+
+  auto request = std::make_shared<Request>();
+  request->write = true;
+  request->fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (request->fd < 0) {
+    return MakeReadyFuture(katana::CopyableErrorInfo{KATANA_ERROR(
+        ErrorCode::LocalStorageError, "opening {}: {}", path,
+        std::strerror(errno))});
+  }
+
+  auto future = request->promise.get_future();
+  // chunks of writes never write through their data pointer
+  Submit(request, size, const_cast<uint8_t*>(data));  // NOLINT
+  return future;
+}
@@ -0,0 +1,93 @@
+#ifndef KATANA_LIBTSUBA_LOCALIOPOOL_H_
+#define KATANA_LIBTSUBA_LOCALIOPOOL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/Result.h"
+
+namespace tsuba {
+
+/// Run the reads and writes of LocalStorage asynchronously with pread and
+/// pwrite on a pool of I/O threads. Requests are cut into chunks so that a
+/// single large request keeps all threads busy; the number of threads is the
+/// number of chunks in flight, i.e., the queue depth seen by the device.
+///
+/// Large reads whose offset, size and buffer are aligned to kDirectAlignment
+/// may bypass the page cache with O_DIRECT, which avoids copying sequential
+/// topology reads through the page cache.
+///
+/// The queue depth comes from the environment variable
+/// KATANA_LOCAL_STORAGE_QUEUE_DEPTH and O_DIRECT is enabled by
+/// KATANA_LOCAL_STORAGE_DIRECT_IO. A pool that is not started runs requests
+/// in the calling thread.
+class LocalIOPool {
+public:
+  static constexpr uint32_t kDefaultQueueDepth = 16;
+  static constexpr uint64_t kChunkSize = UINT64_C(4) << 20;
+  static constexpr uint64_t kDirectAlignment = UINT64_C(4) << 10;
+  /// Reads smaller than this always go through the page cache.
+  static constexpr uint64_t kDirectMinSize = UINT64_C(1) << 20;
+
+  LocalIOPool() = default;
+  LocalIOPool(const LocalIOPool& no_copy) = delete;
+  LocalIOPool& operator=(const LocalIOPool& no_copy) = delete;
+  ~LocalIOPool();
+
+  /// Start queue_depth I/O threads.
+  void Start(uint32_t queue_depth, bool direct_io);
+
+  /// Finish the queued requests and stop the I/O threads.
+  void Stop();
+
+  uint32_t queue_depth() const { return workers_.size(); }
+  bool direct_io() const { return direct_io_; }
+
+  /// Read size bytes at offset start of the file at path into data. Like a
+  /// short read at the end of the file, reading up to a block past the end
+  /// of the file is not an error.
+  std::future<katana::CopyableResult<void>> Read(
+      const std::string& path, uint64_t start, uint64_t size, uint8_t* data);
+
+  /// Create the directories on the way to the file at path.
+  static katana::Result<void> CreateParentDirectories(const std::string& path);
+
+  /// Replace the contents of the file at path, creating the file and its
+  /// parent directories if needed. data must stay valid until the future is
+  /// ready.
+  std::future<katana::CopyableResult<void>> Write(
+      const std::string& path, const uint8_t* data, uint64_t size);
+
+private:
+  struct Request;
+
+  struct Chunk {
+    std::shared_ptr<Request> request;
+    uint64_t offset;
+    uint64_t size;
+    uint8_t* data;
+  };
+
+  void Submit(
+      const std::shared_ptr<Request>& request, uint64_t size, uint8_t* data);
+  void Run(const Chunk& chunk);
+  void Work();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Chunk> queue_;
+  std::vector<std::thread> workers_;
+  bool stopping_{false};
+  bool direct_io_{false};
+};
+
+}  // namespace tsuba
+
+#endif
@@ -2,27 +2,31 @@
 
 #include <dirent.h>
 #include <fcntl.h>
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <fstream>
 #include <iterator>
 #include <system_error>
-
-#include <boost/filesystem.hpp>
-#include <boost/system/error_code.hpp>
+#include <vector>
 
 #include "GlobalState.h"
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
 #include "tsuba/Errors.h"
 #include "tsuba/file.h"
 
-namespace fs = boost::filesystem;
-
 void
 tsuba::LocalStorage::CleanUri(std::string* uri) {
   if (uri->find(uri_scheme()) != 0) {
@@ -32,29 +36,98 @@ tsuba::LocalStorage::CleanUri(std::string* uri) {
 }
 
 katana::Result<void>
-tsuba::LocalStorage::WriteFile(
-    std::string uri, const uint8_t* data, uint64_t size) {
-  CleanUri(&uri);
-  fs::path m_path{uri};
-  fs::path dir = m_path.parent_path();
-  if (!dir.empty()) {
-    if (boost::system::error_code err; !fs::create_directories(dir, err)) {
-      if (err) {
-        return KATANA_ERROR(
-            std::error_code(err.value(), err.category()),
-            "creating parent directories: {}", err.message());
+tsuba::LocalStorage::Init() {
+  int queue_depth = LocalIOPool::kDefaultQueueDepth;
+  katana::GetEnv("KATANA_LOCAL_STORAGE_QUEUE_DEPTH", &queue_depth);
+  bool direct_io = false;
+  katana::GetEnv("KATANA_LOCAL_STORAGE_DIRECT_IO", &direct_io);
+  if (queue_depth < 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "KATANA_LOCAL_STORAGE_QUEUE_DEPTH must not be negative: {}",
+        queue_depth);
+  }
+  io_pool_.Start(queue_depth, direct_io);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::LocalStorage::Fini() {
+  io_pool_.Stop();
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::LocalStorage::CopyRange(
+    int src_fd, int dst_fd, uint64_t begin, uint64_t size, CopyMethod first) {
+#ifdef FICLONE
+  // whole files on file systems like btrfs and xfs can share their extents
+  struct stat src_stat;
+  if (first == CopyMethod::kReflink && begin == 0 &&
+      fstat(src_fd, &src_stat) == 0 &&
+      static_cast<uint64_t>(src_stat.st_size) <= size &&
+      ioctl(dst_fd, FICLONE, src_fd) == 0) {
+    return katana::ResultSuccess();
+  }
+#endif
+
+  // copy_file_range copies in the kernel without a round trip through user
+  // space, but not between all pairs of file systems
+  loff_t src_offset = begin;
+  uint64_t copied = 0;
+  while (first != CopyMethod::kReadWrite && copied < size) {
+    ssize_t ret =
+        copy_file_range(src_fd, &src_offset, dst_fd, nullptr, size - copied, 0);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
       }
+      if (errno == EXDEV || errno == EINVAL || errno == ENOSYS ||
+          errno == EOPNOTSUPP) {
+        break;
+      }
+      return KATANA_ERROR(
+          tsuba::ErrorCode::LocalStorageError, "copy_file_range: {}",
+          std::strerror(errno));
+    }
+    if (ret == 0) {
+      return katana::ResultSuccess();
     }
+    copied += ret;
   }
 
-  std::ofstream ofile(uri);
-  if (!ofile.good()) {
-    return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "opening file: {}", strerror(errno));
-  }
-  ofile.write(reinterpret_cast<const char*>(data), size); /* NOLINT */
-  if (!ofile.good()) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "writing file");
+  // stream the rest through a bounded buffer
+  std::vector<uint8_t> buffer(
+      std::min<uint64_t>(size - copied, tsuba::LocalIOPool::kChunkSize));
+  while (copied < size) {
+    ssize_t ret = pread(
+        src_fd, buffer.data(), std::min<uint64_t>(buffer.size(), size - copied),
+        src_offset);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(
+          tsuba::ErrorCode::LocalStorageError, "reading: {}",
+          std::strerror(errno));
+    }
+    if (ret == 0) {
+      break;
+    }
+    for (ssize_t written = 0; written < ret;) {
+      ssize_t w = write(dst_fd, buffer.data() + written, ret - written);
+      if (w < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return KATANA_ERROR(
+            tsuba::ErrorCode::LocalStorageError, "writing: {}",
+            std::strerror(errno));
+      }
+      written += w;
+    }
+    src_offset += ret;
+    copied += ret;
   }
   return katana::ResultSuccess();
 }
@@ -66,46 +139,66 @@ tsuba::LocalStorage::RemoteCopyFile(
   CleanUri(&source_uri);
   CleanUri(&dest_uri);
 
-  std::ifstream ifile(source_uri, std::ios_base::binary);
-  if (!ifile) {
+  int src_fd = open(source_uri.c_str(), O_RDONLY);
+  if (src_fd < 0) {
     return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "failed to open source file");
+        ErrorCode::LocalStorageError, "opening source file {}: {}", source_uri,
+        std::strerror(errno));
   }
-  ifile.seekg(begin, std::ios_base::beg);
-
-  std::ofstream ofile(dest_uri, std::ios_base::binary | std::ios_base::trunc);
-  if (!ofile) {
+  if (auto res = LocalIOPool::CreateParentDirectories(dest_uri); !res) {
+    close(src_fd);
+    return res.error();
+  }
+  int dst_fd = open(dest_uri.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (dst_fd < 0) {
+    close(src_fd);
     return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "failed to open dest file");
+        ErrorCode::LocalStorageError, "opening dest file {}: {}", dest_uri,
+        std::strerror(errno));
   }
 
-  std::copy_n(
-      std::istreambuf_iterator<char>(ifile), size,
-      std::ostreambuf_iterator<char>(ofile));
+  auto res = CopyRange(src_fd, dst_fd, begin, size);
+  close(src_fd);
+  if (close(dst_fd) != 0 && res) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "closing {}: {}", dest_uri,
+        std::strerror(errno));
+  }
+  if (!res) {
+    return res.error().WithContext("copying {} to {}", source_uri, dest_uri);
+  }
   return katana::ResultSuccess();
 }
 
-katana::Result<void>
-tsuba::LocalStorage::ReadFile(
-    std::string uri, uint64_t start, uint64_t size, uint8_t* data) {
-  CleanUri(&uri);
-  std::ifstream ifile(uri);
-
-  ifile.seekg(start);
-  if (!ifile) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "failed to seek");
-  }
+std::future<katana::CopyableResult<void>>
+tsuba::LocalStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  std::string filename = uri;
+  CleanUri(&filename);
+  return io_pool_.Read(filename, start, size, result_buf);
+}
 
-  ifile.read(reinterpret_cast<char*>(data), size); /* NOLINT */
-  if (!ifile) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "failed to read");
-  }
+std::future<katana::CopyableResult<void>>
+tsuba::LocalStorage::PutAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  std::string filename = uri;
+  CleanUri(&filename);
+  return io_pool_.Write(filename, data, size);
+}
 
-  // if the difference in what was read from what we wanted is less  than a
-  // block it's because the file size isn't well aligned so don't complain.
-  if (size - ifile.gcount() > kBlockSize) {
-    return ErrorCode::LocalStorageError;
-  }
+katana::Result<void>
+tsuba::LocalStorage::GetMultiSync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  KATANA_CHECKED(GetAsync(uri, start, size, result_buf).get());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::LocalStorage::PutMultiSync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  KATANA_CHECKED(PutAsync(uri, data, size).get());
   return katana::ResultSuccess();
 }
 
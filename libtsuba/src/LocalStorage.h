@@ -8,42 +8,56 @@
 #include <string>
 #include <thread>
 
+#include "LocalIOPool.h"
 #include "katana/Result.h"
+#include "katana/config.h"
 #include "tsuba/FileStorage.h"
 
 namespace tsuba {
 
-/// Store byte arrays to the local file system; Provided as a convenience for
-/// testing only (un-optimized)
-class LocalStorage : public FileStorage {
+/// Store byte arrays to the local file system. Reads and writes run on a
+/// LocalIOPool, so GetAsync and PutAsync return before the I/O is done.
+class KATANA_EXPORT LocalStorage : public FileStorage {
   void CleanUri(std::string* uri);
-  katana::Result<void> WriteFile(
-      std::string, const uint8_t* data, uint64_t size);
-  katana::Result<void> ReadFile(
-      std::string uri, uint64_t start, uint64_t size, uint8_t* data);
   katana::Result<void> RemoteCopyFile(
       std::string source_uri, std::string dest_uri, uint64_t begin,
       uint64_t size);
 
+  LocalIOPool io_pool_;
+
 public:
+  /// Ways to copy between files, from the cheapest. Each falls back to the
+  /// next when the file systems involved do not support it.
+  enum class CopyMethod {
+    /// share the extents of a whole file (FICLONE)
+    kReflink,
+    /// copy in the kernel (copy_file_range)
+    kCopyFileRange,
+    /// read and write through a bounded buffer
+    kReadWrite,
+  };
+
+  /// Copy size bytes at offset begin of src_fd to the current offset of
+  /// dst_fd, stopping early at the end of src_fd. Starts with the method
+  /// first; the default picks the cheapest one that works.
+  static katana::Result<void> CopyRange(
+      int src_fd, int dst_fd, uint64_t begin, uint64_t size,
+      CopyMethod first = CopyMethod::kReflink);
+
   LocalStorage() : FileStorage("file://") {}
 
-  katana::Result<void> Init() override { return katana::ResultSuccess(); }
-  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+  katana::Result<void> Init() override;
+  katana::Result<void> Fini() override;
   katana::Result<void> Stat(const std::string& uri, StatBuf* size) override;
 
   uint32_t Priority() const override { return 1; }
 
   katana::Result<void> GetMultiSync(
       const std::string& uri, uint64_t start, uint64_t size,
-      uint8_t* result_buf) override {
-    return ReadFile(uri, start, size, result_buf);
-  }
+      uint8_t* result_buf) override;
 
   katana::Result<void> PutMultiSync(
-      const std::string& uri, const uint8_t* data, uint64_t size) override {
-    return WriteFile(uri, data, size);
-  }
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
 
   katana::Result<void> RemoteCopy(
       const std::string& source_uri, const std::string& dest_uri,
@@ -53,34 +67,10 @@ public:
 
   // get on future can potentially block (bulk synchronous parallel)
   std::future<katana::CopyableResult<void>> PutAsync(
-      const std::string& uri, const uint8_t* data, uint64_t size) override {
-    // No need for AsyncPut to local storage right now
-    if (auto write_res = WriteFile(uri, data, size); !write_res) {
-      katana::CopyableErrorInfo cei{write_res.error()};
-      return std::async(
-          std::launch::deferred,
-          [=]() -> katana::CopyableResult<void> { return cei; });
-    }
-    return std::async(
-        std::launch::deferred, []() -> katana::CopyableResult<void> {
-          return katana::CopyableResultSuccess();
-        });
-  }
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
   std::future<katana::CopyableResult<void>> GetAsync(
       const std::string& uri, uint64_t start, uint64_t size,
-      uint8_t* result_buf) override {
-    // I suppose there is no need for AsyncGet to local storage either
-    if (auto read_res = ReadFile(uri, start, size, result_buf); !read_res) {
-      katana::CopyableErrorInfo cei{read_res.error()};
-      return std::async(
-          std::launch::deferred,
-          [=]() -> katana::CopyableResult<void> { return cei; });
-    }
-    return std::async(
-        std::launch::deferred, []() -> katana::CopyableResult<void> {
-          return katana::CopyableResultSuccess();
-        });
-  }
+      uint8_t* result_buf) override;
   std::future<katana::CopyableResult<void>> ListAsync(
       const std::string& uri, std::vector<std::string>* list,
       std::vector<uint64_t>* size) override;
@@ -97,9 +97,18 @@ BuildReader(
       "opening {}", uri);
   *fv = fv_tmp;
 
+  // FileView supports concurrent positional reads, so let arrow fetch the
+  // column chunks it is going to read up front and decode columns in parallel
+  parquet::ArrowReaderProperties properties;
+  properties.set_pre_buffer(true);
+  properties.set_use_threads(true);
+
+  parquet::arrow::FileReaderBuilder builder;
+  KATANA_CHECKED(builder.Open(fv_tmp));
   std::unique_ptr<parquet::arrow::FileReader> reader;
-  KATANA_CHECKED(
-      parquet::arrow::OpenFile(fv_tmp, arrow::default_memory_pool(), &reader));
+  KATANA_CHECKED(builder.memory_pool(arrow::default_memory_pool())
+                     ->properties(properties)
+                     ->Build(&reader));
 
   return std::unique_ptr<parquet::arrow::FileReader>(std::move(reader));
 }
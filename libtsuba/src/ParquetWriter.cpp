@@ -1,5 +1,10 @@
 #include "tsuba/ParquetWriter.h"
 
+#include <iomanip>
+
+#include <parquet/arrow/schema.h>
+#include <parquet/schema.h>
+
 #include "katana/ArrowInterchange.h"
 #include "katana/JSON.h"
 #include "katana/Result.h"
@@ -160,12 +165,80 @@ BlockTable(std::shared_ptr<arrow::Table> table, uint64_t mbs_per_block) {
   return blocks;
 }
 
+/// Resolve the column settings in opts to the parquet leaf columns they
+/// apply to, rejecting settings that parquet would only complain about in the
+/// middle of an asynchronous write. A top level column name covers every leaf
+/// of a nested column, e.g., "a" covers "a.list.item" of a list column, and
+/// a dotted leaf path names just that leaf. Names of columns that are not in
+/// schema are ignored.
+Result<tsuba::ParquetWriter::ColumnOptsByPath>
+ResolveColumnOpts(
+    const arrow::Schema& schema, const tsuba::ParquetWriter::WriteOpts& opts) {
+  tsuba::ParquetWriter::ColumnOptsByPath resolved;
+  if (opts.column_opts.empty()) {
+    return resolved;
+  }
+
+  // large strings are written as strings, see HandleBadParquetTypes
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (const auto& field : schema.fields()) {
+    fields.emplace_back(
+        field->type()->id() == arrow::Type::LARGE_STRING
+            ? field->WithType(arrow::utf8())
+            : field);
+  }
+  auto arrow_schema = arrow::schema(fields);
+  std::shared_ptr<parquet::SchemaDescriptor> parquet_schema;
+  KATANA_CHECKED(parquet::arrow::ToParquetSchema(
+      arrow_schema.get(), *parquet::default_writer_properties(),
+      *parquet::default_arrow_writer_properties(), &parquet_schema));
+
+  for (int i = 0, num = parquet_schema->num_columns(); i < num; ++i) {
+    const parquet::ColumnDescriptor* leaf = parquet_schema->Column(i);
+    std::string path = leaf->path()->ToDotString();
+    auto it = opts.column_opts.find(path);
+    if (it == opts.column_opts.end()) {
+      it = opts.column_opts.find(leaf->path()->ToDotVector().front());
+    }
+    if (it == opts.column_opts.end()) {
+      continue;
+    }
+    const auto& [name, column] = *it;
+
+    if (column.encoding) {
+      switch (*column.encoding) {
+      case parquet::Encoding::PLAIN_DICTIONARY:
+      case parquet::Encoding::RLE_DICTIONARY:
+        return KATANA_ERROR(
+            tsuba::ErrorCode::InvalidArgument,
+            "column {}: use use_dictionary to dictionary encode a column",
+            std::quoted(name));
+      case parquet::Encoding::BYTE_STREAM_SPLIT:
+        if (leaf->physical_type() != parquet::Type::FLOAT &&
+            leaf->physical_type() != parquet::Type::DOUBLE) {
+          return KATANA_ERROR(
+              tsuba::ErrorCode::InvalidArgument,
+              "column {}: byte stream split needs float or double, not {} "
+              "in {}",
+              std::quoted(name), parquet::TypeToString(leaf->physical_type()),
+              std::quoted(path));
+        }
+        break;
+      default:
+        break;
+      }
+    }
+    resolved.emplace_back(std::move(path), column);
+  }
+  return resolved;
+}
+
 Result<void>
 DoStoreParquet(
     const std::string& path, std::shared_ptr<arrow::Table> table,
     const std::shared_ptr<parquet::WriterProperties>& writer_props,
     const std::shared_ptr<parquet::ArrowWriterProperties>& arrow_props,
-    tsuba::WriteGroup* desc) {
+    int64_t max_row_group_length, tsuba::WriteGroup* desc) {
   auto ff = std::make_shared<tsuba::FileFrame>();
   KATANA_CHECKED(ff->Init());
   ff->Bind(path);
@@ -173,11 +246,12 @@ DoStoreParquet(
   auto future = std::async(
       std::launch::async,
       [table = std::move(table), ff = std::move(ff), desc, writer_props,
-       arrow_props]() mutable -> katana::CopyableResult<void> {
+       arrow_props,
+       max_row_group_length]() mutable -> katana::CopyableResult<void> {
         table = KATANA_CHECKED(HandleBadParquetTypes(table));
         auto write_result = parquet::arrow::WriteTable(
-            *table, arrow::default_memory_pool(), ff,
-            std::numeric_limits<int64_t>::max(), writer_props, arrow_props);
+            *table, arrow::default_memory_pool(), ff, max_row_group_length,
+            writer_props, arrow_props);
         table.reset();
 
         if (!write_result.ok()) {
@@ -222,12 +296,15 @@ tsuba::ParquetWriter::Make(
 Result<std::unique_ptr<tsuba::ParquetWriter>>
 tsuba::ParquetWriter::Make(
     std::shared_ptr<arrow::Table> table, WriteOpts opts) {
+  auto column_opts =
+      KATANA_CHECKED(ResolveColumnOpts(*table->schema(), opts));
   if (!opts.write_blocked) {
-    return std::unique_ptr<ParquetWriter>(
-        new ParquetWriter({std::move(table)}, opts));
+    return std::unique_ptr<ParquetWriter>(new ParquetWriter(
+        {std::move(table)}, opts, std::move(column_opts)));
   }
   return std::unique_ptr<ParquetWriter>(new ParquetWriter(
-      BlockTable(std::move(table), opts.mbs_per_block), opts));
+      BlockTable(std::move(table), opts.mbs_per_block), opts,
+      std::move(column_opts)));
 }
 
 katana::Result<void>
@@ -242,10 +319,45 @@ tsuba::ParquetWriter::WriteToUri(const katana::Uri& uri, WriteGroup* group) {
 
 std::shared_ptr<parquet::WriterProperties>
 tsuba::ParquetWriter::StandardWriterProperties() {
-  return parquet::WriterProperties::Builder()
-      .version(opts_.parquet_version)
+  parquet::WriterProperties::Builder builder;
+  builder.version(opts_.parquet_version)
       ->data_page_version(opts_.data_page_version)
-      ->build();
+      ->compression(opts_.compression)
+      ->compression_level(opts_.compression_level)
+      ->max_row_group_length(opts_.max_row_group_length);
+  if (!opts_.use_dictionary) {
+    builder.disable_dictionary();
+  }
+  if (!opts_.write_statistics) {
+    builder.disable_statistics();
+  }
+
+  for (const auto& [name, column] : column_opts_) {
+    if (column.compression) {
+      builder.compression(name, *column.compression);
+    }
+    if (column.compression_level) {
+      builder.compression_level(name, *column.compression_level);
+    }
+    if (column.use_dictionary) {
+      if (*column.use_dictionary) {
+        builder.enable_dictionary(name);
+      } else {
+        builder.disable_dictionary(name);
+      }
+    }
+    if (column.encoding) {
+      builder.encoding(name, *column.encoding);
+    }
+    if (column.write_statistics) {
+      if (*column.write_statistics) {
+        builder.enable_statistics(name);
+      } else {
+        builder.disable_statistics(name);
+      }
+    }
+  }
+  return builder.build();
 }
 
 std::shared_ptr<parquet::ArrowWriterProperties>
@@ -263,7 +375,9 @@ tsuba::ParquetWriter::StoreParquet(
   std::string prefix = uri.string();
 
   if (table->num_rows() <= kMaxRowsPerFile) {
-    return DoStoreParquet(prefix, table, writer_props, arrow_props, desc);
+    return DoStoreParquet(
+        prefix, table, writer_props, arrow_props, opts_.max_row_group_length,
+        desc);
   }
 
   std::vector<std::shared_ptr<arrow::Table>> tables;
@@ -286,7 +400,7 @@ tsuba::ParquetWriter::StoreParquet(
   for (const auto& t : tables) {
     KATANA_CHECKED(DoStoreParquet(
         fmt::format("{}.part_{:09}", prefix, table_count++), t, writer_props,
-        arrow_props, desc));
+        arrow_props, opts_.max_row_group_length, desc));
   }
   return FileStore(
       uri.string(), KATANA_CHECKED(katana::JsonDump(table_offsets)));
@@ -70,8 +70,9 @@ MasterPropName(unsigned i) {
 katana::Result<std::string>
 StoreArrowArrayAtName(
     const std::shared_ptr<arrow::ChunkedArray>& array, const katana::Uri& dir,
-    const std::string& name, tsuba::WriteGroup* desc) {
-  auto writer_res = tsuba::ParquetWriter::Make(array, name);
+    const std::string& name, const tsuba::ParquetWriter::WriteOpts& opts,
+    tsuba::WriteGroup* desc) {
+  auto writer_res = tsuba::ParquetWriter::Make(array, name, opts);
   if (!writer_res) {
     return writer_res.error().WithContext("making property writer");
   }
@@ -87,7 +88,8 @@ StoreArrowArrayAtName(
 katana::Result<void>
 WriteProperties(
     const arrow::Table& props, std::vector<tsuba::PropStorageInfo*> prop_info,
-    const katana::Uri& dir, tsuba::WriteGroup* desc) {
+    const katana::Uri& dir, const tsuba::RDGWriteOptions& opts,
+    tsuba::NodeEdge node_edge, tsuba::WriteGroup* desc) {
   const auto& schema = props.schema();
 
   std::vector<std::string> next_paths;
@@ -97,8 +99,8 @@ WriteProperties(
     }
     std::string name = prop_info[i]->name().empty() ? schema->field(i)->name()
                                                     : prop_info[i]->name();
-    std::string path =
-        KATANA_CHECKED(StoreArrowArrayAtName(props.column(i), dir, name, desc));
+    std::string path = KATANA_CHECKED(StoreArrowArrayAtName(
+        props.column(i), dir, name, opts.PropertyOpts(node_edge, name), desc));
 
     prop_info[i]->WasWritten(path);
   }
@@ -206,6 +208,7 @@ tsuba::RDGFile::~RDGFile() {
 katana::Result<std::vector<tsuba::PropStorageInfo>>
 tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
   std::vector<tsuba::PropStorageInfo> next_properties;
+  const ParquetWriter::WriteOpts& opts = write_opts_.file_opts;
 
   KATANA_LOG_DEBUG(
       "WritePartArrays master sz: {} mirrors sz: {} h2owned sz : {} "
@@ -224,23 +227,24 @@ tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
   for (size_t i = 0; i < mirror_nodes_.size(); ++i) {
     std::string name = MirrorPropName(i);
     std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(mirror_nodes_[i], dir, name, desc), "storing {}",
-        name);
+        StoreArrowArrayAtName(mirror_nodes_[i], dir, name, opts, desc),
+        "storing {}", name);
     next_properties.emplace_back(tsuba::PropStorageInfo(name, path));
   }
 
   for (size_t i = 0; i < master_nodes_.size(); ++i) {
     std::string name = MasterPropName(i);
     std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(master_nodes_[i], dir, name, desc), "storing {}",
-        name);
+        StoreArrowArrayAtName(master_nodes_[i], dir, name, opts, desc),
+        "storing {}", name);
     next_properties.emplace_back(tsuba::PropStorageInfo(name, path));
   }
 
   if (host_to_owned_global_node_ids_ != nullptr) {
     std::string name = kHostToOwnedGlobalNodeIDsPropName;
     std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(host_to_owned_global_node_ids_, dir, name, desc),
+        StoreArrowArrayAtName(
+            host_to_owned_global_node_ids_, dir, name, opts, desc),
         "storing {}", name);
     next_properties.emplace_back(tsuba::PropStorageInfo(name, path));
   }
@@ -248,7 +252,8 @@ tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
   if (host_to_owned_global_edge_ids_ != nullptr) {
     std::string name = kHostToOwnedGlobalEdgeIDsPropName;
     std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(host_to_owned_global_edge_ids_, dir, name, desc),
+        StoreArrowArrayAtName(
+            host_to_owned_global_edge_ids_, dir, name, opts, desc),
         "storing {}", name);
     next_properties.emplace_back(tsuba::PropStorageInfo(name, path));
   }
@@ -256,8 +261,8 @@ tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
   if (local_to_user_id_ != nullptr) {
     std::string name = kLocalToUserIDPropName;
     std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(local_to_user_id_, dir, name, desc), "storing {}",
-        name);
+        StoreArrowArrayAtName(local_to_user_id_, dir, name, opts, desc),
+        "storing {}", name);
     next_properties.emplace_back(tsuba::PropStorageInfo(name, path));
   }
 
@@ -265,7 +270,7 @@ tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
     std::string name = kLocalToGlobalIDPropName;
     std::string path = KATANA_CHECKED_CONTEXT(
         StoreArrowArrayAtName(
-            local_to_global_id_, dir, kLocalToGlobalIDPropName, desc),
+            local_to_global_id_, dir, kLocalToGlobalIDPropName, opts, desc),
         "storing {}", name);
     next_properties.emplace_back(tsuba::PropStorageInfo(name, path));
   }
@@ -429,7 +434,8 @@ tsuba::RDG::DoStore(
   KATANA_CHECKED_CONTEXT(
       WriteProperties(
           *core_->node_properties(), node_props_to_store,
-          handle.impl_->rdg_manifest().dir(), write_group.get()),
+          handle.impl_->rdg_manifest().dir(), write_opts_,
+          tsuba::NodeEdge::kNode, write_group.get()),
       "writing node properties");
 
   std::vector<std::string> edge_prop_names;
@@ -443,7 +449,8 @@ tsuba::RDG::DoStore(
   KATANA_CHECKED_CONTEXT(
       WriteProperties(
           *core_->edge_properties(), edge_props_to_store,
-          handle.impl_->rdg_manifest().dir(), write_group.get()),
+          handle.impl_->rdg_manifest().dir(), write_opts_,
+          tsuba::NodeEdge::kEdge, write_group.get()),
       "writing edge properties");
 
   core_->part_header().set_part_properties(KATANA_CHECKED_CONTEXT(
@@ -771,8 +778,8 @@ namespace {
 katana::Result<std::shared_ptr<arrow::Table>>
 UnloadProperty(
     const std::shared_ptr<arrow::Table>& props, int i,
-    std::vector<tsuba::PropStorageInfo>* prop_info_list,
-    const katana::Uri& dir) {
+    std::vector<tsuba::PropStorageInfo>* prop_info_list, const katana::Uri& dir,
+    const tsuba::RDGWriteOptions& opts, tsuba::NodeEdge node_edge) {
   if (i < 0 || i > props->num_columns()) {
     return KATANA_ERROR(
         katana::ErrorCode::InvalidArgument, "property index out of bounds");
@@ -790,8 +797,9 @@ UnloadProperty(
   KATANA_LOG_ASSERT(!prop_info.IsAbsent());
 
   if (prop_info.IsDirty()) {
-    std::string path = KATANA_CHECKED(
-        StoreArrowArrayAtName(props->column(i), dir, name, nullptr));
+    std::string path = KATANA_CHECKED(StoreArrowArrayAtName(
+        props->column(i), dir, name, opts.PropertyOpts(node_edge, name),
+        nullptr));
     prop_info.WasWritten(path);
   }
 
@@ -853,7 +861,7 @@ katana::Result<void>
 tsuba::RDG::UnloadNodeProperty(int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(UnloadProperty(
       node_properties(), i, &core_->part_header().node_prop_info_list(),
-      rdg_dir()));
+      rdg_dir(), write_opts_, tsuba::NodeEdge::kNode));
   core_->set_node_properties(std::move(new_props));
   return katana::ResultSuccess();
 }
@@ -874,7 +882,7 @@ katana::Result<void>
 tsuba::RDG::UnloadEdgeProperty(int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(UnloadProperty(
       edge_properties(), i, &core_->part_header().edge_prop_info_list(),
-      rdg_dir()));
+      rdg_dir(), write_opts_, tsuba::NodeEdge::kEdge));
   core_->set_edge_properties(std::move(new_props));
   return katana::ResultSuccess();
 }
@@ -1076,6 +1084,20 @@ tsuba::RDG::RDG(std::unique_ptr<RDGCore>&& core) : core_(std::move(core)) {
   InitArrowVectors();
 }
 
+tsuba::ParquetWriter::WriteOpts
+tsuba::RDGWriteOptions::PropertyOpts(
+    NodeEdge node_edge, const std::string& name) const {
+  ParquetWriter::WriteOpts opts = file_opts;
+  opts.column_opts.clear();
+  const auto& property_opts = node_edge == NodeEdge::kNode
+                                  ? node_property_opts
+                                  : edge_property_opts;
+  if (auto it = property_opts.find(name); it != property_opts.end()) {
+    opts.column_opts.emplace(name, it->second);
+  }
+  return opts;
+}
+
 tsuba::RDG::RDG() : core_(std::make_unique<RDGCore>()) { InitArrowVectors(); }
 
 tsuba::RDG::~RDG() = default;
@@ -313,25 +313,22 @@ public:
       const katana::EntityTypeManager& manager,
       tsuba::EntityTypeIDToSetOfEntityTypeIDsStorageMap& id_dict,
       katana::EntityTypeIDToAtomicTypeNameMap& id_name) const {
-    katana::EntityTypeIDToSetOfEntityTypeIDsMap manager_type_id_sets =
+    const katana::EntityTypeIDToSetOfEntityTypeIDsMap& manager_type_id_sets =
         manager.GetEntityTypeIDToAtomicEntityTypeIDs();
 
     size_t num_entity_types = manager_type_id_sets.size();
     for (size_t i = 0, ni = num_entity_types; i < ni; ++i) {
-      for (size_t j = 0, nj = num_entity_types; j < nj; ++j) {
-        if (manager_type_id_sets[i].test(j)) {
-          auto cur_id = katana::EntityTypeID(i);
-          if (id_dict.count(cur_id)) {
-            // if we have seen this EntityTypeID already, add to its set
-            id_dict.at(cur_id).emplace_back(katana::EntityTypeID(j));
-          } else {
-            // if we have not, create a set with the id
-            tsuba::StorageSetOfEntityTypeIDs new_set = {
-                katana::EntityTypeID(j)};
-            id_dict.emplace(std::make_pair(cur_id, new_set));
-          }
+      auto cur_id = katana::EntityTypeID(i);
+      manager_type_id_sets[i].ForEach([&](katana::EntityTypeID j) {
+        if (id_dict.count(cur_id)) {
+          // if we have seen this EntityTypeID already, add to its set
+          id_dict.at(cur_id).emplace_back(j);
+        } else {
+          // if we have not, create a set with the id
+          tsuba::StorageSetOfEntityTypeIDs new_set = {j};
+          id_dict.emplace(std::make_pair(cur_id, new_set));
         }
-      }
+      });
     }
     // Convert EntityTypeID name map
     id_name = manager.GetEntityTypeIDToAtomicTypeNameMap();
@@ -27,19 +27,16 @@ tsuba::RDGSlice::DoMake(
     katana::Uri edge_types_path = metadata_dir.Join(
         core_->part_header().edge_entity_type_id_array_path());
 
+    // Type id arrays have a header and may store one or two bytes per
+    // entity, so the bytes of a slice cannot be computed without reading the
+    // header; bind the whole arrays
     KATANA_CHECKED_CONTEXT(
         core_->node_entity_type_id_array_file_storage().Bind(
-            node_types_path.string(),
-            slice.node_range.first * sizeof(katana::EntityTypeID),
-            slice.node_range.second * sizeof(katana::EntityTypeID), true),
-        "loading node type id array; begin: {}, end: {}",
-        slice.node_range.first * sizeof(katana::EntityTypeID),
-        slice.node_range.second * sizeof(katana::EntityTypeID));
+            node_types_path.string(), true),
+        "loading node type id array");
     KATANA_CHECKED_CONTEXT(
         core_->edge_entity_type_id_array_file_storage().Bind(
-            edge_types_path.string(),
-            slice.edge_range.first * sizeof(katana::EntityTypeID),
-            slice.edge_range.second * sizeof(katana::EntityTypeID), true),
+            edge_types_path.string(), true),
         "loading edge type id array");
   }
   // all of the properties
@@ -1,5 +1,10 @@
 #include "tsuba/tsuba.h"
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <optional>
+
 #include "GlobalState.h"
 #include "RDGHandleImpl.h"
 #include "RDGPartHeader.h"
@@ -54,6 +59,28 @@ FindLatestManifestFile(const katana::Uri& name) {
   return name.Join(found_manifest);
 }
 
+/// Copy a whole file. Copies within one storage back-end use RemoteCopy,
+/// which streams the data (or, for S3-like stores, copies it on the server)
+/// without reading the whole file into memory. Copies between back-ends
+/// read the file and store it.
+katana::Result<void>
+CopyFile(const katana::Uri& src, const katana::Uri& dst) {
+  tsuba::StatBuf stat_buf;
+  KATANA_CHECKED_CONTEXT(
+      tsuba::FileStat(src.string(), &stat_buf), "stat {}", src);
+  if (src.scheme() == dst.scheme()) {
+    KATANA_CHECKED_CONTEXT(
+        tsuba::FileRemoteCopy(src.string(), dst.string(), 0, stat_buf.size),
+        "copying {} to {}", src, dst);
+    return katana::ResultSuccess();
+  }
+
+  tsuba::FileView fv;
+  KATANA_CHECKED(fv.Bind(src.string(), true));
+  KATANA_CHECKED(tsuba::FileStore(dst.string(), fv.ptr<char>(), fv.size()));
+  return katana::ResultSuccess();
+}
+
 }  // namespace
 
 katana::Result<tsuba::RDGHandle>
@@ -273,20 +300,57 @@ tsuba::CreateSrcDestFromViewsForCopy(
 }
 
 katana::Result<void>
-tsuba::CopyRDG(std::vector<std::pair<katana::Uri, katana::Uri>> src_dst_files) {
-  // TODO(vkarthik): add do_all loop
+tsuba::CopyRDG(
+    std::vector<std::pair<katana::Uri, katana::Uri>> src_dst_files,
+    uint32_t max_parallel_copies) {
+  if (max_parallel_copies == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "max_parallel_copies must be positive");
+  }
+
+  std::vector<uint64_t> data_file_idxs;
   std::vector<uint64_t> manifest_uri_idxs;
   for (uint64_t i = 0; i < src_dst_files.size(); i++) {
-    auto [src_file_uri, dst_file_uri] = src_dst_files[i];
     // We save the names of all the manifest files and we write them out at the end.
-    if (tsuba::RDGManifest::IsManifestUri(src_file_uri)) {
+    if (tsuba::RDGManifest::IsManifestUri(src_dst_files[i].first)) {
       manifest_uri_idxs.push_back(i);
-      continue;
+    } else {
+      data_file_idxs.push_back(i);
     }
-    tsuba::FileView fv;
-    KATANA_CHECKED(fv.Bind(src_file_uri.string(), true));
-    KATANA_CHECKED(
-        tsuba::FileStore(dst_file_uri.string(), fv.ptr<char>(), fv.size()));
+  }
+
+  // Each worker takes the next file as soon as its previous copy is done, so
+  // a slow file only occupies its own worker. After the first failure no
+  // worker starts another copy.
+  std::atomic<uint64_t> next{0};
+  std::atomic<bool> failed{false};
+  std::optional<katana::CopyableErrorInfo> first_error;
+  auto copy_files = [&]() {
+    for (uint64_t i = next++; i < data_file_idxs.size() && !failed;
+         i = next++) {
+      const auto& [src_file_uri, dst_file_uri] =
+          src_dst_files[data_file_idxs[i]];
+      if (auto res = CopyFile(src_file_uri, dst_file_uri); !res) {
+        if (!failed.exchange(true)) {
+          first_error = res.error();
+        }
+      }
+    }
+  };
+
+  uint64_t num_workers =
+      std::min<uint64_t>(max_parallel_copies, data_file_idxs.size());
+  std::vector<std::future<void>> workers;
+  for (uint64_t i = 1; i < num_workers; i++) {
+    workers.emplace_back(std::async(std::launch::async, copy_files));
+  }
+  copy_files();
+  for (auto& worker : workers) {
+    worker.get();
+  }
+  if (first_error) {
+    return katana::ErrorInfo(first_error.value())
+        .WithContext("copying RDG files");
   }
 
   // Process all the manifest files, write them out.
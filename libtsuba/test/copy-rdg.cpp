@@ -0,0 +1,213 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "LocalStorage.h"
+#include "RDGManifest.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/RDG.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+std::string
+ReadFile(const std::string& path) {
+  std::ifstream in(path, std::ios_base::binary);
+  KATANA_LOG_VASSERT(in, "opening {}", path);
+  return std::string(
+      std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+katana::Result<void>
+CheckSameContents(const std::string& expected, const std::string& path) {
+  if (ReadFile(path) != expected) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "{} has the wrong contents",
+        path);
+  }
+  return katana::ResultSuccess();
+}
+
+/// Every copy method and range, including ranges that run past the end of
+/// the source, copy the same bytes.
+katana::Result<void>
+TestCopyRange(const katana::Uri& dir) {
+  // longer than a read/write buffer, and not a multiple of a page
+  std::string data(tsuba::LocalIOPool::kChunkSize + 12345, '\0');
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>((i * 7919) >> 3);
+  }
+  std::string src = dir.Join("range-src").path();
+  std::string dst = dir.Join("range-dst").path();
+  KATANA_CHECKED(tsuba::FileStore(src, data.data(), data.size()));
+
+  const uint64_t size = data.size();
+  std::vector<std::pair<uint64_t, uint64_t>> ranges{
+      {0, size},
+      {0, std::numeric_limits<uint64_t>::max()},
+      {4096 + 7, 100000},
+      {size - 100, 1000},
+      {size, 10},
+  };
+
+  using CopyMethod = tsuba::LocalStorage::CopyMethod;
+  for (auto method :
+       {CopyMethod::kReflink, CopyMethod::kCopyFileRange,
+        CopyMethod::kReadWrite}) {
+    for (const auto& [begin, length] : ranges) {
+      int src_fd = open(src.c_str(), O_RDONLY);
+      int dst_fd = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+      KATANA_LOG_ASSERT(src_fd >= 0 && dst_fd >= 0);
+      auto res = tsuba::LocalStorage::CopyRange(
+          src_fd, dst_fd, begin, length, method);
+      close(src_fd);
+      close(dst_fd);
+      KATANA_CHECKED_CONTEXT(
+          res, "method {} begin {} size {}", static_cast<int>(method), begin,
+          length);
+      KATANA_CHECKED_CONTEXT(
+          CheckSameContents(data.substr(begin, length), dst),
+          "method {} begin {} size {}", static_cast<int>(method), begin,
+          length);
+    }
+  }
+
+  // RemoteCopy creates the parent directories of its destination
+  katana::Uri nested = dir.Join("a").Join("b").Join("range-dst");
+  KATANA_CHECKED(tsuba::FileRemoteCopy(
+      dir.Join("range-src").string(), nested.string(), 12345, 54321));
+  KATANA_CHECKED(CheckSameContents(data.substr(12345, 54321), nested.path()));
+
+  if (tsuba::FileRemoteCopy(
+          dir.Join("no-such-file").string(), nested.string(), 0, 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "copying a missing file should fail");
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestCopyRDG(const std::string& src_dir, const katana::Uri& dir) {
+  std::string dst_dir = dir.Join("copy").string();
+  auto src_dst_files =
+      KATANA_CHECKED(tsuba::CreateSrcDestFromViewsForCopy(src_dir, dst_dir, 1));
+  // a small bound so that copies wait for each other
+  KATANA_CHECKED(tsuba::CopyRDG(src_dst_files, 2));
+
+  for (const auto& [src, dst] : src_dst_files) {
+    if (tsuba::RDGManifest::IsManifestUri(src)) {
+      if (!fs::exists(dst.path())) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed, "missing manifest {}", dst);
+      }
+      continue;
+    }
+    KATANA_CHECKED(CheckSameContents(ReadFile(src.path()), dst.path()));
+  }
+
+  auto src_handle = KATANA_CHECKED(tsuba::Open(src_dir, tsuba::kReadOnly));
+  auto src_rdg =
+      KATANA_CHECKED(tsuba::RDG::Make(src_handle, tsuba::RDGLoadOptions()));
+  auto dst_handle = KATANA_CHECKED(tsuba::Open(dst_dir, tsuba::kReadOnly));
+  auto dst_rdg =
+      KATANA_CHECKED(tsuba::RDG::Make(dst_handle, tsuba::RDGLoadOptions()));
+  if (!src_rdg.Equals(dst_rdg)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "copied RDG differs");
+  }
+  KATANA_CHECKED(tsuba::Close(src_handle));
+  KATANA_CHECKED(tsuba::Close(dst_handle));
+  return katana::ResultSuccess();
+}
+
+/// When a file cannot be copied, CopyRDG fails without writing a manifest,
+/// so the partial copy cannot be opened. With a single worker, no file after
+/// the failed one is copied.
+katana::Result<void>
+TestFailedCopyRDG(const std::string& src_dir, const katana::Uri& dir) {
+  std::string dst_dir = dir.Join("failed-copy").string();
+  auto src_dst_files =
+      KATANA_CHECKED(tsuba::CreateSrcDestFromViewsForCopy(src_dir, dst_dir, 1));
+  src_dst_files.emplace(
+      src_dst_files.begin(), dir.Join("no-such-file"),
+      dir.Join("failed-copy").Join("no-such-file"));
+
+  if (tsuba::CopyRDG(src_dst_files, 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "copying a missing file should fail");
+  }
+  for (const auto& [src, dst] : src_dst_files) {
+    if (fs::exists(dst.path())) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "{} copied after a failed copy", dst);
+    }
+  }
+
+  if (tsuba::CopyRDG(src_dst_files, 2)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "copying a missing file should fail");
+  }
+  for (const auto& [src, dst] : src_dst_files) {
+    if (tsuba::RDGManifest::IsManifestUri(src) && fs::exists(dst.path())) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "manifest {} written by a failed copy", dst);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const std::string& src_dir, const katana::Uri& dir) {
+  KATANA_CHECKED_CONTEXT(TestCopyRange(dir), "TestCopyRange");
+  KATANA_CHECKED_CONTEXT(TestCopyRDG(src_dir, dir), "TestCopyRDG");
+  KATANA_CHECKED_CONTEXT(TestFailedCopyRDG(src_dir, dir), "TestFailedCopyRDG");
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("copy-rdg <rdg dir>");
+  }
+
+  auto dir_res = katana::Uri::MakeRand("/tmp/copy-rdg");
+  KATANA_LOG_ASSERT(dir_res);
+  katana::Uri dir = std::move(dir_res.value());
+  fs::create_directories(dir.path());
+
+  auto res = TestAll(argv[1], dir);
+  fs::remove_all(dir.path());
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+
+  return 0;
+}
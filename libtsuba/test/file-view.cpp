@@ -0,0 +1,476 @@
+#include "tsuba/FileView.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/io/interfaces.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/Errors.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+// FileView fetches files in 1 MiB pages and keeps one bit per page in blocks
+// of 64 pages
+constexpr uint64_t kPageSize = UINT64_C(1) << 20;
+// spans three bitmap blocks and ends with a partial page
+constexpr uint64_t kNumPages = 131;
+constexpr uint64_t kFileSize = (kNumPages - 1) * kPageSize + 4321;
+
+/// Write a sparse file whose pages start with their page number
+katana::Result<void>
+MakeFile(const std::string& path) {
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "creating {}", path);
+  }
+  if (ftruncate(fd, kFileSize) != 0) {
+    auto err = katana::ResultErrno();
+    close(fd);
+    return KATANA_ERROR(err, "sizing {}", path);
+  }
+  for (uint64_t page = 0; page < kNumPages; ++page) {
+    ssize_t written = pwrite(fd, &page, sizeof(page), page * kPageSize);
+    if (written != static_cast<ssize_t>(sizeof(page))) {
+      auto err = katana::ResultErrno();
+      close(fd);
+      return KATANA_ERROR(err, "writing page {}", page);
+    }
+  }
+  if (close(fd) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "closing {}", path);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+CheckResident(tsuba::FileView* fv, uint64_t expected) {
+  if (uint64_t resident = fv->resident_pages(); resident != expected) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} pages resident, expected {}", resident, expected);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+CheckFetched(const tsuba::FileView& fv, uint64_t expected) {
+  if (uint64_t fetched = fv.prefetch_stats().fetched_pages;
+      fetched != expected) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "{} pages fetched, expected {}",
+        fetched, expected);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+CheckPages(const tsuba::FileView& fv, uint64_t first, uint64_t last) {
+  for (uint64_t page = first; page <= last; ++page) {
+    if (*fv.ptr<uint64_t>(page * kPageSize) != page) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed, "page {} has the wrong contents",
+          page);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Fill fetches the missing pages of ranges inside and across bitmap blocks,
+/// and nothing past a range that ends on a page boundary
+katana::Result<void>
+TestFill(const std::string& path) {
+  tsuba::FileView fv;
+  KATANA_CHECKED(fv.Bind(path, UINT64_C(0), false));
+  KATANA_LOG_ASSERT(fv.page_size() == kPageSize);
+  KATANA_CHECKED(CheckResident(&fv, 0));
+
+  // inside a block
+  KATANA_CHECKED(fv.Fill(3 * kPageSize, 6 * kPageSize, true));
+  KATANA_CHECKED(CheckResident(&fv, 3));
+  KATANA_CHECKED(CheckPages(fv, 3, 5));
+
+  // missing pages on both sides of filled ones, which are not fetched again
+  KATANA_CHECKED(fv.Fill(2 * kPageSize + 1, 7 * kPageSize - 1, true));
+  KATANA_CHECKED(CheckResident(&fv, 5));
+  KATANA_CHECKED(CheckFetched(fv, 5));
+  KATANA_CHECKED(CheckPages(fv, 2, 6));
+
+  // across the first block boundary
+  KATANA_CHECKED(fv.Fill(60 * kPageSize, 70 * kPageSize, true));
+  KATANA_CHECKED(CheckResident(&fv, 15));
+  KATANA_CHECKED(CheckPages(fv, 60, 69));
+
+  // already filled, across a block boundary
+  KATANA_CHECKED(fv.Fill(62 * kPageSize, 66 * kPageSize, true));
+  KATANA_CHECKED(CheckResident(&fv, 15));
+
+  // filled pages at the start, then missing pages through a whole block into
+  // the first page of the next one
+  KATANA_CHECKED(fv.Fill(63 * kPageSize, 129 * kPageSize, true));
+  KATANA_CHECKED(CheckResident(&fv, 74));
+  KATANA_CHECKED(CheckFetched(fv, 74));
+  KATANA_CHECKED(CheckPages(fv, 63, 128));
+
+  // ends exactly on a page boundary
+  KATANA_CHECKED(fv.Fill(8 * kPageSize, 10 * kPageSize, true));
+  KATANA_CHECKED(CheckResident(&fv, 76));
+  KATANA_CHECKED(CheckPages(fv, 8, 9));
+
+  // a hole across a block boundary
+  KATANA_CHECKED(fv.Release(62 * kPageSize, 66 * kPageSize));
+  KATANA_CHECKED(CheckResident(&fv, 72));
+
+  KATANA_CHECKED(fv.Fill(0, kFileSize, true));
+  KATANA_CHECKED(CheckResident(&fv, kNumPages));
+  KATANA_CHECKED(CheckFetched(fv, kNumPages + 4));
+  KATANA_CHECKED(CheckPages(fv, 0, kNumPages - 1));
+
+  KATANA_CHECKED(fv.Unbind());
+  return katana::ResultSuccess();
+}
+
+/// Read one page at each of pages and check the prefetching counters
+katana::Result<void>
+TestReads(
+    const std::string& path, const std::vector<uint64_t>& pages,
+    uint64_t expected_misses, bool expect_prefetch) {
+  tsuba::FileView fv;
+  KATANA_CHECKED(fv.Bind(path, UINT64_C(0), false));
+
+  for (uint64_t page : pages) {
+    auto res = fv.ReadAt(page * kPageSize, kPageSize);
+    if (!res.ok()) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::ArrowError, "reading page {}: {}", page,
+          res.status());
+    }
+    if (*reinterpret_cast<const uint64_t*>(res.ValueOrDie()->data()) != page) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed, "page {} has the wrong contents",
+          page);
+    }
+  }
+
+  const auto& stats = fv.prefetch_stats();
+  if (stats.misses != expected_misses ||
+      stats.hits != pages.size() - expected_misses) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} hits and {} misses, expected {} misses of {} reads", stats.hits,
+        stats.misses, expected_misses, pages.size());
+  }
+  if ((stats.prefetched_pages > 0) != expect_prefetch) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "{} pages prefetched",
+        stats.prefetched_pages);
+  }
+  if (stats.wasted_pages != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} pages wasted before unbinding", stats.wasted_pages);
+  }
+
+  // prefetched pages that were never read are wasted
+  uint64_t unread = fv.resident_pages() - pages.size();
+  KATANA_CHECKED(fv.Unbind());
+  if (stats.wasted_pages != unread) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} pages wasted, expected {}", stats.wasted_pages, unread);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestPrefetch(const std::string& path) {
+  // The first read of a stream misses, and so does the read that confirms
+  // the stream; for strided streams, so does the read that confirms the
+  // stride. Later reads find their pages prefetched.
+  std::vector<uint64_t> sequential;
+  std::vector<uint64_t> strided;
+  for (uint64_t i = 0; i < 16; ++i) {
+    sequential.emplace_back(i);
+    strided.emplace_back(5 * i);
+  }
+  KATANA_CHECKED_CONTEXT(TestReads(path, sequential, 2, true), "sequential");
+  KATANA_CHECKED_CONTEXT(TestReads(path, strided, 3, true), "strided");
+
+  // no two consecutive reads are adjacent or share a stride
+  std::vector<uint64_t> random{17, 3, 29, 8, 41, 0, 35, 12, 100, 64, 127};
+  KATANA_CHECKED_CONTEXT(
+      TestReads(path, random, random.size(), false), "random");
+  return katana::ResultSuccess();
+}
+
+/// Strided streams of tiny reads prefetch at most 16 strides ahead, and
+/// streams of reads larger than the readahead limit prefetch nothing
+katana::Result<void>
+TestStridedReadahead(const std::string& path) {
+  constexpr uint64_t kMaxStrides = 16;
+  constexpr uint64_t kNumReads = 10;
+
+  tsuba::FileView fv;
+  KATANA_CHECKED(fv.Bind(path, UINT64_C(0), false));
+  for (uint64_t i = 0; i < kNumReads; ++i) {
+    auto res = fv.ReadAt(3 * i * kPageSize, 64);
+    if (!res.ok()) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::ArrowError, "reading stride {}: {}", i,
+          res.status());
+    }
+  }
+  if (fv.resident_pages() > kNumReads + kMaxStrides) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} pages resident after {} strided reads", fv.resident_pages(),
+        kNumReads);
+  }
+  KATANA_CHECKED(fv.Unbind());
+
+  // reads of 65 pages, 1 page apart
+  constexpr int64_t kLargeRead = 65 * kPageSize;
+  KATANA_CHECKED(fv.Bind(path, UINT64_C(0), false));
+  for (uint64_t i = 0; i < 3; ++i) {
+    auto res = fv.ReadAt(i * kPageSize, kLargeRead);
+    if (!res.ok()) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::ArrowError, "reading stride {}: {}", i,
+          res.status());
+    }
+  }
+  if (fv.prefetch_stats().prefetched_pages != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} pages prefetched ahead of large reads",
+        fv.prefetch_stats().prefetched_pages);
+  }
+  KATANA_CHECKED(fv.Unbind());
+  return katana::ResultSuccess();
+}
+
+/// Reads that end exactly on a page boundary fetch only their own pages
+katana::Result<void>
+TestPageBoundary(const std::string& path) {
+  tsuba::FileView fv;
+  KATANA_CHECKED(fv.Bind(path, UINT64_C(0), false));
+
+  auto res = fv.ReadAt(kPageSize - 8, 8);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "reading: {}", res.status());
+  }
+  KATANA_CHECKED(CheckResident(&fv, 1));
+
+  KATANA_CHECKED(fv.Unbind());
+  KATANA_CHECKED(fv.Bind(path, 2 * kPageSize, 4 * kPageSize, true));
+  KATANA_CHECKED(CheckResident(&fv, 2));
+
+  // the partial last page is released with a range that ends at the file size
+  KATANA_CHECKED(fv.Fill(kFileSize - 1, kFileSize, true));
+  KATANA_CHECKED(CheckResident(&fv, 3));
+  KATANA_CHECKED(fv.Release((kNumPages - 1) * kPageSize, kFileSize));
+  KATANA_CHECKED(CheckResident(&fv, 2));
+  KATANA_CHECKED(fv.Release(2 * kPageSize, 3 * kPageSize));
+  KATANA_CHECKED(CheckResident(&fv, 1));
+  KATANA_CHECKED(CheckPages(fv, 3, 3));
+  return katana::ResultSuccess();
+}
+
+/// Read random ranges of data from fv, with ReadAt if async is false and
+/// with ReadAsync otherwise
+katana::Result<void>
+ReadRandomRanges(
+    tsuba::FileView* fv, const std::string& data, uint64_t seed, bool async) {
+  constexpr int kNumReads = 256;
+  constexpr int kBatchSize = 8;
+
+  std::mt19937_64 gen(seed);
+  std::uniform_int_distribution<int64_t> position_dist(0, data.size());
+  std::uniform_int_distribution<int64_t> size_dist(0, 2 * kPageSize);
+  std::vector<char> buf(2 * kPageSize);
+
+  for (int i = 0; i < kNumReads; i += kBatchSize) {
+    std::vector<std::pair<int64_t, int64_t>> ranges;
+    std::vector<arrow::Future<std::shared_ptr<arrow::Buffer>>> futures;
+    for (int j = 0; j < kBatchSize; ++j) {
+      int64_t position = position_dist(gen);
+      int64_t nbytes = size_dist(gen);
+      ranges.emplace_back(position, nbytes);
+      if (async) {
+        futures.emplace_back(fv->ReadAsync(
+            arrow::io::default_io_context(), position, nbytes));
+      }
+    }
+
+    for (int j = 0; j < kBatchSize; ++j) {
+      auto [position, nbytes] = ranges[j];
+      const char* out = buf.data();
+      int64_t read = 0;
+      if (async) {
+        const auto& res = futures[j].result();
+        if (!res.ok()) {
+          return KATANA_ERROR(
+              tsuba::ErrorCode::ArrowError, "ReadAsync {} at {}: {}", nbytes,
+              position, res.status());
+        }
+        out = reinterpret_cast<const char*>(res.ValueOrDie()->data());
+        read = res.ValueOrDie()->size();
+      } else {
+        auto res = fv->ReadAt(position, nbytes, buf.data());
+        if (!res.ok()) {
+          return KATANA_ERROR(
+              tsuba::ErrorCode::ArrowError, "ReadAt {} at {}: {}", nbytes,
+              position, res.status());
+        }
+        read = res.ValueOrDie();
+      }
+
+      int64_t expected = std::min<int64_t>(nbytes, data.size() - position);
+      if (read != expected ||
+          std::memcmp(out, data.data() + position, read) != 0) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "read of {} at {} returned {} bytes that differ from the file",
+            nbytes, position, read);
+      }
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Read ranges of two pages every two pages, starting a quarter page after
+/// those of the previous thread, so that the reads of all threads overlap
+katana::Result<void>
+ReadInterleavedRanges(
+    tsuba::FileView* fv, const std::string& data, uint64_t thread) {
+  constexpr int64_t kReadSize = 2 * kPageSize;
+  std::vector<char> buf(kReadSize);
+  for (int64_t position = thread * kPageSize / 4;
+       position < static_cast<int64_t>(data.size()); position += kReadSize) {
+    auto res = fv->ReadAt(position, kReadSize, buf.data());
+    if (!res.ok()) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::ArrowError, "ReadAt {} at {}: {}", kReadSize,
+          position, res.status());
+    }
+    int64_t expected = std::min<int64_t>(kReadSize, data.size() - position);
+    if (res.ValueOrDie() != expected ||
+        std::memcmp(buf.data(), data.data() + position, expected) != 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "read at {} returned bytes that differ from the file", position);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Run read(thread) on num_threads threads at the same time
+template <typename ReadFn>
+katana::Result<void>
+RunThreads(uint64_t num_threads, const ReadFn& read) {
+  std::vector<std::future<katana::Result<void>>> threads;
+  for (uint64_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back(
+        std::async(std::launch::async, [&read, i]() { return read(i); }));
+  }
+  katana::Result<void> res = katana::ResultSuccess();
+  for (uint64_t i = 0; i < num_threads; ++i) {
+    // wait for every thread before the FileView goes away
+    if (auto thread_res = threads[i].get(); !thread_res && res) {
+      res = thread_res.error().WithContext("thread {}", i);
+    }
+  }
+  return res;
+}
+
+/// Threads reading overlapping ranges of one FileView at the same time all
+/// get the bytes of the file, and each page is fetched once
+katana::Result<void>
+TestConcurrentReads(const katana::Uri& dir) {
+  constexpr uint64_t kNumThreads = 8;
+
+  std::string data(8 * kPageSize + 789, '\0');
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>((i * 7919) >> 3);
+  }
+  std::string path = dir.Join("dense-file").path();
+  KATANA_CHECKED(tsuba::FileStore(path, data.data(), data.size()));
+
+  tsuba::FileView fv;
+  KATANA_CHECKED(fv.Bind(path, UINT64_C(0), false));
+
+  KATANA_CHECKED(RunThreads(kNumThreads, [&fv, &data](uint64_t i) {
+    return ReadRandomRanges(&fv, data, i, i % 2 == 1);
+  }));
+  KATANA_CHECKED(CheckFetched(fv, fv.resident_pages()));
+
+  // race for the same pages again, from an empty view each time
+  for (int round = 0; round < 4; ++round) {
+    KATANA_CHECKED(fv.Release(0, data.size()));
+    KATANA_CHECKED(CheckResident(&fv, 0));
+    uint64_t fetched = fv.prefetch_stats().fetched_pages;
+    KATANA_CHECKED(RunThreads(kNumThreads, [&fv, &data](uint64_t i) {
+      return ReadInterleavedRanges(&fv, data, i);
+    }));
+    KATANA_CHECKED_CONTEXT(
+        CheckFetched(fv, fetched + fv.resident_pages()), "round {}", round);
+  }
+
+  KATANA_CHECKED(fv.Unbind());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const katana::Uri& dir) {
+  std::string path = dir.Join("file").path();
+  KATANA_CHECKED(MakeFile(path));
+  KATANA_CHECKED_CONTEXT(TestFill(path), "TestFill");
+  KATANA_CHECKED_CONTEXT(TestPrefetch(path), "TestPrefetch");
+  KATANA_CHECKED_CONTEXT(
+      TestStridedReadahead(path), "TestStridedReadahead");
+  KATANA_CHECKED_CONTEXT(TestPageBoundary(path), "TestPageBoundary");
+  KATANA_CHECKED_CONTEXT(TestConcurrentReads(dir), "TestConcurrentReads");
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main() {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  auto dir_res = katana::Uri::MakeRand("/tmp/file-view");
+  KATANA_LOG_ASSERT(dir_res);
+  katana::Uri dir = std::move(dir_res.value());
+  fs::create_directories(dir.path());
+
+  auto res = TestAll(dir);
+  fs::remove_all(dir.path());
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+
+  return 0;
+}
@@ -0,0 +1,173 @@
+/// A fio-like benchmark of local storage: sequential writes, sequential reads
+/// and random reads with a given block size and number of outstanding
+/// asynchronous requests. Run with KATANA_LOCAL_STORAGE_QUEUE_DEPTH and
+/// KATANA_LOCAL_STORAGE_DIRECT_IO set to compare I/O pool configurations.
+
+#include <cstdlib>
+#include <deque>
+#include <future>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr uint64_t kFileSize = UINT64_C(64) << 20;
+
+std::string data_dir;
+std::string data_file;
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long block_size : {4L << 10, 64L << 10, 1L << 20, 8L << 20}) {
+    for (long outstanding : {1, 4, 16}) {
+      b->Args({block_size, outstanding});
+    }
+  }
+}
+
+/// Buffers aligned so that reads may use O_DIRECT.
+std::vector<uint8_t*>
+MakeBuffers(uint64_t block_size, uint64_t count) {
+  std::vector<uint8_t*> buffers;
+  for (uint64_t i = 0; i < count; ++i) {
+    void* buffer = std::aligned_alloc(4096, block_size);
+    KATANA_LOG_ASSERT(buffer);
+    buffers.emplace_back(static_cast<uint8_t*>(buffer));
+  }
+  return buffers;
+}
+
+void
+FreeBuffers(const std::vector<uint8_t*>& buffers) {
+  for (uint8_t* buffer : buffers) {
+    std::free(buffer);
+  }
+}
+
+void
+Wait(std::future<katana::CopyableResult<void>>* future) {
+  auto res = future->get();
+  KATANA_LOG_VASSERT(res, "request failed: {}", res.error());
+}
+
+/// Issue num_requests requests, keeping up to outstanding of them in flight;
+/// issue(i, buffer) starts the i-th request.
+template <typename IssueFn>
+void
+RunRequests(
+    const std::vector<uint8_t*>& buffers, uint64_t num_requests,
+    const IssueFn& issue) {
+  std::deque<std::future<katana::CopyableResult<void>>> in_flight;
+  for (uint64_t i = 0; i < num_requests; ++i) {
+    if (in_flight.size() == buffers.size()) {
+      Wait(&in_flight.front());
+      in_flight.pop_front();
+    }
+    in_flight.emplace_back(issue(i, buffers[i % buffers.size()]));
+  }
+  while (!in_flight.empty()) {
+    Wait(&in_flight.front());
+    in_flight.pop_front();
+  }
+}
+
+void
+SequentialWrite(benchmark::State& state) {
+  uint64_t block_size = state.range(0);
+  auto buffers = MakeBuffers(block_size, state.range(1));
+  uint64_t num_requests = kFileSize / block_size;
+  std::string dir = katana::Uri::JoinPath(data_dir, "write");
+
+  for (auto _ : state) {
+    RunRequests(buffers, num_requests, [&](uint64_t i, uint8_t* buffer) {
+      return tsuba::FileStoreAsync(
+          katana::Uri::JoinPath(dir, std::to_string(i % 64)), buffer,
+          block_size);
+    });
+  }
+
+  state.SetBytesProcessed(state.iterations() * num_requests * block_size);
+  FreeBuffers(buffers);
+  fs::remove_all(dir);
+}
+
+void
+SequentialRead(benchmark::State& state) {
+  uint64_t block_size = state.range(0);
+  auto buffers = MakeBuffers(block_size, state.range(1));
+  uint64_t num_requests = kFileSize / block_size;
+
+  for (auto _ : state) {
+    RunRequests(buffers, num_requests, [&](uint64_t i, uint8_t* buffer) {
+      return tsuba::FileGetAsync(data_file, buffer, i * block_size, block_size);
+    });
+  }
+
+  state.SetBytesProcessed(state.iterations() * num_requests * block_size);
+  FreeBuffers(buffers);
+}
+
+void
+RandomRead(benchmark::State& state) {
+  uint64_t block_size = state.range(0);
+  auto buffers = MakeBuffers(block_size, state.range(1));
+  uint64_t num_requests = kFileSize / block_size;
+
+  std::mt19937_64 gen(0);
+  std::uniform_int_distribution<uint64_t> block(0, num_requests - 1);
+  std::vector<uint64_t> offsets(num_requests);
+  for (auto& offset : offsets) {
+    offset = block(gen) * block_size;
+  }
+
+  for (auto _ : state) {
+    RunRequests(buffers, num_requests, [&](uint64_t i, uint8_t* buffer) {
+      return tsuba::FileGetAsync(data_file, buffer, offsets[i], block_size);
+    });
+  }
+
+  state.SetBytesProcessed(state.iterations() * num_requests * block_size);
+  FreeBuffers(buffers);
+}
+
+BENCHMARK(SequentialWrite)->Apply(MakeArguments)->UseRealTime();
+BENCHMARK(SequentialRead)->Apply(MakeArguments)->UseRealTime();
+BENCHMARK(RandomRead)->Apply(MakeArguments)->UseRealTime();
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  KATANA_LOG_ASSERT(tsuba::Init());
+
+  auto dir_res = katana::Uri::MakeRand("/tmp/local-storage-bench");
+  KATANA_LOG_ASSERT(dir_res);
+  data_dir = dir_res.value().path();
+  data_file = katana::Uri::JoinPath(data_dir, "data");
+
+  std::vector<uint8_t> data(kFileSize);
+  std::mt19937 gen(0);
+  for (auto& byte : data) {
+    byte = gen();
+  }
+  KATANA_LOG_ASSERT(tsuba::FileStore(data_file, data));
+
+  benchmark::RunSpecifiedBenchmarks();
+
+  fs::remove_all(data_dir);
+  KATANA_LOG_ASSERT(tsuba::Fini());
+  return 0;
+}
@@ -0,0 +1,171 @@
+/// Compare the size and load time of the properties of an RDG when they are
+/// stored with different ParquetWriter options.
+///
+/// Usage: parquet-writer-bench [benchmark flags] <rdg>
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/ParquetWriter.h"
+#include "tsuba/RDG.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+using WriteOpts = tsuba::ParquetWriter::WriteOpts;
+
+struct Property {
+  std::string name;
+  std::shared_ptr<arrow::ChunkedArray> array;
+};
+
+std::vector<Property> properties;
+std::string out_dir;
+
+std::vector<std::pair<std::string, WriteOpts>>
+MakeConfigs() {
+  std::vector<std::pair<std::string, WriteOpts>> configs;
+  configs.emplace_back("uncompressed", WriteOpts::Defaults());
+
+  WriteOpts snappy;
+  snappy.compression = arrow::Compression::SNAPPY;
+  configs.emplace_back("snappy", snappy);
+
+  WriteOpts lz4;
+  lz4.compression = arrow::Compression::LZ4;
+  configs.emplace_back("lz4", lz4);
+
+  for (int level : {1, 9}) {
+    WriteOpts zstd;
+    zstd.compression = arrow::Compression::ZSTD;
+    zstd.compression_level = level;
+    configs.emplace_back("zstd-" + std::to_string(level), zstd);
+  }
+
+  WriteOpts split;
+  split.compression = arrow::Compression::ZSTD;
+  split.compression_level = 1;
+  for (const auto& prop : properties) {
+    auto id = prop.array->type()->id();
+    if (id == arrow::Type::FLOAT || id == arrow::Type::DOUBLE) {
+      WriteOpts::ColumnOpts column;
+      column.use_dictionary = false;
+      column.encoding = parquet::Encoding::BYTE_STREAM_SPLIT;
+      split.column_opts.emplace(prop.name, column);
+    }
+  }
+  configs.emplace_back("zstd-1-byte-stream-split", split);
+
+  return configs;
+}
+
+/// Write every property to its own file under dir and return the total size
+/// of the files.
+uint64_t
+StoreProperties(const std::string& dir, const WriteOpts& opts) {
+  uint64_t total = 0;
+  for (const auto& prop : properties) {
+    auto writer = tsuba::ParquetWriter::Make(prop.array, prop.name, opts);
+    KATANA_LOG_VASSERT(writer, "making writer: {}", writer.error());
+    auto uri = katana::Uri::Make(katana::Uri::JoinPath(dir, prop.name));
+    KATANA_LOG_ASSERT(uri);
+    auto res = writer.value()->WriteToUri(uri.value());
+    KATANA_LOG_VASSERT(res, "writing {}: {}", prop.name, res.error());
+
+    tsuba::StatBuf stat;
+    KATANA_LOG_ASSERT(tsuba::FileStat(uri.value().string(), &stat));
+    total += stat.size;
+  }
+  return total;
+}
+
+void
+Store(benchmark::State& state, const std::string& name, const WriteOpts& opts) {
+  std::string dir = katana::Uri::JoinPath(out_dir, name);
+  uint64_t size = 0;
+  for (auto _ : state) {
+    size = StoreProperties(dir, opts);
+  }
+  state.counters["file_bytes"] = size;
+  state.SetBytesProcessed(state.iterations() * size);
+  fs::remove_all(dir);
+}
+
+void
+Load(benchmark::State& state, const std::string& name, const WriteOpts& opts) {
+  std::string dir = katana::Uri::JoinPath(out_dir, name);
+  uint64_t size = StoreProperties(dir, opts);
+
+  auto reader = tsuba::ParquetReader::Make();
+  KATANA_LOG_ASSERT(reader);
+  for (auto _ : state) {
+    for (const auto& prop : properties) {
+      auto uri = katana::Uri::Make(katana::Uri::JoinPath(dir, prop.name));
+      KATANA_LOG_ASSERT(uri);
+      auto table = reader.value()->ReadTable(uri.value());
+      KATANA_LOG_VASSERT(table, "reading {}: {}", prop.name, table.error());
+      benchmark::DoNotOptimize(table.value());
+    }
+  }
+  state.counters["file_bytes"] = size;
+  state.SetBytesProcessed(state.iterations() * size);
+  fs::remove_all(dir);
+}
+
+katana::Result<void>
+LoadProperties(const std::string& rdg_name) {
+  auto handle = KATANA_CHECKED(tsuba::Open(rdg_name, tsuba::kReadOnly));
+  auto rdg = KATANA_CHECKED(tsuba::RDG::Make(handle, tsuba::RDGLoadOptions()));
+  for (const auto& table : {rdg.node_properties(), rdg.edge_properties()}) {
+    for (int i = 0; i < table->num_columns(); ++i) {
+      properties.emplace_back(
+          Property{table->field(i)->name(), table->column(i)});
+    }
+  }
+  return tsuba::Close(handle);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (argc != 2) {
+    std::cerr << "usage: " << argv[0] << " [benchmark flags] <rdg>\n";
+    return 1;
+  }
+  KATANA_LOG_ASSERT(tsuba::Init());
+
+  auto load_res = LoadProperties(argv[1]);
+  KATANA_LOG_VASSERT(load_res, "loading {}: {}", argv[1], load_res.error());
+  auto dir_res = katana::Uri::MakeRand("/tmp/parquet-writer-bench");
+  KATANA_LOG_ASSERT(dir_res);
+  out_dir = dir_res.value().path();
+
+  for (const auto& [name, opts] : MakeConfigs()) {
+    benchmark::RegisterBenchmark(
+        ("Store/" + name).c_str(), Store, name, opts)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+    benchmark::RegisterBenchmark(("Load/" + name).c_str(), Load, name, opts)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+  }
+  benchmark::RunSpecifiedBenchmarks();
+
+  fs::remove_all(out_dir);
+  KATANA_LOG_ASSERT(tsuba::Fini());
+  return 0;
+}
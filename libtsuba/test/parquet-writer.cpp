@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+#include <parquet/file_reader.h>
+#include <parquet/types.h>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/Errors.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/ParquetWriter.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+using WriteOpts = tsuba::ParquetWriter::WriteOpts;
+
+constexpr int64_t kNumRows = 10000;
+
+template <typename BuilderType, typename ValueFn>
+std::shared_ptr<arrow::ChunkedArray>
+MakeColumn(const ValueFn& value, int64_t num_rows = kNumRows) {
+  BuilderType builder;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    KATANA_LOG_ASSERT(builder.Append(value(i)).ok());
+  }
+  auto array = builder.Finish();
+  KATANA_LOG_ASSERT(array.ok());
+  return std::make_shared<arrow::ChunkedArray>(array.ValueOrDie());
+}
+
+/// \returns a column of lists of up to three values of value(i)
+template <typename BuilderType, typename ValueFn>
+std::shared_ptr<arrow::ChunkedArray>
+MakeListColumn(const ValueFn& value, int64_t num_rows = kNumRows) {
+  auto value_builder = std::make_shared<BuilderType>();
+  arrow::ListBuilder builder(arrow::default_memory_pool(), value_builder);
+  for (int64_t i = 0; i < num_rows; ++i) {
+    KATANA_LOG_ASSERT(builder.Append().ok());
+    for (int64_t j = 0; j < i % 4; ++j) {
+      KATANA_LOG_ASSERT(value_builder->Append(value(i)).ok());
+    }
+  }
+  auto array = builder.Finish();
+  KATANA_LOG_ASSERT(array.ok());
+  return std::make_shared<arrow::ChunkedArray>(array.ValueOrDie());
+}
+
+/// Write array with opts, read it back and check that its only column chunk
+/// was written with compression and uses encoding.
+katana::Result<void>
+TestRoundTrip(
+    const katana::Uri& uri, const std::shared_ptr<arrow::ChunkedArray>& array,
+    const WriteOpts& opts, arrow::Compression::type compression,
+    parquet::Encoding::type encoding) {
+  auto writer = KATANA_CHECKED(tsuba::ParquetWriter::Make(array, "a", opts));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+
+  auto reader = KATANA_CHECKED(tsuba::ParquetReader::Make());
+  auto table = KATANA_CHECKED(reader->ReadTable(uri));
+  if (table->num_columns() != 1 || !table->column(0)->Equals(*array)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "{}: values differ", uri);
+  }
+
+  auto file_reader = parquet::ParquetFileReader::OpenFile(uri.path());
+  auto column = file_reader->metadata()->RowGroup(0)->ColumnChunk(0);
+  if (column->compression() != compression) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "{}: wrong codec", uri);
+  }
+  const auto& encodings = column->encodings();
+  if (std::find(encodings.begin(), encodings.end(), encoding) ==
+      encodings.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "{}: encoding {} not used", uri,
+        parquet::EncodingToString(encoding));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+CheckColumn(
+    const std::shared_ptr<arrow::Table>& table, int i,
+    const std::shared_ptr<arrow::ChunkedArray>& expected) {
+  if (i >= table->num_columns() || !table->column(i)->Equals(*expected)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "column {} differs", i);
+  }
+  return katana::ResultSuccess();
+}
+
+/// Reads of some columns or rows do not load the whole file up front, so
+/// they go through parquet pre-buffering and threaded decoding, which read
+/// column chunks of many row groups from the file at the same time
+katana::Result<void>
+TestPreBufferedRead(const katana::Uri& dir) {
+  // several row groups and a file of several FileView pages
+  constexpr int64_t kNumTableRows = 200000;
+  constexpr int kNumColumns = 4;
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int c = 0; c < kNumColumns; ++c) {
+    fields.emplace_back(arrow::field(std::to_string(c), arrow::float64()));
+    columns.emplace_back(MakeColumn<arrow::DoubleBuilder>(
+        [c](int64_t i) { return static_cast<double>(i * (c + 1)) * 0.5; },
+        kNumTableRows));
+  }
+  auto table = arrow::Table::Make(arrow::schema(fields), columns);
+
+  WriteOpts opts;
+  opts.max_row_group_length = 15000;
+  katana::Uri uri = dir.Join("pre-buffered");
+  auto writer = KATANA_CHECKED(tsuba::ParquetWriter::Make(table, opts));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+
+  auto reader = KATANA_CHECKED(tsuba::ParquetReader::Make());
+  auto some_columns = KATANA_CHECKED(reader->ReadTable(uri, {1, 3}));
+  KATANA_CHECKED_CONTEXT(CheckColumn(some_columns, 0, columns[1]), "columns");
+  KATANA_CHECKED_CONTEXT(CheckColumn(some_columns, 1, columns[3]), "columns");
+
+  for (int c = 0; c < kNumColumns; ++c) {
+    auto column = KATANA_CHECKED(reader->ReadColumn(uri, c));
+    KATANA_CHECKED_CONTEXT(CheckColumn(column, 0, columns[c]), "column");
+  }
+
+  // starts and ends inside row groups
+  tsuba::ParquetReader::ReadOpts slice_opts;
+  slice_opts.slice =
+      tsuba::ParquetReader::Slice{.offset = 12345, .length = 99999};
+  auto slice_reader = KATANA_CHECKED(tsuba::ParquetReader::Make(slice_opts));
+  auto rows = KATANA_CHECKED(slice_reader->ReadTable(uri));
+  for (int c = 0; c < kNumColumns; ++c) {
+    KATANA_CHECKED_CONTEXT(
+        CheckColumn(rows, c, columns[c]->Slice(12345, 99999)), "rows");
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const katana::Uri& dir) {
+  auto doubles = MakeColumn<arrow::DoubleBuilder>(
+      [](int64_t i) { return static_cast<double>(i) * 0.25; });
+  auto ints = MakeColumn<arrow::Int64Builder>(
+      [](int64_t i) { return (i * 7919) % 1000; });
+
+  WriteOpts zstd;
+  zstd.compression = arrow::Compression::ZSTD;
+  zstd.compression_level = 3;
+  KATANA_CHECKED_CONTEXT(
+      TestRoundTrip(
+          dir.Join("zstd"), ints, zstd, arrow::Compression::ZSTD,
+          parquet::Encoding::RLE_DICTIONARY),
+      "zstd");
+
+  WriteOpts split;
+  WriteOpts::ColumnOpts split_column;
+  split_column.use_dictionary = false;
+  split_column.encoding = parquet::Encoding::BYTE_STREAM_SPLIT;
+  split.column_opts.emplace("a", split_column);
+  KATANA_CHECKED_CONTEXT(
+      TestRoundTrip(
+          dir.Join("byte-stream-split"), doubles, split,
+          arrow::Compression::UNCOMPRESSED,
+          parquet::Encoding::BYTE_STREAM_SPLIT),
+      "byte stream split");
+
+  // dictionary encodings are chosen with use_dictionary
+  WriteOpts dictionary;
+  WriteOpts::ColumnOpts dictionary_column;
+  dictionary_column.encoding = parquet::Encoding::RLE_DICTIONARY;
+  dictionary.column_opts.emplace("a", dictionary_column);
+  auto dictionary_res = tsuba::ParquetWriter::Make(ints, "a", dictionary);
+  if (dictionary_res ||
+      dictionary_res.error() != tsuba::ErrorCode::InvalidArgument) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "dictionary encoding should be rejected");
+  }
+
+  // byte stream split only applies to floating point columns
+  auto split_ints_res = tsuba::ParquetWriter::Make(ints, "a", split);
+  if (split_ints_res ||
+      split_ints_res.error() != tsuba::ErrorCode::InvalidArgument) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "byte stream split on ints should be rejected");
+  }
+  // settings for other columns are not checked against this one
+  KATANA_CHECKED(tsuba::ParquetWriter::Make(ints, "b", split));
+
+  // settings of a nested column apply to its leaves
+  auto double_lists = MakeListColumn<arrow::DoubleBuilder>(
+      [](int64_t i) { return static_cast<double>(i) * 0.25; });
+  KATANA_CHECKED_CONTEXT(
+      TestRoundTrip(
+          dir.Join("byte-stream-split-list"), double_lists, split,
+          arrow::Compression::UNCOMPRESSED,
+          parquet::Encoding::BYTE_STREAM_SPLIT),
+      "byte stream split list");
+  WriteOpts split_leaf;
+  split_leaf.column_opts.emplace("a.list.item", split_column);
+  KATANA_CHECKED_CONTEXT(
+      TestRoundTrip(
+          dir.Join("byte-stream-split-leaf"), double_lists, split_leaf,
+          arrow::Compression::UNCOMPRESSED,
+          parquet::Encoding::BYTE_STREAM_SPLIT),
+      "byte stream split leaf");
+
+  auto int_lists =
+      MakeListColumn<arrow::Int64Builder>([](int64_t i) { return i; });
+  auto split_int_lists_res = tsuba::ParquetWriter::Make(int_lists, "a", split);
+  if (split_int_lists_res ||
+      split_int_lists_res.error() != tsuba::ErrorCode::InvalidArgument) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "byte stream split on lists of ints should be rejected");
+  }
+
+  KATANA_CHECKED_CONTEXT(TestPreBufferedRead(dir), "pre-buffered read");
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main() {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  auto dir_res = katana::Uri::MakeRand("/tmp/parquet-writer");
+  KATANA_LOG_ASSERT(dir_res);
+  katana::Uri dir = std::move(dir_res.value());
+  fs::create_directories(dir.path());
+
+  auto res = TestAll(dir);
+  fs::remove_all(dir.path());
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+
+  return 0;
+}
@@ -61,14 +61,25 @@ static cll::opt<BetweennessCentralityPlan::Algorithm> algo(
         clEnumValN(
             BetweennessCentralityPlan::kLevel, "Level",
             "Level parallel algorithm"),
-        // clEnumValN(BetweennessCentralityPlan::kAsynchronous, "Async", "Asynchronous"),
+        clEnumValN(
+            BetweennessCentralityPlan::kAsynchronous, "Async",
+            "Asynchronous algorithm"),
         clEnumValN(
             BetweennessCentralityPlan::kOuter, "Outer",
-            "Outer parallel algorithm")
+            "Outer parallel algorithm"),
+        clEnumValN(
+            BetweennessCentralityPlan::kBatched, "Batched",
+            "Multi-source algorithm with bit-parallel frontiers")
         // clEnumValN(BetweennessCentralityPlan::kAutoAlgo, "Auto", "Auto: choose among the algorithms automatically")
         ),
     cll::init(BetweennessCentralityPlan::kLevel));
 
+static cll::opt<unsigned int> batchSize(
+    "batchSize",
+    cll::desc("Number of sources traversed together by the Batched algorithm "
+              "(default 64, at most 64)"),
+    cll::init(BetweennessCentralityPlan::kDefaultBatchSize));
+
 static cll::opt<bool> thread_spin(
     "threadSpin",
     cll::desc("If enabled, threads busy-wait for work rather than use "
@@ -102,6 +113,9 @@ main(int argc, char** argv) {
 
   BetweennessCentralityPlan plan =
       BetweennessCentralityPlan::FromAlgorithm(algo);
+  if (algo == BetweennessCentralityPlan::kBatched) {
+    plan = BetweennessCentralityPlan::Batched(batchSize);
+  }
 
   BetweennessCentralitySources sources = kBetweennessCentralityAllNodes;
   uint32_t num_sources = pg->num_nodes();
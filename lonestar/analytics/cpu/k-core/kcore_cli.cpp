@@ -58,6 +58,12 @@ static cll::opt<uint32_t> kCoreNumber(
               "kCoreNumber value (default value 10)"),
     cll::init(10));
 
+static cll::opt<bool> decomposition(
+    "decomposition",
+    cll::desc("Compute the core number of every node instead of a single "
+              "k-core (default value false)"),
+    cll::init(false));
+
 std::string
 AlgorithmName(KCorePlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -70,6 +76,40 @@ AlgorithmName(KCorePlan::Algorithm algorithm) {
   }
 }
 
+void
+RunDecomposition(katana::PropertyGraph* pg) {
+  std::cout << "Running core decomposition\n";
+
+  if (auto r = KCoreDecomposition(pg, "core-number"); !r) {
+    KATANA_LOG_FATAL("Failed to compute core numbers: {}", r.error());
+  }
+
+  auto stats_result = KCoreDecompositionStatistics::Compute(pg, "core-number");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute core decomposition statistics: {}",
+        stats_result.error());
+  }
+  stats_result.value().Print();
+
+  if (!skipVerify) {
+    if (KCoreDecompositionAssertValid(pg, "core-number")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetNodePropertyTyped<uint32_t>("core-number");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+}
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -92,6 +132,12 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
             << pg->topology().num_edges() << " edges\n";
 
+  if (decomposition) {
+    RunDecomposition(pg.get());
+    total_timer.stop();
+    return 0;
+  }
+
   std::cout << "Running " << AlgorithmName(algo) << "\n";
 
   KCorePlan plan = KCorePlan();
@@ -0,0 +1,127 @@
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/analytics/k_shortest_paths/k_shortest_paths.h"
+
+using namespace katana::analytics;
+namespace cll = llvm::cl;
+
+static const char* name = "Single Source k Shortest Paths";
+static const char* desc =
+    "Computes the k shortest paths from a source node to a report node in a "
+    "directed graph";
+static const char* url = "k_shortest_paths";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+static cll::opt<unsigned int> startNode(
+    "startNode", cll::desc("Node to start search from (default value 0)"),
+    cll::init(0));
+static cll::opt<unsigned int> reportNode(
+    "reportNode", cll::desc("Node to report distance to (default value 0)"),
+    cll::init(0));
+static cll::opt<std::string> queriesFile(
+    "queriesFile",
+    cll::desc("File containing whitespace separated pairs of source and "
+              "report nodes to answer as one batch; if set, -startNode and "
+              "-reportNode are ignored"));
+static cll::opt<unsigned int> numPaths(
+    "numPaths",
+    cll::desc("Number of paths to compute from source to report node (default "
+              "value 1)"),
+    cll::init(1));
+
+static cll::opt<KShortestPathsPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm (default value Automatic):"),
+    cll::values(
+        clEnumValN(
+            KShortestPathsPlan::kAutomatic, "Automatic",
+            "Choose between ParallelQueries and ParallelSpurPaths by the "
+            "number of queries"),
+        clEnumValN(
+            KShortestPathsPlan::kParallelQueries, "ParallelQueries",
+            "Answer the queries in parallel"),
+        clEnumValN(
+            KShortestPathsPlan::kParallelSpurPaths, "ParallelSpurPaths",
+            "Answer the queries one after another")),
+    cll::init(KShortestPathsPlan::kAutomatic));
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer total_timer("TimerTotal");
+  total_timer.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
+            << pg->topology().num_edges() << " edges\n";
+
+  std::vector<KShortestPathsQuery> queries;
+  if (!queriesFile.getValue().empty()) {
+    std::ifstream file(queriesFile);
+    if (!file.good()) {
+      KATANA_LOG_FATAL("failed to open file: {}", queriesFile);
+    }
+    std::vector<uint32_t> nodes{
+        std::istream_iterator<uint32_t>{file},
+        std::istream_iterator<uint32_t>{}};
+    for (size_t i = 0; i + 1 < nodes.size(); i += 2) {
+      queries.push_back({nodes[i], nodes[i + 1]});
+    }
+  } else {
+    queries.push_back({startNode, reportNode});
+  }
+
+  KShortestPathsPlan plan;
+  switch (algo) {
+  case KShortestPathsPlan::kAutomatic:
+    plan = KShortestPathsPlan::Automatic();
+    break;
+  case KShortestPathsPlan::kParallelQueries:
+    plan = KShortestPathsPlan::ParallelQueries();
+    break;
+  case KShortestPathsPlan::kParallelSpurPaths:
+    plan = KShortestPathsPlan::ParallelSpurPaths();
+    break;
+  default:
+    KATANA_LOG_FATAL("Invalid algorithm");
+  }
+
+  std::cout << "Running " << queries.size() << " queries\n";
+  auto result =
+      KShortestPaths(pg.get(), edge_property_name, queries, numPaths, plan);
+  if (!result) {
+    KATANA_LOG_FATAL("Failed to compute k shortest paths: {}", result.error());
+  }
+  auto paths = std::move(result.value());
+
+  for (size_t q = 0; q < queries.size(); ++q) {
+    std::cout << "Node " << queries[q].target << " has these "
+              << paths[q].size() << " paths from " << queries[q].source
+              << ":\n";
+    for (const auto& path : paths[q]) {
+      path.Print();
+    }
+    if (!skipVerify) {
+      if (auto r = KShortestPathsAssertValid(
+              pg.get(), edge_property_name, queries[q], paths[q], false);
+          !r) {
+        KATANA_LOG_FATAL("verification failed: {}", r.error());
+      }
+    }
+  }
+  if (!skipVerify) {
+    std::cout << "Verification successful.\n";
+  }
+
+  total_timer.stop();
+
+  return 0;
+}
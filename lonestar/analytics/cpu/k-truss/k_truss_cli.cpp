@@ -53,6 +53,12 @@ static cll::opt<KTrussPlan::Algorithm> algo(
             "Compute k-1 core and then k-truss")),
     cll::init(KTrussPlan::kBsp));
 
+static cll::opt<bool> decomposition(
+    "decomposition",
+    cll::desc("Compute the trussness of every edge instead of a single "
+              "k-truss (default value false)"),
+    cll::init(false));
+
 std::string
 AlgorithmName(KTrussPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -67,6 +73,40 @@ AlgorithmName(KTrussPlan::Algorithm algorithm) {
   }
 }
 
+void
+RunDecomposition(katana::PropertyGraph* pg) {
+  std::cout << "Running truss decomposition\n";
+
+  if (auto r = KTrussDecomposition(pg, "trussness"); !r) {
+    KATANA_LOG_FATAL("Failed to compute trussness: {}", r.error());
+  }
+
+  auto stats_result = KTrussDecompositionStatistics::Compute(pg, "trussness");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute truss decomposition statistics: {}",
+        stats_result.error());
+  }
+  stats_result.value().Print();
+
+  if (!skipVerify) {
+    if (KTrussDecompositionAssertValid(pg, "trussness")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetEdgePropertyTyped<uint32_t>("trussness");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get edge property {}", r.error());
+    }
+    auto results = r.value();
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+}
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -82,7 +122,7 @@ main(int argc, char** argv) {
         " to indicate the input is a symmetric graph.");
   }
 
-  if (kTrussNumber < 2) {
+  if (!decomposition && kTrussNumber < 2) {
     KATANA_LOG_FATAL("kTrussNumber must be >= 2");
   }
 
@@ -93,6 +133,12 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
             << pg->topology().num_edges() << " edges\n";
 
+  if (decomposition) {
+    RunDecomposition(pg.get());
+    total_timer.stop();
+    return 0;
+  }
+
   std::cout << "Running " << AlgorithmName(algo) << "\n";
 
   KTrussPlan plan = KTrussPlan();
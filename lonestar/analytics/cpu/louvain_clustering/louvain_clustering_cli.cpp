@@ -67,7 +67,10 @@ static cll::opt<LouvainClusteringPlan::Algorithm> algo(
             "Use Katana do_all loop for conflict mitigation"),
         clEnumValN(
             LouvainClusteringPlan::kDeterministic, "Deterministic",
-            "Use Deterministic implementation")),
+            "Use Deterministic implementation"),
+        clEnumValN(
+            LouvainClusteringPlan::kLeiden, "Leiden",
+            "Use Leiden refinement for well connected communities")),
     cll::init(LouvainClusteringPlan::kDoAll));
 
 std::string
@@ -77,6 +80,8 @@ AlgorithmName(LouvainClusteringPlan::Algorithm algorithm) {
     return "DoAll";
   case LouvainClusteringPlan::kDeterministic:
     return "Deterministic";
+  case LouvainClusteringPlan::kLeiden:
+    return "Leiden";
   default:
     return "Unknown";
   }
@@ -118,6 +123,11 @@ main(int argc, char** argv) {
         enable_vf, modularity_threshold_per_round, modularity_threshold_total,
         max_iterations, min_graph_size);
     break;
+  case LouvainClusteringPlan::kLeiden:
+    plan = LouvainClusteringPlan::Leiden(
+        enable_vf, modularity_threshold_per_round, modularity_threshold_total,
+        max_iterations, min_graph_size);
+    break;
   default:
     KATANA_LOG_FATAL("invalid algorithm");
   }
@@ -69,6 +69,24 @@ static cll::opt<uint32_t> numberOfEdgeTypes(
     "numberOfEdgeTypes", cll::desc("Number of edge types (only for Edge2Vec)"),
     cll::init(1));
 
+static cll::opt<bool> weighted(
+    "weighted",
+    cll::desc("Sample the edges of each step in proportion to the edge "
+              "property named by -edgePropertyName (Default: false)"),
+    cll::init(false));
+
+static cll::opt<bool> outputParquet(
+    "outputParquet",
+    cll::desc("Stream walks to parquet files <outputFile>.<batch> while they "
+              "are generated instead of writing text at the end (Default: "
+              "false)"),
+    cll::init(false));
+
+static cll::opt<uint64_t> walksPerBatch(
+    "walksPerBatch",
+    cll::desc("Number of walks per parquet file with -outputParquet"),
+    cll::init(kDefaultRandomWalksPerBatch));
+
 std::string
 AlgorithmName(RandomWalksPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -83,15 +101,20 @@ AlgorithmName(RandomWalksPlan::Algorithm algorithm) {
 
 void
 PrintWalks(
-    const std::vector<std::vector<uint32_t>>& walks,
+    const std::shared_ptr<arrow::ChunkedArray>& walks,
     const std::string& output_file) {
   std::ofstream f(output_file);
 
-  for (auto walk : walks) {
-    for (auto node : walk) {
-      f << node << " ";
+  for (const auto& chunk : walks->chunks()) {
+    auto list = std::static_pointer_cast<arrow::ListArray>(chunk);
+    auto nodes = std::static_pointer_cast<arrow::UInt32Array>(list->values());
+    for (int64_t i = 0; i < list->length(); ++i) {
+      for (int32_t j = list->value_offset(i); j < list->value_offset(i + 1);
+           ++j) {
+        f << nodes->Value(j) << " ";
+      }
+      f << std::endl;
     }
-    f << std::endl;
   }
 }
 
@@ -134,7 +157,31 @@ main(int argc, char** argv) {
     KATANA_LOG_FATAL("Invalid algorithm");
   }
 
-  auto walks_result = RandomWalks(pg.get(), plan);
+  std::string edge_weight_property_name;
+  if (weighted) {
+    if (edge_property_name.empty()) {
+      KATANA_LOG_FATAL("-weighted requires -edgePropertyName");
+    }
+    edge_weight_property_name = edge_property_name;
+  }
+
+  if (outputParquet) {
+    std::string output_file = outputLocation + "/" + outputFile;
+    katana::gInfo("Writing random walks to parquet files: ", output_file);
+    auto uri_res = katana::Uri::Make(output_file);
+    if (!uri_res) {
+      KATANA_LOG_FATAL("Bad output location: {}", uri_res.error());
+    }
+    if (auto res = RandomWalksToParquet(
+            pg.get(), uri_res.value(), plan, edge_weight_property_name,
+            walksPerBatch);
+        !res) {
+      KATANA_LOG_FATAL("Failed to run RandomWalks: {}", res.error());
+    }
+    return 0;
+  }
+
+  auto walks_result = RandomWalks(pg.get(), plan, edge_weight_property_name);
   if (!walks_result) {
     KATANA_LOG_FATAL("Failed to run RandomWalks: {}", walks_result.error());
   }
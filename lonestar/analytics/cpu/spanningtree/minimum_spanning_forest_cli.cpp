@@ -0,0 +1,112 @@
+#include <iostream>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+using namespace katana::analytics;
+namespace cll = llvm::cl;
+
+static const char* name = "Minimum Spanning Forest";
+static const char* desc = "Computes the minimum spanning forest of a graph";
+static const char* url = "mst";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<MinimumSpanningForestPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm (default value Boruvka):"),
+    cll::values(
+        clEnumValN(
+            MinimumSpanningForestPlan::kBoruvka, "Boruvka",
+            "Parallel Boruvka with edge filtering"),
+        clEnumValN(
+            MinimumSpanningForestPlan::kFilterKruskal, "FilterKruskal",
+            "Filter-Kruskal, for dense graphs")),
+    cll::init(MinimumSpanningForestPlan::kBoruvka));
+
+static cll::opt<uint32_t> baseCaseSize(
+    "baseCaseSize",
+    cll::desc("Number of edges below which FilterKruskal sorts instead of "
+              "partitioning (default value 16384)"),
+    cll::init(MinimumSpanningForestPlan::kDefaultBaseCaseSize));
+
+std::string
+AlgorithmName(MinimumSpanningForestPlan::Algorithm algorithm) {
+  switch (algorithm) {
+  case MinimumSpanningForestPlan::kBoruvka:
+    return "Boruvka";
+  case MinimumSpanningForestPlan::kFilterKruskal:
+    return "FilterKruskal";
+  default:
+    return "Unknown";
+  }
+}
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer total_timer("TimerTotal");
+  total_timer.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
+            << pg->topology().num_edges() << " edges\n";
+
+  std::cout << "Running " << AlgorithmName(algo) << " algorithm\n";
+
+  MinimumSpanningForestPlan plan;
+  switch (algo) {
+  case MinimumSpanningForestPlan::kBoruvka:
+    plan = MinimumSpanningForestPlan::Boruvka();
+    break;
+  case MinimumSpanningForestPlan::kFilterKruskal:
+    plan = MinimumSpanningForestPlan::FilterKruskal(baseCaseSize);
+    break;
+  default:
+    KATANA_LOG_FATAL("Invalid algorithm");
+  }
+
+  if (auto r = MinimumSpanningForest(
+          pg.get(), edge_property_name, "forest-edge", plan);
+      !r) {
+    KATANA_LOG_FATAL(
+        "Failed to compute minimum spanning forest: {}", r.error());
+  }
+
+  auto stats_result = MinimumSpanningForestStatistics::Compute(
+      pg.get(), edge_property_name, "forest-edge");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute minimum spanning forest statistics: {}",
+        stats_result.error());
+  }
+  stats_result.value().Print();
+
+  if (!skipVerify) {
+    if (auto r = MinimumSpanningForestAssertValid(
+            pg.get(), edge_property_name, "forest-edge");
+        r) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed: {}", r.error());
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetEdgePropertyTyped<uint8_t>("forest-edge");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get edge property {}", r.error());
+    }
+    auto results = r.value();
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  total_timer.stop();
+
+  return 0;
+}
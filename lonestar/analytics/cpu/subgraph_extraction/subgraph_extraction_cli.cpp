@@ -45,10 +45,19 @@ static cll::opt<std::string> nodesString(
     cll::init(""));
 static cll::opt<SubGraphExtractionPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm:"),
-    cll::values(clEnumValN(
-        SubGraphExtractionPlan::kNodeSet, "nodeSet",
-        "Extract subgraph topology from node set")),
+    cll::values(
+        clEnumValN(
+            SubGraphExtractionPlan::kNodeSet, "nodeSet",
+            "Extract subgraph topology from node set"),
+        clEnumValN(
+            SubGraphExtractionPlan::kKHop, "kHop",
+            "Extract subgraph topology within numHops of the node set")),
     cll::init(SubGraphExtractionPlan::kNodeSet));
+static cll::opt<uint32_t> numHops(
+    "numHops",
+    cll::desc("Number of out-going hops from the node set for kHop "
+              "(default value 1)"),
+    cll::init(SubGraphExtractionPlan::kDefaultNumHops));
 
 int
 main(int argc, char** argv) {
@@ -63,6 +72,16 @@ main(int argc, char** argv) {
       MakeFileGraph(inputFile, edge_property_name);
 
   SubGraphExtractionPlan plan;
+  switch (algo) {
+  case SubGraphExtractionPlan::kNodeSet:
+    plan = SubGraphExtractionPlan::NodeSet();
+    break;
+  case SubGraphExtractionPlan::kKHop:
+    plan = SubGraphExtractionPlan::KHop(numHops);
+    break;
+  default:
+    std::cerr << "Unknown algo: " << algo << "\n";
+  }
 
   std::vector<uint32_t> node_vec;
   if (!nodesFile.getValue().empty()) {
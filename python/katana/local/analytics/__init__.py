@@ -34,6 +34,8 @@ Algorithms
 
 .. automodule:: katana.local.analytics._local_clustering_coefficient
 
+.. automodule:: katana.local.analytics._minimum_spanning_forest
+
 .. automodule:: katana.local.analytics._subgraph_extraction
 
 .. automodule:: katana.local.analytics._jaccard
@@ -65,6 +67,7 @@ from katana.local.analytics._connected_components import (
     ConnectedComponentsStatistics,
     connected_components,
     connected_components_assert_valid,
+    connected_components_incremental,
 )
 from katana.local.analytics._independent_set import (
     IndependentSetPlan,
@@ -85,6 +88,12 @@ from katana.local.analytics._louvain_clustering import (
     louvain_clustering,
     louvain_clustering_assert_valid,
 )
+from katana.local.analytics._minimum_spanning_forest import (
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
+)
 from katana.local.analytics._pagerank import PagerankPlan, PagerankStatistics, pagerank, pagerank_assert_valid
 from katana.local.analytics._sssp import SsspPlan, SsspStatistics, sssp, sssp_assert_valid
 from katana.local.analytics._subgraph_extraction import SubGraphExtractionPlan, subgraph_extraction
@@ -39,8 +39,11 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         enum Algorithm:
             kOuter "katana::analytics::BetweennessCentralityPlan::kOuter"
             kLevel "katana::analytics::BetweennessCentralityPlan::kLevel"
+            kAsynchronous "katana::analytics::BetweennessCentralityPlan::kAsynchronous"
+            kBatched "katana::analytics::BetweennessCentralityPlan::kBatched"
 
         _BetweennessCentralityPlan.Algorithm algorithm() const
+        uint32_t batch_size() const
 
         BetweennessCentralityPlan()
 
@@ -49,8 +52,14 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         @staticmethod
         _BetweennessCentralityPlan Outer()
         @staticmethod
+        _BetweennessCentralityPlan Asynchronous()
+        @staticmethod
+        _BetweennessCentralityPlan Batched(uint32_t batch_size)
+        @staticmethod
         _BetweennessCentralityPlan FromAlgorithm(_BetweennessCentralityPlan.Algorithm algo)
 
+    uint32_t kDefaultBatchSize "katana::analytics::BetweennessCentralityPlan::kDefaultBatchSize"
+
     BetweennessCentralitySources kBetweennessCentralityAllNodes;
 
     Result[void] BetweennessCentrality(_PropertyGraph* pg, string output_property_name, const BetweennessCentralitySources& sources, _BetweennessCentralityPlan plan)
@@ -87,6 +96,8 @@ class _BetweennessCentralityAlgorithm(Enum):
     """
     Outer = _BetweennessCentralityPlan.Algorithm.kOuter
     Level = _BetweennessCentralityPlan.Algorithm.kLevel
+    Asynchronous = _BetweennessCentralityPlan.Algorithm.kAsynchronous
+    Batched = _BetweennessCentralityPlan.Algorithm.kBatched
 
 
 cdef class BetweennessCentralityPlan(Plan):
@@ -113,6 +124,10 @@ cdef class BetweennessCentralityPlan(Plan):
     def algorithm(self) -> _BetweennessCentralityAlgorithm:
         return _BetweennessCentralityAlgorithm(self.underlying_.algorithm())
 
+    @property
+    def batch_size(self) -> int:
+        return self.underlying_.batch_size()
+
     @staticmethod
     def outer():
         """
@@ -127,6 +142,22 @@ cdef class BetweennessCentralityPlan(Plan):
         """
         return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Level())
 
+    @staticmethod
+    def asynchronous():
+        """
+        Process one source at a time without level barriers; suits high-diameter graphs.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Asynchronous())
+
+    @staticmethod
+    def batched(batch_size=kDefaultBatchSize):
+        """
+        Traverse from up to 64 sources at once using bit-parallel frontiers; suits many sampled sources.
+
+        :param batch_size: The number of sources per traversal, at most 64.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Batched(batch_size))
+
 
 def betweenness_centrality(Graph pg, str output_property_name, sources = None,
              BetweennessCentralityPlan plan = BetweennessCentralityPlan()):
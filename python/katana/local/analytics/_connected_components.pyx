@@ -19,6 +19,8 @@ Connected Components
 
 .. autofunction:: katana.local.analytics.connected_components
 
+.. autofunction:: katana.local.analytics.connected_components_incremental
+
 .. autoclass:: katana.local.analytics.ConnectedComponentsStatistics
     :members:
     :undoc-members:
@@ -26,6 +28,8 @@ Connected Components
 from libc.stddef cimport ptrdiff_t
 from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
+from libcpp.utility cimport pair
+from libcpp.vector cimport vector
 
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
@@ -95,6 +99,9 @@ cdef extern from "katana/analytics/connected_components/connected_components.h"
     Result[void] ConnectedComponents(_PropertyGraph*pg, string output_property_name,
                                      _ConnectedComponentsPlan plan)
 
+    Result[void] ConnectedComponentsIncremental(_PropertyGraph*pg, string property_name,
+                                                const vector[pair[uint32_t, uint32_t]]& new_edges)
+
     Result[void] ConnectedComponentsAssertValid(_PropertyGraph*pg, string output_property_name)
 
     cppclass _ConnectedComponentsStatistics "katana::analytics::ConnectedComponentsStatistics":
@@ -280,6 +287,26 @@ def connected_components(Graph pg, str output_property_name,
         v = handle_result_void(ConnectedComponents(pg.underlying_property_graph(), output_property_name_str, plan.underlying_))
     return v
 
+def connected_components_incremental(Graph pg, str property_name, new_edges):
+    """
+    Update the components in `property_name`, computed by :py:func:`connected_components`, to account for new
+    undirected edges between existing nodes of `pg`. Only the labels of the components joined by the new edges are
+    merged, and their nodes are relabeled by one scan of the labels, so an update takes time proportional to the batch
+    plus a scan of the nodes. Neither the new edges nor those of earlier updates need be in `pg`.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph whose components are in `property_name`.
+    :type property_name: str
+    :param property_name: The existing component property to update in place.
+    :type new_edges: Iterable[Tuple[int, int]]
+    :param new_edges: Pairs of source and destination node IDs.
+    """
+    cdef string property_name_str = property_name.encode("utf-8")
+    cdef vector[pair[uint32_t, uint32_t]] c_new_edges = [(int(src), int(dest)) for src, dest in new_edges]
+    with nogil:
+        handle_result_void(ConnectedComponentsIncremental(pg.underlying_property_graph(), property_name_str,
+                                                          c_new_edges))
+
 def connected_components_assert_valid(Graph pg, str output_property_name):
     """
     Raise an exception if the Connected Components results in `pg` with the given parameters appear to be incorrect.
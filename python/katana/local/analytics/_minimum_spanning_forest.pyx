@@ -0,0 +1,252 @@
+"""
+Minimum Spanning Forest
+-----------------------
+
+.. autoclass:: katana.local.analytics.MinimumSpanningForestPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._minimum_spanning_forest._MinimumSpanningForestAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.minimum_spanning_forest
+
+.. autoclass:: katana.local.analytics.MinimumSpanningForestStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.minimum_spanning_forest_assert_valid
+"""
+from enum import Enum
+
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+
+
+cdef extern from "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h" namespace "katana::analytics" nogil:
+    cppclass _MinimumSpanningForestPlan "katana::analytics::MinimumSpanningForestPlan" (_Plan):
+        enum Algorithm:
+            kBoruvka "katana::analytics::MinimumSpanningForestPlan::kBoruvka"
+            kFilterKruskal "katana::analytics::MinimumSpanningForestPlan::kFilterKruskal"
+
+        _MinimumSpanningForestPlan()
+        _MinimumSpanningForestPlan(const _PropertyGraph * pg)
+
+        _MinimumSpanningForestPlan.Algorithm algorithm() const
+        uint32_t base_case_size() const
+
+        @staticmethod
+        _MinimumSpanningForestPlan Boruvka()
+        @staticmethod
+        _MinimumSpanningForestPlan FilterKruskal(uint32_t base_case_size)
+
+    uint32_t kDefaultBaseCaseSize "katana::analytics::MinimumSpanningForestPlan::kDefaultBaseCaseSize"
+
+    Result[void] MinimumSpanningForest(_PropertyGraph* pg, const string& edge_weight_property_name,
+                                       const string& output_property_name, _MinimumSpanningForestPlan plan)
+
+    Result[void] MinimumSpanningForestAssertValid(_PropertyGraph* pg, const string& edge_weight_property_name,
+                                                  const string& output_property_name)
+
+    cppclass _MinimumSpanningForestStatistics "katana::analytics::MinimumSpanningForestStatistics":
+        double total_weight
+        uint64_t num_forest_edges
+        uint64_t num_trees
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MinimumSpanningForestStatistics] Compute(_PropertyGraph* pg, const string& edge_weight_property_name,
+                                                         const string& output_property_name)
+
+
+class _MinimumSpanningForestAlgorithm(Enum):
+    """
+    The concrete algorithms available for minimum spanning forest.
+
+    :see: :py:class:`~katana.local.analytics.MinimumSpanningForestPlan` constructors for algorithm documentation.
+    """
+    Boruvka = _MinimumSpanningForestPlan.Algorithm.kBoruvka
+    FilterKruskal = _MinimumSpanningForestPlan.Algorithm.kFilterKruskal
+
+
+cdef class MinimumSpanningForestPlan(Plan):
+    """
+    A computational :ref:`Plan` for minimum spanning forest.
+
+    Static methods construct MinimumSpanningForestPlans using specific algorithms with their required parameters. All
+    parameters are optional and have reasonable defaults.
+    """
+    cdef:
+        _MinimumSpanningForestPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MinimumSpanningForestAlgorithm
+
+    @staticmethod
+    cdef MinimumSpanningForestPlan make(_MinimumSpanningForestPlan u):
+        f = <MinimumSpanningForestPlan>MinimumSpanningForestPlan.__new__(MinimumSpanningForestPlan)
+        f.underlying_ = u
+        return f
+
+    def __init__(self, graph: Graph = None):
+        """
+        Choose filter-Kruskal if `graph` is dense and Boruvka otherwise, or Boruvka if no graph is given.
+        """
+        if graph is None:
+            self.underlying_ = _MinimumSpanningForestPlan()
+        else:
+            if not isinstance(graph, Graph):
+                raise TypeError(graph)
+            self.underlying_ = _MinimumSpanningForestPlan((<Graph>graph).underlying_property_graph())
+
+    @property
+    def algorithm(self) -> _MinimumSpanningForestAlgorithm:
+        """
+        The selected algorithm.
+        """
+        return _MinimumSpanningForestAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def base_case_size(self) -> int:
+        """
+        The number of edges below which filter-Kruskal sorts edges instead of partitioning them.
+        """
+        return self.underlying_.base_case_size()
+
+    @staticmethod
+    def boruvka() -> MinimumSpanningForestPlan:
+        """
+        Parallel Boruvka. Each round, every component picks its lightest edge to another component. Edges inside a
+        component are filtered out as they are found.
+        """
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.Boruvka())
+
+    @staticmethod
+    def filter_kruskal(uint32_t base_case_size = kDefaultBaseCaseSize) -> MinimumSpanningForestPlan:
+        """
+        Filter-Kruskal: partition the edges around a pivot weight, solve the light edges and drop the heavy edges
+        they made redundant before solving the rest. Best for dense graphs.
+        """
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.FilterKruskal(base_case_size))
+
+
+def minimum_spanning_forest(Graph pg, str edge_weight_property_name, str output_property_name,
+                            MinimumSpanningForestPlan plan = MinimumSpanningForestPlan()):
+    """
+    Compute a minimum spanning forest of `pg`, taking every edge as undirected. Ties are broken by edge ID, so every
+    plan finds the same forest.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The input property containing edge weights.
+    :type output_property_name: str
+    :param output_property_name: The output uint8 edge property, 1 for the forest edges and 0 otherwise. Only one
+        edge is marked per forest link. This property must not already exist.
+    :type plan: MinimumSpanningForestPlan
+    :param plan: The execution plan to use.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_input
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+        from katana.analytics import minimum_spanning_forest, MinimumSpanningForestStatistics
+        minimum_spanning_forest(graph, "value", "output")
+
+        stats = MinimumSpanningForestStatistics(graph, "value", "output")
+        print("Total weight:", stats.total_weight)
+
+    """
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(MinimumSpanningForest(pg.underlying_property_graph(), edge_weight_property_name_str,
+                                                 output_property_name_str, plan.underlying_))
+
+
+def minimum_spanning_forest_assert_valid(Graph pg, str edge_weight_property_name, str output_property_name):
+    """
+    Raise an exception if the forest in `pg` is not a minimum spanning forest.
+
+    :raises: AssertionError
+    """
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_assert(MinimumSpanningForestAssertValid(pg.underlying_property_graph(),
+                                                              edge_weight_property_name_str,
+                                                              output_property_name_str))
+
+
+cdef _MinimumSpanningForestStatistics handle_result_MinimumSpanningForestStatistics(
+        Result[_MinimumSpanningForestStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MinimumSpanningForestStatistics(Statistics):
+    """
+    Compute the :ref:`statistics` of a minimum spanning forest.
+    """
+    cdef _MinimumSpanningForestStatistics underlying
+
+    def __init__(self, Graph pg, str edge_weight_property_name, str output_property_name):
+        """
+        :param pg: The graph on which `minimum_spanning_forest` was called.
+        :param edge_weight_property_name: The edge weight property name passed to `minimum_spanning_forest`.
+        :param output_property_name: The output property name passed to `minimum_spanning_forest`.
+        """
+        cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+        cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_MinimumSpanningForestStatistics(_MinimumSpanningForestStatistics.Compute(
+                pg.underlying_property_graph(), edge_weight_property_name_str, output_property_name_str))
+
+    @property
+    def total_weight(self) -> float:
+        """
+        The total weight of the forest edges.
+
+        :rtype: float
+        """
+        return self.underlying.total_weight
+
+    @property
+    def num_forest_edges(self) -> int:
+        """
+        The number of edges in the forest.
+
+        :rtype: int
+        """
+        return self.underlying.num_forest_edges
+
+    @property
+    def num_trees(self) -> int:
+        """
+        The number of trees in the forest, i.e., of connected components.
+
+        :rtype: int
+        """
+        return self.underlying.num_trees
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
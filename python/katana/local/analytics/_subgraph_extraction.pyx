@@ -11,6 +11,7 @@ Subgraph Extraction
 """
 from libc.stdint cimport uint32_t
 from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.string cimport string
 from libcpp.vector cimport vector
 from pyarrow.lib cimport to_shared
 
@@ -26,8 +27,10 @@ cdef extern from "katana/analytics/subgraph_extraction/subgraph_extraction.h" na
     cppclass _SubGraphExtractionPlan "katana::analytics::SubGraphExtractionPlan" (_Plan):
         enum Algorithm:
             kNodeSet "katana::analytics::SubGraphExtractionPlan::kNodeSet"
+            kKHop "katana::analytics::SubGraphExtractionPlan::kKHop"
 
         _SubGraphExtractionPlan.Algorithm algorithm() const
+        uint32_t num_hops() const
 
         # SubGraphExtractionPlan()
 
@@ -35,11 +38,19 @@ cdef extern from "katana/analytics/subgraph_extraction/subgraph_extraction.h" na
         _SubGraphExtractionPlan NodeSet(
             )
 
-    Result[unique_ptr[_PropertyGraph]] SubGraphExtraction(_PropertyGraph* pfg, const vector[uint32_t]& node_vec, _SubGraphExtractionPlan plan)
+        @staticmethod
+        _SubGraphExtractionPlan KHop(
+            uint32_t num_hops
+            )
+
+    uint32_t kDefaultNumHops "katana::analytics::SubGraphExtractionPlan::kDefaultNumHops"
+
+    Result[unique_ptr[_PropertyGraph]] SubGraphExtraction(_PropertyGraph* pfg, const vector[uint32_t]& node_vec, _SubGraphExtractionPlan plan, const vector[string]& node_properties_to_copy, const vector[string]& edge_properties_to_copy)
 
 
 class _SubGraphExtractionPlanAlgorithm(Enum):
     NodeSet = _SubGraphExtractionPlan.Algorithm.kNodeSet
+    KHop = _SubGraphExtractionPlan.Algorithm.kKHop
 
 
 cdef class SubGraphExtractionPlan(Plan):
@@ -66,6 +77,10 @@ cdef class SubGraphExtractionPlan(Plan):
     def algorithm(self) -> Algorithm:
         return _SubGraphExtractionPlanAlgorithm(self.underlying_.algorithm())
 
+    @property
+    def num_hops(self) -> int:
+        return self.underlying_.num_hops()
+
     @staticmethod
     def node_set() -> SubGraphExtractionPlan:
         """
@@ -73,6 +88,13 @@ cdef class SubGraphExtractionPlan(Plan):
         """
         return SubGraphExtractionPlan.make(_SubGraphExtractionPlan.NodeSet())
 
+    @staticmethod
+    def k_hop(num_hops=kDefaultNumHops) -> SubGraphExtractionPlan:
+        """
+        The k-hop algorithm: the seed nodes and every node within `num_hops` out-going edges of them.
+        """
+        return SubGraphExtractionPlan.make(_SubGraphExtractionPlan.KHop(num_hops))
+
 
 cdef shared_ptr[_PropertyGraph] handle_result_property_graph(Result[unique_ptr[_PropertyGraph]] res) nogil except *:
     if not res.has_value():
@@ -81,12 +103,24 @@ cdef shared_ptr[_PropertyGraph] handle_result_property_graph(Result[unique_ptr[_
     return to_shared(res.value())
 
 
-def subgraph_extraction(Graph pg, node_vec, SubGraphExtractionPlan plan = SubGraphExtractionPlan()) -> Graph:
+def subgraph_extraction(
+    Graph pg,
+    node_vec,
+    SubGraphExtractionPlan plan = SubGraphExtractionPlan(),
+    node_properties_to_copy=None,
+    edge_properties_to_copy=None,
+) -> Graph:
     """
     Given a set of node ids, this algorithm constructs a new sub-graph which contains all nodes in the set and edges
-    between them.
+    between them. The named node and edge properties are copied to the sub-graph.
     """
     cdef vector[uint32_t] vec = [<uint32_t>n for n in node_vec]
+    cdef vector[string] node_properties = [bytes(p, "utf-8") for p in node_properties_to_copy or []]
+    cdef vector[string] edge_properties = [bytes(p, "utf-8") for p in edge_properties_to_copy or []]
     with nogil:
-        v = handle_result_property_graph(SubGraphExtraction(pg.underlying_property_graph(), vec, plan.underlying_))
+        v = handle_result_property_graph(
+            SubGraphExtraction(
+                pg.underlying_property_graph(), vec, plan.underlying_, node_properties, edge_properties
+            )
+        )
     return Graph.make(v)
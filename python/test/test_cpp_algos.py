@@ -19,15 +19,21 @@ from katana.local.analytics import (
     JaccardStatistics,
     KCoreStatistics,
     KTrussStatistics,
+    LouvainClusteringPlan,
     LouvainClusteringStatistics,
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
     PagerankStatistics,
+    SsspPlan,
     SsspStatistics,
+    SubGraphExtractionPlan,
     TriangleCountPlan,
     betweenness_centrality,
     bfs,
     bfs_assert_valid,
     connected_components,
     connected_components_assert_valid,
+    connected_components_incremental,
     find_edge_sorted_by_dest,
     independent_set,
     independent_set_assert_valid,
@@ -40,6 +46,8 @@ from katana.local.analytics import (
     local_clustering_coefficient,
     louvain_clustering,
     louvain_clustering_assert_valid,
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
     pagerank,
     pagerank_assert_valid,
     sort_all_edges_by_dest,
@@ -148,6 +156,26 @@ def test_sssp(graph: Graph):
     verify_sssp(graph, start_node, new_property_id)
 
 
+def test_sssp_plans():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+    start_node = 0
+
+    sssp(graph, start_node, "value", "automatic")
+    sssp_assert_valid(graph, start_node, "value", "automatic")
+    expected = graph.get_node_property("automatic").to_numpy()
+
+    plans = {
+        "dijkstra": SsspPlan.dijkstra(),
+        "topological": SsspPlan.topological(),
+        "delta_step": SsspPlan.delta_step(4),
+        "serial_delta": SsspPlan.serial_delta(4),
+    }
+    for name, plan in plans.items():
+        sssp(graph, start_node, "value", name, plan)
+        sssp_assert_valid(graph, start_node, "value", name)
+        assert np.array_equal(graph.get_node_property(name).to_numpy(), expected), name
+
+
 def test_jaccard(graph: Graph):
     property_name = "NewProp"
     compare_node = 0
@@ -242,6 +270,30 @@ def test_betweenness_centrality_level(graph: Graph):
     assert stats.average_centrality == approx(0.000534295046236366)
 
 
+def test_betweenness_centrality_asynchronous(graph: Graph):
+    property_name = "NewProp"
+
+    betweenness_centrality(graph, property_name, 16, BetweennessCentralityPlan.asynchronous())
+
+    stats = BetweennessCentralityStatistics(graph, property_name)
+
+    assert stats.min_centrality == 0
+    assert stats.max_centrality == approx(7.0)
+    assert stats.average_centrality == approx(0.000534295046236366)
+
+
+def test_betweenness_centrality_batched(graph: Graph):
+    property_name = "NewProp"
+
+    betweenness_centrality(graph, property_name, 16, BetweennessCentralityPlan.batched(5))
+
+    stats = BetweennessCentralityStatistics(graph, property_name)
+
+    assert stats.min_centrality == 0
+    assert stats.max_centrality == approx(7.0)
+    assert stats.average_centrality == approx(0.000534295046236366)
+
+
 def test_triangle_count():
     graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
     original_first_edge_list = [graph.get_edge_dest(e) for e in graph.edges(0)]
@@ -300,6 +352,31 @@ def test_connected_components():
     connected_components_assert_valid(graph, "output")
 
 
+def test_connected_components_incremental():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    connected_components(graph, "output")
+
+    components = graph.get_node_property("output").to_numpy()
+    labels, counts = np.unique(components, return_counts=True)
+    largest_label = labels[counts.argmax()]
+    isolated = [n for n in range(graph.num_nodes()) if components[n] != largest_label]
+    in_largest = int(np.argmax(components == largest_label))
+
+    # join two isolated nodes to the largest component and to each other
+    connected_components_incremental(
+        graph, "output", [(isolated[0], in_largest), (isolated[1], isolated[0]), (isolated[2], isolated[3])]
+    )
+
+    stats = ConnectedComponentsStatistics(graph, "output")
+
+    assert stats.total_components == 66
+    assert stats.total_non_trivial_components == 2
+    assert stats.largest_component_size == 959
+
+    connected_components_assert_valid(graph, "output")
+
+
 def test_k_core():
     graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -334,6 +411,28 @@ def test_k_truss_fail():
         k_truss(graph, 1, "output2")
 
 
+def test_minimum_spanning_forest():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    minimum_spanning_forest(graph, "value", "boruvka", MinimumSpanningForestPlan.boruvka())
+    minimum_spanning_forest(graph, "value", "filter_kruskal", MinimumSpanningForestPlan.filter_kruskal(64))
+
+    minimum_spanning_forest_assert_valid(graph, "value", "boruvka")
+    minimum_spanning_forest_assert_valid(graph, "value", "filter_kruskal")
+
+    stats = MinimumSpanningForestStatistics(graph, "value", "boruvka")
+
+    # one tree per connected component
+    assert stats.num_trees == 69
+    assert stats.num_forest_edges == graph.num_nodes() - 69
+
+    # ties are broken by edge ID, so both plans find the same forest
+    assert np.array_equal(
+        graph.get_edge_property("boruvka").to_numpy(), graph.get_edge_property("filter_kruskal").to_numpy()
+    )
+    assert MinimumSpanningForestStatistics(graph, "value", "filter_kruskal").total_weight == stats.total_weight
+
+
 def test_louvain_clustering():
     graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -349,6 +448,37 @@ def test_louvain_clustering():
     # assert stats.largest_cluster_size == 297
 
 
+def test_louvain_clustering_leiden():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    louvain_clustering(graph, "value", "output", LouvainClusteringPlan.leiden())
+
+    louvain_clustering_assert_valid(graph, "value", "output")
+
+    stats = LouvainClusteringStatistics(graph, "value", "output")
+    assert stats.n_clusters > 0
+
+    # every cluster induces a connected subgraph; nodes without a cluster are
+    # left out
+    unassigned = np.iinfo(np.uint64).max
+    members = {}
+    for n, cluster in enumerate(graph.get_node_property("output").to_numpy()):
+        if cluster != unassigned:
+            members.setdefault(cluster, set()).add(n)
+    for cluster, nodes in members.items():
+        start = next(iter(nodes))
+        reached = {start}
+        stack = [start]
+        while stack:
+            n = stack.pop()
+            for e in graph.edges(n):
+                dest = graph.get_edge_dest(e)
+                if dest in nodes and dest not in reached:
+                    reached.add(dest)
+                    stack.append(dest)
+        assert reached == nodes, cluster
+
+
 def test_local_clustering_coefficient():
     graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
 
@@ -380,6 +510,41 @@ def test_subgraph_extraction():
         assert [pg.get_edge_dest(e) for e in pg.edges(i)] == expected_edges[i]
 
 
+def test_subgraph_extraction_k_hop():
+    graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
+    graph.add_node_property(table({"OriginalID": np.arange(len(graph), dtype=np.uint64)}))
+    graph.add_edge_property(table({"OriginalEdgeID": np.arange(graph.num_edges(), dtype=np.uint64)}))
+    seeds = [3, 1, 3]
+
+    # Seeds first, deduplicated in order, then the first hop sorted by id.
+    hop = {graph.get_edge_dest(e) for n in seeds for e in graph.edges(n)}
+    nodes = [3, 1] + sorted(hop - set(seeds))
+
+    plan = SubGraphExtractionPlan.k_hop(1)
+    assert plan.algorithm == SubGraphExtractionPlan.Algorithm.KHop
+    assert plan.num_hops == 1
+    pg = subgraph_extraction(
+        graph,
+        seeds,
+        plan,
+        node_properties_to_copy=["OriginalID"],
+        edge_properties_to_copy=["OriginalEdgeID"],
+    )
+
+    assert len(pg) == len(nodes)
+    assert list(pg.get_node_property("OriginalID").to_numpy()) == nodes
+
+    original_edge_ids = pg.get_edge_property("OriginalEdgeID").to_numpy()
+    for i, n in enumerate(nodes):
+        dests = [pg.get_edge_dest(e) for e in pg.edges(i)]
+        assert dests == sorted(dests)
+        assert sorted(nodes[d] for d in dests) == sorted(
+            graph.get_edge_dest(e) for e in graph.edges(n) if graph.get_edge_dest(e) in nodes
+        )
+        for e in pg.edges(i):
+            assert graph.get_edge_dest(original_edge_ids[e]) == nodes[pg.get_edge_dest(e)]
+
+
 def test_busy_wait(graph: Graph):
     set_busy_wait()
     property_name = "NewProp"